@@ -0,0 +1,169 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/hardening.h"
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::allocator {
+
+ArenaAllocator::ArenaAllocator(Allocator& allocator, size_t chunk_size)
+    : Allocator(kCapabilities), allocator_(allocator), chunk_size_(chunk_size) {
+  PW_CHECK_UINT_GT(
+      chunk_size, sizeof(Chunk), "chunk size is too small to hold any data");
+}
+
+ArenaAllocator::~ArenaAllocator() {
+  DestroyOwned(nullptr);
+  ReleaseChunks(nullptr);
+}
+
+ArenaAllocator::Checkpoint ArenaAllocator::GetCheckpoint() {
+  // Growing an allocation made before the checkpoint would move the top of the
+  // arena past the point that a rollback restores.
+  last_ = nullptr;
+  Checkpoint checkpoint;
+  checkpoint.chunk_ = chunk_;
+  checkpoint.top_ = top_;
+  checkpoint.allocated_ = allocated_;
+  checkpoint.owned_ = owned_;
+  return checkpoint;
+}
+
+void ArenaAllocator::Rollback(const Checkpoint& checkpoint) {
+  if constexpr (Hardening::kIncludesRobustChecks) {
+    PW_CHECK_UINT_LE(checkpoint.allocated_,
+                     allocated_,
+                     "checkpoint is newer than the arena's current state");
+  }
+  DestroyOwned(checkpoint.owned_);
+  ReleaseChunks(checkpoint.chunk_);
+  SetChunk(checkpoint.chunk_, checkpoint.top_);
+  allocated_ = checkpoint.allocated_;
+}
+
+void ArenaAllocator::Reset() {
+  DestroyOwned(nullptr);
+  Chunk* first = chunk_;
+  while (first != nullptr && first->prev != nullptr) {
+    first = first->prev;
+  }
+
+  // Dedicated chunks for large requests are not kept.
+  if (first != nullptr && first->size != chunk_size_) {
+    first = nullptr;
+  }
+  ReleaseChunks(first);
+  SetChunk(first, nullptr);
+  allocated_ = 0;
+}
+
+void* ArenaAllocator::DoAllocate(Layout layout) {
+  void* ptr = AllocateFromChunk(layout);
+  if (ptr == nullptr && AddChunk(layout)) {
+    ptr = AllocateFromChunk(layout);
+  }
+  return ptr;
+}
+
+bool ArenaAllocator::DoResize(void* ptr, size_t new_size) {
+  auto* bytes = static_cast<std::byte*>(ptr);
+  if (bytes != last_ || static_cast<size_t>(end_ - last_) < new_size) {
+    return false;
+  }
+  std::byte* top = last_ + new_size;
+  if (top > top_) {
+    allocated_ += static_cast<size_t>(top - top_);
+  } else {
+    allocated_ -= static_cast<size_t>(top_ - top);
+  }
+  top_ = top;
+  return true;
+}
+
+void* ArenaAllocator::AllocateFromChunk(Layout layout) {
+  if (chunk_ == nullptr) {
+    return nullptr;
+  }
+  auto addr = cpp20::bit_cast<uintptr_t>(top_);
+  auto* ptr = top_ + (AlignUp(addr, layout.alignment()) - addr);
+  if (ptr > end_ || static_cast<size_t>(end_ - ptr) < layout.size()) {
+    return nullptr;
+  }
+  allocated_ += static_cast<size_t>(ptr - top_) + layout.size();
+  last_ = ptr;
+  top_ = ptr + layout.size();
+  return ptr;
+}
+
+bool ArenaAllocator::AddChunk(Layout layout) {
+  size_t alignment = std::max(layout.alignment(), alignof(std::max_align_t));
+  size_t size = AlignUp(sizeof(Chunk), layout.alignment());
+  if (PW_ADD_OVERFLOW(size, layout.size(), &size)) {
+    return false;
+  }
+  size = std::max(size, chunk_size_);
+  void* ptr = allocator_.Allocate(Layout(size, alignment));
+  if (ptr == nullptr) {
+    return false;
+  }
+  auto* chunk = new (ptr) Chunk{.prev = chunk_, .size = size};
+  ++num_chunks_;
+  SetChunk(chunk, nullptr);
+  return true;
+}
+
+void ArenaAllocator::DestroyOwned(internal::GenericOwned* owned) {
+  while (owned_ != owned) {
+    PW_CHECK_NOTNULL(owned_, "checkpoint does not belong to this arena");
+    internal::GenericOwned* next = owned_->next();
+    owned_->Destroy();
+    owned_ = next;
+  }
+}
+
+void ArenaAllocator::ReleaseChunks(Chunk* chunk) {
+  while (chunk_ != chunk) {
+    PW_CHECK_NOTNULL(chunk_, "checkpoint does not belong to this arena");
+    Chunk* prev = chunk_->prev;
+    std::destroy_at(chunk_);
+    allocator_.Deallocate(chunk_);
+    --num_chunks_;
+    chunk_ = prev;
+  }
+}
+
+void ArenaAllocator::SetChunk(Chunk* chunk, std::byte* top) {
+  chunk_ = chunk;
+  last_ = nullptr;
+  if (chunk == nullptr) {
+    top_ = nullptr;
+    end_ = nullptr;
+    return;
+  }
+  auto* base = reinterpret_cast<std::byte*>(chunk);
+  top_ = top != nullptr ? top : base + sizeof(Chunk);
+  end_ = base + chunk->size;
+}
+
+}  // namespace pw::allocator
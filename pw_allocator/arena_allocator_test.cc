@@ -0,0 +1,196 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/testing.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::ArenaAllocator;
+using ::pw::allocator::Layout;
+
+constexpr size_t kCapacity = 0x1000;
+constexpr size_t kChunkSize = 0x100;
+
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<kCapacity>;
+
+class DestroyCounter final {
+ public:
+  DestroyCounter(size_t* counter) : counter_(counter) {}
+  ~DestroyCounter() { *counter_ += 1; }
+
+ private:
+  size_t* counter_;
+};
+
+// Unit tests.
+
+TEST(ArenaAllocatorTest, AllocateAligned) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  void* ptr = allocator.Allocate(Layout(1, 1));
+  ASSERT_NE(ptr, nullptr);
+
+  // Last pointer was unaligned, so next won't automatically be aligned.
+  ptr = allocator.Allocate(Layout(8, 32));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(cpp20::bit_cast<uintptr_t>(ptr) % 32, 0U);
+  EXPECT_EQ(allocator.num_chunks(), 1U);
+}
+
+TEST(ArenaAllocatorTest, AllocateAcquiresChunksAsNeeded) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  for (size_t i = 0; i < 8; ++i) {
+    ASSERT_NE(allocator.Allocate(Layout(kChunkSize / 2, 1)), nullptr);
+  }
+  EXPECT_EQ(allocator.num_chunks(), 8U);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 8U);
+}
+
+TEST(ArenaAllocatorTest, AllocateLargeUsesDedicatedChunk) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  void* ptr = allocator.Allocate(Layout(kChunkSize * 4, 64));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(cpp20::bit_cast<uintptr_t>(ptr) % 64, 0U);
+  EXPECT_EQ(allocator.num_chunks(), 1U);
+}
+
+TEST(ArenaAllocatorTest, AllocateFailsWhenParentIsExhausted) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  EXPECT_EQ(allocator.Allocate(Layout(kCapacity, 1)), nullptr);
+  EXPECT_EQ(allocator.num_chunks(), 0U);
+}
+
+TEST(ArenaAllocatorTest, DeallocateDoesNothing) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  void* ptr1 = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr1, nullptr);
+  allocator.Deallocate(ptr1);
+  void* ptr2 = allocator.Allocate(Layout(16, 1));
+  EXPECT_NE(ptr1, ptr2);
+}
+
+TEST(ArenaAllocatorTest, ResizeLastAllocation) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  void* ptr1 = allocator.Allocate(Layout(16, 1));
+  void* ptr2 = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_FALSE(allocator.Resize(ptr1, 32));
+  EXPECT_TRUE(allocator.Resize(ptr2, 32));
+  EXPECT_TRUE(allocator.Resize(ptr2, 8));
+  EXPECT_FALSE(allocator.Resize(ptr2, kChunkSize));
+
+  void* ptr3 = allocator.Allocate(Layout(1, 1));
+  EXPECT_EQ(ptr3, static_cast<std::byte*>(ptr2) + 8);
+}
+
+TEST(ArenaAllocatorTest, RollbackFreesLaterAllocations) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  ASSERT_NE(allocator.Allocate(Layout(16, 1)), nullptr);
+  size_t allocated = allocator.GetAllocated();
+  ArenaAllocator::Checkpoint checkpoint = allocator.GetCheckpoint();
+
+  void* ptr = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr, nullptr);
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_NE(allocator.Allocate(Layout(kChunkSize / 2, 1)), nullptr);
+  }
+  EXPECT_GT(allocator.num_chunks(), 1U);
+
+  allocator.Rollback(checkpoint);
+  EXPECT_EQ(allocator.num_chunks(), 1U);
+  EXPECT_EQ(allocator.GetAllocated(), allocated);
+  EXPECT_EQ(allocator.Allocate(Layout(16, 1)), ptr);
+}
+
+TEST(ArenaAllocatorTest, RollbackDestroysLaterOwnedObjects) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  size_t counter1 = 0;
+  size_t counter2 = 0;
+  ASSERT_NE(allocator.NewOwned<DestroyCounter>(&counter1), nullptr);
+  ArenaAllocator::Checkpoint checkpoint = allocator.GetCheckpoint();
+  ASSERT_NE(allocator.NewOwned<DestroyCounter>(&counter2), nullptr);
+  ASSERT_NE(allocator.NewOwned<DestroyCounter>(&counter2), nullptr);
+
+  allocator.Rollback(checkpoint);
+  EXPECT_EQ(counter1, 0U);
+  EXPECT_EQ(counter2, 2U);
+}
+
+TEST(ArenaAllocatorTest, ResetKeepsFirstChunk) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  size_t counter = 0;
+  for (size_t i = 0; i < 16; ++i) {
+    ASSERT_NE(allocator.NewOwned<DestroyCounter>(&counter), nullptr);
+    ASSERT_NE(allocator.Allocate(Layout(kChunkSize / 4, 1)), nullptr);
+  }
+  EXPECT_GT(allocator.num_chunks(), 1U);
+
+  allocator.Reset();
+  EXPECT_EQ(counter, 16U);
+  EXPECT_EQ(allocator.num_chunks(), 1U);
+  EXPECT_EQ(allocator.GetAllocated(), 0U);
+
+  ASSERT_NE(allocator.Allocate(Layout(16, 1)), nullptr);
+  EXPECT_EQ(parent.metrics().num_allocations.value() -
+                parent.metrics().num_deallocations.value(),
+            1U);
+}
+
+TEST(ArenaAllocatorTest, DestructorReleasesAllChunks) {
+  AllocatorForTest parent;
+  size_t counter = 0;
+  {
+    ArenaAllocator allocator(parent, kChunkSize);
+    for (size_t i = 0; i < 4; ++i) {
+      ASSERT_NE(allocator.NewOwned<DestroyCounter>(&counter), nullptr);
+      ASSERT_NE(allocator.Allocate(Layout(kChunkSize / 2, 1)), nullptr);
+    }
+  }
+  EXPECT_EQ(counter, 4U);
+  EXPECT_EQ(parent.metrics().num_allocations.value(),
+            parent.metrics().num_deallocations.value());
+}
+
+TEST(ArenaAllocatorTest, MakeUniqueOwnedDestroysOnce) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, kChunkSize);
+  size_t counter = 0;
+  {
+    auto ptr = allocator.MakeUniqueOwned<DestroyCounter>(&counter);
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(counter, 0U);
+  allocator.Reset();
+  EXPECT_EQ(counter, 1U);
+}
+
+}  // namespace
@@ -14,6 +14,11 @@
 
 #include "pw_allocator/benchmarks/measurements.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "lib/stdcompat/bit.h"
+
 namespace pw::allocator {
 namespace internal {
 
@@ -119,4 +124,174 @@ DefaultMeasurements::DefaultMeasurements(metric::Token name)
   }
 }
 
+// ScalingMeasurements methods
+
+ScalingMeasurements::ScalingMeasurements(metric::Token name) : metrics_(name) {
+  metrics_.Add(one_thread_);
+  metrics_.Add(two_threads_);
+  metrics_.Add(four_threads_);
+  metrics_.Add(eight_threads_);
+}
+
+float ScalingMeasurements::nanoseconds(size_t num_threads) const {
+  switch (num_threads) {
+    case 1:
+      return one_thread_.value();
+    case 2:
+      return two_threads_.value();
+    case 4:
+      return four_threads_.value();
+    case 8:
+      return eight_threads_.value();
+    default:
+      return 0.f;
+  }
+}
+
+void ScalingMeasurements::Update(size_t num_threads, float nanoseconds) {
+  switch (num_threads) {
+    case 1:
+      one_thread_.Set(nanoseconds);
+      break;
+    case 2:
+      two_threads_.Set(nanoseconds);
+      break;
+    case 4:
+      four_threads_.Set(nanoseconds);
+      break;
+    case 8:
+      eight_threads_.Set(nanoseconds);
+      break;
+    default:
+      break;
+  }
+}
+
+// LatencyHistogram methods
+
+size_t LatencyHistogram::BucketOf(uint64_t nanoseconds) {
+  if (nanoseconds < 4) {
+    return static_cast<size_t>(nanoseconds);
+  }
+  // Each power of two is split into 4 buckets using the two bits after the
+  // most significant bit.
+  auto msb = static_cast<size_t>(cpp20::bit_width(nanoseconds)) - 1;
+  auto quarter = static_cast<size_t>((nanoseconds >> (msb - 2)) & 3);
+  return std::min((msb - 1) * 4 + quarter, kNumBuckets - 1);
+}
+
+uint64_t LatencyHistogram::UpperBoundOf(size_t bucket) {
+  if (bucket < 4) {
+    return bucket;
+  }
+  size_t msb = bucket / 4 + 1;
+  uint64_t quarter = bucket % 4;
+  return ((uint64_t(5) + quarter) << (msb - 2)) - 1;
+}
+
+void LatencyHistogram::Add(uint64_t nanoseconds) {
+  ++buckets_[BucketOf(nanoseconds)];
+  ++count_;
+  total_ += nanoseconds;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ += other.total_;
+}
+
+void LatencyHistogram::Clear() {
+  buckets_.fill(0);
+  count_ = 0;
+  total_ = 0;
+}
+
+float LatencyHistogram::mean() const {
+  if (count_ == 0) {
+    return 0.f;
+  }
+  return static_cast<float>(total_) / static_cast<float>(count_);
+}
+
+uint64_t LatencyHistogram::Percentile(float percent) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(
+      std::ceil(static_cast<double>(count_) * percent / 100.0));
+  rank = std::clamp<uint64_t>(rank, 1, count_);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return UpperBoundOf(i);
+    }
+  }
+  return UpperBoundOf(kNumBuckets - 1);
+}
+
+// StressMeasurements methods
+
+StressMeasurements::StressMeasurements(metric::Token name) : metrics_(name) {
+  metrics_.Add(throughput_);
+  metrics_.Add(mean_);
+  metrics_.Add(p50_);
+  metrics_.Add(p99_);
+  metrics_.Add(p999_);
+  metrics_.Add(failures_);
+  metrics_.Add(cross_thread_frees_);
+  metrics_.Add(fragmentation_25_);
+  metrics_.Add(fragmentation_50_);
+  metrics_.Add(fragmentation_75_);
+  metrics_.Add(fragmentation_100_);
+}
+
+float StressMeasurements::fragmentation(size_t sample) const {
+  switch (sample) {
+    case 0:
+      return fragmentation_25_.value();
+    case 1:
+      return fragmentation_50_.value();
+    case 2:
+      return fragmentation_75_.value();
+    case 3:
+      return fragmentation_100_.value();
+    default:
+      return 0.f;
+  }
+}
+
+void StressMeasurements::SetThroughput(float requests_per_second) {
+  throughput_.Set(requests_per_second);
+}
+
+void StressMeasurements::SetLatencies(const LatencyHistogram& histogram) {
+  mean_.Set(histogram.mean());
+  p50_.Set(static_cast<float>(histogram.Percentile(50.f)));
+  p99_.Set(static_cast<float>(histogram.Percentile(99.f)));
+  p999_.Set(static_cast<float>(histogram.Percentile(99.9f)));
+}
+
+void StressMeasurements::SetFragmentation(size_t sample, float fragmentation) {
+  switch (sample) {
+    case 0:
+      fragmentation_25_.Set(fragmentation);
+      break;
+    case 1:
+      fragmentation_50_.Set(fragmentation);
+      break;
+    case 2:
+      fragmentation_75_.Set(fragmentation);
+      break;
+    case 3:
+      fragmentation_100_.Set(fragmentation);
+      break;
+    default:
+      break;
+  }
+}
+
 }  // namespace pw::allocator
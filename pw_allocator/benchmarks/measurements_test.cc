@@ -19,8 +19,11 @@
 
 namespace {
 
+using pw::allocator::LatencyHistogram;
 using pw::allocator::Measurement;
 using pw::allocator::Measurements;
+using pw::allocator::ScalingMeasurements;
+using pw::allocator::StressMeasurements;
 using pw::allocator::internal::BenchmarkSample;
 
 constexpr pw::metric::Token kName = PW_TOKENIZE_STRING("test");
@@ -177,4 +180,105 @@ TEST(MeasurementsTest, BySize) {
   EXPECT_EQ(&(by_size.GetBySize(size_t(-1))), &at_least_256);
 }
 
+TEST(ScalingMeasurementsTest, Update) {
+  ScalingMeasurements measurements(kName);
+  for (size_t num_threads : ScalingMeasurements::kNumThreads) {
+    EXPECT_FLOAT_EQ(measurements.nanoseconds(num_threads), 0.f);
+    measurements.Update(num_threads, 100.f * num_threads);
+  }
+  EXPECT_FLOAT_EQ(measurements.nanoseconds(1), 100.f);
+  EXPECT_FLOAT_EQ(measurements.nanoseconds(2), 200.f);
+  EXPECT_FLOAT_EQ(measurements.nanoseconds(4), 400.f);
+  EXPECT_FLOAT_EQ(measurements.nanoseconds(8), 800.f);
+}
+
+TEST(ScalingMeasurementsTest, IgnoresOtherThreadCounts) {
+  ScalingMeasurements measurements(kName);
+  measurements.Update(3, 300.f);
+  EXPECT_FLOAT_EQ(measurements.nanoseconds(3), 0.f);
+  for (size_t num_threads : ScalingMeasurements::kNumThreads) {
+    EXPECT_FLOAT_EQ(measurements.nanoseconds(num_threads), 0.f);
+  }
+}
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_FLOAT_EQ(histogram.mean(), 0.f);
+  EXPECT_EQ(histogram.Percentile(50.f), 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  histogram.Add(1);
+  histogram.Add(2);
+  histogram.Add(3);
+  EXPECT_EQ(histogram.count(), 3u);
+  EXPECT_FLOAT_EQ(histogram.mean(), 2.f);
+  EXPECT_EQ(histogram.Percentile(0.f), 1u);
+  EXPECT_EQ(histogram.Percentile(50.f), 2u);
+  EXPECT_EQ(histogram.Percentile(100.f), 3u);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinAQuarter) {
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histogram.Add(i * 100);
+  }
+  EXPECT_FLOAT_EQ(histogram.mean(), 50050.f);
+
+  uint64_t p50 = histogram.Percentile(50.f);
+  EXPECT_GE(p50, 50000u);
+  EXPECT_LT(p50, 50000u * 5 / 4);
+
+  uint64_t p99 = histogram.Percentile(99.f);
+  EXPECT_GE(p99, 99000u);
+  EXPECT_LT(p99, 99000u * 5 / 4);
+
+  EXPECT_GE(histogram.Percentile(100.f), 100000u);
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram histogram1;
+  LatencyHistogram histogram2;
+  for (uint64_t i = 0; i < 99; ++i) {
+    histogram1.Add(10);
+  }
+  histogram2.Add(10000);
+  histogram1.Merge(histogram2);
+  EXPECT_EQ(histogram1.count(), 100u);
+  EXPECT_LT(histogram1.Percentile(99.f), 16u);
+  EXPECT_GE(histogram1.Percentile(99.9f), 10000u);
+
+  histogram1.Clear();
+  EXPECT_EQ(histogram1.count(), 0u);
+}
+
+TEST(StressMeasurementsTest, SetLatencies) {
+  LatencyHistogram histogram;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    histogram.Add(i < 990 ? 1 : 3);
+  }
+  StressMeasurements measurements(kName);
+  measurements.SetLatencies(histogram);
+  EXPECT_FLOAT_EQ(measurements.mean(), 1.02f);
+  EXPECT_FLOAT_EQ(measurements.p50(), 1.f);
+  EXPECT_FLOAT_EQ(measurements.p99(), 1.f);
+  EXPECT_FLOAT_EQ(measurements.p999(), 3.f);
+}
+
+TEST(StressMeasurementsTest, SetFragmentation) {
+  StressMeasurements measurements(kName);
+  for (size_t i = 0; i < StressMeasurements::kNumSamples; ++i) {
+    measurements.SetFragmentation(i, 0.1f * static_cast<float>(i + 1));
+  }
+  measurements.SetFragmentation(StressMeasurements::kNumSamples, 1.f);
+  EXPECT_FLOAT_EQ(measurements.fragmentation(0), 0.1f);
+  EXPECT_FLOAT_EQ(measurements.fragmentation(1), 0.2f);
+  EXPECT_FLOAT_EQ(measurements.fragmentation(2), 0.3f);
+  EXPECT_FLOAT_EQ(measurements.fragmentation(3), 0.4f);
+  EXPECT_FLOAT_EQ(
+      measurements.fragmentation(StressMeasurements::kNumSamples), 0.f);
+}
+
 }  // namespace
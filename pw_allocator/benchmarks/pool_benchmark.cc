@@ -0,0 +1,158 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how the throughput of a fixed-size pool shared between threads
+// scales as the number of threads increases, comparing a `ChunkPool` guarded by
+// a mutex with a `LockFreeChunkPool`.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/layout.h"
+#include "pw_allocator/lock_free_chunk_pool.h"
+#include "pw_allocator/pool.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_random/xor_shift.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+constexpr metric::Token kLockedBenchmark =
+    PW_TOKENIZE_STRING("locked ChunkPool benchmark");
+constexpr metric::Token kLockFreeBenchmark =
+    PW_TOKENIZE_STRING("LockFreeChunkPool benchmark");
+
+constexpr size_t kMaxThreads = 8;
+constexpr size_t kRequestsPerThread = 100000;
+constexpr size_t kSlotsPerThread = 16;
+constexpr size_t kChunkSize = 64;
+
+// Leave some chunks unused so that allocations only fail when threads are
+// holding most of the pool.
+constexpr size_t kNumChunks = kMaxThreads * kSlotsPerThread * 3 / 4;
+
+/// Wraps a `ChunkPool` with a mutex, as would be needed to share it between
+/// threads.
+class LockedChunkPool : public Pool {
+ public:
+  LockedChunkPool(ByteSpan region, const Layout& layout)
+      : Pool(ChunkPool::kCapabilities, layout), pool_(region, layout) {}
+
+ private:
+  void* DoAllocate() override {
+    std::lock_guard lock(lock_);
+    return pool_.Allocate();
+  }
+
+  void DoDeallocate(void* ptr) override {
+    std::lock_guard lock(lock_);
+    pool_.Deallocate(ptr);
+  }
+
+  sync::Mutex lock_;
+  ChunkPool pool_;
+};
+
+/// Makes a random sequence of allocations and deallocations, keeping up to
+/// `kSlotsPerThread` chunks outstanding at a time.
+class Worker {
+ public:
+  void Init(Pool& pool, uint64_t seed) {
+    pool_ = &pool;
+    prng_ = random::XorShiftStarRng64(seed);
+  }
+
+  void Run() {
+    for (size_t i = 0; i < kRequestsPerThread; ++i) {
+      size_t index;
+      prng_.GetInt(index, kSlotsPerThread);
+      void*& slot = slots_[index];
+      if (slot != nullptr) {
+        pool_->Deallocate(slot);
+        slot = nullptr;
+      } else {
+        slot = pool_->Allocate();
+      }
+    }
+    for (void*& slot : slots_) {
+      if (slot != nullptr) {
+        pool_->Deallocate(slot);
+        slot = nullptr;
+      }
+    }
+  }
+
+ private:
+  Pool* pool_ = nullptr;
+  random::XorShiftStarRng64 prng_{1};
+  std::array<void*, kSlotsPerThread> slots_{};
+};
+
+alignas(kChunkSize) std::array<std::byte, kChunkSize * kNumChunks> buffer;
+std::array<Worker, kMaxThreads> workers;
+std::array<thread::test::TestThreadContext, kMaxThreads> contexts;
+
+/// Runs `num_threads` workers concurrently and returns the mean time per
+/// request in nanoseconds.
+float RunWorkers(Pool& pool, size_t num_threads) {
+  std::array<Thread, kMaxThreads> threads;
+  auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < num_threads; ++i) {
+    Worker* worker = &workers[i];
+    worker->Init(pool, i + 1);
+    threads[i] = Thread(contexts[i].options(), [worker] { worker->Run(); });
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads[i].join();
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return static_cast<float>(nanoseconds) /
+         static_cast<float>(num_threads * kRequestsPerThread);
+}
+
+void DoPoolBenchmark() {
+  Layout layout(kChunkSize, kChunkSize);
+  ScalingMeasurements locked_measurements(kLockedBenchmark);
+  ScalingMeasurements lock_free_measurements(kLockFreeBenchmark);
+  for (size_t num_threads : ScalingMeasurements::kNumThreads) {
+    {
+      LockedChunkPool pool(buffer, layout);
+      locked_measurements.Update(num_threads, RunWorkers(pool, num_threads));
+    }
+    {
+      LockFreeChunkPool pool(buffer, layout);
+      lock_free_measurements.Update(num_threads, RunWorkers(pool, num_threads));
+    }
+  }
+  locked_measurements.metrics().Dump();
+  lock_free_measurements.metrics().Dump();
+}
+
+}  // namespace pw::allocator
+
+int main() {
+  pw::allocator::DoPoolBenchmark();
+  return 0;
+}
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -172,4 +173,125 @@ class DefaultMeasurements final : public Measurements {
   }};
 };
 
+/// Mean time per request, by the number of threads making requests.
+///
+/// This is used by benchmarks that measure how an allocator's throughput
+/// scales as more threads share it.
+class ScalingMeasurements {
+ public:
+  /// Thread counts for which measurements are recorded.
+  static constexpr std::array<size_t, 4> kNumThreads = {1, 2, 4, 8};
+
+  explicit ScalingMeasurements(metric::Token name);
+
+  metric::Group& metrics() { return metrics_; }
+
+  /// Returns the measurement for the given number of threads, or 0 if it is
+  /// not one of `kNumThreads`.
+  float nanoseconds(size_t num_threads) const;
+
+  /// Records the mean time per request for the given number of threads. Does
+  /// nothing if the number of threads is not one of `kNumThreads`.
+  void Update(size_t num_threads, float nanoseconds);
+
+ private:
+  metric::Group metrics_;
+  PW_METRIC(one_thread_, "1 thread: mean time per request (ns)", 0.f);
+  PW_METRIC(two_threads_, "2 threads: mean time per request (ns)", 0.f);
+  PW_METRIC(four_threads_, "4 threads: mean time per request (ns)", 0.f);
+  PW_METRIC(eight_threads_, "8 threads: mean time per request (ns)", 0.f);
+};
+
+/// Distribution of the latencies of allocator requests.
+///
+/// Latencies are counted in buckets that each span a quarter of a power of
+/// two, so percentiles are accurate to within 25%.
+class LatencyHistogram {
+ public:
+  /// Adds a request that took the given number of nanoseconds.
+  void Add(uint64_t nanoseconds);
+
+  /// Adds the requests counted by another histogram to this one.
+  void Merge(const LatencyHistogram& other);
+
+  /// Removes all requests.
+  void Clear();
+
+  /// Number of requests counted.
+  uint64_t count() const { return count_; }
+
+  /// Mean latency of the requests counted.
+  float mean() const;
+
+  /// Returns an upper bound on the latency of `percent` percent of the
+  /// requests counted, e.g. `Percentile(99.f)` for the 99th percentile.
+  uint64_t Percentile(float percent) const;
+
+ private:
+  static constexpr size_t kNumBuckets = 160;
+
+  static size_t BucketOf(uint64_t nanoseconds);
+  static uint64_t UpperBoundOf(size_t bucket);
+
+  std::array<uint32_t, kNumBuckets> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t total_ = 0;
+};
+
+/// Measurements from running a workload on several threads at once.
+///
+/// Besides throughput and latency percentiles, this records the
+/// fragmentation of the allocator at evenly spaced points in the workload.
+class StressMeasurements {
+ public:
+  /// Number of times fragmentation is sampled over the course of a workload.
+  static constexpr size_t kNumSamples = 4;
+
+  explicit StressMeasurements(metric::Token name);
+
+  metric::Group& metrics() { return metrics_; }
+
+  float throughput() const { return throughput_.value(); }
+  float mean() const { return mean_.value(); }
+  float p50() const { return p50_.value(); }
+  float p99() const { return p99_.value(); }
+  float p999() const { return p999_.value(); }
+  uint32_t failures() const { return failures_.value(); }
+  uint32_t cross_thread_frees() const { return cross_thread_frees_.value(); }
+
+  /// Returns the fragmentation recorded for the given sample, or 0 if the
+  /// sample index is out of range.
+  float fragmentation(size_t sample) const;
+
+  /// Records the number of requests completed per second.
+  void SetThroughput(float requests_per_second);
+
+  /// Records the latency mean and percentiles from a histogram.
+  void SetLatencies(const LatencyHistogram& histogram);
+
+  /// Records the fragmentation after `sample + 1` of `kNumSamples` portions
+  /// of the workload have completed.
+  void SetFragmentation(size_t sample, float fragmentation);
+
+  void AddFailures(uint32_t failures) { failures_.Increment(failures); }
+
+  void AddCrossThreadFrees(uint32_t frees) {
+    cross_thread_frees_.Increment(frees);
+  }
+
+ private:
+  metric::Group metrics_;
+  PW_METRIC(throughput_, "throughput (requests per second)", 0.f);
+  PW_METRIC(mean_, "mean response time (ns)", 0.f);
+  PW_METRIC(p50_, "50th percentile response time (ns)", 0.f);
+  PW_METRIC(p99_, "99th percentile response time (ns)", 0.f);
+  PW_METRIC(p999_, "99.9th percentile response time (ns)", 0.f);
+  PW_METRIC(failures_, "number of calls that failed", 0u);
+  PW_METRIC(cross_thread_frees_, "number of frees by another thread", 0u);
+  PW_METRIC(fragmentation_25_, "fragmentation after 25% of requests", 0.f);
+  PW_METRIC(fragmentation_50_, "fragmentation after 50% of requests", 0.f);
+  PW_METRIC(fragmentation_75_, "fragmentation after 75% of requests", 0.f);
+  PW_METRIC(fragmentation_100_, "fragmentation after all requests", 0.f);
+};
+
 }  // namespace pw::allocator
@@ -0,0 +1,121 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/tracer.h"
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_status/status.h"
+
+namespace pw::allocator {
+
+/// Replays a recorded allocation trace against another allocator.
+///
+/// Traces are recorded on a device by setting a `Tracer` on a
+/// `TrackingAllocator`. Each recorded address is mapped to the memory
+/// returned by the replayed request, so that later requests for the same
+/// address are made with the replayed memory instead.
+///
+/// Requests that failed when recorded are still replayed. If the replayed
+/// request succeeds, it is counted as a divergence and, for allocations,
+/// immediately freed so that the remainder of the trace sees the same live
+/// set as the device did.
+///
+/// This class uses the host's heap to map addresses, and is only intended for
+/// use on host.
+class TraceReplayer {
+ public:
+  explicit TraceReplayer(Allocator& allocator) : allocator_(allocator) {}
+
+  ~TraceReplayer() { Reset(); }
+
+  /// Replays a single request.
+  void Replay(const TraceEvent& event);
+
+  /// Decodes and replays a sequence of requests, as written by a
+  /// `StreamTracer` or `RingBufferTracer::Dump`.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Every request was replayed.
+  ///
+  ///    DATA_LOSS: The trace is corrupt or truncated. Requests before the
+  ///    corrupt portion were replayed.
+  ///
+  /// @endrst
+  Status Replay(ConstByteSpan trace);
+
+  /// Frees any memory still allocated by replayed requests, and clears the
+  /// latencies and counters.
+  void Reset();
+
+  /// Latencies of the replayed requests.
+  const LatencyHistogram& latencies() const { return latencies_; }
+
+  /// Number of replayed requests that failed but succeeded when recorded.
+  uint32_t failures() const { return failures_; }
+
+  /// Number of replayed requests that succeeded but failed when recorded.
+  uint32_t divergences() const { return divergences_; }
+
+  /// Number of requests for addresses that were not returned by any earlier
+  /// replayed request, e.g. because the trace started part way through.
+  uint32_t unmatched() const { return unmatched_; }
+
+  /// Number of replayed allocations that have not been freed.
+  size_t num_outstanding() const { return live_.size() + pending_.size(); }
+
+ private:
+  void ReplayAllocate(const TraceEvent& event);
+  void ReplayDeallocate(const TraceEvent& event);
+  void ReplayResize(const TraceEvent& event);
+  void ReplayReallocate(const TraceEvent& event);
+  void ReplayBeginReallocate(const TraceEvent& event);
+
+  /// Maps the memory from a replayed reallocation to the address that the
+  /// recorded request left in use.
+  void FinishReallocate(const TraceEvent& event, void* ptr, bool reallocated);
+
+  /// Returns the replayed memory for a recorded address, or null if there is
+  /// none.
+  void* Lookup(uint64_t id);
+
+  /// Records the latency of a request that started at `start`.
+  void AddLatency(chrono::SystemClock::time_point start);
+
+  Allocator& allocator_;
+  /// Result of a replayed reallocation whose recorded result has not been
+  /// replayed yet.
+  struct PendingReallocation {
+    void* ptr;
+    bool reallocated;
+  };
+
+  std::unordered_map<uint64_t, void*> live_;
+  std::unordered_map<uint64_t, PendingReallocation> pending_;
+  LatencyHistogram latencies_;
+  uint32_t failures_ = 0;
+  uint32_t divergences_ = 0;
+  uint32_t unmatched_ = 0;
+};
+
+}  // namespace pw::allocator
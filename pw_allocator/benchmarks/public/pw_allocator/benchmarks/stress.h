@@ -0,0 +1,191 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/layout.h"
+#include "pw_random/xor_shift.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+
+namespace pw::allocator {
+
+/// Describes a workload to run against an allocator from several threads.
+///
+/// Each thread makes `requests_per_thread` allocations. Each allocation has a
+/// size chosen uniformly from `[min_size, max_size]`, and is freed once the
+/// thread has made a number of further allocations chosen uniformly from
+/// `[min_lifetime, max_lifetime]`. A `long_lived_percent` share of
+/// allocations instead live until the end of the workload.
+///
+/// A `cross_thread_percent` share of frees are handed to another thread to
+/// perform, as happens when a producer allocates messages that a consumer
+/// frees.
+struct WorkloadProfile {
+  size_t num_threads = 1;
+  size_t requests_per_thread = 10000;
+  size_t min_size = 1;
+  size_t max_size = 256;
+  size_t min_lifetime = 1;
+  size_t max_lifetime = 64;
+  uint8_t long_lived_percent = 0;
+  uint8_t cross_thread_percent = 0;
+};
+
+namespace internal {
+
+// Forward declaration for the workers.
+class GenericStressBenchmark;
+
+/// Runs one thread's share of a workload.
+class StressWorker {
+ public:
+  /// Maximum number of allocations a worker holds at once. Allocations beyond
+  /// this are skipped rather than made.
+  static constexpr size_t kMaxLive = 512;
+
+  /// Maximum number of allocations that may be waiting for a worker to free
+  /// them on behalf of another thread.
+  static constexpr size_t kInboxSize = 64;
+
+  void Init(GenericStressBenchmark& benchmark, size_t index);
+
+  /// Makes this worker's share of the requests, then frees everything it still
+  /// holds.
+  void Run();
+
+  /// Frees allocations handed to this worker by other threads.
+  void DrainInbox();
+
+  const LatencyHistogram& latencies() const { return latencies_; }
+  uint32_t failures() const { return failures_; }
+  uint32_t cross_thread_frees() const { return cross_thread_frees_; }
+
+ private:
+  struct Allocation {
+    void* ptr;
+    size_t expires;
+  };
+
+  static constexpr size_t kNeverExpires = ~size_t(0);
+
+  /// Returns a random value in `[min, max]`.
+  size_t GetRandom(size_t min, size_t max);
+
+  /// Hands an allocation to this worker to free. Returns false if the inbox is
+  /// full.
+  bool Send(void* ptr);
+
+  /// Frees an allocation, possibly by handing it to another worker.
+  void Release(void* ptr);
+
+  GenericStressBenchmark* benchmark_ = nullptr;
+  size_t index_ = 0;
+  random::XorShiftStarRng64 prng_{1};
+  std::array<Allocation, kMaxLive> live_{};
+  size_t num_live_ = 0;
+  LatencyHistogram latencies_;
+  uint32_t failures_ = 0;
+  uint32_t cross_thread_frees_ = 0;
+
+  sync::Mutex inbox_lock_;
+  std::array<void*, kInboxSize> inbox_ PW_GUARDED_BY(inbox_lock_) = {};
+  size_t inbox_count_ PW_GUARDED_BY(inbox_lock_) = 0;
+};
+
+/// Base class for running workloads against block allocators from several
+/// threads.
+///
+/// Requests are serialized on a single lock, and the time taken to acquire it
+/// is included in each request's latency. This class is not templated and
+/// avoids any types related to the specific block allocator.
+///
+/// Callers should not use this class directly, and instead use
+/// `StressBenchmark`.
+class GenericStressBenchmark {
+ public:
+  /// Maximum number of threads in a workload.
+  static constexpr size_t kMaxThreads = 8;
+
+  virtual ~GenericStressBenchmark() = default;
+
+  /// Runs a workload and records the results in `measurements`.
+  ///
+  /// The `measurements` should be freshly constructed, or used only for runs
+  /// with the same profile.
+  void Run(const WorkloadProfile& profile, StressMeasurements& measurements);
+
+ protected:
+  explicit GenericStressBenchmark(Allocator& allocator)
+      : allocator_(allocator) {}
+
+ private:
+  friend class StressWorker;
+
+  /// Measures the current fragmentation of an allocator.
+  virtual Fragmentation GetBlockFragmentation() const = 0;
+
+  void* Allocate(Layout layout, LatencyHistogram& latencies);
+  void Deallocate(void* ptr, LatencyHistogram& latencies);
+
+  /// Records the allocator's fragmentation for a point in the workload.
+  void SampleFragmentation(size_t sample);
+
+  Allocator& allocator_ PW_GUARDED_BY(lock_);
+  sync::Mutex lock_;
+  WorkloadProfile profile_;
+  StressMeasurements* measurements_ = nullptr;
+  std::array<StressWorker, kMaxThreads> workers_;
+  std::array<thread::test::TestThreadContext, kMaxThreads> contexts_;
+};
+
+}  // namespace internal
+
+/// Runs workloads against a block allocator from several threads.
+///
+/// Example:
+/// @code{.cpp}
+///   TlsfAllocator allocator(buffer);
+///   StressBenchmark benchmark(allocator);
+///   StressMeasurements measurements(PW_TOKENIZE_STRING("producer/consumer"));
+///   benchmark.Run(WorkloadProfile{.num_threads = 4,
+///                                 .cross_thread_percent = 100},
+///                 measurements);
+///   measurements.metrics().Dump();
+/// @endcode
+///
+/// @tparam   AllocatorType  Type of the block allocator being benchmarked.
+template <typename AllocatorType>
+class StressBenchmark : public internal::GenericStressBenchmark {
+ public:
+  explicit StressBenchmark(AllocatorType& allocator)
+      : internal::GenericStressBenchmark(allocator), allocator_(allocator) {}
+
+ private:
+  /// @copydoc GenericStressBenchmark::GetBlockFragmentation
+  Fragmentation GetBlockFragmentation() const override {
+    return allocator_.MeasureFragmentation();
+  }
+
+  AllocatorType& allocator_;
+};
+
+}  // namespace pw::allocator
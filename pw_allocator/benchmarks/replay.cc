@@ -0,0 +1,218 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmarks/replay.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "pw_allocator/trace.h"
+
+namespace pw::allocator {
+namespace {
+
+Layout GetLayout(const TraceEvent& event) {
+  return Layout(static_cast<size_t>(event.size),
+                std::max(static_cast<size_t>(event.alignment), size_t(1)));
+}
+
+}  // namespace
+
+void TraceReplayer::Replay(const TraceEvent& event) {
+  switch (event.type) {
+    case TraceEventType::kAllocate:
+      ReplayAllocate(event);
+      break;
+    case TraceEventType::kDeallocate:
+      ReplayDeallocate(event);
+      break;
+    case TraceEventType::kResize:
+      ReplayResize(event);
+      break;
+    case TraceEventType::kReallocate:
+      ReplayReallocate(event);
+      break;
+    case TraceEventType::kBeginReallocate:
+      ReplayBeginReallocate(event);
+      break;
+  }
+}
+
+Status TraceReplayer::Replay(ConstByteSpan trace) {
+  while (!trace.empty()) {
+    TraceEvent event;
+    StatusWithSize result = DecodeTraceEvent(trace, event);
+    if (!result.ok()) {
+      return Status::DataLoss();
+    }
+    Replay(event);
+    trace = trace.subspan(result.size());
+  }
+  return OkStatus();
+}
+
+void TraceReplayer::Reset() {
+  for (auto& [id, ptr] : live_) {
+    allocator_.Deallocate(ptr);
+  }
+  live_.clear();
+  for (auto& [id, pending] : pending_) {
+    allocator_.Deallocate(pending.ptr);
+  }
+  pending_.clear();
+  latencies_.Clear();
+  failures_ = 0;
+  divergences_ = 0;
+  unmatched_ = 0;
+}
+
+void TraceReplayer::ReplayAllocate(const TraceEvent& event) {
+  auto start = chrono::SystemClock::now();
+  void* ptr = allocator_.Allocate(GetLayout(event));
+  AddLatency(start);
+  if (ptr == nullptr) {
+    if (!event.failed) {
+      ++failures_;
+    }
+    return;
+  }
+  if (event.failed) {
+    ++divergences_;
+    allocator_.Deallocate(ptr);
+    return;
+  }
+  auto [iter, inserted] = live_.emplace(event.id, ptr);
+  if (!inserted) {
+    // The trace reused an address without freeing it first.
+    ++unmatched_;
+    allocator_.Deallocate(iter->second);
+    iter->second = ptr;
+  }
+}
+
+void TraceReplayer::ReplayDeallocate(const TraceEvent& event) {
+  if (event.id == 0) {
+    return;
+  }
+  auto iter = live_.find(event.id);
+  if (iter == live_.end()) {
+    ++unmatched_;
+    return;
+  }
+  auto start = chrono::SystemClock::now();
+  allocator_.Deallocate(iter->second);
+  AddLatency(start);
+  live_.erase(iter);
+}
+
+void TraceReplayer::ReplayResize(const TraceEvent& event) {
+  void* ptr = Lookup(event.id);
+  if (ptr == nullptr) {
+    return;
+  }
+  auto start = chrono::SystemClock::now();
+  bool resized = allocator_.Resize(ptr, static_cast<size_t>(event.size));
+  AddLatency(start);
+  if (!resized && !event.failed) {
+    ++failures_;
+  } else if (resized && event.failed) {
+    ++divergences_;
+  }
+}
+
+void TraceReplayer::ReplayBeginReallocate(const TraceEvent& event) {
+  auto iter = live_.find(event.id);
+  if (iter == live_.end()) {
+    ++unmatched_;
+    return;
+  }
+  void* ptr = iter->second;
+  live_.erase(iter);
+
+  // The recorded address may be reused by other requests before the result
+  // is recorded, so the request is replayed now and its result held until
+  // then.
+  auto start = chrono::SystemClock::now();
+  void* new_ptr = allocator_.Reallocate(ptr, GetLayout(event));
+  AddLatency(start);
+  if (new_ptr == nullptr) {
+    pending_[event.id] = {ptr, false};
+  } else {
+    pending_[event.id] = {new_ptr, true};
+  }
+}
+
+void TraceReplayer::ReplayReallocate(const TraceEvent& event) {
+  if (event.id == 0) {
+    // Reallocating null is equivalent to allocating.
+    TraceEvent allocate = event;
+    allocate.type = TraceEventType::kAllocate;
+    allocate.id = event.new_id;
+    ReplayAllocate(allocate);
+    return;
+  }
+
+  // Traces recorded by a `TrackingAllocator` begin each reallocation with a
+  // separate event. Otherwise, the request is replayed here.
+  auto iter = pending_.find(event.id);
+  if (iter != pending_.end()) {
+    PendingReallocation pending = iter->second;
+    pending_.erase(iter);
+    FinishReallocate(event, pending.ptr, pending.reallocated);
+    return;
+  }
+  void* ptr = Lookup(event.id);
+  if (ptr == nullptr) {
+    return;
+  }
+  live_.erase(event.id);
+  auto start = chrono::SystemClock::now();
+  void* new_ptr = allocator_.Reallocate(ptr, GetLayout(event));
+  AddLatency(start);
+  if (new_ptr == nullptr) {
+    FinishReallocate(event, ptr, false);
+  } else {
+    FinishReallocate(event, new_ptr, true);
+  }
+}
+
+void TraceReplayer::FinishReallocate(const TraceEvent& event,
+                                     void* ptr,
+                                     bool reallocated) {
+  if (!reallocated && !event.failed) {
+    ++failures_;
+  } else if (reallocated && event.failed) {
+    ++divergences_;
+  }
+
+  // If the recorded request failed, the device kept using the old address.
+  live_[event.failed ? event.id : event.new_id] = ptr;
+}
+
+void* TraceReplayer::Lookup(uint64_t id) {
+  auto iter = live_.find(id);
+  if (iter == live_.end()) {
+    ++unmatched_;
+    return nullptr;
+  }
+  return iter->second;
+}
+
+void TraceReplayer::AddLatency(chrono::SystemClock::time_point start) {
+  auto elapsed = chrono::SystemClock::now() - start;
+  latencies_.Add(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,165 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmarks/replay.h"
+
+#include <array>
+#include <cstddef>
+
+#include "pw_allocator/testing.h"
+#include "pw_allocator/trace.h"
+#include "pw_allocator/tracking_allocator.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+constexpr size_t kCapacity = 1024;
+
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<kCapacity>;
+using ::pw::allocator::Layout;
+using ::pw::allocator::StreamTracer;
+using ::pw::allocator::TraceEvent;
+using ::pw::allocator::TraceEventType;
+using ::pw::allocator::TraceReplayer;
+using ::pw::allocator::test::kToken;
+
+size_t GetNumOutstanding(const AllocatorForTest& allocator) {
+  return allocator.metrics().num_allocations.value() -
+         allocator.metrics().num_deallocations.value();
+}
+
+TEST(TraceReplayerTest, ReplaysRecordedTrace) {
+  std::array<std::byte, 512> trace;
+  pw::stream::MemoryWriter writer(trace);
+  StreamTracer tracer(writer);
+
+  AllocatorForTest recorded;
+  pw::allocator::TrackingAllocator<pw::allocator::NoMetrics> tracker(kToken,
+                                                                     recorded);
+  tracker.set_tracer(&tracer);
+  void* ptr1 = tracker.Allocate(Layout(64, 8));
+  void* ptr2 = tracker.Allocate(Layout(32, 4));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_TRUE(tracker.Resize(ptr2, 16));
+  EXPECT_EQ(tracker.Allocate(Layout(kCapacity * 2, 1)), nullptr);
+  void* ptr3 = tracker.Reallocate(ptr1, Layout(128, 8));
+  ASSERT_NE(ptr3, nullptr);
+  tracker.Deallocate(ptr2);
+  tracker.set_tracer(nullptr);
+
+  AllocatorForTest replayed;
+  TraceReplayer replayer(replayed);
+  EXPECT_EQ(replayer.Replay(writer.WrittenData()), pw::OkStatus());
+  EXPECT_EQ(replayer.failures(), 0u);
+  EXPECT_EQ(replayer.divergences(), 0u);
+  EXPECT_EQ(replayer.unmatched(), 0u);
+  EXPECT_EQ(replayer.latencies().count(), 6u);
+
+  // Only the reallocated memory is still live.
+  EXPECT_EQ(replayer.num_outstanding(), 1u);
+  EXPECT_EQ(GetNumOutstanding(replayed), 1u);
+
+  replayer.Reset();
+  EXPECT_EQ(replayer.num_outstanding(), 0u);
+  EXPECT_EQ(GetNumOutstanding(replayed), 0u);
+  tracker.Deallocate(ptr3);
+}
+
+TEST(TraceReplayerTest, CountsFailuresAndDivergences) {
+  AllocatorForTest allocator;
+  TraceReplayer replayer(allocator);
+
+  // Succeeded when recorded, fails when replayed.
+  replayer.Replay({.type = TraceEventType::kAllocate,
+                   .id = 0x1000,
+                   .size = kCapacity * 2,
+                   .alignment = 1});
+  EXPECT_EQ(replayer.failures(), 1u);
+
+  // Failed when recorded, succeeds when replayed.
+  replayer.Replay({.type = TraceEventType::kAllocate,
+                   .failed = true,
+                   .size = 16,
+                   .alignment = 1});
+  EXPECT_EQ(replayer.divergences(), 1u);
+  EXPECT_EQ(replayer.num_outstanding(), 0u);
+  EXPECT_EQ(GetNumOutstanding(allocator), 0u);
+}
+
+TEST(TraceReplayerTest, CountsUnmatchedAddresses) {
+  AllocatorForTest allocator;
+  TraceReplayer replayer(allocator);
+  replayer.Replay({.type = TraceEventType::kDeallocate, .id = 0x1000});
+  replayer.Replay({.type = TraceEventType::kResize, .id = 0x2000, .size = 8});
+  EXPECT_EQ(replayer.unmatched(), 2u);
+  EXPECT_EQ(replayer.latencies().count(), 0u);
+}
+
+TEST(TraceReplayerTest, ReallocateNullAllocates) {
+  AllocatorForTest allocator;
+  TraceReplayer replayer(allocator);
+  replayer.Replay({.type = TraceEventType::kReallocate,
+                   .new_id = 0x1000,
+                   .size = 16,
+                   .alignment = 4});
+  EXPECT_EQ(replayer.num_outstanding(), 1u);
+  replayer.Replay({.type = TraceEventType::kDeallocate, .id = 0x1000});
+  EXPECT_EQ(replayer.num_outstanding(), 0u);
+  EXPECT_EQ(replayer.unmatched(), 0u);
+}
+
+TEST(TraceReplayerTest, ReallocatedAddressReusedBeforeResult) {
+  AllocatorForTest allocator;
+  TraceReplayer replayer(allocator);
+
+  // Another thread allocates the released address before the reallocation's
+  // result is recorded.
+  replayer.Replay({.type = TraceEventType::kAllocate,
+                   .id = 0x1000,
+                   .size = 16,
+                   .alignment = 4});
+  replayer.Replay({.type = TraceEventType::kBeginReallocate,
+                   .id = 0x1000,
+                   .size = 64,
+                   .alignment = 4});
+  replayer.Replay({.type = TraceEventType::kAllocate,
+                   .id = 0x1000,
+                   .size = 16,
+                   .alignment = 4});
+  replayer.Replay({.type = TraceEventType::kReallocate,
+                   .id = 0x1000,
+                   .new_id = 0x2000,
+                   .size = 64,
+                   .alignment = 4});
+  EXPECT_EQ(replayer.num_outstanding(), 2u);
+  EXPECT_EQ(GetNumOutstanding(allocator), 2u);
+
+  replayer.Replay({.type = TraceEventType::kDeallocate, .id = 0x1000});
+  replayer.Replay({.type = TraceEventType::kDeallocate, .id = 0x2000});
+  EXPECT_EQ(replayer.num_outstanding(), 0u);
+  EXPECT_EQ(GetNumOutstanding(allocator), 0u);
+  EXPECT_EQ(replayer.unmatched(), 0u);
+  EXPECT_EQ(replayer.failures(), 0u);
+}
+
+TEST(TraceReplayerTest, RejectsCorruptTrace) {
+  AllocatorForTest allocator;
+  TraceReplayer replayer(allocator);
+  std::array<std::byte, 2> trace = {std::byte(0x7f), std::byte(0)};
+  EXPECT_EQ(replayer.Replay(trace), pw::Status::DataLoss());
+}
+
+}  // namespace
@@ -0,0 +1,134 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares a `SlabAllocator` with a `BucketAllocator` for a workload made up of
+// a few fixed object sizes, and reports latency and the fragmentation of the
+// underlying memory over time.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/bucket_allocator.h"
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/layout.h"
+#include "pw_allocator/slab_allocator.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_random/xor_shift.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+constexpr metric::Token kBucketBenchmark =
+    PW_TOKENIZE_STRING("bucket allocator benchmark");
+constexpr metric::Token kSlabBenchmark =
+    PW_TOKENIZE_STRING("slab allocator benchmark");
+
+constexpr size_t kCapacity = 0x100000;  // 1 MiB
+constexpr size_t kPageSize = 0x1000;
+constexpr size_t kNumRequests = 200000;
+constexpr size_t kNumSlots = 2048;
+
+// Object sizes, e.g. list items, RPC calls, and buffer chunks.
+constexpr std::array<size_t, 4> kSizes = {24, 48, 96, 192};
+
+using BucketAllocatorType = BucketAllocator<BucketBlock<>, 32, 8>;
+
+std::array<std::byte, kCapacity> buffer;
+
+/// Makes a random sequence of allocations and deallocations of the object
+/// sizes, keeping up to `kNumSlots` objects outstanding at a time.
+///
+/// Fragmentation is measured from `heap`, which provides the memory for
+/// `allocator`.
+void RunWorkload(Allocator& allocator,
+                 BucketAllocatorType& heap,
+                 StressMeasurements& measurements) {
+  random::XorShiftStarRng64 prng(1);
+  std::array<void*, kNumSlots> slots{};
+  LatencyHistogram latencies;
+  uint32_t failures = 0;
+  constexpr size_t kSampleInterval =
+      kNumRequests / StressMeasurements::kNumSamples;
+
+  auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    size_t index;
+    prng.GetInt(index, kNumSlots);
+    void*& slot = slots[index];
+    auto request_start = chrono::SystemClock::now();
+    if (slot != nullptr) {
+      allocator.Deallocate(slot);
+      slot = nullptr;
+    } else {
+      size_t size_index;
+      prng.GetInt(size_index, kSizes.size());
+      slot = allocator.Allocate(Layout(kSizes[size_index], alignof(void*)));
+      if (slot == nullptr) {
+        ++failures;
+      }
+    }
+    auto elapsed = chrono::SystemClock::now() - request_start;
+    latencies.Add(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+            .count()));
+
+    if ((i + 1) % kSampleInterval == 0) {
+      measurements.SetFragmentation(
+          (i + 1) / kSampleInterval - 1,
+          CalculateFragmentation(heap.MeasureFragmentation()));
+    }
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+
+  for (void*& slot : slots) {
+    if (slot != nullptr) {
+      allocator.Deallocate(slot);
+    }
+  }
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (nanoseconds > 0) {
+    measurements.SetThroughput(static_cast<float>(kNumRequests) * 1e9f /
+                               static_cast<float>(nanoseconds));
+  }
+  measurements.SetLatencies(latencies);
+  measurements.AddFailures(failures);
+}
+
+void DoSlabBenchmark() {
+  StressMeasurements bucket_measurements(kBucketBenchmark);
+  StressMeasurements slab_measurements(kSlabBenchmark);
+  {
+    BucketAllocatorType heap(buffer);
+    RunWorkload(heap, heap, bucket_measurements);
+  }
+  {
+    BucketAllocatorType heap(buffer);
+    SlabAllocator<kSizes.size()> allocator(heap, kPageSize, kSizes);
+    RunWorkload(allocator, heap, slab_measurements);
+  }
+  bucket_measurements.metrics().Dump();
+  slab_measurements.metrics().Dump();
+}
+
+}  // namespace pw::allocator
+
+int main() {
+  pw::allocator::DoSlabBenchmark();
+  return 0;
+}
@@ -0,0 +1,209 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmarks/stress.h"
+
+#include <chrono>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_thread/thread.h"
+
+namespace pw::allocator::internal {
+
+// StressWorker methods
+
+void StressWorker::Init(GenericStressBenchmark& benchmark, size_t index) {
+  benchmark_ = &benchmark;
+  index_ = index;
+  prng_ = random::XorShiftStarRng64(index + 1);
+  num_live_ = 0;
+  latencies_.Clear();
+  failures_ = 0;
+  cross_thread_frees_ = 0;
+}
+
+size_t StressWorker::GetRandom(size_t min, size_t max) {
+  if (min >= max) {
+    return min;
+  }
+  size_t value;
+  prng_.GetInt(value, max - min + 1);
+  return min + value;
+}
+
+void StressWorker::Run() {
+  const WorkloadProfile& profile = benchmark_->profile_;
+  size_t sample_interval =
+      profile.requests_per_thread / StressMeasurements::kNumSamples;
+  for (size_t step = 0; step < profile.requests_per_thread; ++step) {
+    DrainInbox();
+
+    // Free expired allocations.
+    for (size_t i = 0; i < num_live_;) {
+      if (live_[i].expires > step) {
+        ++i;
+        continue;
+      }
+      Release(live_[i].ptr);
+      live_[i] = live_[--num_live_];
+    }
+
+    if (num_live_ < kMaxLive) {
+      Layout layout(GetRandom(profile.min_size, profile.max_size));
+      void* ptr = benchmark_->Allocate(layout, latencies_);
+      if (ptr == nullptr) {
+        ++failures_;
+      } else {
+        size_t expires = kNeverExpires;
+        if (GetRandom(1, 100) > profile.long_lived_percent) {
+          expires =
+              step + GetRandom(profile.min_lifetime, profile.max_lifetime);
+        }
+        live_[num_live_++] = Allocation{ptr, expires};
+      }
+    }
+
+    // Only the first worker samples fragmentation, to avoid stalling the
+    // others more than needed.
+    if (index_ == 0 && sample_interval != 0 &&
+        (step + 1) % sample_interval == 0) {
+      benchmark_->SampleFragmentation((step + 1) / sample_interval - 1);
+    }
+  }
+
+  DrainInbox();
+  for (size_t i = 0; i < num_live_; ++i) {
+    benchmark_->Deallocate(live_[i].ptr, latencies_);
+  }
+  num_live_ = 0;
+}
+
+bool StressWorker::Send(void* ptr) {
+  std::lock_guard lock(inbox_lock_);
+  if (inbox_count_ == kInboxSize) {
+    return false;
+  }
+  inbox_[inbox_count_++] = ptr;
+  return true;
+}
+
+void StressWorker::DrainInbox() {
+  std::array<void*, kInboxSize> ptrs;
+  size_t count;
+  {
+    std::lock_guard lock(inbox_lock_);
+    ptrs = inbox_;
+    count = inbox_count_;
+    inbox_count_ = 0;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    benchmark_->Deallocate(ptrs[i], latencies_);
+  }
+}
+
+void StressWorker::Release(void* ptr) {
+  const WorkloadProfile& profile = benchmark_->profile_;
+  if (profile.num_threads > 1 &&
+      GetRandom(1, 100) <= profile.cross_thread_percent) {
+    size_t peer = (index_ + 1) % profile.num_threads;
+    if (benchmark_->workers_[peer].Send(ptr)) {
+      ++cross_thread_frees_;
+      return;
+    }
+  }
+  benchmark_->Deallocate(ptr, latencies_);
+}
+
+// GenericStressBenchmark methods
+
+void GenericStressBenchmark::Run(const WorkloadProfile& profile,
+                                 StressMeasurements& measurements) {
+  PW_CHECK_UINT_NE(profile.num_threads, 0);
+  PW_CHECK_UINT_LE(profile.num_threads, kMaxThreads);
+  PW_CHECK_UINT_LE(profile.min_size, profile.max_size);
+  PW_CHECK_UINT_LE(profile.min_lifetime, profile.max_lifetime);
+  profile_ = profile;
+  measurements_ = &measurements;
+
+  std::array<Thread, kMaxThreads> threads;
+  auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < profile.num_threads; ++i) {
+    StressWorker* worker = &workers_[i];
+    worker->Init(*this, i);
+    threads[i] = Thread(contexts_[i].options(), [worker] { worker->Run(); });
+  }
+  for (size_t i = 0; i < profile.num_threads; ++i) {
+    threads[i].join();
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+
+  // Workers may have handed allocations to peers that had already finished.
+  LatencyHistogram latencies;
+  for (size_t i = 0; i < profile.num_threads; ++i) {
+    StressWorker& worker = workers_[i];
+    worker.DrainInbox();
+    latencies.Merge(worker.latencies());
+    measurements.AddFailures(worker.failures());
+    measurements.AddCrossThreadFrees(worker.cross_thread_frees());
+  }
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (nanoseconds > 0) {
+    measurements.SetThroughput(static_cast<float>(latencies.count()) * 1e9f /
+                               static_cast<float>(nanoseconds));
+  }
+  measurements.SetLatencies(latencies);
+  measurements_ = nullptr;
+}
+
+void* GenericStressBenchmark::Allocate(Layout layout,
+                                       LatencyHistogram& latencies) {
+  auto start = chrono::SystemClock::now();
+  void* ptr;
+  {
+    std::lock_guard lock(lock_);
+    ptr = allocator_.Allocate(layout);
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+  latencies.Add(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+  return ptr;
+}
+
+void GenericStressBenchmark::Deallocate(void* ptr,
+                                        LatencyHistogram& latencies) {
+  auto start = chrono::SystemClock::now();
+  {
+    std::lock_guard lock(lock_);
+    allocator_.Deallocate(ptr);
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+  latencies.Add(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+void GenericStressBenchmark::SampleFragmentation(size_t sample) {
+  Fragmentation fragmentation;
+  {
+    std::lock_guard lock(lock_);
+    fragmentation = GetBlockFragmentation();
+  }
+  PW_CHECK_NOTNULL(measurements_);
+  measurements_->SetFragmentation(sample,
+                                  CalculateFragmentation(fragmentation));
+}
+
+}  // namespace pw::allocator::internal
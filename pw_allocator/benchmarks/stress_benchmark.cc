@@ -0,0 +1,106 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Runs several multi-threaded workloads against each block allocator, and
+// reports throughput, tail latency, and fragmentation over time.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/benchmarks/stress.h"
+#include "pw_allocator/best_fit.h"
+#include "pw_allocator/first_fit.h"
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_allocator/worst_fit.h"
+#include "pw_metric/metric.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+// The allocators are kept small, since the cost of some of their checks grows
+// with the size of their largest free block.
+constexpr size_t kCapacity = 0x200000;  // 2 MiB
+constexpr size_t kNumWorkloads = 3;
+
+constexpr std::array<WorkloadProfile, kNumWorkloads> kWorkloads = {{
+    // Many small, short-lived allocations on each thread.
+    {
+        .num_threads = 4,
+        .requests_per_thread = 10000,
+        .min_size = 16,
+        .max_size = 256,
+        .min_lifetime = 1,
+        .max_lifetime = 16,
+    },
+    // Allocations of widely varying sizes and lifetimes, with a few that live
+    // until the end.
+    {
+        .num_threads = 4,
+        .requests_per_thread = 10000,
+        .min_size = 16,
+        .max_size = 1024,
+        .min_lifetime = 1,
+        .max_lifetime = 256,
+        .long_lived_percent = 2,
+    },
+    // Messages that are allocated by one thread and freed by another.
+    {
+        .num_threads = 4,
+        .requests_per_thread = 10000,
+        .min_size = 64,
+        .max_size = 512,
+        .min_lifetime = 1,
+        .max_lifetime = 32,
+        .cross_thread_percent = 100,
+    },
+}};
+
+std::array<std::byte, kCapacity> buffer;
+
+template <typename AllocatorType>
+void RunWorkloads(metric::Token name) {
+  metric::Group metrics(name);
+  std::array<StressMeasurements, kNumWorkloads> measurements = {{
+      StressMeasurements(PW_TOKENIZE_STRING_EXPR("short-lived")),
+      StressMeasurements(PW_TOKENIZE_STRING_EXPR("mixed lifetimes")),
+      StressMeasurements(PW_TOKENIZE_STRING_EXPR("producer/consumer")),
+  }};
+  for (size_t i = 0; i < kNumWorkloads; ++i) {
+    AllocatorType allocator(buffer);
+    StressBenchmark benchmark(allocator);
+    benchmark.Run(kWorkloads[i], measurements[i]);
+    metrics.Add(measurements[i].metrics());
+  }
+  metrics.Dump();
+}
+
+void DoStressBenchmarks() {
+  RunWorkloads<BestFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("best fit stress benchmark"));
+  RunWorkloads<FirstFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("first fit stress benchmark"));
+  RunWorkloads<TlsfAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("two-layer, segregated-fit stress benchmark"));
+  RunWorkloads<WorstFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("worst fit stress benchmark"));
+}
+
+}  // namespace pw::allocator
+
+int main() {
+  pw::allocator::DoStressBenchmarks();
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmarks/stress.h"
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/testing.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+constexpr size_t kCapacity = 65536;
+
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<kCapacity>;
+using Benchmark = ::pw::allocator::StressBenchmark<AllocatorForTest>;
+using ::pw::allocator::StressMeasurements;
+using ::pw::allocator::WorkloadProfile;
+using ::pw::allocator::test::kToken;
+
+size_t GetNumOutstanding(const AllocatorForTest& allocator) {
+  return allocator.metrics().num_allocations.value() -
+         allocator.metrics().num_deallocations.value();
+}
+
+TEST(StressBenchmarkTest, SingleThread) {
+  AllocatorForTest allocator;
+  Benchmark benchmark(allocator);
+  StressMeasurements measurements(kToken);
+  benchmark.Run(WorkloadProfile{.num_threads = 1,
+                                .requests_per_thread = 1000,
+                                .min_size = 16,
+                                .max_size = 128,
+                                .long_lived_percent = 10},
+                measurements);
+
+  EXPECT_EQ(GetNumOutstanding(allocator), 0u);
+  EXPECT_EQ(measurements.failures(), 0u);
+  EXPECT_EQ(measurements.cross_thread_frees(), 0u);
+  EXPECT_GT(measurements.throughput(), 0.f);
+  EXPECT_LE(measurements.p50(), measurements.p99());
+  EXPECT_LE(measurements.p99(), measurements.p999());
+
+  // Long-lived allocations leave holes between them.
+  EXPECT_GT(measurements.fragmentation(StressMeasurements::kNumSamples - 1),
+            0.f);
+}
+
+TEST(StressBenchmarkTest, ReportsFailures) {
+  AllocatorForTest allocator;
+  Benchmark benchmark(allocator);
+  StressMeasurements measurements(kToken);
+  benchmark.Run(WorkloadProfile{.num_threads = 1,
+                                .requests_per_thread = 100,
+                                .min_size = kCapacity,
+                                .max_size = kCapacity},
+                measurements);
+  EXPECT_EQ(measurements.failures(), 100u);
+  EXPECT_EQ(GetNumOutstanding(allocator), 0u);
+}
+
+// TODO: https://pwbug.dev/365161669 - Express joinability as a build-system
+// constraint.
+#if PW_THREAD_JOINING_ENABLED
+
+TEST(StressBenchmarkTest, ProducerConsumer) {
+  AllocatorForTest allocator;
+  Benchmark benchmark(allocator);
+  StressMeasurements measurements(kToken);
+  benchmark.Run(WorkloadProfile{.num_threads = 4,
+                                .requests_per_thread = 1000,
+                                .min_size = 16,
+                                .max_size = 64,
+                                .cross_thread_percent = 100},
+                measurements);
+
+  // Every allocation is freed, whichever thread frees it.
+  EXPECT_EQ(GetNumOutstanding(allocator), 0u);
+  EXPECT_EQ(measurements.failures(), 0u);
+  EXPECT_GT(measurements.cross_thread_frees(), 0u);
+}
+
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
@@ -0,0 +1,138 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how the throughput of a shared allocator scales as the number of
+// threads making small requests increases, with and without per-thread caches.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/layout.h"
+#include "pw_allocator/synchronized_allocator.h"
+#include "pw_allocator/thread_caching_allocator.h"
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+#include "pw_random/xor_shift.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+constexpr metric::Token kSynchronizedBenchmark =
+    PW_TOKENIZE_STRING("synchronized TLSF benchmark");
+constexpr metric::Token kThreadCachingBenchmark =
+    PW_TOKENIZE_STRING("thread-caching TLSF benchmark");
+
+// The wrapped allocator is kept small, since the cost of some of its checks
+// grows with the size of its largest free block.
+constexpr size_t kCapacity = 0x400000;  // 4 MiB
+constexpr size_t kMaxThreads = 8;
+constexpr size_t kRequestsPerThread = 20000;
+constexpr size_t kSlotsPerThread = 64;
+constexpr size_t kMaxRequestSize = 512;
+
+/// Makes a random sequence of small allocations and deallocations, keeping up
+/// to `kSlotsPerThread` allocations outstanding at a time.
+class Worker {
+ public:
+  void Init(Allocator& allocator, uint64_t seed) {
+    allocator_ = &allocator;
+    prng_ = random::XorShiftStarRng64(seed);
+  }
+
+  void Run() {
+    for (size_t i = 0; i < kRequestsPerThread; ++i) {
+      size_t index;
+      prng_.GetInt(index, kSlotsPerThread);
+      void*& slot = slots_[index];
+      if (slot != nullptr) {
+        allocator_->Deallocate(slot);
+        slot = nullptr;
+        continue;
+      }
+      size_t size;
+      prng_.GetInt(size, kMaxRequestSize);
+      slot = allocator_->Allocate(Layout(size + 1));
+    }
+    for (void*& slot : slots_) {
+      if (slot != nullptr) {
+        allocator_->Deallocate(slot);
+        slot = nullptr;
+      }
+    }
+  }
+
+ private:
+  Allocator* allocator_ = nullptr;
+  random::XorShiftStarRng64 prng_{1};
+  std::array<void*, kSlotsPerThread> slots_{};
+};
+
+std::array<std::byte, kCapacity> buffer;
+std::array<Worker, kMaxThreads> workers;
+std::array<thread::test::TestThreadContext, kMaxThreads> contexts;
+
+/// Runs `num_threads` workers concurrently and returns the mean time per
+/// request in nanoseconds.
+float RunWorkers(Allocator& allocator, size_t num_threads) {
+  std::array<Thread, kMaxThreads> threads;
+  auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < num_threads; ++i) {
+    Worker* worker = &workers[i];
+    worker->Init(allocator, i + 1);
+    threads[i] = Thread(contexts[i].options(), [worker] { worker->Run(); });
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads[i].join();
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return static_cast<float>(nanoseconds) /
+         static_cast<float>(num_threads * kRequestsPerThread);
+}
+
+void DoThreadCachingBenchmark() {
+  ScalingMeasurements synchronized_measurements(kSynchronizedBenchmark);
+  ScalingMeasurements caching_measurements(kThreadCachingBenchmark);
+  for (size_t num_threads : ScalingMeasurements::kNumThreads) {
+    {
+      TlsfAllocator tlsf(buffer);
+      SynchronizedAllocator<sync::Mutex> synchronized(tlsf);
+      synchronized_measurements.Update(num_threads,
+                                       RunWorkers(synchronized, num_threads));
+    }
+    {
+      TlsfAllocator tlsf(buffer);
+      ThreadCachingAllocator<sync::Mutex, kMaxThreads> caching(tlsf);
+      caching_measurements.Update(num_threads,
+                                  RunWorkers(caching, num_threads));
+    }
+  }
+  synchronized_measurements.metrics().Dump();
+  caching_measurements.metrics().Dump();
+}
+
+}  // namespace pw::allocator
+
+int main() {
+  pw::allocator::DoThreadCachingBenchmark();
+  return 0;
+}
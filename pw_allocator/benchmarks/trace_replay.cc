@@ -0,0 +1,145 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Replays an allocation trace recorded on a device against each block
+// allocator, and reports latency, failures, and fragmentation over time.
+//
+// Usage: trace_replay <trace file>
+//
+// The trace file holds events as written by a `StreamTracer` or by
+// `RingBufferTracer::Dump`.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pw_allocator/benchmarks/measurements.h"
+#include "pw_allocator/benchmarks/replay.h"
+#include "pw_allocator/best_fit.h"
+#include "pw_allocator/first_fit.h"
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_allocator/trace.h"
+#include "pw_allocator/worst_fit.h"
+#include "pw_log/log.h"
+#include "pw_metric/metric.h"
+#include "pw_stream/std_file_stream.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+
+// The allocators are kept small, since the cost of some of their checks grows
+// with the size of their largest free block.
+constexpr size_t kCapacity = 0x400000;  // 4 MiB
+
+std::array<std::byte, kCapacity> buffer;
+
+/// Reads a trace file and splits it into events.
+Status ReadTrace(const char* path, std::vector<TraceEvent>& events) {
+  stream::StdFileReader reader(path);
+  std::vector<std::byte> contents;
+  std::array<std::byte, 4096> chunk;
+  while (true) {
+    Result<ByteSpan> result = reader.Read(chunk);
+    if (result.status().IsOutOfRange()) {
+      break;
+    }
+    if (!result.ok()) {
+      return result.status();
+    }
+    contents.insert(contents.end(), result->begin(), result->end());
+  }
+
+  ConstByteSpan data(contents.data(), contents.size());
+  while (!data.empty()) {
+    TraceEvent event;
+    StatusWithSize decoded = DecodeTraceEvent(data, event);
+    if (!decoded.ok()) {
+      return Status::DataLoss();
+    }
+    events.push_back(event);
+    data = data.subspan(decoded.size());
+  }
+  return OkStatus();
+}
+
+template <typename AllocatorType>
+void ReplayTrace(metric::Token name, const std::vector<TraceEvent>& events) {
+  AllocatorType allocator(buffer);
+  TraceReplayer replayer(allocator);
+  StressMeasurements measurements(name);
+  size_t sample_interval = events.size() / StressMeasurements::kNumSamples;
+  if (sample_interval == 0) {
+    sample_interval = 1;
+  }
+
+  auto start = chrono::SystemClock::now();
+  for (size_t i = 0; i < events.size(); ++i) {
+    replayer.Replay(events[i]);
+    size_t sample = (i + 1) / sample_interval - 1;
+    if ((i + 1) % sample_interval == 0 &&
+        sample < StressMeasurements::kNumSamples) {
+      measurements.SetFragmentation(
+          sample, CalculateFragmentation(allocator.MeasureFragmentation()));
+    }
+  }
+  auto elapsed = chrono::SystemClock::now() - start;
+
+  const LatencyHistogram& latencies = replayer.latencies();
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  if (nanoseconds > 0) {
+    measurements.SetThroughput(static_cast<float>(latencies.count()) * 1e9f /
+                               static_cast<float>(nanoseconds));
+  }
+  measurements.SetLatencies(latencies);
+  measurements.AddFailures(replayer.failures());
+  if (replayer.divergences() != 0 || replayer.unmatched() != 0) {
+    PW_LOG_WARN("%u requests diverged and %u were for unknown addresses",
+                static_cast<unsigned>(replayer.divergences()),
+                static_cast<unsigned>(replayer.unmatched()));
+  }
+  measurements.metrics().Dump();
+}
+
+int DoTraceReplay(const char* path) {
+  std::vector<TraceEvent> events;
+  Status status = ReadTrace(path, events);
+  if (!status.ok()) {
+    PW_LOG_ERROR("Failed to read trace from %s: %s", path, status.str());
+    return 1;
+  }
+  PW_LOG_INFO("Replaying %u events", static_cast<unsigned>(events.size()));
+  ReplayTrace<BestFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("best fit trace replay"), events);
+  ReplayTrace<FirstFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("first fit trace replay"), events);
+  ReplayTrace<TlsfAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("two-layer, segregated-fit trace replay"),
+      events);
+  ReplayTrace<WorstFitAllocator<>>(
+      PW_TOKENIZE_STRING_EXPR("worst fit trace replay"), events);
+  return 0;
+}
+
+}  // namespace pw::allocator
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    PW_LOG_ERROR("Usage: %s <trace file>", argv[0]);
+    return 1;
+  }
+  return pw::allocator::DoTraceReplay(argv[1]);
+}
@@ -0,0 +1,64 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_TRACE_MODULE_NAME "pw_allocator"
+
+#include "pw_allocator/block_trace.h"
+
+#include "pw_trace/trace.h"
+
+// Events are only emitted by builds that enable block tracing. Tests of this
+// file build it again with a fake trace backend.
+#if PW_ALLOCATOR_BLOCK_TRACE
+
+namespace pw::allocator::internal {
+
+// Describes `BlockTraceData` to `pw_trace`'s host tools. Labels and formats
+// may be tokenized, and so must be string literals.
+#define PW_ALLOCATOR_BLOCK_TRACE_DATA_FORMAT \
+  "@pw_py_map_fmt:{search_length:I,splits:H,merges:H}"
+
+void BlockTrace::DoStart(Request request) {
+  switch (request) {
+    case Request::kAllocate:
+      PW_TRACE_START("Allocate", "BlockAllocator");
+      break;
+    case Request::kDeallocate:
+      PW_TRACE_START("Deallocate", "BlockAllocator");
+      break;
+  }
+}
+
+void BlockTrace::DoEnd(Request request, const BlockTraceData& data) {
+  switch (request) {
+    case Request::kAllocate:
+      PW_TRACE_END_DATA("Allocate",
+                        "BlockAllocator",
+                        PW_ALLOCATOR_BLOCK_TRACE_DATA_FORMAT,
+                        &data,
+                        sizeof(data));
+      break;
+    case Request::kDeallocate:
+      PW_TRACE_END_DATA("Deallocate",
+                        "BlockAllocator",
+                        PW_ALLOCATOR_BLOCK_TRACE_DATA_FORMAT,
+                        &data,
+                        sizeof(data));
+      break;
+  }
+}
+
+}  // namespace pw::allocator::internal
+
+#endif  // PW_ALLOCATOR_BLOCK_TRACE
@@ -0,0 +1,151 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/block_trace.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "fake_backend.h"
+#include "pw_allocator/first_fit.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+// Used by the fake trace backend.
+trace_fake_backend::LastEvent trace_fake_backend::LastEvent::instance_;
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::internal::BlockTrace;
+using ::pw::allocator::internal::BlockTraceData;
+using ::trace_fake_backend::Event;
+using ::trace_fake_backend::LastEvent;
+using Request = BlockTrace::Request;
+
+static_assert(BlockTrace::kEnabled,
+              "This test must be built with PW_ALLOCATOR_BLOCK_TRACE=1");
+
+/// Returns the last trace event.
+const Event& LastTraceEvent() { return LastEvent::Instance().Get(); }
+
+/// Returns the data attached to the last trace event.
+BlockTraceData LastTraceData() {
+  BlockTraceData data{};
+  const Event& event = LastTraceEvent();
+  EXPECT_EQ(event.data_size(), sizeof(data));
+  if (event.data_size() == sizeof(data)) {
+    std::memcpy(&data, event.data(), sizeof(data));
+  }
+  return data;
+}
+
+class BlockTraceTest : public ::testing::Test {
+ protected:
+  BlockTraceTest() : allocator_(buffer_) {}
+
+  void ExpectLastEvent(trace_fake_backend::pw_trace_EventType event_type,
+                       const char* label) {
+    const Event& event = LastTraceEvent();
+    EXPECT_EQ(event.event_type(), event_type);
+    EXPECT_STREQ(event.label(), label);
+    EXPECT_STREQ(event.group(), "BlockAllocator");
+  }
+
+  alignas(std::max_align_t) std::array<std::byte, 1024> buffer_{};
+  pw::allocator::FirstFitAllocator<> allocator_;
+};
+
+// Unit tests.
+
+TEST_F(BlockTraceTest, AllocateIsTraced) {
+  void* ptr = allocator_.Allocate(Layout(64));
+  ASSERT_NE(ptr, nullptr);
+
+  ExpectLastEvent(trace_fake_backend::DurationGroupEnd, "Allocate");
+  BlockTraceData data = LastTraceData();
+  EXPECT_EQ(data.search_length, 1u);
+  EXPECT_NE(data.splits, 0u);
+  EXPECT_EQ(data.merges, 0u);
+
+  allocator_.Deallocate(ptr);
+}
+
+TEST_F(BlockTraceTest, DeallocateIsTraced) {
+  void* ptr1 = allocator_.Allocate(Layout(64));
+  void* ptr2 = allocator_.Allocate(Layout(64));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+
+  allocator_.Deallocate(ptr1);
+  ExpectLastEvent(trace_fake_backend::DurationGroupEnd, "Deallocate");
+  BlockTraceData data = LastTraceData();
+  EXPECT_EQ(data.search_length, 0u);
+  EXPECT_EQ(data.splits, 0u);
+
+  // Freeing the second block merges it with both free neighbors.
+  allocator_.Deallocate(ptr2);
+  ExpectLastEvent(trace_fake_backend::DurationGroupEnd, "Deallocate");
+  data = LastTraceData();
+  EXPECT_EQ(data.search_length, 0u);
+  EXPECT_EQ(data.splits, 0u);
+  EXPECT_EQ(data.merges, 2u);
+}
+
+TEST_F(BlockTraceTest, FailedAllocateIsTraced) {
+  EXPECT_EQ(allocator_.Allocate(Layout(4096)), nullptr);
+  ExpectLastEvent(trace_fake_backend::DurationGroupEnd, "Allocate");
+  BlockTraceData data = LastTraceData();
+  EXPECT_EQ(data.splits, 0u);
+  EXPECT_EQ(data.merges, 0u);
+}
+
+// TODO: https://pwbug.dev/365161669 - Express joinability as a build-system
+// constraint.
+#if PW_THREAD_JOINING_ENABLED
+
+TEST(BlockTraceThreadTest, CountsArePerThread) {
+  BlockTrace::Start(Request::kAllocate);
+  BlockTrace::CountSearchStep();
+  BlockTrace::CountSplit();
+
+  // Count a whole request on another thread while this one is in progress.
+  BlockTraceData other{};
+  pw::thread::test::TestThreadContext context;
+  pw::Thread thread(context.options(), [&other] {
+    BlockTrace::Start(Request::kDeallocate);
+    BlockTrace::CountMerge();
+    BlockTrace::CountMerge();
+    BlockTrace::End(Request::kDeallocate);
+    other = LastTraceData();
+  });
+  thread.join();
+  EXPECT_EQ(other.search_length, 0u);
+  EXPECT_EQ(other.splits, 0u);
+  EXPECT_EQ(other.merges, 2u);
+
+  BlockTrace::End(Request::kAllocate);
+  BlockTraceData data = LastTraceData();
+  EXPECT_EQ(data.search_length, 1u);
+  EXPECT_EQ(data.splits, 1u);
+  EXPECT_EQ(data.merges, 0u);
+}
+
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
@@ -17,6 +17,7 @@
 #include <limits>
 
 #include "pw_allocator/block/poisonable.h"
+#include "pw_allocator/block_trace.h"
 #include "pw_allocator/config.h"
 #include "pw_allocator/hardening.h"
 #include "pw_allocator/layout.h"
@@ -156,6 +157,7 @@ class BucketBase {
   /// This lambda can be used with `std::find_if` and `FindPrevIf`.
   static auto MakeCanAllocPredicate(Layout layout) {
     return [layout](ItemType& item) {
+      BlockTrace::CountSearchStep();
       auto* block = BlockType::FromUsableSpace(&item);
       return block->CanAlloc(layout).ok();
     };
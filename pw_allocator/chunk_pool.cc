@@ -65,4 +65,9 @@ void ChunkPool::DoDeallocate(void* ptr) {
   next_ = cpp20::bit_cast<std::byte*>(ptr);
 }
 
+bool ChunkPool::DoRecognizes(const void* ptr) const {
+  auto addr = cpp20::bit_cast<uintptr_t>(ptr);
+  return start_ <= addr && addr < end_;
+}
+
 }  // namespace pw::allocator
@@ -31,6 +31,17 @@ struct U64 {
   std::byte bytes[8];
 };
 
+// Exposes `Deallocator::Recognizes`, which is only available to derived
+// classes.
+class ChunkPoolForTest : public pw::allocator::ChunkPool {
+ public:
+  using ChunkPool::ChunkPool;
+
+  bool Recognizes(const void* ptr) const {
+    return ChunkPool::Recognizes(*this, ptr);
+  }
+};
+
 // Unit tests.
 
 TEST(ChunkPoolTest, Capabilities) {
@@ -81,4 +92,39 @@ TEST(ChunkPoolTest, ExhaustTwice) {
   }
 }
 
+TEST(ChunkPoolTest, RecognizesPointersInsidePool) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  ChunkPoolForTest pool(buffer, Layout::Of<U64>());
+
+  void* ptr = pool.Allocate();
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(pool.Recognizes(ptr));
+  EXPECT_TRUE(pool.Recognizes(buffer.data()));
+  EXPECT_TRUE(pool.Recognizes(buffer.data() + sizeof(U64) * 31));
+  pool.Deallocate(ptr);
+}
+
+TEST(ChunkPoolTest, DoesNotRecognizeEndOfPool) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  ChunkPoolForTest pool(buffer, Layout::Of<U64>());
+  EXPECT_FALSE(pool.Recognizes(buffer.data() + buffer.size()));
+}
+
+TEST(ChunkPoolTest, DoesNotRecognizeTrailingPartialChunk) {
+  // The last 4 bytes are too few to hold a chunk, and are not part of the pool.
+  alignas(U64) std::array<std::byte, 260> buffer;
+  ChunkPoolForTest pool(buffer, Layout::Of<U64>());
+  EXPECT_TRUE(pool.Recognizes(buffer.data() + 255));
+  EXPECT_FALSE(pool.Recognizes(buffer.data() + 256));
+}
+
+TEST(ChunkPoolTest, DoesNotRecognizePointersOutsidePool) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  ChunkPoolForTest pool(buffer, Layout::Of<U64>());
+
+  U64 other;
+  EXPECT_FALSE(pool.Recognizes(&other));
+  EXPECT_FALSE(pool.Recognizes(nullptr));
+}
+
 }  // namespace
@@ -0,0 +1,109 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/lock_free_chunk_pool.h"
+
+#include <algorithm>
+#include <new>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/buffer.h"
+#include "pw_allocator/hardening.h"
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator {
+
+static Layout EnsureLinkLayout(const Layout& layout) {
+  return Layout(
+      AlignUp(std::max(layout.size(), LockFreeChunkPool::kMinSize),
+              std::max(layout.alignment(), LockFreeChunkPool::kMinAlignment)),
+      std::max(layout.alignment(), LockFreeChunkPool::kMinAlignment));
+}
+
+LockFreeChunkPool::LockFreeChunkPool(ByteSpan region, const Layout& layout)
+    : Pool(kCapabilities, layout),
+      allocated_layout_(EnsureLinkLayout(layout)) {
+  Result<ByteSpan> result =
+      GetAlignedSubspan(region, allocated_layout_.alignment());
+  PW_CHECK_OK(result.status());
+  region = result.value();
+  size_t num_chunks = region.size() / allocated_layout_.size();
+  PW_CHECK_UINT_NE(num_chunks, 0);
+  PW_CHECK_UINT_LE(num_chunks, kMaxChunks);
+
+  chunks_ = region.data();
+  start_ = cpp20::bit_cast<uintptr_t>(chunks_);
+  end_ = start_ + num_chunks * allocated_layout_.size();
+  for (size_t i = 0; i < num_chunks; ++i) {
+    uintptr_t next = i + 1 < num_chunks ? i + 1 : kNoChunk;
+    new (chunks_ + i * allocated_layout_.size()) Link(next);
+  }
+  head_.store(0, std::memory_order_relaxed);
+}
+
+LockFreeChunkPool::Link& LockFreeChunkPool::LinkAt(uintptr_t index) const {
+  return *std::launder(
+      reinterpret_cast<Link*>(chunks_ + index * allocated_layout_.size()));
+}
+
+void* LockFreeChunkPool::DoAllocate() {
+  uintptr_t head = head_.load(std::memory_order_acquire);
+  while (true) {
+    uintptr_t index = head & kIndexMask;
+    if (index == kNoChunk) {
+      return nullptr;
+    }
+    // If another thread takes this chunk first, the link read here may be
+    // stale, but the tag in `head_` will have changed and the swap will fail.
+    uintptr_t next = LinkAt(index).load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head,
+                                    NextHead(head, next),
+                                    std::memory_order_acquire,
+                                    std::memory_order_acquire)) {
+      return &LinkAt(index);
+    }
+  }
+}
+
+void LockFreeChunkPool::DoDeallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  uintptr_t offset = cpp20::bit_cast<uintptr_t>(ptr) - start_;
+  if constexpr (Hardening::kIncludesBasicChecks) {
+    PW_CHECK(DoRecognizes(ptr), "Freed memory was not allocated from the pool");
+  }
+  if constexpr (Hardening::kIncludesRobustChecks) {
+    const size_t misalignment = offset % allocated_layout_.size();
+    PW_CHECK_UINT_EQ(
+        misalignment, 0, "Freed pointer is not the start of a chunk");
+  }
+  uintptr_t index = offset / allocated_layout_.size();
+  Link& link = LinkAt(index);
+  uintptr_t head = head_.load(std::memory_order_relaxed);
+  do {
+    link.store(head & kIndexMask, std::memory_order_relaxed);
+  } while (!head_.compare_exchange_weak(head,
+                                        NextHead(head, index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+bool LockFreeChunkPool::DoRecognizes(const void* ptr) const {
+  auto addr = cpp20::bit_cast<uintptr_t>(ptr);
+  return start_ <= addr && addr < end_;
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,213 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/lock_free_chunk_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/typed_pool.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::LockFreeChunkPool;
+using ::pw::allocator::TypedPool;
+
+struct U64 {
+  std::byte bytes[8];
+};
+
+// Unit tests.
+
+TEST(LockFreeChunkPoolTest, Capabilities) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+  EXPECT_EQ(pool.capabilities(), LockFreeChunkPool::kCapabilities);
+}
+
+TEST(LockFreeChunkPoolTest, AllocateDeallocate) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  void* ptr = pool.Allocate();
+  ASSERT_NE(ptr, nullptr);
+  pool.Deallocate(ptr);
+}
+
+TEST(LockFreeChunkPoolTest, ReusesMostRecentlyFreedChunk) {
+  alignas(U64) std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  void* ptr1 = pool.Allocate();
+  void* ptr2 = pool.Allocate();
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_NE(ptr1, ptr2);
+
+  pool.Deallocate(ptr1);
+  EXPECT_EQ(pool.Allocate(), ptr1);
+  pool.Deallocate(ptr2);
+  pool.Deallocate(ptr1);
+}
+
+TEST(LockFreeChunkPoolTest, ExhaustTwice) {
+  constexpr size_t kNumU64s = 32;
+  constexpr size_t kBufferSize = sizeof(U64) * kNumU64s;
+  alignas(U64) std::array<std::byte, kBufferSize> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+  EXPECT_EQ(pool.GetCapacity(), kBufferSize);
+
+  // Allocate everything.
+  std::array<void*, kNumU64s> ptrs;
+  for (auto& ptr : ptrs) {
+    ptr = pool.Allocate();
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // At this point, the pool is empty.
+  EXPECT_EQ(pool.Allocate(), nullptr);
+
+  // Now refill the pool, and show it can be emptied again.
+  for (auto& ptr : ptrs) {
+    pool.Deallocate(ptr);
+    ptr = nullptr;
+  }
+  for (auto& ptr : ptrs) {
+    ptr = pool.Allocate();
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(pool.Allocate(), nullptr);
+
+  // Release everything.
+  for (auto& ptr : ptrs) {
+    pool.Deallocate(ptr);
+    ptr = nullptr;
+  }
+}
+
+TEST(LockFreeChunkPoolTest, SmallChunksHoldLinks) {
+  alignas(LockFreeChunkPool::kMinAlignment) std::array<std::byte, 64> buffer;
+  LockFreeChunkPool pool(buffer, Layout(1, 1));
+
+  auto* ptr1 = static_cast<std::byte*>(pool.Allocate());
+  auto* ptr2 = static_cast<std::byte*>(pool.Allocate());
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(ptr2 - ptr1, static_cast<ptrdiff_t>(LockFreeChunkPool::kMinSize));
+  pool.Deallocate(ptr1);
+  pool.Deallocate(ptr2);
+}
+
+TEST(LockFreeChunkPoolTest, TypedPool) {
+  TypedPool<U64, LockFreeChunkPool>::Buffer<2> buffer;
+  TypedPool<U64, LockFreeChunkPool> pool(buffer);
+
+  pw::UniquePtr<U64> ptr1 = pool.MakeUnique();
+  pw::UniquePtr<U64> ptr2 = pool.MakeUnique();
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(pool.MakeUnique(), nullptr);
+
+  ptr1.Reset();
+  EXPECT_NE(pool.MakeUnique(), nullptr);
+}
+
+// TODO: https://pwbug.dev/365161669 - Express joinability as a build-system
+// constraint.
+#if PW_THREAD_JOINING_ENABLED
+
+constexpr size_t kNumThreads = 4;
+constexpr size_t kNumChunks = 3;
+constexpr size_t kNumIterations = 20000;
+
+/// Repeatedly allocates chunks from a small pool shared with other threads,
+/// and checks that no chunk is ever handed to two threads at once.
+///
+/// With fewer chunks than threads, the same chunk is frequently allocated and
+/// freed again by one thread while another is in the middle of allocating it.
+/// This is the interleaving that corrupts a lock-free list without ABA
+/// protection.
+struct Worker {
+  LockFreeChunkPool* pool;
+  std::array<std::atomic<uint32_t>, kNumChunks>* owners;
+  std::byte* base;
+  uint32_t id;
+  size_t conflicts = 0;
+  size_t allocations = 0;
+
+  void Run() {
+    for (size_t i = 0; i < kNumIterations; ++i) {
+      auto* ptr = static_cast<std::byte*>(pool->Allocate());
+      if (ptr == nullptr) {
+        pw::this_thread::yield();
+        continue;
+      }
+      ++allocations;
+      auto index = static_cast<size_t>(ptr - base) / sizeof(U64);
+      if ((*owners)[index].exchange(id) != 0) {
+        ++conflicts;
+      }
+      if (i % 16 == 0) {
+        pw::this_thread::yield();
+      }
+      (*owners)[index].store(0);
+      pool->Deallocate(ptr);
+    }
+  }
+};
+
+TEST(LockFreeChunkPoolTest, ConcurrentAllocationsAreExclusive) {
+  alignas(U64) std::array<std::byte, sizeof(U64) * kNumChunks> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+  std::array<std::atomic<uint32_t>, kNumChunks> owners{};
+
+  std::array<Worker, kNumThreads> workers;
+  std::array<pw::thread::test::TestThreadContext, kNumThreads> contexts;
+  std::array<pw::Thread, kNumThreads> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    Worker* worker = &workers[i];
+    *worker =
+        Worker{&pool, &owners, buffer.data(), static_cast<uint32_t>(i + 1)};
+    threads[i] = pw::Thread(contexts[i].options(), [worker] { worker->Run(); });
+  }
+  for (pw::Thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const Worker& worker : workers) {
+    EXPECT_EQ(worker.conflicts, 0u);
+    EXPECT_NE(worker.allocations, 0u);
+  }
+
+  // Every chunk should have been returned.
+  std::array<void*, kNumChunks> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = pool.Allocate();
+    EXPECT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(pool.Allocate(), nullptr);
+}
+
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
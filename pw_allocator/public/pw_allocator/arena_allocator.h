@@ -0,0 +1,197 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/bump_allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+
+namespace pw::allocator {
+
+/// Allocator that bumps through chunks of memory requested from another
+/// allocator, and frees them all at once.
+///
+/// Like a `BumpAllocator`, this allocator provides memory by incrementing a
+/// pointer, and does nothing on deallocation. Unlike a `BumpAllocator`, it is
+/// not limited to a single, fixed region. When the current chunk is exhausted,
+/// it requests another of `chunk_size` bytes from the wrapped allocator.
+/// Requests too large to fit in a chunk get a dedicated chunk of their own.
+///
+/// This makes it well suited to objects whose lifetimes end together, such as
+/// the temporaries used while handling a single RPC or running a single
+/// coroutine. Memory can be reclaimed in two ways:
+///
+/// - `Reset` frees everything allocated so far. The first chunk is kept so
+///   that the next set of allocations does not need to request it again.
+/// - `GetCheckpoint` and `Rollback` free everything allocated after a given
+///   point, allowing nested scopes to share one arena.
+///
+/// As with `BumpAllocator`, destructors for objects allocated using `New` or
+/// `MakeUnique` are NOT called. Objects allocated using `NewOwned` or
+/// `MakeUniqueOwned` have their destructors invoked, in reverse order of
+/// allocation, when their memory is freed by `Reset`, `Rollback`, or the arena
+/// being destroyed.
+///
+/// Since it implements `Allocator`, an arena can be passed to any API that
+/// takes one. For example, it can provide the memory for a `CoroContext` whose
+/// coroutines all complete before the arena is reset:
+///
+/// @code{.cpp}
+///   pw::allocator::ArenaAllocator arena(heap, 1024);
+///   pw::async2::CoroContext coro_cx(arena);
+///   // ...run coroutines...
+///   arena.Reset();
+/// @endcode
+///
+/// This allocator is not thread-safe. Use a `SynchronizedAllocator` to share
+/// it between threads.
+class ArenaAllocator : public Allocator {
+ private:
+  /// Header at the start of each chunk.
+  struct Chunk {
+    Chunk* prev;
+    size_t size;
+  };
+
+ public:
+  static constexpr Capabilities kCapabilities = kSkipsDestroy;
+
+  /// Marks a point in the sequence of allocations made by an arena.
+  ///
+  /// See `GetCheckpoint` and `Rollback`.
+  class Checkpoint {
+   private:
+    friend class ArenaAllocator;
+
+    Chunk* chunk_ = nullptr;
+    std::byte* top_ = nullptr;
+    size_t allocated_ = 0;
+    internal::GenericOwned* owned_ = nullptr;
+  };
+
+  /// Constructs an arena allocator.
+  ///
+  /// @param[in] allocator    Allocator from which to request chunks.
+  /// @param[in] chunk_size   Size of each chunk, including a small header.
+  ArenaAllocator(Allocator& allocator, size_t chunk_size);
+
+  ~ArenaAllocator() override;
+
+  /// Returns the number of chunks currently held by this arena.
+  size_t num_chunks() const { return num_chunks_; }
+
+  /// Returns a marker for the arena's current state.
+  ///
+  /// Allocations made before the checkpoint can no longer be resized.
+  Checkpoint GetCheckpoint();
+
+  /// Frees all memory allocated after the given `checkpoint` was taken, and
+  /// returns any chunks requested since then to the wrapped allocator.
+  ///
+  /// The checkpoint must have been returned by this arena, and must not have
+  /// been invalidated by rolling back to an earlier checkpoint or by calling
+  /// `Reset`.
+  void Rollback(const Checkpoint& checkpoint);
+
+  /// Frees all memory allocated by this arena.
+  ///
+  /// All chunks except the first are returned to the wrapped allocator. This
+  /// invalidates any checkpoints.
+  void Reset();
+
+  /// Constructs an "owned" object of type `T` from the given `args`
+  ///
+  /// Owned objects will have their destructors invoked when their memory is
+  /// freed by the arena.
+  ///
+  /// The return value is nullable, as allocating memory for the object may
+  /// fail. Callers must check for this error before using the resulting
+  /// pointer.
+  ///
+  /// @param[in]  args...     Arguments passed to the object constructor.
+  template <typename T, int&... kExplicitGuard, typename... Args>
+  T* NewOwned(Args&&... args) {
+    internal::Owned<T>* owned = New<internal::Owned<T>>();
+    T* ptr = owned != nullptr ? New<T>(std::forward<Args>(args)...) : nullptr;
+    if (ptr != nullptr) {
+      owned->set_object(ptr);
+      owned->set_next(owned_);
+      owned_ = owned;
+    }
+    return ptr;
+  }
+
+  /// Constructs and object of type `T` from the given `args`, and wraps it in a
+  /// `UniquePtr`
+  ///
+  /// Owned objects will have their destructors invoked when their memory is
+  /// freed by the arena. Destroying the `UniquePtr` does not invoke the
+  /// destructor.
+  ///
+  /// The returned value may contain null if allocating memory for the object
+  /// fails. Callers must check for null before using the `UniquePtr`.
+  ///
+  /// @param[in]  args...     Arguments passed to the object constructor.
+  template <typename T, int&... kExplicitGuard, typename... Args>
+  [[nodiscard]] UniquePtr<T> MakeUniqueOwned(Args&&... args) {
+    return WrapUnique<T>(NewOwned<T>(std::forward<Args>(args)...));
+  }
+
+ private:
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void*) override {}
+
+  /// @copydoc Allocator::Resize
+  ///
+  /// Only the most recent allocation can be resized.
+  bool DoResize(void* ptr, size_t new_size) override;
+
+  /// @copydoc Allocator::GetAllocated
+  size_t DoGetAllocated() const override { return allocated_; }
+
+  /// Allocates memory from the current chunk, if it has room.
+  void* AllocateFromChunk(Layout layout);
+
+  /// Requests a chunk from the wrapped allocator that can hold the given
+  /// `layout` and makes it the current chunk.
+  bool AddChunk(Layout layout);
+
+  /// Destroys owned objects until reaching `owned`.
+  void DestroyOwned(internal::GenericOwned* owned);
+
+  /// Returns chunks to the wrapped allocator until reaching `chunk`.
+  void ReleaseChunks(Chunk* chunk);
+
+  /// Makes the given chunk the current chunk, starting at `top`.
+  void SetChunk(Chunk* chunk, std::byte* top);
+
+  Allocator& allocator_;
+  size_t chunk_size_;
+  size_t num_chunks_ = 0;
+  size_t allocated_ = 0;
+  Chunk* chunk_ = nullptr;
+  std::byte* top_ = nullptr;
+  std::byte* end_ = nullptr;
+  std::byte* last_ = nullptr;
+  internal::GenericOwned* owned_ = nullptr;
+};
+
+}  // namespace pw::allocator
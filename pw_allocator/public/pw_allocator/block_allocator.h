@@ -21,6 +21,7 @@
 #include "pw_allocator/block/poisonable.h"
 #include "pw_allocator/block/result.h"
 #include "pw_allocator/block/with_layout.h"
+#include "pw_allocator/block_trace.h"
 #include "pw_allocator/capability.h"
 #include "pw_allocator/config.h"
 #include "pw_allocator/fragmentation.h"
@@ -171,6 +172,7 @@ class BlockAllocator : public internal::GenericBlockAllocator {
  private:
   using BlockResultPrev = internal::GenericBlockResult::Prev;
   using BlockResultNext = internal::GenericBlockResult::Next;
+  using BlockTrace = internal::BlockTrace;
 
   // Let unit tests call internal methods in order to "preallocate" blocks..
   template <typename, size_t>
@@ -318,9 +320,11 @@ void* BlockAllocator<BlockType>::DoAllocate(Layout layout) {
   if constexpr (Hardening::kIncludesDebugChecks) {
     PW_ASSERT(last_->Next() == nullptr);
   }
+  BlockTrace::Start(BlockTrace::Request::kAllocate);
   auto result = ChooseBlock(layout);
   if (!result.ok()) {
     // No valid block for request.
+    BlockTrace::End(BlockTrace::Request::kAllocate);
     return nullptr;
   }
   BlockType* block = result.block();
@@ -328,6 +332,7 @@ void* BlockAllocator<BlockType>::DoAllocate(Layout layout) {
   switch (result.prev()) {
     case BlockResultPrev::kSplitNew:
       // New free blocks may be created when allocating.
+      BlockTrace::CountSplit();
       RecycleBlock(*(block->Prev()));
       break;
     case BlockResultPrev::kResizedLarger:
@@ -339,6 +344,7 @@ void* BlockAllocator<BlockType>::DoAllocate(Layout layout) {
       break;
   }
   if (result.next() == BlockResultNext::kSplitNew) {
+    BlockTrace::CountSplit();
     RecycleBlock(*(block->Next()));
   }
 
@@ -347,6 +353,7 @@ void* BlockAllocator<BlockType>::DoAllocate(Layout layout) {
     PW_ASSERT(block <= last_);
   }
 
+  BlockTrace::End(BlockTrace::Request::kAllocate);
   return block->UsableSpace();
 }
 
@@ -360,16 +367,20 @@ void BlockAllocator<BlockType>::DoDeallocate(void* ptr) {
       return;
     }
   }
+  BlockTrace::Start(BlockTrace::Request::kDeallocate);
   DeallocateBlock(std::move(block));
+  BlockTrace::End(BlockTrace::Request::kDeallocate);
 }
 
 template <typename BlockType>
 void BlockAllocator<BlockType>::DeallocateBlock(BlockType*&& block) {
   // Neighboring blocks may be merged when freeing.
   if (auto* prev = block->Prev(); prev != nullptr && prev->IsFree()) {
+    BlockTrace::CountMerge();
     ReserveBlock(*prev);
   }
   if (auto* next = block->Next(); next != nullptr && next->IsFree()) {
+    BlockTrace::CountMerge();
     ReserveBlock(*next);
   }
 
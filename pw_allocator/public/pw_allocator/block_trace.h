@@ -0,0 +1,95 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/config.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::allocator::internal {
+
+/// Data attached to the trace event that ends a block allocator request.
+///
+/// Fields are packed in host byte order. The trace events describe this layout
+/// using a `pw_trace` map format string, so that host tools can decode it.
+PW_PACKED(struct) BlockTraceData {
+  uint32_t search_length;
+  uint16_t splits;
+  uint16_t merges;
+};
+
+/// Emits trace events for requests to block allocators.
+///
+/// This class is used by `BlockAllocator` and the buckets used by its derived
+/// types. When `PW_ALLOCATOR_BLOCK_TRACE` is 0, each of its methods is empty
+/// and is compiled out.
+///
+/// Each thread has its own counters, so requests made to different block
+/// allocators from different threads at the same time are counted separately.
+class BlockTrace {
+ public:
+  static constexpr bool kEnabled = PW_ALLOCATOR_BLOCK_TRACE != 0;
+
+  /// Types of requests that are traced.
+  enum class Request {
+    kAllocate,
+    kDeallocate,
+  };
+
+  /// Marks the start of a request, and resets the counters.
+  static void Start(Request request) {
+    if constexpr (kEnabled) {
+      data_ = BlockTraceData{};
+      DoStart(request);
+    }
+  }
+
+  /// Counts a free block examined while searching for one to allocate.
+  static void CountSearchStep() {
+    if constexpr (kEnabled) {
+      ++data_.search_length;
+    }
+  }
+
+  /// Counts a block being split into two while allocating.
+  static void CountSplit() {
+    if constexpr (kEnabled) {
+      ++data_.splits;
+    }
+  }
+
+  /// Counts a block being merged with a neighbor while freeing.
+  static void CountMerge() {
+    if constexpr (kEnabled) {
+      ++data_.merges;
+    }
+  }
+
+  /// Marks the end of a request, and records the counters.
+  static void End(Request request) {
+    if constexpr (kEnabled) {
+      DoEnd(request, data_);
+    }
+  }
+
+ private:
+  static void DoStart(Request request);
+  static void DoEnd(Request request, const BlockTraceData& data);
+
+  static inline thread_local BlockTraceData data_{};
+};
+
+}  // namespace pw::allocator::internal
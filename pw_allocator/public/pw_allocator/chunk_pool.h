@@ -31,7 +31,8 @@ class ChunkPool : public Pool {
  public:
   static constexpr Capabilities kCapabilities =
       kImplementsGetRequestedLayout | kImplementsGetUsableLayout |
-      kImplementsGetAllocatedLayout | kImplementsGetCapacity;
+      kImplementsGetAllocatedLayout | kImplementsGetCapacity |
+      kImplementsRecognizes;
   static constexpr size_t kMinSize = sizeof(void*);
   static constexpr size_t kMinAlignment = alignof(void*);
 
@@ -58,6 +59,9 @@ class ChunkPool : public Pool {
     return allocated_layout_;
   }
 
+  /// @copydoc Deallocator::Recognizes
+  bool DoRecognizes(const void* ptr) const override;
+
   const Layout allocated_layout_;
   uintptr_t start_;
   uintptr_t end_;
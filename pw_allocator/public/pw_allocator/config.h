@@ -115,3 +115,20 @@
 #ifndef PW_ALLOCATOR_HAS_ATOMICS
 #define PW_ALLOCATOR_HAS_ATOMICS 1
 #endif  // PW_ALLOCATOR_HAS_ATOMICS
+
+/// Enables trace events for requests to block allocators.
+///
+/// If set to 1, each call to `BlockAllocator::Allocate` and
+/// `BlockAllocator::Deallocate` emits a pair of `pw_trace` duration events. The
+/// event ending each request carries the number of free blocks examined while
+/// searching, and the number of blocks split and merged. The elapsed time is
+/// given by the timestamps of the events, as measured by the trace backend.
+/// The counts are kept per thread, so enabling this requires `thread_local`
+/// support.
+///
+/// If set to 0, the instrumentation is compiled out entirely.
+///
+/// The default is 0.
+#ifndef PW_ALLOCATOR_BLOCK_TRACE
+#define PW_ALLOCATOR_BLOCK_TRACE 0
+#endif  // PW_ALLOCATOR_BLOCK_TRACE
@@ -0,0 +1,108 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+#include "pw_allocator/pool.h"
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+
+/// Implementation of ``Pool`` that can be shared between threads without a
+/// lock.
+///
+/// Like ``ChunkPool``, this pool keeps a list of free chunks, using the first
+/// bytes of each free chunk to refer to the next one. The list is a lock-free
+/// stack: ``Allocate`` and ``Deallocate`` each update its head with a single
+/// compare-and-swap, and may be called concurrently from any number of threads.
+///
+/// To guard against the "ABA" problem, where a chunk is allocated and freed
+/// again between another thread reading the head and swapping it, the head
+/// stores the index of the first free chunk together with a counter that is
+/// incremented by every update. On targets with 32-bit pointers, both values
+/// are 16 bits wide, which limits the pool to 65535 chunks.
+class LockFreeChunkPool : public Pool {
+ private:
+  using Link = std::atomic<uintptr_t>;
+
+  /// The list head packs a chunk index into the low half of its bits and a
+  /// tag into the high half.
+  static constexpr size_t kIndexBits =
+      std::numeric_limits<uintptr_t>::digits / 2;
+
+ public:
+  static constexpr Capabilities kCapabilities =
+      kImplementsGetRequestedLayout | kImplementsGetUsableLayout |
+      kImplementsGetAllocatedLayout | kImplementsGetCapacity |
+      kImplementsRecognizes;
+  static constexpr size_t kMinSize = sizeof(Link);
+  static constexpr size_t kMinAlignment = alignof(Link);
+
+  /// Maximum number of chunks in a pool.
+  static constexpr size_t kMaxChunks = (uintptr_t(1) << kIndexBits) - 1;
+
+  /// Construct a `Pool` that allocates from a region of memory.
+  ///
+  /// @param  region      The memory to allocate from. Must be large enough to
+  ///                     allocate at least one chunk with the given layout,
+  ///                     and must not hold more than `kMaxChunks` chunks.
+  /// @param  layout      The size and alignment of the memory to be returned
+  ///                     from this pool.
+  LockFreeChunkPool(ByteSpan region, const Layout& layout);
+
+ private:
+  static constexpr uintptr_t kIndexMask = kMaxChunks;
+  static constexpr uintptr_t kNoChunk = kMaxChunks;
+  static constexpr uintptr_t kTagIncrement = uintptr_t(1) << kIndexBits;
+
+  /// Returns a new value for the list head that refers to the chunk at
+  /// `index`, with a tag that differs from that of `head`.
+  static constexpr uintptr_t NextHead(uintptr_t head, uintptr_t index) {
+    return ((head + kTagIncrement) & ~kIndexMask) | index;
+  }
+
+  /// Returns the link stored in the free chunk at `index`.
+  Link& LinkAt(uintptr_t index) const;
+
+  /// @copydoc Pool::Allocate
+  void* DoAllocate() override;
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr) override;
+
+  /// @copydoc Deallocator::GetCapacity
+  size_t DoGetCapacity() const override { return end_ - start_; }
+
+  /// @copydoc Deallocator::GetLayout
+  Layout DoGetLayout(LayoutType, const void*) const override {
+    return allocated_layout_;
+  }
+
+  /// @copydoc Deallocator::Recognizes
+  bool DoRecognizes(const void* ptr) const override;
+
+  const Layout allocated_layout_;
+  uintptr_t start_;
+  uintptr_t end_;
+  std::byte* chunks_;
+  std::atomic<uintptr_t> head_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,226 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+#include "pw_assert/assert.h"
+#include "pw_bytes/span.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Returns the index of the CPU that the calling thread is running on.
+///
+/// On platforms that cannot report this, returns the calling thread's
+/// `GetThreadCacheIndex` instead.
+size_t GetCurrentCpuIndex();
+
+}  // namespace internal
+
+/// Dispatches requests between several allocators, each with its own lock.
+///
+/// A `SynchronizedAllocator` serializes every request on a single lock, and a
+/// `FallbackAllocator` always tries its primary allocator first. On a host
+/// with many cores, both make every thread contend for the same allocator.
+/// This allocator instead owns a fixed number of "shards", each of which is an
+/// allocator that manages its own region of memory. Allocations are routed to
+/// a shard chosen by the CPU the calling thread is running on, so threads on
+/// different cores usually use different shards. If that shard cannot satisfy
+/// a request, the other shards are tried in turn.
+///
+/// Memory is always freed back to the shard that allocated it. The owning
+/// shard is found by looking up the pointer in a table of the shards' regions,
+/// sorted by address. As a result, the regions must not overlap, and each
+/// shard must only return memory from within its region.
+///
+/// Shards are selected by `cpu % kNumShards`. To keep a shard's memory close
+/// to the cores that use it on a NUMA system, allocate each region from the
+/// node whose CPUs map to that shard.
+///
+/// Example:
+/// @code{.cpp}
+///   pw::allocator::TlsfAllocator shard0(region0);
+///   pw::allocator::TlsfAllocator shard1(region1);
+///   pw::allocator::ShardedAllocator<std::mutex, 2> allocator({{
+///       {shard0, region0},
+///       {shard1, region1},
+///   }});
+/// @endcode
+///
+/// @tparam LockType    The type of the locks used to synchronize access to
+///                     each shard. Must be default-constructible.
+/// @tparam kNumShards  Number of shards.
+template <typename LockType, size_t kNumShards>
+class ShardedAllocator : public Allocator {
+ public:
+  /// Describes an allocator and the region of memory that it manages.
+  struct Shard {
+    Allocator& allocator;
+    ConstByteSpan region;
+  };
+
+  static_assert(kNumShards != 0);
+
+  /// Constructs a sharded allocator.
+  ///
+  /// @param[in] shards   Allocators to dispatch between, and their regions.
+  ///                     Regions must not overlap.
+  explicit ShardedAllocator(const std::array<Shard, kNumShards>& shards)
+      : Allocator(GetCapabilities(shards)) {
+    for (size_t i = 0; i < kNumShards; ++i) {
+      ShardState& state = shards_[i];
+      std::lock_guard lock(state.lock);
+      state.allocator = &shards[i].allocator;
+      state.begin = reinterpret_cast<uintptr_t>(shards[i].region.data());
+      state.end = state.begin + shards[i].region.size();
+      sorted_[i] = &state;
+    }
+    std::sort(sorted_.begin(),
+              sorted_.end(),
+              [](const ShardState* lhs, const ShardState* rhs) {
+                return lhs->begin < rhs->begin;
+              });
+    for (size_t i = 1; i < kNumShards; ++i) {
+      PW_ASSERT(sorted_[i - 1]->end <= sorted_[i]->begin);
+    }
+  }
+
+ private:
+  /// Shards are kept on separate cache lines to avoid false sharing.
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct alignas(kCacheLineSize) ShardState {
+    LockType lock;
+    Allocator* allocator PW_GUARDED_BY(lock) = nullptr;
+    uintptr_t begin = 0;
+    uintptr_t end = 0;
+  };
+
+  /// Returns the capabilities that are common to all shards.
+  static Capabilities GetCapabilities(
+      const std::array<Shard, kNumShards>& shards) {
+    uint32_t capabilities = shards[0].allocator.capabilities().get();
+    for (const Shard& shard : shards) {
+      capabilities &= shard.allocator.capabilities().get();
+    }
+    return Capabilities(capabilities) | kImplementsRecognizes;
+  }
+
+  /// Returns the shard whose region contains `ptr`, or null if no such shard
+  /// exists.
+  ShardState* FindShard(const void* ptr) const {
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    auto iter = std::upper_bound(
+        sorted_.begin(),
+        sorted_.end(),
+        addr,
+        [](uintptr_t value, const ShardState* state) {
+          return value < state->begin;
+        });
+    if (iter == sorted_.begin()) {
+      return nullptr;
+    }
+    ShardState* state = *(--iter);
+    return addr < state->end ? state : nullptr;
+  }
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override {
+    size_t first = internal::GetCurrentCpuIndex() % kNumShards;
+    for (size_t i = 0; i < kNumShards; ++i) {
+      ShardState& state = shards_[(first + i) % kNumShards];
+      std::lock_guard lock(state.lock);
+      void* ptr = state.allocator->Allocate(layout);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override {
+    ShardState* state = FindShard(ptr);
+    PW_ASSERT(state != nullptr);
+    std::lock_guard lock(state->lock);
+    state->allocator->Deallocate(ptr);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    ShardState* state = FindShard(ptr);
+    if (state == nullptr) {
+      return false;
+    }
+    std::lock_guard lock(state->lock);
+    return state->allocator->Resize(ptr, new_size);
+  }
+
+  /// @copydoc Allocator::GetAllocated
+  size_t DoGetAllocated() const override {
+    size_t allocated = 0;
+    for (ShardState& state : shards_) {
+      std::lock_guard lock(state.lock);
+      allocated += state.allocator->GetAllocated();
+    }
+    return allocated;
+  }
+
+  /// @copydoc Deallocator::GetCapacity
+  size_t DoGetCapacity() const override {
+    size_t capacity = 0;
+    for (ShardState& state : shards_) {
+      std::lock_guard lock(state.lock);
+      if (PW_ADD_OVERFLOW(
+              capacity, state.allocator->GetCapacity(), &capacity)) {
+        return std::numeric_limits<size_t>::max();
+      }
+    }
+    return capacity;
+  }
+
+  /// @copydoc Deallocator::GetLayout
+  Layout DoGetLayout(LayoutType layout_type, const void* ptr) const override {
+    ShardState* state = FindShard(ptr);
+    if (state == nullptr) {
+      return Layout();
+    }
+    std::lock_guard lock(state->lock);
+    return GetLayout(*(state->allocator), layout_type, ptr);
+  }
+
+  /// @copydoc Deallocator::Recognizes
+  bool DoRecognizes(const void* ptr) const override {
+    return FindShard(ptr) != nullptr;
+  }
+
+  mutable std::array<ShardState, kNumShards> shards_;
+  std::array<ShardState*, kNumShards> sorted_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,244 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_span/span.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Header at the start of each page of a `SlabAllocator`.
+///
+/// The rest of the page is divided into slots of the same size. Slots that
+/// have been freed are kept on an intrusive free list. Slots that have never
+/// been used are handed out in order, so that a new page does not need to be
+/// walked to build its free list.
+class SlabPage : public containers::future::IntrusiveList<SlabPage>::Item {
+ public:
+  explicit SlabPage(size_t size_class) : size_class_(size_class) {}
+
+  size_t size_class() const { return size_class_; }
+  size_t num_used() const { return num_used_; }
+
+  /// Returns a free slot. The page must not be full.
+  void* Pop(size_t first_offset, size_t slot_size);
+
+  /// Returns a slot to the page.
+  void Push(void* ptr);
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  size_t size_class_;
+  size_t num_used_ = 0;
+  size_t num_carved_ = 0;
+  FreeSlot* free_list_ = nullptr;
+};
+
+/// Pages and parameters for allocations of a single size.
+struct SlabSizeClass {
+  /// Size of each slot.
+  size_t size = 0;
+
+  /// Alignment of each slot.
+  size_t alignment = 0;
+
+  /// Offset of the first slot from the start of a page.
+  size_t first_offset = 0;
+
+  /// Number of slots in each page.
+  size_t slots_per_page = 0;
+
+  /// Pages with at least one free slot. Pages with allocated slots are kept
+  /// ahead of the retained empty page, if any.
+  containers::future::IntrusiveList<SlabPage> partial;
+
+  /// Pages with no free slots.
+  containers::future::IntrusiveList<SlabPage> full;
+
+  /// An empty page kept to avoid returning and reacquiring a page when a
+  /// single object is repeatedly allocated and freed.
+  SlabPage* empty = nullptr;
+};
+
+/// Size-independent implementation of `SlabAllocator`.
+///
+/// This class is not an `Allocator` itself, and only depends on the storage
+/// for size classes provided by `SlabAllocator`.
+class GenericSlabAllocator final {
+ public:
+  /// Maximum alignment of the slots in any size class.
+  static constexpr size_t kMaxSlotAlignment = alignof(std::max_align_t);
+
+  /// Constructs a slab allocator.
+  ///
+  /// @param[in] allocator    Allocator from which to request pages.
+  /// @param[in] page_size    Size and alignment of each page.
+  /// @param[in] size_classes Storage for the size classes.
+  /// @param[in] sizes        Object size of each size class.
+  GenericSlabAllocator(Allocator& allocator,
+                       size_t page_size,
+                       span<SlabSizeClass> size_classes,
+                       span<const size_t> sizes);
+
+  /// @copydoc Allocator::Allocate
+  void* Allocate(Layout layout);
+
+  /// @copydoc Deallocator::Deallocate
+  void Deallocate(void* ptr);
+
+  /// @copydoc Allocator::Resize
+  bool Resize(void* ptr, size_t new_size) const;
+
+  /// Returns the layout of the slot holding a given pointer.
+  Layout GetLayout(const void* ptr) const;
+
+  /// Returns whether a pointer is within a page held by this allocator.
+  bool Recognizes(const void* ptr) const;
+
+  /// Returns the total size of the pages held by this allocator.
+  size_t GetAllocated() const { return num_pages_ * page_size_; }
+
+  /// Returns every retained empty page to the wrapped allocator.
+  void ReleaseEmptyPages();
+
+  /// Ensures all allocations have been freed. Crashes with a diagnostic message
+  /// if any allocations remain outstanding.
+  void CrashIfAllocated();
+
+ private:
+  /// Returns the page containing a pointer.
+  SlabPage& PageOf(const void* ptr) const;
+
+  /// Returns a page to the wrapped allocator.
+  void Release(SlabPage& page);
+
+  Allocator& allocator_;
+  size_t page_size_;
+  span<SlabSizeClass> size_classes_;
+  size_t num_pages_ = 0;
+};
+
+}  // namespace internal
+
+/// Allocator that carves pages into slots of a few fixed sizes.
+///
+/// Many objects, such as RPC calls, list items, or buffer chunks, come in a
+/// handful of sizes. This allocator requests pages of `page_size` bytes from
+/// another allocator and divides each page into same-size slots for one of a
+/// configured list of size classes. Each request is served from the smallest
+/// size class that fits it. Allocating and freeing are constant time, and
+/// objects have no per-allocation header: the page, and hence size class, of
+/// an object is found by rounding its address down to a multiple of the page
+/// size.
+///
+/// When a page is emptied, it is returned to the wrapped allocator, except
+/// that one empty page is retained for each size class. Call
+/// `ReleaseEmptyPages` to return these as well.
+///
+/// Slots are aligned to the largest power of two that divides their size, up
+/// to `alignof(std::max_align_t)`. Requests that are larger than the largest
+/// size class, or that need greater alignment than any size class that fits
+/// them, fail. To serve these, combine this allocator with another using a
+/// `FallbackAllocator`.
+///
+/// This allocator is not thread-safe. Use a `SynchronizedAllocator` to share
+/// it between threads.
+///
+/// Example:
+/// @code{.cpp}
+///   pw::allocator::TlsfAllocator tlsf(heap);
+///   pw::allocator::SlabAllocator<3> allocator(tlsf, 4096, {32, 64, 256});
+/// @endcode
+///
+/// @tparam kNumSizeClasses   Number of size classes.
+template <size_t kNumSizeClasses>
+class SlabAllocator : public Allocator {
+ public:
+  static constexpr Capabilities kCapabilities =
+      kImplementsGetUsableLayout | kImplementsGetAllocatedLayout |
+      kImplementsRecognizes;
+
+  static_assert(kNumSizeClasses != 0);
+
+  /// Constructs a slab allocator.
+  ///
+  /// @param[in] allocator  Allocator from which to request pages.
+  /// @param[in] page_size  Size and alignment of each page. Must be a power of
+  ///                       two, and large enough to hold at least one slot of
+  ///                       the largest size class.
+  /// @param[in] sizes      Object size of each size class, in increasing
+  ///                       order. Sizes are rounded up to hold at least a
+  ///                       pointer.
+  SlabAllocator(Allocator& allocator,
+                size_t page_size,
+                const std::array<size_t, kNumSizeClasses>& sizes)
+      : Allocator(kCapabilities),
+        impl_(allocator, page_size, size_classes_, sizes) {}
+
+  ~SlabAllocator() override {
+    impl_.ReleaseEmptyPages();
+    impl_.CrashIfAllocated();
+  }
+
+  /// @copydoc internal::GenericSlabAllocator::ReleaseEmptyPages
+  void ReleaseEmptyPages() { impl_.ReleaseEmptyPages(); }
+
+ private:
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override { return impl_.Allocate(layout); }
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr) override { impl_.Deallocate(ptr); }
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    return impl_.Resize(ptr, new_size);
+  }
+
+  /// @copydoc Allocator::GetAllocated
+  ///
+  /// This includes the free slots in every page held by this allocator.
+  size_t DoGetAllocated() const override { return impl_.GetAllocated(); }
+
+  /// @copydoc Deallocator::GetLayout
+  Layout DoGetLayout(LayoutType layout_type, const void* ptr) const override {
+    if (layout_type == LayoutType::kRequested) {
+      return Layout();
+    }
+    return impl_.GetLayout(ptr);
+  }
+
+  /// @copydoc Deallocator::Recognizes
+  bool DoRecognizes(const void* ptr) const override {
+    return impl_.Recognizes(ptr);
+  }
+
+  std::array<internal::SlabSizeClass, kNumSizeClasses> size_classes_;
+  internal::GenericSlabAllocator impl_;
+};
+
+}  // namespace pw::allocator
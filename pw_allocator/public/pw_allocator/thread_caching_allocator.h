@@ -0,0 +1,300 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Returns a small integer that identifies the calling thread.
+///
+/// Indices are assigned sequentially, starting from zero, in the order in
+/// which threads first call this function.
+size_t GetThreadCacheIndex();
+
+}  // namespace internal
+
+/// Wraps an `Allocator` with per-thread caches of small, fixed-size blocks.
+///
+/// A `SynchronizedAllocator` serializes every request on a single lock. When
+/// many threads make small allocations, they contend for that lock even though
+/// most of the requests are for a handful of sizes. This allocator instead
+/// rounds small requests up to a power-of-two size class and serves them from
+/// a "magazine" of free blocks of that class in a cache selected by the
+/// calling thread. Each cache has its own lock, which is usually uncontended.
+///
+/// When a magazine is empty, it is refilled with half of its capacity in a
+/// single locked visit to the wrapped allocator. When a magazine is full, half
+/// of it is returned to the wrapped allocator in the same way. Requests that
+/// are larger than `kMaxCachedSize` or more strictly aligned than
+/// `alignof(std::max_align_t)` bypass the caches.
+///
+/// Every allocation carries a header of `alignof(std::max_align_t)` bytes that
+/// records how to free it. Memory held in the caches remains allocated from
+/// the wrapped allocator until it is drained or `Flush` is called.
+///
+/// Example:
+/// @code{.cpp}
+///   pw::allocator::TlsfAllocator tlsf(heap);
+///   pw::allocator::ThreadCachingAllocator<pw::sync::Mutex> allocator(tlsf);
+/// @endcode
+///
+/// @tparam LockType        The type of the locks used to synchronize access
+///                         to the caches and the wrapped allocator. Must be
+///                         default-constructible.
+/// @tparam kNumCaches      Number of caches. Threads share caches only when
+///                         there are more threads than caches.
+/// @tparam kMagazineSize   Maximum number of free blocks of each size class
+///                         held by each cache.
+/// @tparam kMaxCachedSize  Largest cached size class. Must be a power of two.
+template <typename LockType,
+          size_t kNumCaches = 8,
+          size_t kMagazineSize = 32,
+          size_t kMaxCachedSize = 1024>
+class ThreadCachingAllocator : public Allocator {
+ public:
+  static constexpr Capabilities kCapabilities = kImplementsGetUsableLayout;
+
+  /// Size of the smallest size class. This is also the alignment of cached
+  /// blocks and the size of the per-allocation header.
+  static constexpr size_t kMinCachedSize = alignof(std::max_align_t);
+
+  /// Number of power-of-two size classes, from `kMinCachedSize` to
+  /// `kMaxCachedSize`.
+  static constexpr size_t kNumSizeClasses =
+      static_cast<size_t>(cpp20::bit_width(kMaxCachedSize / kMinCachedSize));
+
+  static_assert(kNumCaches != 0);
+  static_assert(kMagazineSize >= 2);
+  static_assert(cpp20::has_single_bit(kMaxCachedSize) &&
+                kMaxCachedSize >= kMinCachedSize);
+
+  explicit ThreadCachingAllocator(Allocator& allocator)
+      : Allocator(kCapabilities), allocator_(allocator) {}
+
+  ~ThreadCachingAllocator() override { Flush(); }
+
+  /// Returns every cached block to the wrapped allocator.
+  void Flush() {
+    for (Cache& cache : caches_) {
+      std::lock_guard lock(cache.lock);
+      for (Magazine& magazine : cache.magazines) {
+        Drain(magazine, magazine.count);
+      }
+    }
+  }
+
+ private:
+  /// Records how to free an allocation. Stored immediately before the pointer
+  /// returned to the caller.
+  struct Header {
+    uint32_t offset;
+    uint32_t size_class;
+  };
+  static_assert(sizeof(Header) <= kMinCachedSize);
+
+  static constexpr uint32_t kUncached = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kBatchSize = kMagazineSize / 2;
+
+  /// Caches are kept on separate cache lines to avoid false sharing.
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Magazine {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+  };
+
+  struct alignas(kCacheLineSize) Cache {
+    LockType lock;
+    std::array<Magazine, kNumSizeClasses> magazines PW_GUARDED_BY(lock);
+  };
+
+  static constexpr size_t SizeOf(size_t size_class) {
+    return kMinCachedSize << size_class;
+  }
+
+  static constexpr size_t SizeClassOf(size_t size) {
+    return size <= kMinCachedSize
+               ? 0
+               : static_cast<size_t>(cpp20::bit_width((size - 1) /
+                                                      kMinCachedSize));
+  }
+
+  static Header& GetHeader(const void* ptr) {
+    return *(static_cast<Header*>(const_cast<void*>(ptr)) - 1);
+  }
+
+  static void* GetBase(void* ptr) {
+    return static_cast<std::byte*>(ptr) - GetHeader(ptr).offset;
+  }
+
+  /// Writes a header into memory from the wrapped allocator and returns the
+  /// pointer to give to the caller.
+  static void* Init(void* base, size_t offset, uint32_t size_class) {
+    void* ptr = static_cast<std::byte*>(base) + offset;
+    GetHeader(ptr) = Header{static_cast<uint32_t>(offset), size_class};
+    return ptr;
+  }
+
+  static void Push(Magazine& magazine, void* ptr) {
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = magazine.head;
+    magazine.head = block;
+    ++magazine.count;
+  }
+
+  static void* Pop(Magazine& magazine) {
+    FreeBlock* block = magazine.head;
+    magazine.head = block->next;
+    --magazine.count;
+    return block;
+  }
+
+  Cache& GetCache() {
+    return caches_[internal::GetThreadCacheIndex() % kNumCaches];
+  }
+
+  /// Adds up to `kBatchSize` blocks from the wrapped allocator to a magazine.
+  /// Returns whether the magazine is non-empty.
+  bool Refill(Magazine& magazine, size_t size_class) {
+    Layout layout(kMinCachedSize + SizeOf(size_class), kMinCachedSize);
+    std::lock_guard lock(lock_);
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      void* base = allocator_.Allocate(layout);
+      if (base == nullptr) {
+        break;
+      }
+      Push(magazine,
+           Init(base, kMinCachedSize, static_cast<uint32_t>(size_class)));
+    }
+    return magazine.count != 0;
+  }
+
+  /// Returns up to `count` blocks from a magazine to the wrapped allocator.
+  void Drain(Magazine& magazine, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    std::lock_guard lock(lock_);
+    for (; count != 0 && magazine.count != 0; --count) {
+      allocator_.Deallocate(GetBase(Pop(magazine)));
+    }
+  }
+
+  void* AllocateUncached(Layout layout) {
+    size_t offset = std::max(layout.alignment(), kMinCachedSize);
+    if (layout.size() > std::numeric_limits<size_t>::max() - offset) {
+      return nullptr;
+    }
+    std::lock_guard lock(lock_);
+    void* base = allocator_.Allocate(Layout(layout.size() + offset, offset));
+    return base == nullptr ? nullptr : Init(base, offset, kUncached);
+  }
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override {
+    if (layout.size() > kMaxCachedSize || layout.alignment() > kMinCachedSize) {
+      return AllocateUncached(layout);
+    }
+    size_t size_class = SizeClassOf(layout.size());
+    Cache& cache = GetCache();
+    std::lock_guard lock(cache.lock);
+    Magazine& magazine = cache.magazines[size_class];
+    if (magazine.count == 0 && !Refill(magazine, size_class)) {
+      return nullptr;
+    }
+    return Pop(magazine);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override {
+    uint32_t size_class = GetHeader(ptr).size_class;
+    if (size_class == kUncached) {
+      std::lock_guard lock(lock_);
+      allocator_.Deallocate(GetBase(ptr));
+      return;
+    }
+    Cache& cache = GetCache();
+    std::lock_guard lock(cache.lock);
+    Magazine& magazine = cache.magazines[size_class];
+    if (magazine.count == kMagazineSize) {
+      Drain(magazine, kBatchSize);
+    }
+    Push(magazine, ptr);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    const Header& header = GetHeader(ptr);
+    if (header.size_class != kUncached) {
+      return new_size <= SizeOf(header.size_class);
+    }
+    if (new_size > std::numeric_limits<size_t>::max() - header.offset) {
+      return false;
+    }
+    std::lock_guard lock(lock_);
+    return allocator_.Resize(GetBase(ptr), new_size + header.offset);
+  }
+
+  /// @copydoc Allocator::GetAllocated
+  ///
+  /// This includes memory held in the caches.
+  size_t DoGetAllocated() const override {
+    std::lock_guard lock(lock_);
+    return allocator_.GetAllocated();
+  }
+
+  /// @copydoc Deallocator::GetLayout
+  Layout DoGetLayout(LayoutType layout_type, const void* ptr) const override {
+    if (layout_type != LayoutType::kUsable) {
+      return Layout();
+    }
+    const Header& header = GetHeader(ptr);
+    if (header.size_class != kUncached) {
+      return Layout(SizeOf(header.size_class), kMinCachedSize);
+    }
+    const void* base = static_cast<const std::byte*>(ptr) - header.offset;
+    std::lock_guard lock(lock_);
+    Layout layout = GetLayout(allocator_, LayoutType::kUsable, base);
+    if (layout.size() < header.offset) {
+      return Layout();
+    }
+    return Layout(layout.size() - header.offset, header.offset);
+  }
+
+  Allocator& allocator_ PW_GUARDED_BY(lock_);
+  mutable LockType lock_;
+  std::array<Cache, kNumCaches> caches_;
+};
+
+}  // namespace pw::allocator
@@ -63,6 +63,18 @@ struct TlsfIndices {
 /// bucket on the topmost shelf is unbounded to handle any blocks of arbitrary
 /// size.
 ///
+/// Each shelf and each bucket has a bit in a bitmap that is set when it holds
+/// any free blocks. To allocate, the requested size is rounded up to the
+/// smallest bucket whose blocks are all at least that large, and the bitmaps
+/// are used to find the first non-empty bucket at or above it using
+/// count-trailing-zero operations. This is the "good fit" strategy from the
+/// paper: it finds a block in constant time instead of searching a bucket for
+/// one that fits, at the cost of sometimes passing over a block in the
+/// requested size's own bucket that would have fit more closely. Only if no
+/// larger block is available is that bucket searched. Requests of up to
+/// `kMinSize` bytes always search the first bucket, which holds all smaller
+/// blocks.
+///
 /// For example, if `kMinSize` is 64, and `kNumShelves` is 10, than the maximum
 /// inner sizes of buckets on each shelf could be represented as:
 ///
@@ -129,6 +141,20 @@ class TlsfAllocator : public BlockAllocator<BlockType> {
   /// maximum inner size greater than the given size.
   static TlsfIndices MapToIndices(size_t size);
 
+  /// Returns the shelf and bucket indices for the bucket with the smallest
+  /// maximum inner size whose blocks are all at least the given size, or the
+  /// first bucket for sizes no larger than `kMinSize`.
+  ///
+  /// The returned bucket index may be one past the end of a shelf. It is
+  /// suitable for passing to `FindNextAvailable`.
+  static TlsfIndices MapToGoodFit(size_t size);
+
+  /// Returns whether the given indices refer to the same bucket.
+  static constexpr bool IsSameBucket(const TlsfIndices& lhs,
+                                     const TlsfIndices& rhs) {
+    return lhs.shelf == rhs.shelf && lhs.bucket == rhs.bucket;
+  }
+
   /// Starting with the bucket indicated by the given `indices`, searches for
   /// the non-empty bucket with the smallest maximum inner size. Updates the
   /// given `indices` and returns true if such a bucket is found; otherwise
@@ -177,19 +203,39 @@ TlsfAllocator<BlockType, kMinSize, kNumShelves>::ChooseBlock(Layout layout) {
     }
   }
 
-  // Check the buckets on the shelves.
-  for (TlsfIndices indices = MapToIndices(layout.size());
-       FindNextAvailable(indices);
-       indices.bucket++) {
+  // Check the buckets on the shelves, starting with the first whose blocks
+  // are all large enough. Blocks in buckets other than the one the requested
+  // size maps to do not need to be searched unless extra alignment is needed.
+  TlsfIndices exact = MapToIndices(layout.size());
+  TlsfIndices indices = MapToGoodFit(layout.size());
+  bool skipped_exact = !IsSameBucket(indices, exact);
+  for (; FindNextAvailable(indices); indices.bucket++) {
     FastSortedBucket<BlockType>& bucket =
         shelves_[indices.shelf][indices.bucket];
-    BlockType* block = bucket.RemoveCompatible(layout);
+    BlockType* block = nullptr;
+    if (IsSameBucket(indices, exact) ||
+        layout.alignment() > BlockType::kAlignment) {
+      block = bucket.RemoveCompatible(layout);
+    } else {
+      block = bucket.RemoveAny();
+    }
     if (block != nullptr) {
       UpdateBitmaps(indices, bucket.empty());
       return BlockType::AllocFirst(std::move(block), layout);
     }
   }
 
+  // Check the bucket the requested size maps to, which may also hold smaller
+  // blocks, if it was skipped.
+  if (skipped_exact) {
+    FastSortedBucket<BlockType>& bucket = shelves_[exact.shelf][exact.bucket];
+    BlockType* block = bucket.RemoveCompatible(layout);
+    if (block != nullptr) {
+      UpdateBitmaps(exact, bucket.empty());
+      return BlockType::AllocFirst(std::move(block), layout);
+    }
+  }
+
   // No sufficiently large block found.
   return BlockResult<BlockType>(nullptr, Status::NotFound());
 }
@@ -231,7 +277,7 @@ TlsfIndices TlsfAllocator<BlockType, kMinSize, kNumShelves>::MapToIndices(
   }
 
   // Most significant bit set determines the shelf.
-  auto shelf = internal::CountRZero(cpp20::bit_floor(size));
+  auto shelf = static_cast<size_t>(cpp20::bit_width(size)) - 1;
   // Each shelf has 16 buckets, so next 4 bits determine the bucket.
   auto bucket = static_cast<uint16_t>((size >> (shelf - kBucketBits)) & 0xF);
 
@@ -244,6 +290,28 @@ TlsfIndices TlsfAllocator<BlockType, kMinSize, kNumShelves>::MapToIndices(
   return TlsfIndices{.shelf = static_cast<uint32_t>(shelf), .bucket = bucket};
 }
 
+template <typename BlockType, size_t kMinSize, size_t kNumShelves>
+TlsfIndices TlsfAllocator<BlockType, kMinSize, kNumShelves>::MapToGoodFit(
+    size_t size) {
+  // The first bucket holds all the blocks smaller than `kMinSize`. Rounding
+  // up would skip blocks that could be much closer in size than those in the
+  // next bucket, so search it instead.
+  if (size <= kMinSize) {
+    return TlsfIndices{.shelf = 0, .bucket = 0};
+  }
+
+  // Move to the next bucket if the size is not the smallest for its bucket.
+  // If the size was clamped to the last bucket, this moves past the top shelf.
+  TlsfIndices indices = MapToIndices(size);
+  auto msb = static_cast<size_t>(cpp20::bit_width(size)) - 1;
+  size_t mask = (size_t(1) << (msb - kBucketBits)) - 1;
+  if ((size & mask) != 0 ||
+      msb - internal::CountRZero(kMinSize) >= kNumShelves) {
+    indices.bucket++;
+  }
+  return indices;
+}
+
 template <typename BlockType, size_t kMinSize, size_t kNumShelves>
 bool TlsfAllocator<BlockType, kMinSize, kNumShelves>::FindNextAvailable(
     TlsfIndices& indices) {
@@ -0,0 +1,123 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/tracer.h"
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_varint/varint.h"
+
+namespace pw::allocator {
+
+/// Maximum number of bytes needed to encode a `TraceEvent`.
+///
+/// Events are encoded as a header byte holding the event type and a failure
+/// flag, followed by varints for the timestamp, token, and those fields of the
+/// event used by its type.
+inline constexpr size_t kMaxEncodedTraceEventSize =
+    1 + 6 * varint::kMaxVarint64SizeBytes;
+
+/// Encodes an event into the front of a buffer.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: Returns the number of bytes written.
+///
+///    RESOURCE_EXHAUSTED: The buffer is too small.
+///
+/// @endrst
+StatusWithSize EncodeTraceEvent(const TraceEvent& event, ByteSpan buffer);
+
+/// Decodes an event from the front of a buffer.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: Returns the number of bytes read.
+///
+///    OUT_OF_RANGE: The buffer ends part way through an event.
+///
+///    DATA_LOSS: The buffer does not start with a valid event.
+///
+/// @endrst
+StatusWithSize DecodeTraceEvent(ConstByteSpan buffer, TraceEvent& event);
+
+/// Tracer that encodes events and writes them to a stream.
+///
+/// The stream receives a sequence of encoded events with no other framing,
+/// which can be decoded with `DecodeTraceEvent`. If a write fails, the event
+/// is dropped and later events are still written.
+class StreamTracer : public Tracer {
+ public:
+  explicit StreamTracer(stream::Writer& writer,
+                        chrono::VirtualSystemClock& clock =
+                            chrono::VirtualSystemClock::RealClock())
+      : writer_(writer), clock_(clock) {}
+
+  /// Number of events that could not be written.
+  size_t dropped() const { return dropped_; }
+
+ private:
+  /// @copydoc Tracer::Record
+  void DoRecord(const TraceEvent& event) override;
+
+  stream::Writer& writer_;
+  chrono::VirtualSystemClock& clock_;
+  size_t dropped_ = 0;
+};
+
+/// Tracer that keeps the most recent events in a ring buffer.
+///
+/// This is useful on devices that cannot stream a full trace as it is
+/// recorded. When the buffer is full, the oldest events are discarded. The
+/// retained events can later be written out with `Dump`.
+class RingBufferTracer : public Tracer {
+ public:
+  /// Constructs a tracer that stores events in the given buffer.
+  ///
+  /// @param  buffer  Storage for encoded events. Each event takes at most
+  ///                 `kMaxEncodedTraceEventSize` bytes, plus a small prefix.
+  explicit RingBufferTracer(ByteSpan buffer,
+                            chrono::VirtualSystemClock& clock =
+                                chrono::VirtualSystemClock::RealClock());
+
+  /// Number of events currently retained.
+  size_t size() const { return ring_buffer_.EntryCount(); }
+
+  /// Writes the retained events, oldest first, to a stream in the same format
+  /// as `StreamTracer`.
+  Status Dump(stream::Writer& writer);
+
+  /// Discards all retained events.
+  void Clear() { ring_buffer_.Clear(); }
+
+ private:
+  /// @copydoc Tracer::Record
+  void DoRecord(const TraceEvent& event) override;
+
+  ring_buffer::PrefixedEntryRingBuffer ring_buffer_;
+  chrono::VirtualSystemClock& clock_;
+};
+
+}  // namespace pw::allocator
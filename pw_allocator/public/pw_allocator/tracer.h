@@ -0,0 +1,82 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+namespace pw::allocator {
+
+/// Kinds of allocator requests that can be traced.
+enum class TraceEventType : uint8_t {
+  kAllocate = 1,
+  kDeallocate = 2,
+  kResize = 3,
+  kReallocate = 4,
+
+  /// Recorded before a `Reallocate` request that may release `id`, and
+  /// followed by a `kReallocate` event once the request completes.
+  kBeginReallocate = 5,
+};
+
+/// Describes a single allocator request.
+struct TraceEvent {
+  TraceEventType type = TraceEventType::kAllocate;
+
+  /// Whether the request failed.
+  bool failed = false;
+
+  /// Clock ticks at which the request was recorded. This is set by the
+  /// `Tracer`.
+  uint64_t timestamp = 0;
+
+  /// Identifies the allocator that received the request, e.g. the metric
+  /// token of a `TrackingAllocator`.
+  ///
+  /// Allocators do not know which code made a request. To tell callers apart,
+  /// give each caller its own `TrackingAllocator` with its own token.
+  uint32_t token = 0;
+
+  /// Address of the memory returned by `Allocate`, or passed to `Deallocate`,
+  /// `Resize`, or `Reallocate`.
+  uint64_t id = 0;
+
+  /// Address of the memory returned by `Reallocate`.
+  uint64_t new_id = 0;
+
+  /// Size requested by `Allocate` or `Reallocate`, or new size passed to
+  /// `Resize`.
+  uint64_t size = 0;
+
+  /// Alignment requested by `Allocate` or `Reallocate`.
+  uint64_t alignment = 0;
+};
+
+/// Receives a record of every request made to a `TrackingAllocator`.
+///
+/// Tracers are called while handling each request, and so should be fast. A
+/// tracer that is shared by allocators used from several threads must be
+/// synchronized by the caller.
+class Tracer {
+ public:
+  virtual ~Tracer() = default;
+
+  /// Records a request.
+  void Record(const TraceEvent& event) { DoRecord(event); }
+
+ private:
+  /// @copydoc Record
+  virtual void DoRecord(const TraceEvent& event) = 0;
+};
+
+}  // namespace pw::allocator
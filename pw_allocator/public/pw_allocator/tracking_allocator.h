@@ -20,6 +20,7 @@
 #include "pw_allocator/allocator.h"
 #include "pw_allocator/capability.h"
 #include "pw_allocator/metrics.h"
+#include "pw_allocator/tracer.h"
 #include "pw_assert/assert.h"
 #include "pw_metric/metric.h"
 #include "pw_preprocessor/compiler.h"
@@ -43,6 +44,11 @@ static constexpr struct AddTrackingAllocatorAsChild {
 /// template parameter type, such as `TrackingAllocator` which uses the
 /// default metrics implementation, or `TrackingAllocatorForTest` which
 /// always uses the real metrics implementation.
+///
+/// In addition to collecting metrics, the allocator can pass a record of each
+/// request to a `Tracer`, e.g. to capture a trace that can be replayed on a
+/// host. Tracing is independent of the metrics type, and costs only a pointer
+/// comparison per request when no tracer is set.
 template <typename MetricsType>
 class TrackingAllocator : public Allocator {
  public:
@@ -69,21 +75,77 @@ class TrackingAllocator : public Allocator {
   /// See also `NoMetrics::UpdateDeferred`.
   void UpdateDeferred() const { metrics_.UpdateDeferred(allocator_); }
 
+  /// Sets the tracer that receives a record of each request, or stops tracing
+  /// if `tracer` is null.
+  ///
+  /// Events are tagged with this allocator's metric token.
+  void set_tracer(Tracer* tracer) { tracer_ = tracer; }
+
  private:
   /// @copydoc Allocator::Allocate
-  void* DoAllocate(Layout layout) override;
+  void* DoAllocate(Layout layout) override {
+    void* new_ptr = TrackAllocate(layout);
+    Trace(TraceEventType::kAllocate, new_ptr == nullptr, new_ptr, nullptr,
+          layout);
+    return new_ptr;
+  }
 
   /// @copydoc Allocator::Deallocate
-  void DoDeallocate(void* ptr) override;
+  void DoDeallocate(void* ptr) override {
+    // Record the event first. Once the memory is freed, another thread may
+    // allocate it and record that before this event would be recorded.
+    Trace(TraceEventType::kDeallocate, false, ptr, nullptr, Layout(0, 0));
+    TrackDeallocate(ptr);
+  }
 
   /// @copydoc Allocator::Deallocate
   void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
 
   /// @copydoc Allocator::Resize
-  bool DoResize(void* ptr, size_t new_size) override;
+  bool DoResize(void* ptr, size_t new_size) override {
+    bool resized = TrackResize(ptr, new_size);
+    Trace(TraceEventType::kResize, !resized, ptr, nullptr, Layout(new_size, 0));
+    return resized;
+  }
 
   /// @copydoc Allocator::Reallocate
-  void* DoReallocate(void* ptr, Layout new_layout) override;
+  void* DoReallocate(void* ptr, Layout new_layout) override {
+    // As with deallocations, `ptr` may be freed and reused by another thread
+    // before this request returns, so record that it is being released first.
+    if (ptr != nullptr) {
+      Trace(TraceEventType::kBeginReallocate, false, ptr, nullptr, new_layout);
+    }
+    void* new_ptr = TrackReallocate(ptr, new_layout);
+    Trace(TraceEventType::kReallocate, new_ptr == nullptr, ptr, new_ptr,
+          new_layout);
+    return new_ptr;
+  }
+
+  /// Forwards requests to the wrapped allocator and updates metrics.
+  void* TrackAllocate(Layout layout);
+  void TrackDeallocate(void* ptr);
+  bool TrackResize(void* ptr, size_t new_size);
+  void* TrackReallocate(void* ptr, Layout new_layout);
+
+  /// Passes a record of a request to the tracer, if any.
+  void Trace(TraceEventType type,
+             bool failed,
+             const void* ptr,
+             const void* new_ptr,
+             Layout layout) {
+    if (tracer_ == nullptr) {
+      return;
+    }
+    TraceEvent event;
+    event.type = type;
+    event.failed = failed;
+    event.token = metric_group().name();
+    event.id = reinterpret_cast<uintptr_t>(ptr);
+    event.new_id = reinterpret_cast<uintptr_t>(new_ptr);
+    event.size = layout.size();
+    event.alignment = layout.alignment();
+    tracer_->Record(event);
+  }
 
   /// @copydoc Allocator::GetAllocated
   size_t DoGetAllocated() const override { return allocator_.GetAllocated(); }
@@ -103,12 +165,13 @@ class TrackingAllocator : public Allocator {
 
   Allocator& allocator_;
   mutable internal::Metrics<MetricsType> metrics_;
+  Tracer* tracer_ = nullptr;
 };
 
 // Template method implementation.
 
 template <typename MetricsType>
-void* TrackingAllocator<MetricsType>::DoAllocate(Layout layout) {
+void* TrackingAllocator<MetricsType>::TrackAllocate(Layout layout) {
   if constexpr (internal::AnyEnabled<MetricsType>()) {
     Layout requested = layout;
     size_t allocated = allocator_.GetAllocated();
@@ -127,7 +190,7 @@ void* TrackingAllocator<MetricsType>::DoAllocate(Layout layout) {
 }
 
 template <typename MetricsType>
-void TrackingAllocator<MetricsType>::DoDeallocate(void* ptr) {
+void TrackingAllocator<MetricsType>::TrackDeallocate(void* ptr) {
   if constexpr (internal::AnyEnabled<MetricsType>()) {
     Layout requested = GetRequestedLayout(ptr);
     size_t allocated = allocator_.GetAllocated();
@@ -141,7 +204,7 @@ void TrackingAllocator<MetricsType>::DoDeallocate(void* ptr) {
 }
 
 template <typename MetricsType>
-bool TrackingAllocator<MetricsType>::DoResize(void* ptr, size_t new_size) {
+bool TrackingAllocator<MetricsType>::TrackResize(void* ptr, size_t new_size) {
   if constexpr (internal::AnyEnabled<MetricsType>()) {
     Layout requested = GetRequestedLayout(ptr);
     size_t allocated = allocator_.GetAllocated();
@@ -160,8 +223,8 @@ bool TrackingAllocator<MetricsType>::DoResize(void* ptr, size_t new_size) {
 }
 
 template <typename MetricsType>
-void* TrackingAllocator<MetricsType>::DoReallocate(void* ptr,
-                                                   Layout new_layout) {
+void* TrackingAllocator<MetricsType>::TrackReallocate(void* ptr,
+                                                      Layout new_layout) {
   if constexpr (internal::AnyEnabled<MetricsType>()) {
     // Check if possible to resize in place with no additional overhead.
     Layout requested = GetRequestedLayout(ptr);
@@ -17,6 +17,7 @@
 
 #include "pw_allocator/chunk_pool.h"
 #include "pw_allocator/hardening.h"
+#include "pw_bytes/alignment.h"
 #include "pw_bytes/span.h"
 
 namespace pw::allocator {
@@ -29,20 +30,32 @@ namespace pw::allocator {
 /// dispatcher might use such an allocator to manage memory for a set of task
 /// objects.
 ///
-/// @tparam   T   The type of object to allocate memory for.
-template <typename T>
-class TypedPool : public ChunkPool {
+/// By default, the pool is a ``ChunkPool``, which requires external
+/// synchronization to be shared between threads. To share the pool between
+/// threads without a lock, use ``LockFreeChunkPool`` instead:
+///
+/// @code{.cpp}
+/// TypedPool<Packet, LockFreeChunkPool>::Buffer<32> buffer;
+/// TypedPool<Packet, LockFreeChunkPool> packet_pool(buffer);
+/// @endcode
+///
+/// @tparam   T         The type of object to allocate memory for.
+/// @tparam   PoolType  The type of chunk pool, e.g. ``ChunkPool`` or
+///                     ``LockFreeChunkPool``.
+template <typename T, typename PoolType = ChunkPool>
+class TypedPool : public PoolType {
  public:
   /// Returns the amount of memory needed to allocate ``num_objects``.
   static constexpr size_t SizeNeeded(size_t num_objects) {
-    size_t needed = std::max(sizeof(T), ChunkPool::kMinSize);
+    size_t needed =
+        AlignUp(std::max(sizeof(T), PoolType::kMinSize), AlignmentNeeded());
     Hardening::Multiply(needed, num_objects);
     return needed;
   }
 
   /// Returns the optimal alignment for the backing memory region.
   static constexpr size_t AlignmentNeeded() {
-    return std::max(alignof(T), ChunkPool::kMinAlignment);
+    return std::max(alignof(T), PoolType::kMinAlignment);
   }
 
   /// Provides aligned storage for `kNumObjects` of type `T`.
@@ -66,7 +79,7 @@ class TypedPool : public ChunkPool {
   /// @param  buffer  The memory to allocate from.
   template <size_t kNumObjects>
   TypedPool(Buffer<kNumObjects>& buffer)
-      : ChunkPool(buffer.data, Layout::Of<T>()) {}
+      : PoolType(buffer.data, Layout::Of<T>()) {}
 
   /// Construct a ``TypedPool``.
   ///
@@ -80,7 +93,7 @@ class TypedPool : public ChunkPool {
   ///
   /// @param  region  The memory to allocate from. Must be large enough to
   ///                 allocate memory for at least one object.
-  TypedPool(ByteSpan region) : ChunkPool(region, Layout::Of<T>()) {}
+  TypedPool(ByteSpan region) : PoolType(region, Layout::Of<T>()) {}
 
   /// Constructs and object from the given `args`
   ///
@@ -90,7 +103,7 @@ class TypedPool : public ChunkPool {
   /// @param[in]  args...     Arguments passed to the object constructor.
   template <int&... kExplicitGuard, typename... Args>
   T* New(Args&&... args) {
-    void* ptr = Allocate();
+    void* ptr = PoolType::Allocate();
     return ptr != nullptr ? new (ptr) T(std::forward<Args>(args)...) : nullptr;
   }
 
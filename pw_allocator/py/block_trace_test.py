@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Copyright 2025 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for summarizing block allocator trace events."""
+
+import io
+import unittest
+from typing import Any
+
+from pw_allocator.block_trace import collect_stats
+
+
+def _event(
+    name: str,
+    phase: str,
+    ts: float,
+    group: str = 'BlockAllocator',
+    **args: int,
+) -> dict[str, Any]:
+    """Returns a trace event in the format written by trace_tokenized.py."""
+    event: dict[str, Any] = {
+        'pid': 'pw_allocator',
+        'tid': group,
+        'name': name,
+        'ph': phase,
+        'ts': ts,
+    }
+    if args:
+        event['args'] = args
+    return event
+
+
+class CollectStatsTest(unittest.TestCase):
+    """Tests for collect_stats."""
+
+    def test_pairs_start_and_end_events(self) -> None:
+        stats = collect_stats(
+            [
+                _event('Allocate', 'B', 10),
+                _event('Allocate', 'E', 13, search_length=4, splits=1),
+                _event('Deallocate', 'B', 20),
+                _event('Deallocate', 'E', 28, merges=2),
+                _event('Allocate', 'B', 30),
+                _event('Allocate', 'E', 35, search_length=2, splits=0),
+            ]
+        )
+        self.assertEqual(set(stats), {'Allocate', 'Deallocate'})
+
+        allocate = stats['Allocate']
+        self.assertEqual(allocate.latencies, [3, 5])
+        self.assertEqual(allocate.counters['search_length'], [4, 2])
+        self.assertEqual(allocate.counters['splits'], [1, 0])
+        self.assertEqual(allocate.counters['merges'], [0, 0])
+
+        deallocate = stats['Deallocate']
+        self.assertEqual(deallocate.latencies, [8])
+        self.assertEqual(deallocate.counters['merges'], [2])
+
+    def test_ignores_unmatched_events(self) -> None:
+        stats = collect_stats(
+            [
+                _event('Allocate', 'E', 5, search_length=9),
+                _event('Allocate', 'B', 10),
+                _event('Allocate', 'E', 12),
+                _event('Deallocate', 'B', 20),
+            ]
+        )
+        self.assertEqual(list(stats), ['Allocate'])
+        self.assertEqual(stats['Allocate'].latencies, [2])
+
+    def test_ignores_other_groups(self) -> None:
+        stats = collect_stats(
+            [
+                _event('Allocate', 'B', 10, group='Other'),
+                _event('Allocate', 'E', 12, group='Other'),
+            ]
+        )
+        self.assertEqual(stats, {})
+
+    def test_histogram_uses_power_of_two_buckets(self) -> None:
+        events: list[dict[str, Any]] = []
+        for ts, latency in enumerate([0.5, 1, 3, 3, 8]):
+            events.append(_event('Allocate', 'B', ts * 100))
+            events.append(_event('Allocate', 'E', ts * 100 + latency))
+        histogram = collect_stats(events)['Allocate'].histogram()
+        self.assertEqual(histogram, {0: 1, 1: 1, 2: 2, 4: 1})
+
+    def test_write_csv(self) -> None:
+        stats = collect_stats(
+            [
+                _event('Allocate', 'B', 0),
+                _event('Allocate', 'E', 3),
+                _event('Allocate', 'B', 10),
+                _event('Allocate', 'E', 11),
+            ]
+        )
+        output = io.StringIO()
+        stats['Allocate'].write_csv(output)
+        self.assertEqual(
+            output.getvalue(),
+            'Allocate,"[1, 2)",1\nAllocate,"[2, 4)",1\n',
+        )
+
+    def test_write_summary(self) -> None:
+        stats = collect_stats(
+            [
+                _event('Allocate', 'B', 0),
+                _event('Allocate', 'E', 4, search_length=3, splits=1),
+            ]
+        )
+        output = io.StringIO()
+        stats['Allocate'].write_summary(output)
+        summary = output.getvalue()
+        self.assertIn('Allocate: 1 requests', summary)
+        self.assertIn('latency: min 4, p50 4, p90 4, p99 4, max 4', summary)
+        self.assertIn('search_length: mean 3.00, max 3', summary)
+        self.assertIn('splits: mean 1.00, max 1', summary)
+
+
+if __name__ == '__main__':
+    unittest.main()
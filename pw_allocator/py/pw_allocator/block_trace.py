@@ -0,0 +1,186 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Summarizes block allocator trace events as latency histograms.
+
+The input is a JSON trace file, as produced by
+``pw_trace_tokenized/py/pw_trace_tokenized/trace_tokenized.py``, from a device
+built with ``PW_ALLOCATOR_BLOCK_TRACE`` enabled. Each allocator request is
+recorded as a pair of duration events. The elapsed time between them is
+reported in the units of the trace's timestamps. If the trace's time source
+counts cycles, decoding it with a ``--ticks-per-second`` of 1000000 will make
+the reported values cycle counts.
+
+Example:
+
+.. code-block:: sh
+
+   python -m pw_allocator.block_trace trace.json
+"""
+
+import argparse
+import json
+import sys
+
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, IO, Iterable
+
+MODULE = 'pw_allocator'
+GROUP = 'BlockAllocator'
+
+COUNTERS = ['search_length', 'splits', 'merges']
+
+HISTOGRAM_WIDTH = 40
+
+
+def _parse_args() -> argparse.Namespace:
+    """Parse arguments."""
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        'trace', type=Path, help='JSON trace file to read events from'
+    )
+    parser.add_argument(
+        '-o', '--output', type=Path, help='Path to write a CSV file to'
+    )
+    return parser.parse_args()
+
+
+def _bucket(value: float) -> int:
+    """Returns the power-of-two bucket that includes the given value.
+
+    Bucket 0 holds values less than 1. Bucket N holds values in
+    [2^(N-1), 2^N).
+    """
+    return int(value).bit_length()
+
+
+def _bucket_label(bucket: int) -> str:
+    """Returns a description of the range of values in a bucket."""
+    if bucket == 0:
+        return '[0, 1)'
+    return f'[{1 << (bucket - 1)}, {1 << bucket})'
+
+
+def _percentile(values: list[float], percent: int) -> float:
+    """Returns the given percentile of a sorted list of values."""
+    index = (len(values) * percent) // 100
+    return values[min(index, len(values) - 1)]
+
+
+@dataclass
+class RequestStats:
+    """Statistics for a single type of allocator request."""
+
+    name: str
+    latencies: list[float] = field(default_factory=list)
+    counters: dict[str, list[int]] = field(
+        default_factory=lambda: {counter: [] for counter in COUNTERS}
+    )
+
+    def add(self, latency: float, args: dict[str, Any]) -> None:
+        """Records a completed request."""
+        self.latencies.append(latency)
+        for counter in COUNTERS:
+            self.counters[counter].append(int(args.get(counter, 0)))
+
+    def histogram(self) -> dict[int, int]:
+        """Returns the number of requests in each power-of-two bucket."""
+        buckets: dict[int, int] = {}
+        for latency in self.latencies:
+            bucket = _bucket(latency)
+            buckets[bucket] = buckets.get(bucket, 0) + 1
+        return buckets
+
+    def write_summary(self, output: IO) -> None:
+        """Writes a human-readable summary to the given output."""
+        latencies = sorted(self.latencies)
+        output.write(f'{self.name}: {len(latencies)} requests\n')
+        if not latencies:
+            return
+        output.write(
+            f'  latency: min {latencies[0]:g}, '
+            f'p50 {_percentile(latencies, 50):g}, '
+            f'p90 {_percentile(latencies, 90):g}, '
+            f'p99 {_percentile(latencies, 99):g}, '
+            f'max {latencies[-1]:g}\n'
+        )
+        for counter in COUNTERS:
+            values = self.counters[counter]
+            output.write(
+                f'  {counter}: mean {sum(values) / len(values):.2f}, '
+                f'max {max(values)}\n'
+            )
+
+        buckets = self.histogram()
+        most = max(buckets.values())
+        for bucket in range(min(buckets), max(buckets) + 1):
+            count = buckets.get(bucket, 0)
+            bar = '#' * ((count * HISTOGRAM_WIDTH + most - 1) // most)
+            output.write(f'  {_bucket_label(bucket):>16} {count:>8} {bar}\n')
+        output.write('\n')
+
+    def write_csv(self, output: IO) -> None:
+        """Writes the latency histogram as comma-separated values."""
+        for bucket, count in sorted(self.histogram().items()):
+            output.write(f'{self.name},"{_bucket_label(bucket)}",{count}\n')
+
+
+def collect_stats(events: Iterable[dict[str, Any]]) -> dict[str, RequestStats]:
+    """Pairs the start and end events of each request and collects stats.
+
+    Block allocators are not reentrant, so a request of a given type always
+    ends before the next one of that type starts. Unmatched events, such as
+    those at the edges of a ring buffer, are ignored.
+    """
+    stats: dict[str, RequestStats] = {}
+    starts: dict[str, float] = {}
+    for event in events:
+        if event.get('pid') != MODULE or event.get('tid') != GROUP:
+            continue
+        name = event['name']
+        if event['ph'] == 'B':
+            starts[name] = event['ts']
+        elif event['ph'] == 'E' and name in starts:
+            latency = event['ts'] - starts.pop(name)
+            if name not in stats:
+                stats[name] = RequestStats(name)
+            stats[name].add(latency, event.get('args', {}))
+    return stats
+
+
+def main() -> int:
+    """Reads a trace and writes a summary of block allocator requests."""
+    args = _parse_args()
+    with open(args.trace) as trace:
+        stats = collect_stats(json.load(trace))
+
+    if not stats:
+        print(f'No {GROUP} events found in {args.trace}', file=sys.stderr)
+        return 1
+
+    for request in stats.values():
+        request.write_summary(sys.stdout)
+
+    if args.output:
+        with open(args.output, 'w+') as output:
+            output.write('request,latency,count\n')
+            for request in stats.values():
+                request.write_csv(output)
+        print(f'Wrote to {args.output.resolve()}')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
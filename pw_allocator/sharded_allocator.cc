@@ -0,0 +1,35 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/sharded_allocator.h"
+
+#include "pw_allocator/thread_caching_allocator.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif  // defined(__linux__)
+
+namespace pw::allocator::internal {
+
+size_t GetCurrentCpuIndex() {
+#if defined(__linux__)
+  int cpu = sched_getcpu();
+  if (cpu >= 0) {
+    return static_cast<size_t>(cpu);
+  }
+#endif  // defined(__linux__)
+  return GetThreadCacheIndex();
+}
+
+}  // namespace pw::allocator::internal
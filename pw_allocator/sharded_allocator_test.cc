@@ -0,0 +1,214 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/sharded_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/fallback_allocator.h"
+#include "pw_allocator/first_fit.h"
+#include "pw_allocator/synchronized_allocator.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_allocator/testing.h"
+#include "pw_bytes/span.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+constexpr size_t kSmallCapacity = 256;
+constexpr size_t kLargeCapacity = 4096;
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::NoSync;
+using AllocatorForTest =
+    ::pw::allocator::test::AllocatorForTest<kLargeCapacity * 2>;
+using FirstFitAllocator = ::pw::allocator::FirstFitAllocator<>;
+
+/// Two shards of different sizes, each with its own region of memory.
+template <typename LockType>
+class ShardsForTest {
+ public:
+  using ShardedAllocator = ::pw::allocator::ShardedAllocator<LockType, 2>;
+
+  ShardsForTest()
+      : small_(small_buffer_),
+        large_(large_buffer_),
+        sharded_({{
+            {large_, large_buffer_},
+            {small_, small_buffer_},
+        }}) {}
+
+  FirstFitAllocator& small() { return small_; }
+  FirstFitAllocator& large() { return large_; }
+  ShardedAllocator& sharded() { return sharded_; }
+
+  /// Returns whether `ptr` lies within the region of the given shard.
+  bool InSmall(const void* ptr) const { return Contains(small_buffer_, ptr); }
+  bool InLarge(const void* ptr) const { return Contains(large_buffer_, ptr); }
+
+ private:
+  template <size_t kSize>
+  static bool Contains(const std::array<std::byte, kSize>& buffer,
+                       const void* ptr) {
+    auto* bytes = static_cast<const std::byte*>(ptr);
+    return buffer.data() <= bytes && bytes < buffer.data() + buffer.size();
+  }
+
+  alignas(16) std::array<std::byte, kSmallCapacity> small_buffer_{};
+  alignas(16) std::array<std::byte, kLargeCapacity> large_buffer_{};
+  FirstFitAllocator small_;
+  FirstFitAllocator large_;
+  ShardedAllocator sharded_;
+};
+
+// Unit tests.
+
+TEST(ShardedAllocatorTest, AllocatesFromOneShard) {
+  ShardsForTest<NoSync> shards;
+  void* ptr = shards.sharded().Allocate(Layout(32));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_NE(shards.InSmall(ptr), shards.InLarge(ptr));
+  EXPECT_EQ(shards.sharded().GetAllocated(),
+            shards.small().GetAllocated() + shards.large().GetAllocated());
+  shards.sharded().Deallocate(ptr);
+}
+
+TEST(ShardedAllocatorTest, DeallocatesToOwningShard) {
+  ShardsForTest<NoSync> shards;
+  std::array<void*, 8> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = shards.sharded().Allocate(Layout(64));
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_NE(shards.sharded().GetAllocated(), 0u);
+
+  for (void* ptr : ptrs) {
+    FirstFitAllocator& owner =
+        shards.InSmall(ptr) ? shards.small() : shards.large();
+    size_t allocated = owner.GetAllocated();
+    shards.sharded().Deallocate(ptr);
+    EXPECT_LT(owner.GetAllocated(), allocated);
+  }
+  EXPECT_EQ(shards.small().GetAllocated(), 0u);
+  EXPECT_EQ(shards.large().GetAllocated(), 0u);
+}
+
+TEST(ShardedAllocatorTest, FallsBackToOtherShards) {
+  ShardsForTest<NoSync> shards;
+
+  // Only the large shard can satisfy this request, regardless of which shard
+  // is tried first.
+  void* ptr = shards.sharded().Allocate(Layout(kSmallCapacity * 2));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(shards.InLarge(ptr));
+  shards.sharded().Deallocate(ptr);
+}
+
+TEST(ShardedAllocatorTest, FailsWhenAllShardsAreExhausted) {
+  ShardsForTest<NoSync> shards;
+  EXPECT_EQ(shards.sharded().Allocate(Layout(kLargeCapacity)), nullptr);
+}
+
+TEST(ShardedAllocatorTest, GetCapacityIsSumOfShards) {
+  ShardsForTest<NoSync> shards;
+  EXPECT_EQ(shards.sharded().GetCapacity(),
+            shards.small().GetCapacity() + shards.large().GetCapacity());
+}
+
+TEST(ShardedAllocatorTest, ResizeInOwningShard) {
+  ShardsForTest<NoSync> shards;
+  void* ptr = shards.sharded().Allocate(Layout(kSmallCapacity * 2));
+  ASSERT_NE(ptr, nullptr);
+  size_t allocated = shards.large().GetAllocated();
+  EXPECT_TRUE(shards.sharded().Resize(ptr, kSmallCapacity * 4));
+  EXPECT_GT(shards.large().GetAllocated(), allocated);
+  EXPECT_FALSE(shards.sharded().Resize(ptr, kLargeCapacity));
+  shards.sharded().Deallocate(ptr);
+  EXPECT_EQ(shards.large().GetAllocated(), 0u);
+}
+
+TEST(ShardedAllocatorTest, RecognizesOnlyShardMemory) {
+  ShardsForTest<NoSync> shards;
+  AllocatorForTest secondary;
+  pw::allocator::FallbackAllocator fallback(shards.sharded(), secondary);
+
+  void* sharded = fallback.Allocate(Layout(32));
+  ASSERT_NE(sharded, nullptr);
+  void* unsharded = fallback.Allocate(Layout(kLargeCapacity));
+  ASSERT_NE(unsharded, nullptr);
+  EXPECT_EQ(secondary.metrics().num_allocations.value(), 1u);
+
+  // The fallback allocator frees each pointer to the allocator that
+  // recognizes it.
+  fallback.Deallocate(unsharded);
+  EXPECT_EQ(secondary.metrics().num_deallocations.value(), 1u);
+  fallback.Deallocate(sharded);
+  EXPECT_EQ(shards.sharded().GetAllocated(), 0u);
+}
+
+// TODO: https://pwbug.dev/365161669 - Express joinability as a build-system
+// constraint.
+#if PW_THREAD_JOINING_ENABLED
+
+constexpr size_t kNumThreads = 4;
+constexpr size_t kNumIterations = 50;
+constexpr size_t kMaxSize = 128;
+constexpr size_t kNumRequests = 8;
+
+using ::pw::allocator::test::TestHarness;
+
+/// Uses a test harness to make random requests on a background thread.
+class Background final {
+ public:
+  Background(pw::Allocator& allocator, uint64_t seed) {
+    test_harness_.set_allocator(&allocator);
+    test_harness_.set_prng_seed(seed);
+    thread_ = pw::Thread(context_.options(), [this] { Run(); });
+  }
+
+  ~Background() { thread_.join(); }
+
+ private:
+  void Run() {
+    for (size_t i = 0; i < kNumIterations; ++i) {
+      test_harness_.GenerateRequests(kMaxSize, kNumRequests);
+    }
+  }
+
+  TestHarness test_harness_;
+  pw::thread::test::TestThreadContext context_;
+  pw::Thread thread_;
+};
+
+TEST(ShardedAllocatorTest, ConcurrentAllocations) {
+  ShardsForTest<pw::sync::Mutex> shards;
+  {
+    std::array<std::optional<Background>, kNumThreads> background;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      background[i].emplace(shards.sharded(), i + 1);
+    }
+  }
+  EXPECT_EQ(shards.sharded().GetAllocated(), 0u);
+}
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
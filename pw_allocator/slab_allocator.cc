@@ -0,0 +1,202 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/slab_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/hardening.h"
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator::internal {
+
+// SlabPage methods
+
+void* SlabPage::Pop(size_t first_offset, size_t slot_size) {
+  ++num_used_;
+  if (free_list_ != nullptr) {
+    FreeSlot* slot = free_list_;
+    free_list_ = slot->next;
+    return slot;
+  }
+  auto* base = reinterpret_cast<std::byte*>(this);
+  return base + first_offset + (num_carved_++ * slot_size);
+}
+
+void SlabPage::Push(void* ptr) {
+  auto* slot = static_cast<FreeSlot*>(ptr);
+  slot->next = free_list_;
+  free_list_ = slot;
+  --num_used_;
+}
+
+// GenericSlabAllocator methods
+
+GenericSlabAllocator::GenericSlabAllocator(Allocator& allocator,
+                                           size_t page_size,
+                                           span<SlabSizeClass> size_classes,
+                                           span<const size_t> sizes)
+    : allocator_(allocator),
+      page_size_(page_size),
+      size_classes_(size_classes) {
+  PW_CHECK(cpp20::has_single_bit(page_size), "page size must be a power of 2");
+  PW_CHECK_UINT_EQ(size_classes.size(), sizes.size());
+  size_t prev_size = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    SlabSizeClass& size_class = size_classes[i];
+    size_t size = std::max(sizes[i], sizeof(void*));
+    size = AlignUp(size, alignof(void*));
+    PW_CHECK_UINT_GT(size, prev_size, "sizes must be in increasing order");
+    prev_size = size;
+
+    size_class.size = size;
+    size_class.alignment = std::min(size & (~size + 1), kMaxSlotAlignment);
+    size_class.first_offset = AlignUp(sizeof(SlabPage), size_class.alignment);
+    PW_CHECK_UINT_GE(page_size,
+                     size_class.first_offset + size,
+                     "page size is too small for the largest size class");
+    size_class.slots_per_page = (page_size - size_class.first_offset) / size;
+  }
+}
+
+void* GenericSlabAllocator::Allocate(Layout layout) {
+  auto iter = std::find_if(
+      size_classes_.begin(),
+      size_classes_.end(),
+      [&layout](const SlabSizeClass& size_class) {
+        return layout.size() <= size_class.size &&
+               layout.alignment() <= size_class.alignment;
+      });
+  if (iter == size_classes_.end()) {
+    return nullptr;
+  }
+  SlabSizeClass& size_class = *iter;
+
+  if (size_class.partial.empty()) {
+    void* ptr = allocator_.Allocate(Layout(page_size_, page_size_));
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    auto index = static_cast<size_t>(iter - size_classes_.begin());
+    size_class.partial.push_front(*(new (ptr) SlabPage(index)));
+    ++num_pages_;
+  }
+
+  SlabPage& page = size_class.partial.front();
+  if (&page == size_class.empty) {
+    size_class.empty = nullptr;
+  }
+  void* ptr = page.Pop(size_class.first_offset, size_class.size);
+  if (page.num_used() == size_class.slots_per_page) {
+    size_class.partial.pop_front();
+    size_class.full.push_front(page);
+  }
+  return ptr;
+}
+
+void GenericSlabAllocator::Deallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  SlabPage& page = PageOf(ptr);
+  SlabSizeClass& size_class = size_classes_[page.size_class()];
+  if (page.num_used() == size_class.slots_per_page) {
+    size_class.full.erase(page);
+    size_class.partial.push_front(page);
+  }
+  page.Push(ptr);
+  if (page.num_used() != 0) {
+    return;
+  }
+
+  // Keep one empty page at the back of the list, so that pages with allocated
+  // slots are filled first.
+  size_class.partial.erase(page);
+  if (size_class.empty == nullptr) {
+    size_class.empty = &page;
+    size_class.partial.push_back(page);
+  } else {
+    Release(page);
+  }
+}
+
+bool GenericSlabAllocator::Resize(void* ptr, size_t new_size) const {
+  return new_size <= GetLayout(ptr).size();
+}
+
+Layout GenericSlabAllocator::GetLayout(const void* ptr) const {
+  const SlabSizeClass& size_class = size_classes_[PageOf(ptr).size_class()];
+  return Layout(size_class.size, size_class.alignment);
+}
+
+bool GenericSlabAllocator::Recognizes(const void* ptr) const {
+  const SlabPage* page = &PageOf(ptr);
+  for (const SlabSizeClass& size_class : size_classes_) {
+    for (const SlabPage& other : size_class.partial) {
+      if (&other == page) {
+        return true;
+      }
+    }
+    for (const SlabPage& other : size_class.full) {
+      if (&other == page) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void GenericSlabAllocator::ReleaseEmptyPages() {
+  for (SlabSizeClass& size_class : size_classes_) {
+    if (size_class.empty != nullptr) {
+      size_class.partial.erase(*size_class.empty);
+      Release(*size_class.empty);
+      size_class.empty = nullptr;
+    }
+  }
+}
+
+void GenericSlabAllocator::CrashIfAllocated() {
+  if constexpr (Hardening::kIncludesRobustChecks) {
+    PW_CHECK_UINT_EQ(num_pages_,
+                     0,
+                     "%zu pages were still in use when an allocator was "
+                     "destroyed. All memory allocated by an allocator must be "
+                     "released before the allocator goes out of scope.",
+                     num_pages_);
+  }
+  for (SlabSizeClass& size_class : size_classes_) {
+    size_class.partial.clear();
+    size_class.full.clear();
+    size_class.empty = nullptr;
+  }
+  num_pages_ = 0;
+}
+
+SlabPage& GenericSlabAllocator::PageOf(const void* ptr) const {
+  auto addr = reinterpret_cast<uintptr_t>(ptr) & ~(page_size_ - 1);
+  return *reinterpret_cast<SlabPage*>(addr);
+}
+
+void GenericSlabAllocator::Release(SlabPage& page) {
+  page.~SlabPage();
+  allocator_.Deallocate(&page);
+  --num_pages_;
+}
+
+}  // namespace pw::allocator::internal
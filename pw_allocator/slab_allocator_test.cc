@@ -0,0 +1,200 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/slab_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/fallback_allocator.h"
+#include "pw_allocator/fuzzing.h"
+#include "pw_allocator/testing.h"
+#include "pw_containers/vector.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+using SlabAllocator = ::pw::allocator::SlabAllocator<3>;
+
+constexpr size_t kCapacity = 0x1000;
+constexpr size_t kPageSize = 0x100;
+constexpr std::array<size_t, 3> kSizes = {16, 32, 64};
+
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<kCapacity>;
+
+size_t GetNumPages(const AllocatorForTest& parent) {
+  return parent.metrics().num_allocations.value() -
+         parent.metrics().num_deallocations.value();
+}
+
+// Unit tests.
+
+TEST(SlabAllocatorTest, AllocateFromSmallestFittingClass) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  void* ptr = allocator.Allocate(Layout(20, 4));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(allocator.Resize(ptr, 32));
+  EXPECT_FALSE(allocator.Resize(ptr, 33));
+  allocator.Deallocate(ptr);
+}
+
+TEST(SlabAllocatorTest, AllocateExcessiveSize) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  EXPECT_EQ(allocator.Allocate(Layout(65, 1)), nullptr);
+  EXPECT_EQ(GetNumPages(parent), 0u);
+}
+
+TEST(SlabAllocatorTest, AllocateExcessiveAlignment) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  EXPECT_EQ(allocator.Allocate(Layout(16, kPageSize)), nullptr);
+}
+
+TEST(SlabAllocatorTest, SlotsHaveNoHeader) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  void* ptr1 = allocator.Allocate(Layout(32, 8));
+  void* ptr2 = allocator.Allocate(Layout(32, 8));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  auto addr1 = reinterpret_cast<uintptr_t>(ptr1);
+  auto addr2 = reinterpret_cast<uintptr_t>(ptr2);
+  EXPECT_EQ(addr2 - addr1, 32u);
+  EXPECT_EQ(addr1 % 16, 0u);
+  EXPECT_EQ(GetNumPages(parent), 1u);
+  allocator.Deallocate(ptr1);
+  allocator.Deallocate(ptr2);
+}
+
+TEST(SlabAllocatorTest, ReusesFreedSlots) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  void* ptr1 = allocator.Allocate(Layout(16, 1));
+  void* ptr2 = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  allocator.Deallocate(ptr1);
+  EXPECT_EQ(allocator.Allocate(Layout(16, 1)), ptr1);
+  allocator.Deallocate(ptr1);
+  allocator.Deallocate(ptr2);
+}
+
+TEST(SlabAllocatorTest, SizeClassesUseSeparatePages) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  void* ptr1 = allocator.Allocate(Layout(16, 1));
+  void* ptr2 = allocator.Allocate(Layout(64, 1));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(GetNumPages(parent), 2u);
+  EXPECT_EQ(allocator.GetAllocated(), 2 * kPageSize);
+  allocator.Deallocate(ptr1);
+  allocator.Deallocate(ptr2);
+}
+
+TEST(SlabAllocatorTest, RecyclesEmptyPages) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  pw::Vector<void*, kPageSize / 16 * 3> ptrs;
+
+  // Fill three pages, and start a fourth.
+  while (GetNumPages(parent) < 4) {
+    void* ptr = allocator.Allocate(Layout(16, 1));
+    ASSERT_NE(ptr, nullptr);
+    ptrs.push_back(ptr);
+  }
+  allocator.Deallocate(ptrs.back());
+  ptrs.pop_back();
+  EXPECT_EQ(GetNumPages(parent), 4u);
+
+  // One empty page is retained, and the rest are returned.
+  while (!ptrs.empty()) {
+    allocator.Deallocate(ptrs.back());
+    ptrs.pop_back();
+  }
+  EXPECT_EQ(GetNumPages(parent), 1u);
+  EXPECT_EQ(allocator.GetAllocated(), kPageSize);
+
+  // The retained page is reused.
+  void* ptr = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(GetNumPages(parent), 1u);
+  allocator.Deallocate(ptr);
+
+  allocator.ReleaseEmptyPages();
+  EXPECT_EQ(GetNumPages(parent), 0u);
+  EXPECT_EQ(allocator.GetAllocated(), 0u);
+}
+
+TEST(SlabAllocatorTest, FailsWhenParentIsExhausted) {
+  AllocatorForTest parent;
+  SlabAllocator allocator(parent, kPageSize, kSizes);
+  pw::Vector<void*, kCapacity / 64> ptrs;
+  while (true) {
+    void* ptr = allocator.Allocate(Layout(64, 1));
+    if (ptr == nullptr) {
+      break;
+    }
+    ptrs.push_back(ptr);
+  }
+  EXPECT_FALSE(ptrs.empty());
+  EXPECT_LT(ptrs.size(), kCapacity / 64);
+  while (!ptrs.empty()) {
+    allocator.Deallocate(ptrs.back());
+    ptrs.pop_back();
+  }
+}
+
+TEST(SlabAllocatorTest, FallsBackForLargeRequests) {
+  AllocatorForTest parent;
+  SlabAllocator slab(parent, kPageSize, kSizes);
+  AllocatorForTest secondary;
+  pw::allocator::FallbackAllocator allocator(slab, secondary);
+
+  void* small = allocator.Allocate(Layout(16, 1));
+  void* large = allocator.Allocate(Layout(128, 1));
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(secondary.metrics().num_allocations.value(), 1u);
+
+  allocator.Deallocate(large);
+  EXPECT_EQ(secondary.metrics().num_deallocations.value(), 1u);
+  allocator.Deallocate(small);
+  slab.ReleaseEmptyPages();
+  EXPECT_EQ(GetNumPages(parent), 0u);
+}
+
+// Fuzz tests.
+
+using ::pw::allocator::test::DefaultArbitraryRequests;
+using ::pw::allocator::test::Request;
+using ::pw::allocator::test::TestHarness;
+
+void NeverCrashes(const pw::Vector<Request>& requests) {
+  static AllocatorForTest parent;
+  static SlabAllocator allocator(parent, kPageSize, kSizes);
+  static TestHarness fuzzer(allocator);
+  fuzzer.HandleRequests(requests);
+}
+
+FUZZ_TEST(SlabAllocatorFuzzTest, NeverCrashes)
+    .WithDomains(DefaultArbitraryRequests());
+
+}  // namespace
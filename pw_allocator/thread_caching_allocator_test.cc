@@ -0,0 +1,234 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/thread_caching_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/synchronized_allocator.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_allocator/testing.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+constexpr size_t kCapacity = 16384;
+constexpr size_t kMagazineSize = 4;
+constexpr size_t kBatchSize = kMagazineSize / 2;
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::NoSync;
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<kCapacity>;
+using ThreadCachingAllocator =
+    ::pw::allocator::ThreadCachingAllocator<NoSync, 1, kMagazineSize>;
+
+/// Returns the number of outstanding allocations from the wrapped allocator.
+size_t NumAllocations(const AllocatorForTest& allocator) {
+  return allocator.metrics().num_allocations.value() -
+         allocator.metrics().num_deallocations.value();
+}
+
+// Unit tests.
+
+TEST(ThreadCachingAllocatorTest, RefillsInBatches) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(40));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(NumAllocations(allocator), kBatchSize);
+
+  void* other = caching.Allocate(Layout(64));
+  ASSERT_NE(other, nullptr);
+  EXPECT_EQ(NumAllocations(allocator), kBatchSize);
+
+  caching.Deallocate(ptr);
+  caching.Deallocate(other);
+}
+
+TEST(ThreadCachingAllocatorTest, ReusesFreedBlocks) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(64));
+  ASSERT_NE(ptr, nullptr);
+  caching.Deallocate(ptr);
+  EXPECT_EQ(caching.Allocate(Layout(33)), ptr);
+  EXPECT_EQ(NumAllocations(allocator), kBatchSize);
+  caching.Deallocate(ptr);
+}
+
+TEST(ThreadCachingAllocatorTest, SeparatesSizeClasses) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* small = caching.Allocate(Layout(16));
+  void* large = caching.Allocate(Layout(17));
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(NumAllocations(allocator), kBatchSize * 2);
+
+  caching.Deallocate(small);
+  caching.Deallocate(large);
+}
+
+TEST(ThreadCachingAllocatorTest, DrainsFullMagazines) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  std::array<void*, kMagazineSize * 2> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = caching.Allocate(Layout(128));
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(NumAllocations(allocator), ptrs.size());
+
+  for (void* ptr : ptrs) {
+    caching.Deallocate(ptr);
+  }
+  EXPECT_EQ(NumAllocations(allocator), kMagazineSize);
+
+  caching.Flush();
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+
+TEST(ThreadCachingAllocatorTest, FlushesOnDestruction) {
+  AllocatorForTest allocator;
+  {
+    ThreadCachingAllocator caching(allocator);
+    void* ptr = caching.Allocate(Layout(256));
+    ASSERT_NE(ptr, nullptr);
+    caching.Deallocate(ptr);
+    EXPECT_NE(NumAllocations(allocator), 0u);
+  }
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+
+TEST(ThreadCachingAllocatorTest, BypassesCacheForLargeRequests) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(2048));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(NumAllocations(allocator), 1u);
+  EXPECT_GT(allocator.allocate_size(), 2048u);
+
+  caching.Deallocate(ptr);
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+
+TEST(ThreadCachingAllocatorTest, BypassesCacheForOveralignedRequests) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(64, 64));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0u);
+  EXPECT_EQ(NumAllocations(allocator), 1u);
+
+  caching.Deallocate(ptr);
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+
+TEST(ThreadCachingAllocatorTest, ResizeWithinSizeClass) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(40));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(caching.Resize(ptr, 64));
+  EXPECT_TRUE(caching.Resize(ptr, 8));
+  EXPECT_FALSE(caching.Resize(ptr, 65));
+  caching.Deallocate(ptr);
+}
+
+TEST(ThreadCachingAllocatorTest, ResizeUncached) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+
+  void* ptr = caching.Allocate(Layout(2048));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(caching.Resize(ptr, 1024));
+  EXPECT_EQ(allocator.resize_new_size(), 1024 + alignof(std::max_align_t));
+  caching.Deallocate(ptr);
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+
+TEST(ThreadCachingAllocatorTest, FailsWhenWrappedAllocatorIsExhausted) {
+  AllocatorForTest allocator;
+  ThreadCachingAllocator caching(allocator);
+  allocator.Exhaust();
+
+  EXPECT_EQ(caching.Allocate(Layout(64)), nullptr);
+  EXPECT_EQ(caching.Allocate(Layout(4096)), nullptr);
+}
+
+// TODO: https://pwbug.dev/365161669 - Express joinability as a build-system
+// constraint.
+#if PW_THREAD_JOINING_ENABLED
+
+constexpr size_t kNumThreads = 4;
+constexpr size_t kNumIterations = 50;
+constexpr size_t kMaxSize = 512;
+constexpr size_t kNumRequests = 16;
+
+using ::pw::allocator::test::TestHarness;
+
+/// Uses a test harness to make random requests on a background thread.
+class Background final {
+ public:
+  Background(pw::Allocator& allocator, uint64_t seed) {
+    test_harness_.set_allocator(&allocator);
+    test_harness_.set_prng_seed(seed);
+    thread_ = pw::Thread(context_.options(), [this] { Run(); });
+  }
+
+  ~Background() { thread_.join(); }
+
+ private:
+  void Run() {
+    for (size_t i = 0; i < kNumIterations; ++i) {
+      test_harness_.GenerateRequests(kMaxSize, kNumRequests);
+    }
+  }
+
+  TestHarness test_harness_;
+  pw::thread::test::TestThreadContext context_;
+  pw::Thread thread_;
+};
+
+TEST(ThreadCachingAllocatorTest, ConcurrentAllocations) {
+  AllocatorForTest allocator;
+  pw::allocator::ThreadCachingAllocator<pw::sync::Mutex, 2, kMagazineSize>
+      caching(allocator);
+  {
+    std::array<std::optional<Background>, kNumThreads> background;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      background[i].emplace(caching, i + 1);
+    }
+  }
+  caching.Flush();
+  EXPECT_EQ(NumAllocations(allocator), 0u);
+}
+#endif  // PW_THREAD_JOINING_ENABLED
+
+}  // namespace
@@ -88,6 +88,36 @@ TEST_F(TlsfAllocatorTest, AllocatesBestCompatible) {
   allocator.Deallocate(ptr3);
 }
 
+TEST_F(TlsfAllocatorTest, AllocatesGoodFit) {
+  // Both free blocks can satisfy the request, but only the second is in a
+  // bucket where every block can.
+  constexpr size_t kOverhead = BlockType::kBlockOverhead;
+  auto& allocator = GetAllocator({
+      {kOverhead + 280, Preallocation::kFree},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {kOverhead + 320, Preallocation::kFree},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  void* ptr = allocator.Allocate(Layout(273, 1));
+  EXPECT_LT(Fetch(1), ptr);
+  allocator.Deallocate(ptr);
+}
+
+TEST_F(TlsfAllocatorTest, AllocatesFromSameBucketIfNoGoodFit) {
+  constexpr size_t kOverhead = BlockType::kBlockOverhead;
+  auto& allocator = GetAllocator({
+      {kOverhead + 272, Preallocation::kFree},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {kOverhead + 280, Preallocation::kFree},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  void* ptr = allocator.Allocate(Layout(273, 1));
+  EXPECT_LT(Fetch(1), ptr);
+  allocator.Deallocate(ptr);
+}
+
 TEST_F(TlsfAllocatorTest, DeallocateNull) { DeallocateNull(); }
 
 TEST_F(TlsfAllocatorTest, DeallocateShuffled) { DeallocateShuffled(); }
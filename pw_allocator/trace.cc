@@ -0,0 +1,220 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/trace.h"
+
+#include <array>
+#include <limits>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr std::byte kTypeMask{0x7f};
+constexpr std::byte kFailedFlag{0x80};
+
+/// Appends varints to a buffer, tracking the first error.
+class VarintWriter {
+ public:
+  explicit VarintWriter(ByteSpan buffer) : buffer_(buffer) {}
+
+  void Write(uint64_t value) {
+    if (!ok_) {
+      return;
+    }
+    size_t written = varint::Encode(value, buffer_.subspan(offset_));
+    ok_ = written != 0;
+    offset_ += written;
+  }
+
+  StatusWithSize result() const {
+    return ok_ ? StatusWithSize(offset_) : StatusWithSize::ResourceExhausted();
+  }
+
+ private:
+  ByteSpan buffer_;
+  size_t offset_ = 1;
+  bool ok_ = true;
+};
+
+/// Reads varints from a buffer, tracking the first error.
+class VarintReader {
+ public:
+  explicit VarintReader(ConstByteSpan buffer) : buffer_(buffer) {}
+
+  uint64_t Read() {
+    uint64_t value = 0;
+    if (!ok_) {
+      return value;
+    }
+    size_t read = varint::Decode(buffer_.subspan(offset_), &value);
+    ok_ = read != 0;
+    offset_ += read;
+    return value;
+  }
+
+  template <typename T>
+  T ReadAs() {
+    uint64_t value = Read();
+    if (value > std::numeric_limits<T>::max()) {
+      ok_ = false;
+      corrupt_ = true;
+    }
+    return static_cast<T>(value);
+  }
+
+  StatusWithSize result() const {
+    if (corrupt_) {
+      return StatusWithSize::DataLoss();
+    }
+    return ok_ ? StatusWithSize(offset_) : StatusWithSize::OutOfRange();
+  }
+
+ private:
+  ConstByteSpan buffer_;
+  size_t offset_ = 1;
+  bool ok_ = true;
+  bool corrupt_ = false;
+};
+
+uint64_t GetTimestamp(chrono::VirtualSystemClock& clock) {
+  return static_cast<uint64_t>(clock.now().time_since_epoch().count());
+}
+
+}  // namespace
+
+StatusWithSize EncodeTraceEvent(const TraceEvent& event, ByteSpan buffer) {
+  if (buffer.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  buffer[0] = static_cast<std::byte>(event.type);
+  if (event.failed) {
+    buffer[0] |= kFailedFlag;
+  }
+  VarintWriter writer(buffer);
+  writer.Write(event.timestamp);
+  writer.Write(event.token);
+  writer.Write(event.id);
+  switch (event.type) {
+    case TraceEventType::kAllocate:
+      writer.Write(event.size);
+      writer.Write(event.alignment);
+      break;
+    case TraceEventType::kDeallocate:
+      break;
+    case TraceEventType::kResize:
+      writer.Write(event.size);
+      break;
+    case TraceEventType::kReallocate:
+      writer.Write(event.new_id);
+      writer.Write(event.size);
+      writer.Write(event.alignment);
+      break;
+    case TraceEventType::kBeginReallocate:
+      writer.Write(event.size);
+      writer.Write(event.alignment);
+      break;
+  }
+  return writer.result();
+}
+
+StatusWithSize DecodeTraceEvent(ConstByteSpan buffer, TraceEvent& event) {
+  if (buffer.empty()) {
+    return StatusWithSize::OutOfRange();
+  }
+  auto type = static_cast<TraceEventType>(buffer[0] & kTypeMask);
+  switch (type) {
+    case TraceEventType::kAllocate:
+    case TraceEventType::kDeallocate:
+    case TraceEventType::kResize:
+    case TraceEventType::kReallocate:
+    case TraceEventType::kBeginReallocate:
+      break;
+    default:
+      return StatusWithSize::DataLoss();
+  }
+  event = TraceEvent();
+  event.type = type;
+  event.failed = (buffer[0] & kFailedFlag) != std::byte(0);
+  VarintReader reader(buffer);
+  event.timestamp = reader.Read();
+  event.token = reader.ReadAs<uint32_t>();
+  event.id = reader.Read();
+  switch (type) {
+    case TraceEventType::kAllocate:
+      event.size = reader.Read();
+      event.alignment = reader.Read();
+      break;
+    case TraceEventType::kDeallocate:
+      break;
+    case TraceEventType::kResize:
+      event.size = reader.Read();
+      break;
+    case TraceEventType::kReallocate:
+      event.new_id = reader.Read();
+      event.size = reader.Read();
+      event.alignment = reader.Read();
+      break;
+    case TraceEventType::kBeginReallocate:
+      event.size = reader.Read();
+      event.alignment = reader.Read();
+      break;
+  }
+  return reader.result();
+}
+
+// StreamTracer methods
+
+void StreamTracer::DoRecord(const TraceEvent& event) {
+  TraceEvent stamped = event;
+  stamped.timestamp = GetTimestamp(clock_);
+  std::array<std::byte, kMaxEncodedTraceEventSize> buffer;
+  StatusWithSize encoded = EncodeTraceEvent(stamped, buffer);
+  if (!encoded.ok() ||
+      !writer_.Write(ConstByteSpan(buffer).first(encoded.size())).ok()) {
+    ++dropped_;
+  }
+}
+
+// RingBufferTracer methods
+
+RingBufferTracer::RingBufferTracer(ByteSpan buffer,
+                                   chrono::VirtualSystemClock& clock)
+    : clock_(clock) {
+  PW_CHECK_OK(ring_buffer_.SetBuffer(buffer));
+}
+
+void RingBufferTracer::DoRecord(const TraceEvent& event) {
+  TraceEvent stamped = event;
+  stamped.timestamp = GetTimestamp(clock_);
+  std::array<std::byte, kMaxEncodedTraceEventSize> buffer;
+  StatusWithSize encoded = EncodeTraceEvent(stamped, buffer);
+  if (encoded.ok()) {
+    // The ring buffer discards the oldest events to make room.
+    ring_buffer_.PushBack(ConstByteSpan(buffer).first(encoded.size()))
+        .IgnoreError();
+  }
+}
+
+Status RingBufferTracer::Dump(stream::Writer& writer) {
+  auto iter = ring_buffer_.begin();
+  for (; iter != ring_buffer_.end(); ++iter) {
+    PW_TRY(writer.Write(iter->buffer));
+  }
+  return iter.status();
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,271 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/trace.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_allocator/tracking_allocator.h"
+#include "pw_chrono/simulated_system_clock.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::DecodeTraceEvent;
+using ::pw::allocator::EncodeTraceEvent;
+using ::pw::allocator::kMaxEncodedTraceEventSize;
+using ::pw::allocator::Layout;
+using ::pw::allocator::RingBufferTracer;
+using ::pw::allocator::StreamTracer;
+using ::pw::allocator::TraceEvent;
+using ::pw::allocator::TraceEventType;
+using ::pw::allocator::TrackingAllocator;
+using ::pw::allocator::internal::AllMetrics;
+using ::pw::chrono::SimulatedSystemClock;
+using ::pw::chrono::SystemClock;
+
+constexpr pw::metric::Token kToken = 0x1234;
+
+void ExpectEqual(const TraceEvent& actual, const TraceEvent& expected) {
+  EXPECT_EQ(actual.type, expected.type);
+  EXPECT_EQ(actual.failed, expected.failed);
+  EXPECT_EQ(actual.timestamp, expected.timestamp);
+  EXPECT_EQ(actual.token, expected.token);
+  EXPECT_EQ(actual.id, expected.id);
+  EXPECT_EQ(actual.new_id, expected.new_id);
+  EXPECT_EQ(actual.size, expected.size);
+  EXPECT_EQ(actual.alignment, expected.alignment);
+}
+
+/// Decodes every event in a buffer.
+template <size_t kMaxEvents>
+size_t DecodeAll(pw::ConstByteSpan data,
+                 std::array<TraceEvent, kMaxEvents>& events) {
+  size_t num_events = 0;
+  while (!data.empty() && num_events < kMaxEvents) {
+    pw::StatusWithSize result = DecodeTraceEvent(data, events[num_events]);
+    EXPECT_EQ(result.status(), pw::OkStatus());
+    if (!result.ok()) {
+      break;
+    }
+    data = data.subspan(result.size());
+    ++num_events;
+  }
+  return num_events;
+}
+
+// Unit tests.
+
+TEST(TraceTest, EncodeDecodeEachType) {
+  std::array<TraceEvent, 5> events;
+  events[0] = {.type = TraceEventType::kAllocate,
+               .timestamp = 1000,
+               .token = kToken,
+               .id = 0x20001000,
+               .size = 64,
+               .alignment = 8};
+  events[1] = {.type = TraceEventType::kResize,
+               .failed = true,
+               .timestamp = 2000,
+               .token = kToken,
+               .id = 0x20001000,
+               .size = 128};
+  events[2] = {.type = TraceEventType::kReallocate,
+               .timestamp = 3000,
+               .token = kToken,
+               .id = 0x20001000,
+               .new_id = 0x20002000,
+               .size = 256,
+               .alignment = 8};
+  events[3] = {.type = TraceEventType::kDeallocate,
+               .timestamp = 4000,
+               .token = kToken,
+               .id = 0x20002000};
+  events[4] = {.type = TraceEventType::kBeginReallocate,
+               .timestamp = 5000,
+               .token = kToken,
+               .id = 0x20003000,
+               .size = 512,
+               .alignment = 16};
+
+  for (const TraceEvent& event : events) {
+    std::array<std::byte, kMaxEncodedTraceEventSize> buffer;
+    pw::StatusWithSize encoded = EncodeTraceEvent(event, buffer);
+    ASSERT_EQ(encoded.status(), pw::OkStatus());
+
+    TraceEvent decoded;
+    pw::StatusWithSize result =
+        DecodeTraceEvent(pw::ConstByteSpan(buffer).first(encoded.size()),
+                         decoded);
+    ASSERT_EQ(result.status(), pw::OkStatus());
+    EXPECT_EQ(result.size(), encoded.size());
+    ExpectEqual(decoded, event);
+  }
+}
+
+TEST(TraceTest, EncodeMaximumValues) {
+  TraceEvent event = {.type = TraceEventType::kReallocate,
+                      .failed = true,
+                      .timestamp = UINT64_MAX,
+                      .token = UINT32_MAX,
+                      .id = UINT64_MAX,
+                      .new_id = UINT64_MAX,
+                      .size = UINT64_MAX,
+                      .alignment = UINT64_MAX};
+  std::array<std::byte, kMaxEncodedTraceEventSize> buffer;
+  pw::StatusWithSize encoded = EncodeTraceEvent(event, buffer);
+  ASSERT_EQ(encoded.status(), pw::OkStatus());
+
+  TraceEvent decoded;
+  ASSERT_EQ(DecodeTraceEvent(buffer, decoded).status(), pw::OkStatus());
+  ExpectEqual(decoded, event);
+}
+
+TEST(TraceTest, EncodeBufferTooSmall) {
+  TraceEvent event = {.type = TraceEventType::kAllocate,
+                      .id = 0x20001000,
+                      .size = 64,
+                      .alignment = 8};
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(EncodeTraceEvent(event, buffer).status(),
+            pw::Status::ResourceExhausted());
+}
+
+TEST(TraceTest, DecodeTruncated) {
+  TraceEvent event = {.type = TraceEventType::kAllocate,
+                      .id = 0x20001000,
+                      .size = 64,
+                      .alignment = 8};
+  std::array<std::byte, kMaxEncodedTraceEventSize> buffer;
+  pw::StatusWithSize encoded = EncodeTraceEvent(event, buffer);
+  ASSERT_EQ(encoded.status(), pw::OkStatus());
+
+  TraceEvent decoded;
+  pw::ConstByteSpan truncated =
+      pw::ConstByteSpan(buffer).first(encoded.size() - 1);
+  EXPECT_EQ(DecodeTraceEvent(truncated, decoded).status(),
+            pw::Status::OutOfRange());
+}
+
+TEST(TraceTest, DecodeInvalidType) {
+  std::array<std::byte, 4> buffer = {
+      std::byte(0x7f), std::byte(0), std::byte(0), std::byte(0)};
+  TraceEvent decoded;
+  EXPECT_EQ(DecodeTraceEvent(buffer, decoded).status(),
+            pw::Status::DataLoss());
+}
+
+TEST(TraceTest, StreamTracerRecordsTrackingAllocator) {
+  pw::allocator::test::AllocatorForTest<256> allocator;
+  TrackingAllocator<AllMetrics> tracker(kToken, allocator);
+  std::array<std::byte, 256> buffer;
+  pw::stream::MemoryWriter writer(buffer);
+  SimulatedSystemClock clock;
+  StreamTracer tracer(writer, clock);
+  tracker.set_tracer(&tracer);
+
+  void* ptr = tracker.Allocate(Layout(16, 4));
+  ASSERT_NE(ptr, nullptr);
+  clock.AdvanceTime(SystemClock::duration(10));
+  EXPECT_TRUE(tracker.Resize(ptr, 32));
+  clock.AdvanceTime(SystemClock::duration(10));
+  EXPECT_EQ(tracker.Allocate(Layout(1024, 4)), nullptr);
+  clock.AdvanceTime(SystemClock::duration(10));
+  tracker.Deallocate(ptr);
+
+  // Requests are not recorded once the tracer is removed.
+  tracker.set_tracer(nullptr);
+  tracker.Deallocate(tracker.Allocate(Layout(16, 4)));
+
+  std::array<TraceEvent, 8> events;
+  ASSERT_EQ(DecodeAll(writer.WrittenData(), events), 4u);
+  EXPECT_EQ(tracer.dropped(), 0u);
+  auto id = reinterpret_cast<uintptr_t>(ptr);
+  ExpectEqual(events[0],
+              {.type = TraceEventType::kAllocate,
+               .timestamp = 0,
+               .token = kToken,
+               .id = id,
+               .size = 16,
+               .alignment = 4});
+  ExpectEqual(events[1],
+              {.type = TraceEventType::kResize,
+               .timestamp = 10,
+               .token = kToken,
+               .id = id,
+               .size = 32});
+  ExpectEqual(events[2],
+              {.type = TraceEventType::kAllocate,
+               .failed = true,
+               .timestamp = 20,
+               .token = kToken,
+               .size = 1024,
+               .alignment = 4});
+  ExpectEqual(events[3],
+              {.type = TraceEventType::kDeallocate,
+               .timestamp = 30,
+               .token = kToken,
+               .id = id});
+}
+
+TEST(TraceTest, StreamTracerCountsDroppedEvents) {
+  pw::allocator::test::AllocatorForTest<256> allocator;
+  TrackingAllocator<AllMetrics> tracker(kToken, allocator);
+  std::array<std::byte, 4> buffer;
+  pw::stream::MemoryWriter writer(buffer);
+  StreamTracer tracer(writer);
+  tracker.set_tracer(&tracer);
+
+  tracker.Deallocate(tracker.Allocate(Layout(16, 4)));
+  EXPECT_EQ(tracer.dropped(), 2u);
+}
+
+TEST(TraceTest, RingBufferTracerKeepsMostRecentEvents) {
+  constexpr size_t kNumEvents = 100;
+  std::array<std::byte, 128> storage;
+  SimulatedSystemClock clock;
+  RingBufferTracer tracer(storage, clock);
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    clock.AdvanceTime(SystemClock::duration(1));
+    tracer.Record({.type = TraceEventType::kDeallocate,
+                   .token = kToken,
+                   .id = 0x1000 + i});
+  }
+  size_t num_retained = tracer.size();
+  EXPECT_GT(num_retained, 0u);
+  EXPECT_LT(num_retained, kNumEvents);
+
+  std::array<std::byte, 256> buffer;
+  pw::stream::MemoryWriter writer(buffer);
+  ASSERT_EQ(tracer.Dump(writer), pw::OkStatus());
+
+  std::array<TraceEvent, kNumEvents> events;
+  ASSERT_EQ(DecodeAll(writer.WrittenData(), events), num_retained);
+  for (size_t i = 0; i < num_retained; ++i) {
+    size_t n = kNumEvents - num_retained + i;
+    EXPECT_EQ(events[i].timestamp, n + 1);
+    EXPECT_EQ(events[i].id, 0x1000 + n);
+  }
+
+  tracer.Clear();
+  EXPECT_EQ(tracer.size(), 0u);
+}
+
+}  // namespace
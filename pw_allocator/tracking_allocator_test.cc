@@ -13,6 +13,7 @@
 // the License.
 #include "pw_allocator/tracking_allocator.h"
 
+#include <array>
 #include <cstdint>
 
 #include "pw_allocator/allocator.h"
@@ -28,6 +29,8 @@ namespace {
 // Test fixtures.
 
 using ::pw::allocator::Layout;
+using ::pw::allocator::TraceEvent;
+using ::pw::allocator::TraceEventType;
 using ::pw::allocator::TrackingAllocator;
 using TestMetrics = ::pw::allocator::internal::AllMetrics;
 
@@ -64,6 +67,51 @@ class TrackingAllocatorTest : public ::testing::Test {
   TrackingAllocatorForTest tracker_;
 };
 
+/// Tracer that stores the events it receives.
+class RecordingTracer : public ::pw::allocator::Tracer {
+ public:
+  size_t size() const { return num_events_; }
+  const TraceEvent& operator[](size_t index) const { return events_[index]; }
+
+ private:
+  void DoRecord(const TraceEvent& event) override {
+    if (num_events_ < events_.size()) {
+      events_[num_events_++] = event;
+    }
+  }
+
+  std::array<TraceEvent, 8> events_;
+  size_t num_events_ = 0;
+};
+
+/// Tracer that checks that memory is still allocated when its deallocation or
+/// reallocation is recorded.
+class DeallocationCheckingTracer : public ::pw::allocator::Tracer {
+ public:
+  using BlockType = ::pw::allocator::FirstFitBlock<uint32_t>;
+
+  size_t num_deallocations() const { return num_deallocations_; }
+  size_t num_recorded_while_allocated() const {
+    return num_recorded_while_allocated_;
+  }
+
+ private:
+  void DoRecord(const TraceEvent& event) override {
+    if (event.type != TraceEventType::kDeallocate &&
+        event.type != TraceEventType::kBeginReallocate) {
+      return;
+    }
+    ++num_deallocations_;
+    auto* ptr = reinterpret_cast<void*>(static_cast<uintptr_t>(event.id));
+    if (!BlockType::FromUsableSpace(ptr)->IsFree()) {
+      ++num_recorded_while_allocated_;
+    }
+  }
+
+  size_t num_deallocations_ = 0;
+  size_t num_recorded_while_allocated_ = 0;
+};
+
 struct ExpectedValues {
 #define INCLUDE_EXPECTED_METRIC(metric_name) uint32_t metric_name = 0
 
@@ -444,4 +492,100 @@ TEST_F(TrackingAllocatorTest, CorrectlyAccountsForShiftedBytes) {
   EXPECT_METRICS_EQ(expected, metrics);
 }
 
+TEST_F(TrackingAllocatorTest, RecordsTraceEvents) {
+  RecordingTracer tracer;
+  tracker_.set_tracer(&tracer);
+
+  constexpr Layout layout1 = Layout::Of<uintptr_t[2]>();
+  void* ptr1 = tracker_.Allocate(layout1);
+  ASSERT_NE(ptr1, nullptr);
+  EXPECT_TRUE(tracker_.Resize(ptr1, sizeof(uintptr_t[3])));
+  void* ptr2 = tracker_.Allocate(layout1);
+  ASSERT_NE(ptr2, nullptr);
+  constexpr Layout layout2 = Layout::Of<uintptr_t[8]>();
+  void* ptr3 = tracker_.Reallocate(ptr1, layout2);
+  ASSERT_NE(ptr3, nullptr);
+  EXPECT_EQ(tracker_.Allocate(Layout(kCapacity, 1)), nullptr);
+  tracker_.Deallocate(ptr2);
+  tracker_.Deallocate(ptr3);
+
+  ASSERT_EQ(tracer.size(), 8u);
+  auto id1 = reinterpret_cast<uintptr_t>(ptr1);
+  auto id2 = reinterpret_cast<uintptr_t>(ptr2);
+  auto id3 = reinterpret_cast<uintptr_t>(ptr3);
+  for (size_t i = 0; i < tracer.size(); ++i) {
+    EXPECT_EQ(tracer[i].token, kToken);
+  }
+
+  EXPECT_EQ(tracer[0].type, TraceEventType::kAllocate);
+  EXPECT_FALSE(tracer[0].failed);
+  EXPECT_EQ(tracer[0].id, id1);
+  EXPECT_EQ(tracer[0].size, layout1.size());
+  EXPECT_EQ(tracer[0].alignment, layout1.alignment());
+
+  EXPECT_EQ(tracer[1].type, TraceEventType::kResize);
+  EXPECT_FALSE(tracer[1].failed);
+  EXPECT_EQ(tracer[1].id, id1);
+  EXPECT_EQ(tracer[1].size, sizeof(uintptr_t[3]));
+
+  EXPECT_EQ(tracer[2].type, TraceEventType::kAllocate);
+  EXPECT_EQ(tracer[2].id, id2);
+
+  EXPECT_EQ(tracer[3].type, TraceEventType::kBeginReallocate);
+  EXPECT_EQ(tracer[3].id, id1);
+  EXPECT_EQ(tracer[3].size, layout2.size());
+  EXPECT_EQ(tracer[3].alignment, layout2.alignment());
+
+  EXPECT_EQ(tracer[4].type, TraceEventType::kReallocate);
+  EXPECT_FALSE(tracer[4].failed);
+  EXPECT_EQ(tracer[4].id, id1);
+  EXPECT_EQ(tracer[4].new_id, id3);
+  EXPECT_EQ(tracer[4].size, layout2.size());
+
+  EXPECT_EQ(tracer[5].type, TraceEventType::kAllocate);
+  EXPECT_TRUE(tracer[5].failed);
+  EXPECT_EQ(tracer[5].id, 0u);
+  EXPECT_EQ(tracer[5].size, kCapacity);
+
+  EXPECT_EQ(tracer[6].type, TraceEventType::kDeallocate);
+  EXPECT_EQ(tracer[6].id, id2);
+  EXPECT_EQ(tracer[7].type, TraceEventType::kDeallocate);
+  EXPECT_EQ(tracer[7].id, id3);
+}
+
+TEST_F(TrackingAllocatorTest, RecordsDeallocationBeforeFreeing) {
+  DeallocationCheckingTracer tracer;
+  tracker_.set_tracer(&tracer);
+
+  void* ptr1 = tracker_.Allocate(Layout::Of<uintptr_t[2]>());
+  ASSERT_NE(ptr1, nullptr);
+  void* ptr2 = tracker_.Allocate(Layout::Of<uintptr_t[4]>());
+  ASSERT_NE(ptr2, nullptr);
+  tracker_.Deallocate(ptr1);
+  tracker_.Deallocate(ptr2);
+
+  EXPECT_EQ(tracer.num_deallocations(), 2u);
+  EXPECT_EQ(tracer.num_recorded_while_allocated(), 2u);
+}
+
+TEST_F(TrackingAllocatorTest, RecordsReallocationBeforeFreeing) {
+  DeallocationCheckingTracer tracer;
+  tracker_.set_tracer(&tracer);
+
+  // The second allocation keeps the first from being resized in place, so
+  // reallocating it frees its memory.
+  void* ptr1 = tracker_.Allocate(Layout::Of<uintptr_t[2]>());
+  ASSERT_NE(ptr1, nullptr);
+  void* ptr2 = tracker_.Allocate(Layout::Of<uintptr_t[2]>());
+  ASSERT_NE(ptr2, nullptr);
+  void* ptr3 = tracker_.Reallocate(ptr1, Layout::Of<uintptr_t[8]>());
+  ASSERT_NE(ptr3, nullptr);
+  EXPECT_NE(ptr3, ptr1);
+  EXPECT_EQ(tracer.num_deallocations(), 1u);
+  EXPECT_EQ(tracer.num_recorded_while_allocated(), 1u);
+
+  tracker_.Deallocate(ptr2);
+  tracker_.Deallocate(ptr3);
+}
+
 }  // namespace
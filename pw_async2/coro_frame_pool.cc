@@ -0,0 +1,67 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/coro_frame_pool.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::async2 {
+
+using pw::allocator::ChunkPool;
+using pw::allocator::Layout;
+
+CoroFramePool::CoroFramePool(span<ChunkPool> pools,
+                             pw::allocator::Allocator& fallback)
+    : pools_(pools), fallback_(fallback) {
+  for (size_t i = 1; i < pools_.size(); ++i) {
+    PW_CHECK_UINT_LT(pools_[i - 1].layout().size(),
+                     pools_[i].layout().size(),
+                     "CoroFramePool pools must be sorted by chunk size");
+  }
+}
+
+void* CoroFramePool::DoAllocate(Layout layout) {
+  for (ChunkPool& pool : pools_) {
+    if (layout.size() > pool.layout().size() ||
+        layout.alignment() > pool.layout().alignment()) {
+      continue;
+    }
+    // Only the smallest pool that fits is used, so that small frames do not
+    // take chunks meant for larger ones.
+    if (void* ptr = pool.Allocate(); ptr != nullptr) {
+      pool_allocations_.Increment();
+      return ptr;
+    }
+    break;
+  }
+  void* ptr = fallback_.Allocate(layout);
+  if (ptr == nullptr) {
+    failed_allocations_.Increment();
+    return nullptr;
+  }
+  fallback_allocations_.Increment();
+  return ptr;
+}
+
+void CoroFramePool::DoDeallocate(void* ptr) {
+  for (ChunkPool& pool : pools_) {
+    if (Recognizes(pool, ptr)) {
+      pool.Deallocate(ptr);
+      return;
+    }
+  }
+  fallback_.Deallocate(ptr);
+}
+
+}  // namespace pw::async2
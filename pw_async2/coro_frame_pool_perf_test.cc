@@ -0,0 +1,115 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures starting and running many short-lived coroutines, with frames
+// allocated either by a general-purpose allocator or by a `CoroFramePool` in
+// front of it.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/best_fit.h"
+#include "pw_allocator/chunk_pool.h"
+#include "pw_async2/coro.h"
+#include "pw_async2/coro_frame_pool.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_status/status.h"
+
+namespace pw::async2 {
+namespace {
+
+using allocator::BestFitAllocator;
+using allocator::ChunkPool;
+using allocator::Layout;
+
+// The number of coroutines that are alive at once.
+constexpr size_t kBatch = 32;
+
+// Two coroutines with different frame sizes, standing in for request handlers.
+Coro<Status> HandleSmallRequest(CoroContext&, uint32_t& sum) {
+  sum += 1;
+  co_return OkStatus();
+}
+
+Coro<Status> HandleLargeRequest(CoroContext&, uint32_t& sum) {
+  std::array<uint32_t, 32> scratch;
+  for (size_t i = 0; i < scratch.size(); ++i) {
+    scratch[i] = sum + static_cast<uint32_t>(i);
+  }
+  sum += scratch[scratch.size() - 1];
+  co_return OkStatus();
+}
+
+class RequestTask : public Task {
+ public:
+  void Start(Coro<Status>&& coro) { coro_ = std::move(coro); }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    if (coro_.Pend(cx).IsPending()) {
+      return Pending();
+    }
+    coro_ = Coro<Status>::Empty();
+    return Ready();
+  }
+
+  Coro<Status> coro_ = Coro<Status>::Empty();
+};
+
+// Starts a batch of coroutines, then runs them all to completion.
+void SpawnBatches(perf_test::State& state, allocator::Allocator& alloc) {
+  CoroContext coro_cx(alloc);
+  Dispatcher dispatcher;
+  std::array<RequestTask, kBatch> tasks;
+  uint32_t sum = 0;
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      tasks[i].Start(i % 4 == 0 ? HandleLargeRequest(coro_cx, sum)
+                                : HandleSmallRequest(coro_cx, sum));
+      dispatcher.Post(tasks[i]);
+    }
+    dispatcher.RunToCompletion();
+  }
+}
+
+alignas(std::max_align_t) std::array<std::byte, 16384> heap_buffer;
+alignas(std::max_align_t) std::array<std::byte, 256 * kBatch> small_frames;
+alignas(std::max_align_t) std::array<std::byte, 512 * kBatch> large_frames;
+
+void GeneralAllocator(perf_test::State& state) {
+  BestFitAllocator<> heap(heap_buffer);
+  SpawnBatches(state, heap);
+}
+
+void FramePool(perf_test::State& state) {
+  BestFitAllocator<> heap(heap_buffer);
+  std::array<ChunkPool, 2> pools = {ChunkPool(small_frames, Layout(256)),
+                                    ChunkPool(large_frames, Layout(512))};
+  CoroFramePool frame_pool(pools, heap);
+  SpawnBatches(state, frame_pool);
+  PW_LOG_INFO("CoroFramePool: %u pool, %u fallback, %u failed allocations",
+              static_cast<unsigned>(frame_pool.pool_allocations()),
+              static_cast<unsigned>(frame_pool.fallback_allocations()),
+              static_cast<unsigned>(frame_pool.failed_allocations()));
+}
+
+PW_PERF_TEST(CoroSpawnGeneralAllocator, GeneralAllocator);
+PW_PERF_TEST(CoroSpawnFramePool, FramePool);
+
+}  // namespace
+}  // namespace pw::async2
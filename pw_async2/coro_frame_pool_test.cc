@@ -0,0 +1,158 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/coro_frame_pool.h"
+
+#include <array>
+#include <cstddef>
+
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/null_allocator.h"
+#include "pw_allocator/testing.h"
+#include "pw_async2/coro.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::OkStatus;
+using ::pw::Status;
+using ::pw::allocator::ChunkPool;
+using ::pw::allocator::GetNullAllocator;
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::AllocatorForTest;
+using ::pw::async2::Context;
+using ::pw::async2::Coro;
+using ::pw::async2::CoroContext;
+using ::pw::async2::CoroFramePool;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+
+constexpr size_t kSmallChunk = 64;
+constexpr size_t kLargeChunk = 512;
+
+class CoroFramePoolTest : public ::testing::Test {
+ protected:
+  CoroFramePoolTest()
+      : pools_{ChunkPool(small_buffer_, Layout(kSmallChunk)),
+               ChunkPool(large_buffer_, Layout(kLargeChunk))},
+        frame_pool_(pools_, fallback_) {}
+
+  alignas(std::max_align_t) std::array<std::byte, kSmallChunk * 2>
+      small_buffer_;
+  alignas(std::max_align_t) std::array<std::byte, kLargeChunk * 2>
+      large_buffer_;
+  AllocatorForTest<1024> fallback_;
+  std::array<ChunkPool, 2> pools_;
+  CoroFramePool frame_pool_;
+};
+
+TEST_F(CoroFramePoolTest, AllocatesFromSmallestPoolThatFits) {
+  void* small = frame_pool_.Allocate(Layout(kSmallChunk));
+  void* large = frame_pool_.Allocate(Layout(kSmallChunk + 1));
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+
+  EXPECT_GE(small, static_cast<void*>(small_buffer_.data()));
+  EXPECT_LT(small, static_cast<void*>(small_buffer_.data() + kSmallChunk * 2));
+  EXPECT_GE(large, static_cast<void*>(large_buffer_.data()));
+  EXPECT_LT(large, static_cast<void*>(large_buffer_.data() + kLargeChunk * 2));
+  EXPECT_EQ(frame_pool_.pool_allocations(), 2u);
+  EXPECT_EQ(frame_pool_.fallback_allocations(), 0u);
+  EXPECT_EQ(fallback_.allocate_size(), 0u);
+
+  frame_pool_.Deallocate(small);
+  frame_pool_.Deallocate(large);
+  EXPECT_EQ(fallback_.deallocate_ptr(), nullptr);
+}
+
+TEST_F(CoroFramePoolTest, FallsBackForOversizedFrames) {
+  void* ptr = frame_pool_.Allocate(Layout(kLargeChunk + 1));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(fallback_.allocate_size(), kLargeChunk + 1);
+  EXPECT_EQ(frame_pool_.pool_allocations(), 0u);
+  EXPECT_EQ(frame_pool_.fallback_allocations(), 1u);
+
+  frame_pool_.Deallocate(ptr);
+  EXPECT_EQ(fallback_.deallocate_ptr(), ptr);
+}
+
+TEST_F(CoroFramePoolTest, FallsBackWhenPoolIsExhausted) {
+  std::array<void*, 3> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = frame_pool_.Allocate(Layout(kSmallChunk));
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(frame_pool_.pool_allocations(), 2u);
+  EXPECT_EQ(frame_pool_.fallback_allocations(), 1u);
+  EXPECT_EQ(fallback_.allocate_size(), kSmallChunk);
+
+  for (void* ptr : ptrs) {
+    frame_pool_.Deallocate(ptr);
+  }
+  EXPECT_EQ(fallback_.deallocate_ptr(), ptrs[2]);
+}
+
+TEST(CoroFramePool, CountsFailedAllocations) {
+  std::array<std::byte, kSmallChunk> buffer;
+  std::array<ChunkPool, 1> pools = {ChunkPool(buffer, Layout(kSmallChunk))};
+  CoroFramePool frame_pool(pools, GetNullAllocator());
+
+  EXPECT_EQ(frame_pool.Allocate(Layout(kSmallChunk + 1)), nullptr);
+  EXPECT_EQ(frame_pool.failed_allocations(), 1u);
+}
+
+Coro<Status> AddOne(CoroContext&, int& value) {
+  value += 1;
+  co_return OkStatus();
+}
+
+class CoroTask final : public Task {
+ public:
+  CoroTask(Coro<Status>&& coro) : coro_(std::move(coro)) {}
+
+ private:
+  Poll<> DoPend(Context& cx) final {
+    if (coro_.Pend(cx).IsPending()) {
+      return Pending();
+    }
+    return Ready();
+  }
+
+  Coro<Status> coro_;
+};
+
+TEST_F(CoroFramePoolTest, ServesCoroutineFrames) {
+  CoroContext coro_cx(frame_pool_);
+  Dispatcher dispatcher;
+  int value = 0;
+
+  // Start more coroutines than the pools have chunks, one at a time, to show
+  // that completed frames are returned to their pool.
+  for (int i = 0; i < 5; ++i) {
+    CoroTask task(AddOne(coro_cx, value));
+    dispatcher.Post(task);
+    EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  }
+
+  EXPECT_EQ(value, 5);
+  EXPECT_EQ(frame_pool_.pool_allocations(), 5u);
+  EXPECT_EQ(frame_pool_.fallback_allocations(), 0u);
+}
+
+}  // namespace
@@ -14,6 +14,7 @@
 
 #include "pw_async2/dispatcher_base.h"
 
+#include <array>
 #include <iterator>
 #include <mutex>
 
@@ -24,9 +25,28 @@
 #define PW_LOG_LEVEL PW_ASYNC2_CONFIG_LOG_LEVEL
 
 #include "pw_log/log.h"
+#include "pw_toolchain/no_destructor.h"
 
 namespace pw::async2 {
 
+namespace impl {
+
+DispatcherLock& AssignDispatcherLock() {
+  static NoDestructor<
+      std::array<DispatcherLock, PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT>>
+      locks;
+  static size_t next_lock = 0;
+
+  // Guard the counter with one of the locks rather than making it atomic, as
+  // not every target supports atomic read-modify-write operations.
+  std::lock_guard lock((*locks)[0]);
+  DispatcherLock& assigned = (*locks)[next_lock];
+  next_lock = (next_lock + 1) % locks->size();
+  return assigned;
+}
+
+}  // namespace impl
+
 void Context::ReEnqueue() {
   Waker waker;
   waker_->InternalCloneInto(waker);
@@ -46,6 +66,8 @@ void Task::RemoveAllWakersLocked() {
 }
 
 void Task::AddWakerLocked(Waker& waker) {
+  PW_DASSERT(waker.lock_.load(std::memory_order_relaxed) ==
+             lock_.load(std::memory_order_relaxed));
   waker.task_ = this;
   wakers_.push_front(waker);
 }
@@ -56,20 +78,28 @@ void Task::RemoveWakerLocked(Waker& waker) {
 }
 
 bool Task::IsRegistered() const {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (lock_.load(std::memory_order_acquire) == nullptr) {
+    return false;  // Never posted.
+  }
+  impl::DispatcherLockGuard lock(lock_);
   return state_ != Task::State::kUnposted;
 }
 
 void Task::Deregister() {
+  if (lock_.load(std::memory_order_acquire) == nullptr) {
+    return;  // Never posted.
+  }
+  NativeDispatcherBase* dispatcher;
   pw::sync::Mutex* task_execution_lock;
   {
     // Fast path: the task is not running.
-    std::lock_guard lock(impl::dispatcher_lock());
+    impl::DispatcherLockGuard lock(lock_);
     if (TryDeregister()) {
       return;
     }
     // The task was running, so we have to wait for the task to stop being
     // run by acquiring the `task_lock`.
+    dispatcher = dispatcher_;
     task_execution_lock = &dispatcher_->task_execution_lock_;
   }
 
@@ -77,9 +107,20 @@ void Task::Deregister() {
   // invalidated by concurrent destruction of the dispatcher.
   //
   // This restriction is documented above, but is still fairly footgun-y.
-  std::lock_guard task_lock(*task_execution_lock);
-  std::lock_guard lock(impl::dispatcher_lock());
-  PW_CHECK(TryDeregister());
+  //
+  // Dispatchers that run tasks on several threads poll them without holding
+  // the task execution lock, so retry until the task is between polls,
+  // letting the dispatcher wait between attempts.
+  while (true) {
+    {
+      std::lock_guard task_lock(*task_execution_lock);
+      impl::DispatcherLockGuard lock(lock_);
+      if (TryDeregister()) {
+        return;
+      }
+    }
+    dispatcher->DoWaitForRunningTask();
+  }
 }
 
 bool Task::TryDeregister() {
@@ -90,9 +131,10 @@ bool Task::TryDeregister() {
       dispatcher_->RemoveSleepingTaskLocked(*this);
       break;
     case Task::State::kRunning:
+    case Task::State::kWokenWhileRunning:
       return false;
     case Task::State::kWoken:
-      dispatcher_->RemoveWokenTaskLocked(*this);
+      dispatcher_->DoRemoveWokenTask(*this);
       break;
   }
   state_ = Task::State::kUnposted;
@@ -100,16 +142,25 @@ bool Task::TryDeregister() {
 
   // Wake the dispatcher up if this was the last task so that it can see that
   // all tasks have completed.
-  if (dispatcher_->first_woken_ == nullptr &&
-      dispatcher_->sleeping_ == nullptr && dispatcher_->wants_wake_) {
-    dispatcher_->Wake();
+  if (dispatcher_->woken_.empty() && dispatcher_->sleeping_ == nullptr) {
+    dispatcher_->WakeIfRequestedLocked();
   }
   dispatcher_ = nullptr;
   return true;
 }
 
+Waker::Waker(Task& task) : lock_(task.lock_.load(std::memory_order_relaxed)) {
+  impl::DispatcherLockGuard lock(lock_);
+  task.AddWakerLocked(*this);
+}
+
 Waker::Waker(Waker&& other) noexcept {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (other.lock_.load(std::memory_order_acquire) == nullptr) {
+    return;
+  }
+  impl::DispatcherLockGuard lock(other.lock_);
+  lock_.store(other.lock_.load(std::memory_order_relaxed),
+              std::memory_order_relaxed);
   if (other.task_ == nullptr) {
     return;
   }
@@ -119,8 +170,20 @@ Waker::Waker(Waker&& other) noexcept {
 }
 
 Waker& Waker::operator=(Waker&& other) noexcept {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (this == &other) {
+    return *this;
+  }
+  // This waker and `other` may belong to tasks on dispatchers with different
+  // locks. Hold both so that the move appears atomic to concurrent calls to
+  // `Wake`.
+  impl::DispatcherLockPairGuard lock(lock_, other.lock_);
   RemoveFromTaskWakerListLocked();
+  impl::DispatcherLock* other_lock =
+      other.lock_.load(std::memory_order_relaxed);
+  if (other_lock == nullptr) {
+    return *this;
+  }
+  lock_.store(other_lock, std::memory_order_release);
   if (other.task_ == nullptr) {
     return *this;
   }
@@ -131,7 +194,10 @@ Waker& Waker::operator=(Waker&& other) noexcept {
 }
 
 void Waker::Wake() && {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (lock_.load(std::memory_order_acquire) == nullptr) {
+    return;
+  }
+  impl::DispatcherLockGuard lock(lock_);
   if (task_ != nullptr) {
     task_->dispatcher_->WakeTask(*task_);
     RemoveFromTaskWakerListLocked();
@@ -139,38 +205,39 @@ void Waker::Wake() && {
 }
 
 void Waker::InternalCloneInto(Waker& out) & {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (&out == this) {
+    return;
+  }
+  // `out` may belong to a task on a dispatcher with a different lock. Hold
+  // both so that the clone appears atomic to concurrent calls to `Wake`.
+  impl::DispatcherLockPairGuard lock(lock_, out.lock_);
   // The `out` waker already points to this task, so no work is necessary.
   if (out.task_ == task_) {
     return;
   }
   // Remove the output waker from its existing task's list.
   out.RemoveFromTaskWakerListLocked();
-  out.task_ = task_;
   // Only add if the waker being cloned is actually associated with a task.
   if (task_ != nullptr) {
+    out.lock_.store(lock_.load(std::memory_order_relaxed),
+                    std::memory_order_release);
     task_->AddWakerLocked(out);
   }
 }
 
 bool Waker::IsEmpty() const {
-  std::lock_guard lock(impl::dispatcher_lock());
-  return task_ == nullptr;
-}
-
-void Waker::InsertIntoTaskWakerList() {
-  std::lock_guard lock(impl::dispatcher_lock());
-  InsertIntoTaskWakerListLocked();
-}
-
-void Waker::InsertIntoTaskWakerListLocked() {
-  if (task_ != nullptr) {
-    task_->AddWakerLocked(*this);
+  if (lock_.load(std::memory_order_acquire) == nullptr) {
+    return true;
   }
+  impl::DispatcherLockGuard lock(lock_);
+  return task_ == nullptr;
 }
 
 void Waker::RemoveFromTaskWakerList() {
-  std::lock_guard lock(impl::dispatcher_lock());
+  if (lock_.load(std::memory_order_acquire) == nullptr) {
+    return;
+  }
+  impl::DispatcherLockGuard lock(lock_);
   RemoveFromTaskWakerListLocked();
 }
 
@@ -181,23 +248,34 @@ void Waker::RemoveFromTaskWakerListLocked() {
 }
 
 void NativeDispatcherBase::Deregister() {
-  std::lock_guard lock(impl::dispatcher_lock());
-  UnpostTaskList(first_woken_);
-  first_woken_ = nullptr;
-  last_woken_ = nullptr;
+  impl::DispatcherLockGuard lock(lock_);
+  UnpostTaskList(woken_.front());
+  woken_ = TaskQueue();
   UnpostTaskList(sleeping_);
   sleeping_ = nullptr;
 }
 
 void NativeDispatcherBase::Post(Task& task) {
+  // The task is not registered, so its lock only guards it against
+  // concurrent calls to `IsRegistered` and `Deregister`. Switch it to this
+  // dispatcher's lock while holding its previous one.
+  if (impl::DispatcherLock* previous_lock =
+          task.lock_.load(std::memory_order_relaxed);
+      previous_lock == nullptr) {
+    task.lock_.store(&lock_, std::memory_order_release);
+  } else if (previous_lock != &lock_) {
+    impl::DispatcherLockGuard lock(*previous_lock);
+    task.lock_.store(&lock_, std::memory_order_release);
+  }
+
   bool wake_dispatcher = false;
   {
-    std::lock_guard lock(impl::dispatcher_lock());
+    impl::DispatcherLockGuard lock(lock_);
     PW_DASSERT(task.state_ == Task::State::kUnposted);
     PW_DASSERT(task.dispatcher_ == nullptr);
     task.state_ = Task::State::kWoken;
     task.dispatcher_ = this;
-    AddTaskToWokenList(task);
+    DoEnqueueWokenTask(task);
     if (wants_wake_) {
       wake_dispatcher = true;
       wants_wake_ = false;
@@ -213,9 +291,14 @@ void NativeDispatcherBase::Post(Task& task) {
 
 NativeDispatcherBase::SleepInfo NativeDispatcherBase::AttemptRequestWake(
     bool allow_empty) {
-  std::lock_guard lock(impl::dispatcher_lock());
+  impl::DispatcherLockGuard lock(lock_);
+  return AttemptRequestWakeLocked(allow_empty);
+}
+
+NativeDispatcherBase::SleepInfo NativeDispatcherBase::AttemptRequestWakeLocked(
+    bool allow_empty) {
   // Don't allow sleeping if there are already tasks waiting to be run.
-  if (first_woken_ != nullptr) {
+  if (!woken_.empty()) {
     PW_LOG_DEBUG("Dispatcher will not sleep due to nonempty task queue");
     return SleepInfo::DontSleep();
   }
@@ -236,84 +319,98 @@ NativeDispatcherBase::RunOneTaskResult NativeDispatcherBase::RunOneTask(
   std::lock_guard task_lock(task_execution_lock_);
   Task* task;
   {
-    std::lock_guard lock(impl::dispatcher_lock());
-    task = PopWokenTask();
+    impl::DispatcherLockGuard lock(lock_);
+    task = woken_.pop_front();
     if (task == nullptr) {
       PW_LOG_DEBUG("Dispatcher has no woken tasks to run");
-      bool all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
+      bool all_complete = woken_.empty() && sleeping_ == nullptr;
       return RunOneTaskResult(
           /*completed_all_tasks=*/all_complete,
           /*completed_main_task=*/false,
           /*ran_a_task=*/false);
     }
-    task->state_ = Task::State::kRunning;
+    StartRunningTaskLocked(*task);
   }
+  return RunTask(dispatcher, *task, task_to_look_for);
+}
+
+void NativeDispatcherBase::StartRunningTaskLocked(Task& task) {
+  PW_DASSERT(task.state_ == Task::State::kWoken);
+  task.state_ = Task::State::kRunning;
+  tasks_polled_.Increment();
+}
 
+NativeDispatcherBase::RunOneTaskResult NativeDispatcherBase::RunTask(
+    Dispatcher& dispatcher, Task& task, Task* task_to_look_for) {
   bool complete;
   bool requires_waker;
   {
-    Waker waker(*task);
+    Waker waker(task);
     Context context(dispatcher, waker);
-    tasks_polled_.Increment();
-    complete = task->Pend(context).IsReady();
+    complete = task.Pend(context).IsReady();
     requires_waker = context.requires_waker_;
   }
   if (complete) {
-    tasks_completed_.Increment();
     bool all_complete;
     {
-      std::lock_guard lock(impl::dispatcher_lock());
-      switch (task->state_) {
+      impl::DispatcherLockGuard lock(lock_);
+      switch (task.state_) {
         case Task::State::kUnposted:
+        case Task::State::kWoken:
         case Task::State::kSleeping:
           PW_DASSERT(false);
           PW_UNREACHABLE;
         case Task::State::kRunning:
-          break;
-        case Task::State::kWoken:
-          RemoveWokenTaskLocked(*task);
+        case Task::State::kWokenWhileRunning:
           break;
       }
-      task->state_ = Task::State::kUnposted;
-      task->dispatcher_ = nullptr;
-      task->RemoveAllWakersLocked();
-      all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
+      tasks_completed_.Increment();
+      task.state_ = Task::State::kUnposted;
+      task.dispatcher_ = nullptr;
+      task.RemoveAllWakersLocked();
+      all_complete = woken_.empty() && sleeping_ == nullptr;
     }
-    task->DoDestroy();
+    task.DoDestroy();
     return RunOneTaskResult(
         /*completed_all_tasks=*/all_complete,
-        /*completed_main_task=*/task == task_to_look_for,
+        /*completed_main_task=*/&task == task_to_look_for,
         /*ran_a_task=*/true);
-  } else {
-    std::lock_guard lock(impl::dispatcher_lock());
-    if (task->state_ == Task::State::kRunning) {
-      PW_LOG_DEBUG("Dispatcher adding task %p to sleep queue",
-                   static_cast<const void*>(task));
-
-      if (requires_waker) {
-        PW_CHECK(!task->wakers_.empty(),
-                 "Task %p returned Pending() without registering a waker",
-                 static_cast<const void*>(task));
-        task->state_ = Task::State::kSleeping;
-        AddTaskToSleepingList(*task);
-      } else {
-        // Require the task to be manually re-posted.
-        task->state_ = Task::State::kUnposted;
-        task->dispatcher_ = nullptr;
-      }
+  }
+
+  impl::DispatcherLockGuard lock(lock_);
+  if (task.state_ == Task::State::kWokenWhileRunning) {
+    task.state_ = Task::State::kWoken;
+    DoEnqueueWokenTask(task);
+  } else if (task.state_ == Task::State::kRunning) {
+    PW_LOG_DEBUG("Dispatcher adding task %p to sleep queue",
+                 static_cast<const void*>(&task));
+
+    if (requires_waker) {
+      PW_CHECK(!task.wakers_.empty(),
+               "Task %p returned Pending() without registering a waker",
+               static_cast<const void*>(&task));
+      task.state_ = Task::State::kSleeping;
+      AddTaskToSleepingList(task);
+    } else {
+      // Require the task to be manually re-posted.
+      task.state_ = Task::State::kUnposted;
+      task.dispatcher_ = nullptr;
     }
-    return RunOneTaskResult(
-        /*completed_all_tasks=*/false,
-        /*completed_main_task=*/false,
-        /*ran_a_task=*/true);
   }
+  return RunOneTaskResult(
+      /*completed_all_tasks=*/false,
+      /*completed_main_task=*/false,
+      /*ran_a_task=*/true);
 }
 
+Task* NativeDispatcherBase::PopWokenTaskLocked() { return woken_.pop_front(); }
+
 void NativeDispatcherBase::UnpostTaskList(Task* task) {
   while (task != nullptr) {
     task->state_ = Task::State::kUnposted;
     task->dispatcher_ = nullptr;
     task->prev_ = nullptr;
+    task->queue_ = nullptr;
     Task* next = task->next_;
     task->next_ = nullptr;
     task->RemoveAllWakersLocked();
@@ -332,16 +429,6 @@ void NativeDispatcherBase::RemoveTaskFromList(Task& task) {
   task.next_ = nullptr;
 }
 
-void NativeDispatcherBase::RemoveWokenTaskLocked(Task& task) {
-  if (first_woken_ == &task) {
-    first_woken_ = task.next_;
-  }
-  if (last_woken_ == &task) {
-    last_woken_ = task.prev_;
-  }
-  RemoveTaskFromList(task);
-}
-
 void NativeDispatcherBase::RemoveSleepingTaskLocked(Task& task) {
   if (sleeping_ == &task) {
     sleeping_ = task.next_;
@@ -349,16 +436,59 @@ void NativeDispatcherBase::RemoveSleepingTaskLocked(Task& task) {
   RemoveTaskFromList(task);
 }
 
-void NativeDispatcherBase::AddTaskToWokenList(Task& task) {
-  if (first_woken_ == nullptr) {
-    first_woken_ = &task;
+namespace impl {
+
+void TaskQueue::push_back(Task& task) {
+  if (first_ == nullptr) {
+    first_ = &task;
   } else {
-    last_woken_->next_ = &task;
-    task.prev_ = last_woken_;
+    last_->next_ = &task;
+    task.prev_ = last_;
   }
-  last_woken_ = &task;
+  last_ = &task;
+  task.queue_ = this;
+  size_ += 1;
 }
 
+Task* TaskQueue::pop_front() {
+  if (first_ == nullptr) {
+    return nullptr;
+  }
+  Task& task = *first_;
+  if (task.next_ != nullptr) {
+    task.next_->prev_ = nullptr;
+  } else {
+    last_ = nullptr;
+  }
+  first_ = task.next_;
+  task.prev_ = nullptr;
+  task.next_ = nullptr;
+  task.queue_ = nullptr;
+  size_ -= 1;
+  return &task;
+}
+
+void TaskQueue::remove(Task& task) {
+  if (first_ == &task) {
+    first_ = task.next_;
+  }
+  if (last_ == &task) {
+    last_ = task.prev_;
+  }
+  if (task.prev_ != nullptr) {
+    task.prev_->next_ = task.next_;
+  }
+  if (task.next_ != nullptr) {
+    task.next_->prev_ = task.prev_;
+  }
+  task.prev_ = nullptr;
+  task.next_ = nullptr;
+  task.queue_ = nullptr;
+  size_ -= 1;
+}
+
+}  // namespace impl
+
 void NativeDispatcherBase::AddTaskToSleepingList(Task& task) {
   if (sleeping_ != nullptr) {
     sleeping_->prev_ = &task;
@@ -368,59 +498,50 @@ void NativeDispatcherBase::AddTaskToSleepingList(Task& task) {
 }
 
 void NativeDispatcherBase::WakeTask(Task& task) {
+  PW_DASSERT(task.lock_.load(std::memory_order_relaxed) == &lock_);
   PW_LOG_DEBUG("Dispatcher waking task %p", static_cast<const void*>(&task));
 
   switch (task.state_) {
     case Task::State::kWoken:
+    case Task::State::kWokenWhileRunning:
       // Do nothing-- this has already been woken.
       return;
     case Task::State::kUnposted:
       // This should be unreachable.
       PW_CHECK(false);
     case Task::State::kRunning:
-      // Wake again to indicate that this task should be run once more,
-      // as the state of the world may have changed since the task
-      // started running.
-      break;
+      // Run the task once more when its current ``Pend`` returns, as the state
+      // of the world may have changed since the task started running.
+      task.state_ = Task::State::kWokenWhileRunning;
+      return;
     case Task::State::kSleeping:
       RemoveSleepingTaskLocked(task);
       // Wake away!
       break;
   }
   task.state_ = Task::State::kWoken;
-  AddTaskToWokenList(task);
-  if (wants_wake_) {
-    // Note: it's quite annoying to make this call under the lock, as it can
-    // result in extra thread wakeup/sleep cycles.
-    //
-    // However, releasing the lock first would allow for the possibility that
-    // the ``Dispatcher`` has been destroyed, making the call invalid.
-    Wake();
-  }
+  DoEnqueueWokenTask(task);
+  // Note: it's quite annoying to make this call under the lock, as it can
+  // result in extra thread wakeup/sleep cycles.
+  //
+  // However, releasing the lock first would allow for the possibility that
+  // the ``Dispatcher`` has been destroyed, making the call invalid.
+  WakeIfRequestedLocked();
 }
 
-Task* NativeDispatcherBase::PopWokenTask() {
-  if (first_woken_ == nullptr) {
-    return nullptr;
-  }
-  Task& task = *first_woken_;
-  if (task.next_ != nullptr) {
-    task.next_->prev_ = nullptr;
-  } else {
-    last_woken_ = nullptr;
+void NativeDispatcherBase::WakeIfRequestedLocked() {
+  if (wants_wake_) {
+    wants_wake_ = false;
+    Wake();
   }
-  first_woken_ = task.next_;
-  task.prev_ = nullptr;
-  task.next_ = nullptr;
-  return &task;
 }
 
 void NativeDispatcherBase::LogRegisteredTasks() {
   PW_LOG_INFO("pw::async2::Dispatcher");
-  std::lock_guard lock(impl::dispatcher_lock());
+  impl::DispatcherLockGuard lock(lock_);
 
   PW_LOG_INFO("Woken tasks:");
-  for (Task* task = first_woken_; task != nullptr; task = task->next_) {
+  for (Task* task = woken_.front(); task != nullptr; task = task->next_) {
     PW_LOG_INFO("  - Task %p", static_cast<const void*>(task));
   }
   PW_LOG_INFO("Sleeping tasks:");
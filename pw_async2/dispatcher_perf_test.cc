@@ -0,0 +1,191 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures Dispatcher throughput for a few workloads. The workloads only use
+// the portable Dispatcher API, so the same test can be built with each
+// dispatcher backend to compare them.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::async2 {
+namespace {
+
+constexpr size_t kTasks = 64;
+
+// Spins for a while to stand in for the work a task does each time it runs.
+uint32_t Work(uint32_t seed, size_t iterations) {
+  uint32_t value = seed;
+  for (size_t i = 0; i < iterations; ++i) {
+    value = value * 1664525u + 1013904223u;
+  }
+  return value;
+}
+
+// Does some work each time it is polled and re-enqueues itself until it has
+// been polled `polls` times. The tasks are independent, so a dispatcher that
+// polls tasks on several threads can run them in parallel.
+class ComputeTask : public Task {
+ public:
+  void Reset(int polls, size_t work_per_poll) {
+    polls_left_ = polls;
+    work_per_poll_ = work_per_poll;
+  }
+
+  uint32_t result() const { return result_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    result_ = Work(result_, work_per_poll_);
+    if (--polls_left_ == 0) {
+      return Ready();
+    }
+    cx.ReEnqueue();
+    return Pending();
+  }
+
+  int polls_left_ = 0;
+  size_t work_per_poll_ = 0;
+  uint32_t result_ = 1;
+};
+
+void ComputeBound(perf_test::State& state, size_t work_per_poll) {
+  constexpr int kPollsPerTask = 16;
+  Dispatcher dispatcher;
+  std::array<ComputeTask, kTasks> tasks;
+
+  while (state.KeepRunning()) {
+    for (ComputeTask& task : tasks) {
+      task.Reset(kPollsPerTask, work_per_poll);
+      dispatcher.Post(task);
+    }
+    dispatcher.RunToCompletion();
+  }
+}
+
+// Passes a token around a ring of tasks. Each task wakes the next, so only one
+// task can make progress at a time; this measures the cost of a wakeup.
+class RingTask : public Task {
+ public:
+  void Reset(RingTask& next, int rounds) {
+    next_ = &next;
+    rounds_left_ = rounds;
+    has_token_ = false;
+  }
+
+  void GiveToken() {
+    has_token_ = true;
+    std::move(waker_).Wake();
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    // Store the waker before checking for the token, so that a token given in
+    // between is not missed.
+    PW_ASYNC_STORE_WAKER(cx, waker_, "RingTask is waiting for the token");
+    if (!has_token_.exchange(false)) {
+      return Pending();
+    }
+    rounds_left_ -= 1;
+    if (next_->rounds_left_ > 0) {
+      next_->GiveToken();
+    }
+    return rounds_left_ == 0 ? Ready() : Pending();
+  }
+
+  RingTask* next_ = nullptr;
+  std::atomic<int> rounds_left_ = 0;
+  std::atomic<bool> has_token_ = false;
+  Waker waker_;
+};
+
+using Ring = std::array<RingTask, kTasks>;
+
+void RunRing(Dispatcher& dispatcher, Ring& tasks) {
+  constexpr int kRounds = 16;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    tasks[i].Reset(tasks[(i + 1) % tasks.size()], kRounds);
+    dispatcher.Post(tasks[i]);
+  }
+  tasks[0].GiveToken();
+  dispatcher.RunToCompletion();
+}
+
+void WakeRing(perf_test::State& state) {
+  Dispatcher dispatcher;
+  Ring tasks;
+
+  while (state.KeepRunning()) {
+    RunRing(dispatcher, tasks);
+  }
+}
+
+// Runs a ring on each of several dispatchers at once, one per thread. The
+// dispatchers share no tasks, so any slowdown relative to `WakeRing` comes
+// from contention on state shared between dispatchers, such as their locks.
+void IndependentWakeRings(perf_test::State& state) {
+  constexpr size_t kThreads = 4;
+  struct DispatcherAndRing {
+    Dispatcher dispatcher;
+    Ring tasks;
+  };
+  std::array<DispatcherAndRing, kThreads> rings;
+
+  while (state.KeepRunning()) {
+    std::array<Thread, kThreads> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+      threads[i] = Thread(thread::stl::Options(), [ring = &rings[i]] {
+        RunRing(ring->dispatcher, ring->tasks);
+      });
+    }
+    for (Thread& thread : threads) {
+      thread.join();
+    }
+  }
+}
+
+// Completes the first time it is polled; measures per-task overhead.
+class NoopTask : public Task {
+ private:
+  Poll<> DoPend(Context&) override { return Ready(); }
+};
+
+void PostAndComplete(perf_test::State& state) {
+  Dispatcher dispatcher;
+  std::array<NoopTask, 1024> tasks;
+
+  while (state.KeepRunning()) {
+    for (NoopTask& task : tasks) {
+      dispatcher.Post(task);
+    }
+    dispatcher.RunToCompletion();
+  }
+}
+
+PW_PERF_TEST(DispatcherComputeBoundLight, ComputeBound, 100);
+PW_PERF_TEST(DispatcherComputeBoundHeavy, ComputeBound, 10000);
+PW_PERF_TEST(DispatcherWakeRing, WakeRing);
+PW_PERF_TEST(DispatcherIndependentWakeRings, IndependentWakeRings);
+PW_PERF_TEST(DispatcherPostAndComplete, PostAndComplete);
+
+}  // namespace
+}  // namespace pw::async2
@@ -13,6 +13,7 @@
 // the License.
 
 #include <atomic>
+#include <utility>
 
 #include "pw_async2/dispatcher.h"
 #include "pw_function/function.h"
@@ -68,5 +69,127 @@ TEST(Dispatcher, RunToCompletion_SleepsUntilWoken) {
   EXPECT_EQ(dispatcher.tasks_polled(), 2u);
 }
 
+// Takes turns with a peer task, which may be on another dispatcher.
+class PingPongTask : public Task {
+ public:
+  explicit PingPongTask(int rounds) : rounds_left_(rounds) {}
+
+  void set_peer(PingPongTask& peer) { peer_ = &peer; }
+
+  void GiveTurn() {
+    has_turn_ = true;
+    std::move(waker_).Wake();
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    PW_ASYNC_STORE_WAKER(cx, waker_, "PingPongTask is waiting for its turn");
+    if (!has_turn_.exchange(false)) {
+      return Pending();
+    }
+    rounds_left_ -= 1;
+    peer_->GiveTurn();
+    return rounds_left_ == 0 ? Ready() : Pending();
+  }
+
+  PingPongTask* peer_ = nullptr;
+  int rounds_left_;
+  std::atomic_bool has_turn_ = false;
+  Waker waker_;
+};
+
+TEST(Dispatcher, RunToCompletion_WakesTasksOnOtherDispatchers) {
+  constexpr int kRounds = 1000;
+  Dispatcher dispatcher_a;
+  Dispatcher dispatcher_b;
+  PingPongTask task_a(kRounds);
+  PingPongTask task_b(kRounds);
+  task_a.set_peer(task_b);
+  task_b.set_peer(task_a);
+  dispatcher_a.Post(task_a);
+  dispatcher_b.Post(task_b);
+  task_a.GiveTurn();
+
+  Thread thread_b(thread::stl::Options(),
+                  [&dispatcher_b]() { dispatcher_b.RunToCompletion(); });
+  dispatcher_a.RunToCompletion();
+  thread_b.join();
+
+  EXPECT_FALSE(task_a.IsRegistered());
+  EXPECT_FALSE(task_b.IsRegistered());
+  EXPECT_EQ(dispatcher_a.tasks_completed(), 1u);
+  EXPECT_EQ(dispatcher_b.tasks_completed(), 1u);
+}
+
+TEST(Dispatcher, Post_TaskCanMoveBetweenDispatchers) {
+  MockTask task;
+  task.should_complete = true;
+  Dispatcher dispatcher_a;
+  Dispatcher dispatcher_b;
+
+  dispatcher_a.Post(task);
+  EXPECT_TRUE(task.IsRegistered());
+  task.Deregister();
+  EXPECT_FALSE(task.IsRegistered());
+
+  dispatcher_b.Post(task);
+  EXPECT_TRUE(task.IsRegistered());
+  dispatcher_b.RunToCompletion();
+  EXPECT_FALSE(task.IsRegistered());
+  EXPECT_EQ(dispatcher_a.tasks_polled(), 0u);
+  EXPECT_EQ(dispatcher_b.tasks_polled(), 1u);
+}
+
+TEST(Waker, MoveAndCloneWhileWaking) {
+  constexpr int kIterations = 10000;
+  Dispatcher dispatcher_a;
+  Dispatcher dispatcher_b;
+  MockTask task_a;
+  MockTask task_b;
+  dispatcher_a.Post(task_a);
+  dispatcher_b.Post(task_b);
+
+  // Poll each task once so that it stores a waker.
+  EXPECT_TRUE(dispatcher_a.RunUntilStalled().IsPending());
+  EXPECT_TRUE(dispatcher_b.RunUntilStalled().IsPending());
+
+  // Repeatedly wake a waker that is moved and cloned between the two tasks,
+  // whose dispatchers may have different locks.
+  struct {
+    Waker shared;
+    std::atomic_bool done = false;
+  } state;
+  Thread wake_thread(thread::stl::Options(), [&state]() {
+    while (!state.done.load(std::memory_order_relaxed)) {
+      std::move(state.shared).Wake();
+    }
+  });
+
+  for (int i = 0; i < kIterations; ++i) {
+    if (i % 2 == 0) {
+      PW_ASYNC_CLONE_WAKER(
+          task_a.last_waker, state.shared, "Test clones a waker");
+    } else {
+      Waker waker;
+      PW_ASYNC_CLONE_WAKER(task_b.last_waker, waker, "Test clones a waker");
+      state.shared = std::move(waker);
+    }
+  }
+
+  state.done.store(true, std::memory_order_relaxed);
+  wake_thread.join();
+  std::move(state.shared).Wake();
+  EXPECT_TRUE(state.shared.IsEmpty());
+
+  task_a.should_complete = true;
+  task_b.should_complete = true;
+  std::move(task_a.last_waker).Wake();
+  std::move(task_b.last_waker).Wake();
+  EXPECT_TRUE(dispatcher_a.RunUntilStalled().IsReady());
+  EXPECT_TRUE(dispatcher_b.RunUntilStalled().IsReady());
+  EXPECT_EQ(task_a.destroyed, 1);
+  EXPECT_EQ(task_b.destroyed, 1);
+}
+
 }  // namespace
 }  // namespace pw::async2
@@ -0,0 +1,100 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/layout.h"
+#include "pw_metric/metric.h"
+#include "pw_span/span.h"
+
+namespace pw::async2 {
+
+/// An allocator for coroutine frames which serves each frame from a pool of
+/// fixed-size chunks.
+///
+/// Every call to a given coroutine function allocates a frame of the same size,
+/// so code that starts many short-lived coroutines allocates and frees the same
+/// few sizes over and over. A ``CoroFramePool`` serves each frame from the
+/// smallest of its ``ChunkPool`` s that fits it, which takes constant time and
+/// does not fragment memory. Frames that are larger than every pool, or whose
+/// pool is exhausted, are allocated from a fallback allocator instead.
+///
+/// Use a ``CoroFramePool`` by passing it to a ``CoroContext``:
+///
+/// @code{.cpp}
+///   std::array<std::byte, 4096> small_frames;
+///   std::array<std::byte, 4096> large_frames;
+///   std::array<pw::allocator::ChunkPool, 2> pools = {
+///       pw::allocator::ChunkPool(small_frames, pw::allocator::Layout(128)),
+///       pw::allocator::ChunkPool(large_frames, pw::allocator::Layout(512)),
+///   };
+///   pw::async2::CoroFramePool frame_pool(pools, fallback_allocator);
+///   pw::async2::CoroContext coro_cx(frame_pool);
+/// @endcode
+///
+/// ``CoroFramePool`` is not thread-safe. If coroutines are created or
+/// destroyed on more than one thread, wrap it in a
+/// ``pw::allocator::SynchronizedAllocator``.
+class CoroFramePool final : public pw::allocator::Allocator {
+ public:
+  /// Creates a ``CoroFramePool``.
+  ///
+  /// @param[in]  pools     The pools to serve frames from, in increasing order
+  ///                       of chunk size. Each must be used only by this
+  ///                       ``CoroFramePool``.
+  /// @param[in]  fallback  Allocator for frames that no pool can serve. Must
+  ///                       not recognize pointers from any of ``pools``.
+  CoroFramePool(span<pw::allocator::ChunkPool> pools,
+                pw::allocator::Allocator& fallback);
+
+  /// Returns the number of frames that were allocated from a pool.
+  uint32_t pool_allocations() const { return pool_allocations_.value(); }
+
+  /// Returns the number of frames that were allocated from the fallback
+  /// allocator.
+  uint32_t fallback_allocations() const {
+    return fallback_allocations_.value();
+  }
+
+  /// Returns the number of frames that could not be allocated at all.
+  uint32_t failed_allocations() const { return failed_allocations_.value(); }
+
+  /// Returns the pool's allocation metrics.
+  metric::Group& metrics() { return metrics_; }
+
+ private:
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(pw::allocator::Layout layout) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, pw::allocator::Layout) override {
+    DoDeallocate(ptr);
+  }
+
+  span<pw::allocator::ChunkPool> pools_;
+  pw::allocator::Allocator& fallback_;
+
+  PW_METRIC_GROUP(metrics_, "pw::async2::CoroFramePool");
+  PW_METRIC(metrics_, pool_allocations_, "pool_allocations", 0u);
+  PW_METRIC(metrics_, fallback_allocations_, "fallback_allocations", 0u);
+  PW_METRIC(metrics_, failed_allocations_, "failed_allocations", 0u);
+};
+
+}  // namespace pw::async2
@@ -31,6 +31,56 @@ template <typename T>
 using PendOutputOf = typename decltype(std::declval<T>().Pend(
     std::declval<Context&>()))::OutputType;
 
+namespace impl {
+
+/// An intrusive FIFO of woken ``Task`` s.
+///
+/// ``Dispatcher`` implementations that keep their own run queues (for
+/// example, one per worker thread) build them from this type. A task is in
+/// at most one queue at a time, and it records which one.
+///
+/// A queue, and the links of the tasks in it, are guarded by whatever guards
+/// the queue, which need not be the dispatcher lock. If tasks move between
+/// queues with different locks, ``Containing`` is only meaningful while
+/// holding all of them.
+class TaskQueue {
+ public:
+  constexpr TaskQueue() = default;
+
+  bool empty() const { return first_ == nullptr; }
+  size_t size() const { return size_; }
+  Task* front() const { return first_; }
+  Task* back() const { return last_; }
+
+  void push_back(Task& task);
+
+  /// Removes and returns the first task, or ``nullptr`` if empty.
+  Task* pop_front();
+
+  /// Removes ``task``, which must be in this queue.
+  void remove(Task& task);
+
+  /// Whether ``task`` is in this queue.
+  bool contains(const Task& task) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock()) {
+    return task.queue_ == this;
+  }
+
+  /// Returns the queue that ``task`` is in, or ``nullptr`` if it is not in
+  /// one.
+  static TaskQueue* Containing(const Task& task)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock()) {
+    return task.queue_;
+  }
+
+ private:
+  Task* first_ = nullptr;
+  Task* last_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace impl
+
 // Windows GCC doesn't realize the nonvirtual destructor is protected.
 PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wnon-virtual-dtor");
@@ -44,7 +94,7 @@ PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wnon-virtual-dtor");
 /// to the ``Dispatcher`` class.
 class NativeDispatcherBase {
  public:
-  NativeDispatcherBase() = default;
+  NativeDispatcherBase() : lock_(impl::AssignDispatcherLock()) {}
   NativeDispatcherBase(NativeDispatcherBase&) = delete;
   NativeDispatcherBase(NativeDispatcherBase&&) = delete;
   NativeDispatcherBase& operator=(NativeDispatcherBase&) = delete;
@@ -53,6 +103,13 @@ class NativeDispatcherBase {
  protected:
   ~NativeDispatcherBase() = default;
 
+  /// The lock guarding this dispatcher's task queues and the state of its
+  /// ``Task`` s and ``Waker`` s. Acquire it with ``impl::DispatcherLockGuard``.
+  ///
+  /// ``Dispatcher`` implementations use this lock for any additional state
+  /// that is annotated as guarded by ``impl::dispatcher_lock()``.
+  impl::DispatcherLock& dispatcher_lock() const { return lock_; }
+
   /// Check that a task is posted on this ``Dispatcher``.
   bool HasPostedTask(Task& task)
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock()) {
@@ -106,6 +163,10 @@ class NativeDispatcherBase {
   SleepInfo AttemptRequestWake(bool allow_empty)
       PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
 
+  /// Same as ``AttemptRequestWake``, for callers that already hold the lock.
+  SleepInfo AttemptRequestWakeLocked(bool allow_empty)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
   /// Information about the result of a call to ``RunOneTask``.
   ///
   /// This should only be used by ``Dispatcher`` implementations.
@@ -132,6 +193,65 @@ class NativeDispatcherBase {
   [[nodiscard]] RunOneTaskResult RunOneTask(Dispatcher& dispatcher,
                                             Task* task_to_look_for);
 
+  /// An intrusive FIFO of woken ``Task`` s. See ``impl::TaskQueue``.
+  using TaskQueue = impl::TaskQueue;
+
+  /// Marks ``task``, which was just taken from a run queue, as running.
+  ///
+  /// The caller must then pass it to ``RunTask``.
+  void StartRunningTaskLocked(Task& task)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  /// Polls a task marked as running by ``StartRunningTaskLocked`` and then
+  /// puts it to sleep, requeues it, or completes and destroys it.
+  ///
+  /// Unlike ``RunOneTask``, this does not acquire the task execution lock, so
+  /// ``Dispatcher`` implementations may call it from several threads at once.
+  [[nodiscard]] RunOneTaskResult RunTask(Dispatcher& dispatcher,
+                                         Task& task,
+                                         Task* task_to_look_for)
+      PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
+
+  /// Removes and returns the oldest task in the default woken queue, or
+  /// ``nullptr`` if it is empty.
+  Task* PopWokenTaskLocked()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  /// Whether any task is sleeping, i.e. waiting for a ``Waker``.
+  bool HasSleepingTasksLocked() const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock()) {
+    return sleeping_ != nullptr;
+  }
+
+  /// Queues a task that was posted or woken so that it will be run.
+  ///
+  /// The default implementation appends the task to a single woken queue that
+  /// ``RunOneTask`` takes tasks from. ``Dispatcher`` implementations with
+  /// their own run queues may override this, in which case they must also
+  /// override ``DoRemoveWokenTask``.
+  ///
+  /// Like ``DoWake``, this may be called from any thread or interrupt.
+  virtual void DoEnqueueWokenTask(Task& task)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock()) {
+    woken_.push_back(task);
+  }
+
+  /// Removes a woken task queued by ``DoEnqueueWokenTask``.
+  virtual void DoRemoveWokenTask(Task& task)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock()) {
+    woken_.remove(task);
+  }
+
+  /// Called by ``Task::Deregister`` between attempts to deregister a task
+  /// that is being polled.
+  ///
+  /// The default implementation does nothing, since ``RunOneTask`` holds the
+  /// task execution lock while it polls a task, and ``Deregister`` waits for
+  /// that lock. ``Dispatcher`` implementations that poll tasks without it
+  /// should yield or otherwise wait here, rather than let ``Deregister`` spin.
+  virtual void DoWaitForRunningTask()
+      PW_LOCKS_EXCLUDED(impl::dispatcher_lock()) {}
+
   uint32_t tasks_polled() const { return tasks_polled_.value(); }
   uint32_t tasks_completed() const { return tasks_completed_.value(); }
   uint32_t sleep_count() const { return sleep_count_.value(); }
@@ -152,33 +272,28 @@ class NativeDispatcherBase {
   /// This method's implementation should ensure that the ``Dispatcher`` comes
   /// back from sleep and begins invoking ``RunOneTask`` again.
   ///
-  /// Note: the ``impl::dispatcher_lock()`` may or may not be held here, so it
-  /// must not be acquired by ``DoWake``, nor may ``DoWake`` assume that it has
-  /// been acquired.
+  /// Note: the dispatcher lock may or may not be held here, so it must not be
+  /// acquired by ``DoWake``, nor may ``DoWake`` assume that it has been
+  /// acquired.
   virtual void DoWake() = 0;
 
   static void UnpostTaskList(Task*)
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
   static void RemoveTaskFromList(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
-  void RemoveWokenTaskLocked(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
   void RemoveSleepingTaskLocked(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
 
-  // For use by ``WakeTask`` and ``DispatcherImpl::Post``.
-  void AddTaskToWokenList(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
-
-  // For use by ``RunOneTask``.
+  // For use by ``RunTask``.
   void AddTaskToSleepingList(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
 
   // For use by ``Waker``.
   void WakeTask(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
 
-  // For use by ``RunOneTask``.
-  Task* PopWokenTask() PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+  // Calls ``DoWake`` if the dispatcher asked to be woken.
+  void WakeIfRequestedLocked()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
 
   void LogRegisteredTasks();
 
@@ -188,15 +303,17 @@ class NativeDispatcherBase {
   // queue, and only released after they have been run and possibly
   // destroyed.
   //
-  // If acquiring this lock and ``impl::dispatcher_lock()``, this lock must
-  // be acquired first in order to avoid deadlocks.
+  // If acquiring this lock and the dispatcher lock, this lock must be
+  // acquired first in order to avoid deadlocks.
   //
   // Acquiring this lock may be a slow process, as it must wait until
   // the running task has finished executing ``Task::Pend``.
   pw::sync::Mutex task_execution_lock_;
 
-  Task* first_woken_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
-  Task* last_woken_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
+  // See ``dispatcher_lock()``. Not owned by this dispatcher.
+  impl::DispatcherLock& lock_;
+
+  TaskQueue woken_ PW_GUARDED_BY(impl::dispatcher_lock());
   // Note: the sleeping list's order is not significant.
   Task* sleeping_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
   bool wants_wake_ PW_GUARDED_BY(impl::dispatcher_lock()) = false;
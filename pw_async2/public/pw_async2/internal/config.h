@@ -24,3 +24,29 @@
 #ifndef PW_ASYNC2_CONFIG_LOG_MODULE_NAME
 #define PW_ASYNC2_CONFIG_LOG_MODULE_NAME "PW_ASYNC2"
 #endif  // PW_ASYNC2_CONFIG_LOG_MODULE_NAME
+
+/// The number of locks that dispatchers are spread across.
+///
+/// Each dispatcher is assigned one of these locks, round-robin, when it is
+/// constructed. Dispatchers that share a lock contend with each other when
+/// posting, waking, and running tasks. Setting this to 1 restores a single
+/// global lock, which may suit targets with one dispatcher.
+#ifndef PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT
+#define PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT 4
+#endif  // PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT
+
+static_assert(PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT > 0,
+              "PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT must be positive");
+
+/// Whether `TimeProvider` keeps pending timers in a hierarchical timing wheel
+/// rather than a sorted list.
+///
+/// A sorted list is small, but adding and cancelling timers takes time
+/// proportional to the number of pending timers. A timing wheel adds timers in
+/// constant time and cancels them in time proportional to the number of timers
+/// that expire close together, at the cost of about 700 pointers of memory per
+/// `TimeProvider`. Enable this when there are many concurrent timers, such as
+/// per-connection timeouts.
+#ifndef PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL
+#define PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL 0
+#endif  // PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL
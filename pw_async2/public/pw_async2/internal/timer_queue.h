@@ -0,0 +1,309 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_async2/internal/config.h"
+#include "pw_containers/intrusive_forward_list.h"
+
+namespace pw::async2::internal {
+
+// Containers for the pending timers of a `TimeProvider`.
+//
+// Both containers hold items of type `T`, which must derive from
+// `IntrusiveForwardList<T>::Item` and have an `expiration()` method that
+// returns a `Clock::time_point`. Items must not be added while their
+// expiration is changed. The containers are not thread-safe; `TimeProvider`
+// only uses them while holding `time_lock()`.
+//
+// Each container provides:
+//
+//   bool empty() const;
+//   bool Insert(T& item, time_point now);  // True if `item` is now earliest.
+//   bool Remove(T& item);                  // True if `item` was earliest.
+//   void Replace(T& old_item, T& new_item);
+//   time_point NextExpiration();           // Must not be empty.
+//   T* PopExpired(time_point now);         // nullptr if none have expired.
+
+/// Keeps timers in a list sorted by expiration.
+///
+/// Finding the next timer to expire is O(1), but inserting and removing timers
+/// are O(n). This is small and fast for a few timers.
+template <typename T, typename Clock>
+class SortedTimerQueue {
+ public:
+  using time_point = typename Clock::time_point;
+
+  bool empty() const { return timers_.empty(); }
+
+  bool Insert(T& item, time_point) {
+    if (timers_.empty() || timers_.front().expiration() > item.expiration()) {
+      timers_.push_front(item);
+      return true;
+    }
+    auto current = timers_.begin();
+    while (std::next(current) != timers_.end() &&
+           std::next(current)->expiration() < item.expiration()) {
+      current++;
+    }
+    timers_.insert_after(current, item);
+    return false;
+  }
+
+  bool Remove(T& item) {
+    if (&timers_.front() == &item) {
+      timers_.pop_front();
+      return true;
+    }
+    timers_.remove(item);
+    return false;
+  }
+
+  void Replace(T& old_item, T& new_item) {
+    ReplaceInList(timers_, old_item, new_item);
+  }
+
+  time_point NextExpiration() { return timers_.front().expiration(); }
+
+  T* PopExpired(time_point now) {
+    if (timers_.empty() || timers_.front().expiration() > now) {
+      return nullptr;
+    }
+    T& item = timers_.front();
+    timers_.pop_front();
+    return &item;
+  }
+
+  // Puts `new_item` in the place of `old_item` in `list`.
+  static void ReplaceInList(IntrusiveForwardList<T>& list,
+                            T& old_item,
+                            T& new_item) {
+    auto previous = list.before_begin();
+    while (&*std::next(previous) != &old_item) {
+      previous++;
+    }
+    list.erase_after(previous);
+    list.insert_after(previous, new_item);
+  }
+
+ private:
+  IntrusiveForwardList<T> timers_;
+};
+
+/// Keeps timers in a hierarchical timing wheel.
+///
+/// The wheel has a level for each group of `kBitsPerLevel` bits of a clock
+/// tick count, and each level has a slot for each value of its group. A timer
+/// is stored at the level of the most significant group in which its
+/// expiration differs from the wheel's current tick, in the slot for its
+/// expiration's value of that group. Timers at lower levels therefore always
+/// expire before timers at higher levels, and within a level, timers in lower
+/// slots expire first. As time advances, the timers in the first occupied
+/// slot are moved down to the lower levels until they reach level 0, where all
+/// timers in a slot share an expiration.
+///
+/// Inserting a timer is O(1). Removing a timer and finding the next timer to
+/// expire are proportional to the number of timers in a slot. Each timer is
+/// moved between levels at most once per level as it approaches expiration.
+///
+/// The wheel always has slots for the full range of the clock, so it uses
+/// about `kLevels * kSlotsPerLevel` pointers of memory regardless of how many
+/// timers are pending.
+template <typename T, typename Clock>
+class TimerWheel {
+ public:
+  using time_point = typename Clock::time_point;
+  using rep = typename Clock::rep;
+
+  static_assert(std::is_integral_v<rep> && sizeof(rep) <= sizeof(uint64_t),
+                "TimerWheel requires a clock with an integral tick count");
+
+  static constexpr size_t kBitsPerLevel = 6;
+  static constexpr size_t kSlotsPerLevel = size_t{1} << kBitsPerLevel;
+  static constexpr size_t kLevels = (64 + kBitsPerLevel - 1) / kBitsPerLevel;
+
+  bool empty() const { return count_ == 0; }
+
+  bool Insert(T& item, time_point now) {
+    if (count_ == 0) {
+      current_ = ToTick(now);
+    }
+    Place(item);
+    count_ += 1;
+    if (count_ == 1 || item.expiration() < earliest_) {
+      earliest_ = item.expiration();
+      return true;
+    }
+    return false;
+  }
+
+  bool Remove(T& item) {
+    auto [level, slot] = Locate(item);
+    slots_[level][slot].remove(item);
+    if (slots_[level][slot].empty()) {
+      occupied_[level] &= ~(uint64_t{1} << slot);
+    }
+    count_ -= 1;
+    if (item.expiration() > earliest_) {
+      return false;
+    }
+    if (count_ != 0) {
+      earliest_ = FindEarliest();
+    }
+    return true;
+  }
+
+  void Replace(T& old_item, T& new_item) {
+    auto [level, slot] = Locate(old_item);
+    SortedTimerQueue<T, Clock>::ReplaceInList(
+        slots_[level][slot], old_item, new_item);
+  }
+
+  time_point NextExpiration() { return earliest_; }
+
+  T* PopExpired(time_point now) {
+    const uint64_t now_tick = ToTick(now);
+    while (count_ != 0) {
+      auto [level, slot] = FirstOccupied();
+      const uint64_t start = SlotStart(level, slot);
+      if (start > now_tick) {
+        return nullptr;
+      }
+      // Advancing to the start of the first occupied slot does not move any
+      // other timer, since none differ from it in a lower group.
+      current_ = start;
+      IntrusiveForwardList<T>& list = slots_[level][slot];
+      if (level == 0) {
+        T& item = list.front();
+        list.pop_front();
+        if (list.empty()) {
+          occupied_[0] &= ~(uint64_t{1} << slot);
+        }
+        if (--count_ != 0) {
+          earliest_ = FindEarliest();
+        }
+        return &item;
+      }
+      // Move the slot's timers down to the levels for the new current tick.
+      occupied_[level] &= ~(uint64_t{1} << slot);
+      while (!list.empty()) {
+        T& item = list.front();
+        list.pop_front();
+        Place(item);
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  struct Position {
+    size_t level;
+    size_t slot;
+  };
+
+  // Maps times to unsigned tick counts that sort in the same order.
+  static constexpr uint64_t kTickOffset =
+      std::is_signed_v<rep> ? uint64_t{1} << 63 : 0;
+
+  static uint64_t ToTick(time_point time) {
+    return static_cast<uint64_t>(time.time_since_epoch().count()) ^
+           kTickOffset;
+  }
+
+  static time_point FromTick(uint64_t tick) {
+    return time_point(
+        typename Clock::duration(static_cast<rep>(tick ^ kTickOffset)));
+  }
+
+  // Returns where `item` belongs relative to `current_`. Timers that have
+  // already expired are kept in the current tick's slot.
+  Position Locate(T& item) const {
+    uint64_t tick = ToTick(item.expiration());
+    if (tick < current_) {
+      tick = current_;
+    }
+    const uint64_t differing_bits = tick ^ current_;
+    const size_t level =
+        differing_bits == 0
+            ? 0
+            : (static_cast<size_t>(cpp20::bit_width(differing_bits)) - 1) /
+                  kBitsPerLevel;
+    const size_t slot = static_cast<size_t>(
+        (tick >> (level * kBitsPerLevel)) & (kSlotsPerLevel - 1));
+    return {level, slot};
+  }
+
+  void Place(T& item) {
+    auto [level, slot] = Locate(item);
+    slots_[level][slot].push_front(item);
+    occupied_[level] |= uint64_t{1} << slot;
+  }
+
+  // Returns the slot holding the earliest timers. Must not be empty.
+  Position FirstOccupied() const {
+    size_t level = 0;
+    while (occupied_[level] == 0) {
+      level += 1;
+    }
+    return {level,
+            static_cast<size_t>(cpp20::countr_zero(occupied_[level]))};
+  }
+
+  // Returns the first tick covered by a slot.
+  uint64_t SlotStart(size_t level, size_t slot) const {
+    const size_t shift = level * kBitsPerLevel;
+    const size_t upper_shift = shift + kBitsPerLevel;
+    const uint64_t upper =
+        upper_shift >= 64 ? 0 : (current_ >> upper_shift) << upper_shift;
+    return upper | (static_cast<uint64_t>(slot) << shift);
+  }
+
+  time_point FindEarliest() {
+    auto [level, slot] = FirstOccupied();
+    if (level == 0) {
+      return FromTick(SlotStart(0, slot));
+    }
+    IntrusiveForwardList<T>& list = slots_[level][slot];
+    time_point earliest = list.front().expiration();
+    for (T& item : list) {
+      if (item.expiration() < earliest) {
+        earliest = item.expiration();
+      }
+    }
+    return earliest;
+  }
+
+  std::array<std::array<IntrusiveForwardList<T>, kSlotsPerLevel>, kLevels>
+      slots_;
+  std::array<uint64_t, kLevels> occupied_ = {};
+  uint64_t current_ = 0;
+  size_t count_ = 0;
+  time_point earliest_;
+};
+
+#if PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL
+template <typename T, typename Clock>
+using TimerQueue = TimerWheel<T, Clock>;
+#else
+template <typename T, typename Clock>
+using TimerQueue = SortedTimerQueue<T, Clock>;
+#endif  // PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL
+
+}  // namespace pw::async2::internal
@@ -13,24 +13,147 @@
 // the License.
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <utility>
+
 #include "pw_sync/interrupt_spin_lock.h"
-#include "pw_toolchain/no_destructor.h"
+#include "pw_sync/lock_annotations.h"
 
 namespace pw::async2::impl {
 
-/// A lock guarding the `Task` queue and `Waker` lists. This is a `Dispatcher`
-/// implementation detail and should only be used by `Dispatcher` backends.
+/// A lock guarding a `Dispatcher`'s task queues and the state of the `Task` s
+/// and `Waker` s associated with it. This is a `Dispatcher` implementation
+/// detail and should only be used by `Dispatcher` backends.
 ///
 /// This is an `InterruptSpinLock` in order to allow posting work from ISR
 /// contexts.
+using DispatcherLock = pw::sync::InterruptSpinLock;
+
+/// Returns the lock to use for a newly constructed `Dispatcher`.
+///
+/// Dispatchers share a small static set of locks, assigned round-robin, so
+/// dispatchers running on different threads usually do not contend with each
+/// other. The locks are static rather than owned by each dispatcher in order
+/// to allow `Task` and `Waker` to take out the lock without dereferencing
+/// their `Dispatcher*` fields, which are themselves guarded by the lock in
+/// order to allow the `Dispatcher` to `Deregister` itself upon destruction.
+///
+/// The number of locks is set by `PW_ASYNC2_CONFIG_DISPATCHER_LOCK_COUNT`.
+DispatcherLock& AssignDispatcherLock();
+
+/// Stands in for whichever `DispatcherLock` guards the data in question in
+/// thread safety annotations.
 ///
-/// This lock is global rather than per-dispatcher in order to allow `Task` and
-/// `Waker` to take out the lock without dereferencing their `Dispatcher*`
-/// fields, which are themselves guarded by the lock in order to allow the
-/// `Dispatcher` to `Deregister` itself upon destruction.
-inline pw::sync::InterruptSpinLock& dispatcher_lock() {
-  static NoDestructor<pw::sync::InterruptSpinLock> lock;
-  return *lock;
+/// The analysis cannot tell which dispatcher a `Task` or `Waker` belongs to,
+/// so every `DispatcherLock` is annotated as this one capability. Acquire
+/// dispatcher locks with `DispatcherLockGuard` so that the analysis sees it.
+class PW_LOCKABLE("pw::async2::impl::DispatcherLockCapability")
+    DispatcherLockCapability {};
+
+inline DispatcherLockCapability& dispatcher_lock() {
+  static DispatcherLockCapability capability;
+  return capability;
 }
 
+/// Holds a `DispatcherLock` for the duration of a scope.
+class PW_SCOPED_LOCKABLE DispatcherLockGuard {
+ public:
+  explicit DispatcherLockGuard(DispatcherLock& lock)
+      PW_EXCLUSIVE_LOCK_FUNCTION(dispatcher_lock()) PW_NO_LOCK_SAFETY_ANALYSIS
+      : lock_(lock) {
+    lock_.lock();
+  }
+
+  /// Acquires the lock that `lock` points to. `lock` may be changed by other
+  /// threads, but only while they hold the lock it points to.
+  explicit DispatcherLockGuard(const std::atomic<DispatcherLock*>& lock)
+      PW_EXCLUSIVE_LOCK_FUNCTION(dispatcher_lock()) PW_NO_LOCK_SAFETY_ANALYSIS
+      : lock_(Acquire(lock)) {}
+
+  ~DispatcherLockGuard() PW_UNLOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    lock_.unlock();
+  }
+
+  DispatcherLockGuard(const DispatcherLockGuard&) = delete;
+  DispatcherLockGuard& operator=(const DispatcherLockGuard&) = delete;
+
+ private:
+  static DispatcherLock& Acquire(const std::atomic<DispatcherLock*>& lock)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    while (true) {
+      DispatcherLock* locked = lock.load(std::memory_order_acquire);
+      locked->lock();
+      if (lock.load(std::memory_order_relaxed) == locked) {
+        return *locked;
+      }
+      locked->unlock();
+    }
+  }
+
+  DispatcherLock& lock_;
+};
+
+/// Holds the locks that two `std::atomic<DispatcherLock*>` point to for the
+/// duration of a scope. Either may be null, in which case it is not locked,
+/// and both may point to the same lock, in which case it is locked once.
+///
+/// The locks are acquired in address order, so that two threads locking the
+/// same pair cannot deadlock. As with `DispatcherLockGuard`, each pointer may
+/// be changed by other threads, but only while they hold the lock it points
+/// to.
+class PW_SCOPED_LOCKABLE DispatcherLockPairGuard {
+ public:
+  DispatcherLockPairGuard(const std::atomic<DispatcherLock*>& first,
+                          const std::atomic<DispatcherLock*>& second)
+      PW_EXCLUSIVE_LOCK_FUNCTION(dispatcher_lock()) PW_NO_LOCK_SAFETY_ANALYSIS {
+    while (true) {
+      DispatcherLock* first_locked = first.load(std::memory_order_acquire);
+      DispatcherLock* second_locked = second.load(std::memory_order_acquire);
+      Lock(first_locked, second_locked);
+      if (first.load(std::memory_order_relaxed) == first_locked &&
+          second.load(std::memory_order_relaxed) == second_locked) {
+        return;
+      }
+      Unlock();
+    }
+  }
+
+  ~DispatcherLockPairGuard() PW_UNLOCK_FUNCTION() PW_NO_LOCK_SAFETY_ANALYSIS {
+    Unlock();
+  }
+
+  DispatcherLockPairGuard(const DispatcherLockPairGuard&) = delete;
+  DispatcherLockPairGuard& operator=(const DispatcherLockPairGuard&) = delete;
+
+ private:
+  void Lock(DispatcherLock* first, DispatcherLock* second)
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (first == second) {
+      second = nullptr;
+    }
+    if (first == nullptr ||
+        (second != nullptr && std::less<DispatcherLock*>()(second, first))) {
+      std::swap(first, second);
+    }
+    locks_[0] = first;
+    locks_[1] = second;
+    for (DispatcherLock* lock : locks_) {
+      if (lock != nullptr) {
+        lock->lock();
+      }
+    }
+  }
+
+  void Unlock() PW_NO_LOCK_SAFETY_ANALYSIS {
+    for (DispatcherLock* lock : locks_) {
+      if (lock != nullptr) {
+        lock->unlock();
+      }
+    }
+  }
+
+  DispatcherLock* locks_[2] = {};
+};
+
 }  // namespace pw::async2::impl
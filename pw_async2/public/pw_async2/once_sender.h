@@ -16,7 +16,9 @@
 #include "pw_async2/dispatcher.h"
 #include "pw_async2/dispatcher_base.h"
 #include "pw_function/function.h"
+#include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/mutex.h"
+#include "pw_toolchain/no_destructor.h"
 
 namespace pw::async2 {
 
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <atomic>
+
 #include "pw_async2/context.h"
 #include "pw_async2/lock.h"
 #include "pw_async2/poll.h"
@@ -23,6 +25,10 @@ namespace pw::async2 {
 
 class NativeDispatcherBase;
 
+namespace impl {
+class TaskQueue;
+}  // namespace impl
+
 /// A task which may complete one or more asynchronous operations.
 ///
 /// The ``Task`` interface is commonly implemented by users wishing to schedule
@@ -57,6 +63,7 @@ class Task {
   friend class Dispatcher;
   friend class Waker;
   friend class NativeDispatcherBase;
+  friend class impl::TaskQueue;
 
  public:
   Task() = default;
@@ -179,12 +186,23 @@ class Task {
   enum class State {
     kUnposted,
     kRunning,
+    // The task was woken while running. It is queued to run again once its
+    // current ``Pend`` call returns, so that it is never polled by two threads
+    // at once.
+    kWokenWhileRunning,
     kWoken,
     kSleeping,
   };
   // The current state of the task.
   State state_ PW_GUARDED_BY(impl::dispatcher_lock()) = State::kUnposted;
 
+  // The lock of the dispatcher this task was last posted to, or ``nullptr``
+  // if it has never been posted. This guards the rest of the task's state.
+  //
+  // This is only changed by ``Post`` while the task is not registered, and
+  // only while holding the lock it points to.
+  std::atomic<impl::DispatcherLock*> lock_ = nullptr;
+
   // A pointer to the dispatcher this task is associated with.
   //
   // This will be non-null when `state_` is anything other than `kUnposted`.
@@ -199,6 +217,9 @@ class Task {
   Task* prev_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
   Task* next_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
 
+  // The run queue this task is in while it is woken, if any.
+  impl::TaskQueue* queue_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
+
   // Linked list of ``Waker`` s that may awaken this ``Task``.
   IntrusiveForwardList<Waker> wakers_ PW_GUARDED_BY(impl::dispatcher_lock());
 };
@@ -19,8 +19,9 @@
 #include <mutex>
 
 #include "pw_async2/dispatcher.h"
+#include "pw_async2/internal/timer_queue.h"
 #include "pw_chrono/virtual_clock.h"
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_forward_list.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_toolchain/no_destructor.h"
@@ -29,7 +30,7 @@ namespace pw::async2 {
 
 namespace internal {
 
-// A lock which guards `TimeProvider`'s linked list.
+// A lock which guards `TimeProvider`'s timer queue.
 inline pw::sync::InterruptSpinLock& time_lock() {
   static pw::sync::InterruptSpinLock lock;
   return lock;
@@ -56,6 +57,10 @@ class TimeFuture;
 ///
 /// Note that `Timer` objects must not outlive the `TimeProvider` from which
 /// they were created.
+///
+/// Pending timers are kept in a sorted list by default. Set
+/// `PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL` to keep them in a hierarchical
+/// timing wheel instead, which scales to many concurrent timers.
 template <typename Clock>
 class TimeProvider : public chrono::VirtualClock<Clock> {
  public:
@@ -106,8 +111,8 @@ class TimeProvider : public chrono::VirtualClock<Clock> {
   virtual void DoCancel()
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::time_lock()) = 0;
 
-  // Head of the waiting timers list.
-  IntrusiveList<TimeFuture<Clock>> futures_
+  // The waiting timers.
+  internal::TimerQueue<TimeFuture<Clock>, Clock> futures_
       PW_GUARDED_BY(internal::time_lock());
 };
 
@@ -134,17 +139,11 @@ class [[nodiscard]] TimeFuture
     provider_ = other.provider_;
     expiration_ = other.expiration_;
 
-    // Replace the entry of `other_` in the list.
+    // Replace the entry of `other_` in the queue.
     if (!other.unlisted()) {
-      auto previous = provider_->futures_.before_begin();
-      while (&*std::next(previous) != &other) {
-        previous++;
-      }
-
       // NOTE: this will leave `other` reporting (falsely) that it has expired.
       // However, `other` should not be used post-`move`.
-      other.unlist(&*previous);
-      provider_->futures_.insert_after(previous, *this);
+      provider_->futures_.Replace(other, *this);
     }
 
     return *this;
@@ -212,22 +211,14 @@ class [[nodiscard]] TimeFuture
     // Skip enlisting if the expiration of the timer is in the past.
     // NOTE: this *does not* trigger a waker since `Poll` has not yet been
     // invoked, so none has been registered.
-    if (provider_->now() >= expiration_) {
+    const typename Clock::time_point now = provider_->now();
+    if (now >= expiration_) {
       return;
     }
 
-    if (provider_->futures_.empty() ||
-        provider_->futures_.front().expiration_ > expiration_) {
-      provider_->futures_.push_front(*this);
+    if (provider_->futures_.Insert(*this, now)) {
       provider_->DoInvokeAt(expiration_);
-      return;
-    }
-    auto current = provider_->futures_.begin();
-    while (std::next(current) != provider_->futures_.end() &&
-           std::next(current)->expiration_ < expiration_) {
-      current++;
     }
-    provider_->futures_.insert_after(current, *this);
   }
 
   void Unlist() PW_LOCKS_EXCLUDED(internal::time_lock()) {
@@ -235,26 +226,22 @@ class [[nodiscard]] TimeFuture
     UnlistLocked();
   }
 
-  // Removes this timer from the `TimeProvider`'s list (if listed).
+  // Removes this timer from the `TimeProvider`'s queue (if listed).
   //
-  // If this timer was previously the `head` element of the `TimeProvider`'s
-  // list, the `TimeProvider` will be rescheduled to wake up based on the
-  // new `head`'s expiration time.
+  // If this timer was previously the next to expire in the `TimeProvider`'s
+  // queue, the `TimeProvider` will be rescheduled to wake up based on the
+  // new next timer's expiration time.
   void UnlistLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(internal::time_lock()) {
     if (this->unlisted()) {
       return;
     }
-    if (&provider_->futures_.front() == this) {
-      provider_->futures_.pop_front();
+    if (provider_->futures_.Remove(*this)) {
       if (provider_->futures_.empty()) {
         provider_->DoCancel();
       } else {
-        provider_->DoInvokeAt(provider_->futures_.front().expiration_);
+        provider_->DoInvokeAt(provider_->futures_.NextExpiration());
       }
-      return;
     }
-
-    provider_->futures_.remove(*this);
   }
 
   Waker waker_;
@@ -272,13 +259,11 @@ class [[nodiscard]] TimeFuture
 template <typename Clock>
 void TimeProvider<Clock>::RunExpired(typename Clock::time_point now) {
   std::lock_guard lock(internal::time_lock());
-  while (!futures_.empty()) {
-    if (futures_.front().expiration_ > now) {
-      DoInvokeAt(futures_.front().expiration_);
-      return;
-    }
-    std::move(futures_.front().waker_).Wake();
-    futures_.pop_front();
+  while (TimeFuture<Clock>* future = futures_.PopExpired(now)) {
+    std::move(future->waker_).Wake();
+  }
+  if (!futures_.empty()) {
+    DoInvokeAt(futures_.NextExpiration());
   }
 }
 
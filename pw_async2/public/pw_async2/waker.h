@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <atomic>
+
 #include "pw_async2/lock.h"
 #include "pw_containers/intrusive_forward_list.h"
 #include "pw_sync/lock_annotations.h"
@@ -119,17 +121,20 @@ class Waker : public pw::IntrusiveForwardList<Waker>::Item {
   }
 
  private:
-  Waker(Task& task) PW_LOCKS_EXCLUDED(impl::dispatcher_lock()) : task_(&task) {
-    InsertIntoTaskWakerList();
-  }
+  Waker(Task& task) PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
 
-  void InsertIntoTaskWakerList();
-  void InsertIntoTaskWakerListLocked()
-      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
   void RemoveFromTaskWakerList();
   void RemoveFromTaskWakerListLocked()
       PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
 
+  // The lock of the dispatcher of the last ``Task`` this ``Waker`` was
+  // associated with, which guards ``task_``.
+  //
+  // This is only changed by operations on this ``Waker``, while ``task_`` is
+  // ``nullptr``, and while holding both the lock it points to and the lock it
+  // is changed to. Once set, it is never reset to ``nullptr``.
+  std::atomic<impl::DispatcherLock*> lock_ = nullptr;
+
   // The ``Task`` to poll when awoken.
   Task* task_ PW_GUARDED_BY(impl::dispatcher_lock()) = nullptr;
 };
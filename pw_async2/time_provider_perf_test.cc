@@ -0,0 +1,92 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the cost of adding, cancelling, and expiring many concurrent
+// timers. Build with and without PW_ASYNC2_CONFIG_TIME_PROVIDER_TIMER_WHEEL to
+// compare the timer queues.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_async2/simulated_time_provider.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::async2 {
+namespace {
+
+using chrono::SystemClock;
+
+constexpr size_t kTimers = 10000;
+
+// Timers expire up to this many ticks after they are set.
+constexpr uint32_t kMaxDelayTicks = 1u << 20;
+
+SimulatedTimeProvider<SystemClock> time_provider;
+std::array<TimeFuture<SystemClock>, kTimers> timers;
+
+// Returns a pseudo-random value so that runs are repeatable.
+uint32_t Next(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Associates every timer with `time_provider` without queueing it.
+void InitTimers() {
+  static bool initialized = false;
+  if (!initialized) {
+    for (TimeFuture<SystemClock>& timer : timers) {
+      timer = time_provider.WaitUntil(time_provider.now());
+    }
+    initialized = true;
+  }
+}
+
+void SetTimers(uint32_t& random) {
+  const SystemClock::time_point now = time_provider.now();
+  for (TimeFuture<SystemClock>& timer : timers) {
+    timer.Reset(now + SystemClock::duration(1 + Next(random) % kMaxDelayTicks));
+  }
+}
+
+// Queues each timer, then cancels them in a different order.
+void InsertAndCancel(perf_test::State& state) {
+  InitTimers();
+  uint32_t random = 1;
+  while (state.KeepRunning()) {
+    SetTimers(random);
+    const SystemClock::time_point now = time_provider.now();
+    for (size_t i = 0; i < kTimers; ++i) {
+      timers[(i * 7919) % kTimers].Reset(now);
+    }
+  }
+}
+
+// Queues each timer, then advances time until all of them have expired.
+void InsertAndExpire(perf_test::State& state) {
+  InitTimers();
+  uint32_t random = 1;
+  while (state.KeepRunning()) {
+    SetTimers(random);
+    while (time_provider.AdvanceUntilNextExpiration()) {
+    }
+  }
+}
+
+PW_PERF_TEST(TimeProviderInsertAndCancel, InsertAndCancel);
+PW_PERF_TEST(TimeProviderInsertAndExpire, InsertAndExpire);
+
+}  // namespace
+}  // namespace pw::async2
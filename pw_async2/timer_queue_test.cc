@@ -0,0 +1,211 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/internal/timer_queue.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_containers/intrusive_forward_list.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::IntrusiveForwardList;
+using ::pw::async2::internal::SortedTimerQueue;
+using ::pw::async2::internal::TimerWheel;
+
+struct TestClock {
+  using rep = int64_t;
+  using period = std::micro;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<TestClock>;
+};
+
+TestClock::time_point At(int64_t ticks) {
+  return TestClock::time_point(TestClock::duration(ticks));
+}
+
+class Timer : public IntrusiveForwardList<Timer>::Item {
+ public:
+  TestClock::time_point expiration() const { return expiration_; }
+  void set_expiration(int64_t ticks) { expiration_ = At(ticks); }
+  bool queued() const { return !unlisted(); }
+
+ private:
+  TestClock::time_point expiration_;
+};
+
+// Returns a pseudo-random value so that tests are repeatable.
+uint32_t Next(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+template <typename Queue>
+void InsertReportsNewEarliest() {
+  Queue queue;
+  std::array<Timer, 3> timers;
+  timers[0].set_expiration(100);
+  timers[1].set_expiration(200);
+  timers[2].set_expiration(50);
+
+  EXPECT_TRUE(queue.Insert(timers[0], At(0)));
+  EXPECT_FALSE(queue.Insert(timers[1], At(0)));
+  EXPECT_TRUE(queue.Insert(timers[2], At(0)));
+  EXPECT_EQ(queue.NextExpiration(), At(50));
+
+  EXPECT_TRUE(queue.Remove(timers[2]));
+  EXPECT_FALSE(queue.Remove(timers[1]));
+  EXPECT_TRUE(queue.Remove(timers[0]));
+  EXPECT_TRUE(queue.empty());
+}
+
+template <typename Queue>
+void PopExpiredReturnsTimersInOrder() {
+  Queue queue;
+  std::array<Timer, 6> timers;
+  constexpr std::array<int64_t, 6> kExpirations = {
+      70, 5, 1'000'000, 5'000, 70, 123'456'789};
+  for (size_t i = 0; i < timers.size(); ++i) {
+    timers[i].set_expiration(kExpirations[i]);
+    queue.Insert(timers[i], At(0));
+  }
+
+  EXPECT_EQ(queue.PopExpired(At(4)), nullptr);
+  EXPECT_EQ(queue.PopExpired(At(5)), &timers[1]);
+  EXPECT_EQ(queue.PopExpired(At(5)), nullptr);
+  EXPECT_EQ(queue.NextExpiration(), At(70));
+
+  Timer* first = queue.PopExpired(At(100'000));
+  Timer* second = queue.PopExpired(At(100'000));
+  EXPECT_TRUE((first == &timers[0] && second == &timers[4]) ||
+              (first == &timers[4] && second == &timers[0]));
+  EXPECT_EQ(queue.PopExpired(At(100'000)), &timers[3]);
+  EXPECT_EQ(queue.PopExpired(At(100'000)), nullptr);
+  EXPECT_EQ(queue.NextExpiration(), At(1'000'000));
+
+  EXPECT_EQ(queue.PopExpired(At(200'000'000)), &timers[2]);
+  EXPECT_EQ(queue.PopExpired(At(200'000'000)), &timers[5]);
+  EXPECT_TRUE(queue.empty());
+}
+
+template <typename Queue>
+void ReplaceKeepsExpiration() {
+  Queue queue;
+  std::array<Timer, 3> timers;
+  timers[0].set_expiration(10);
+  timers[1].set_expiration(20'000);
+  timers[2].set_expiration(20'000);
+  queue.Insert(timers[0], At(0));
+  queue.Insert(timers[1], At(0));
+
+  queue.Replace(timers[1], timers[2]);
+  EXPECT_EQ(queue.PopExpired(At(30'000)), &timers[0]);
+  EXPECT_EQ(queue.PopExpired(At(30'000)), &timers[2]);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SortedTimerQueue, InsertReportsNewEarliest) {
+  InsertReportsNewEarliest<SortedTimerQueue<Timer, TestClock>>();
+}
+
+TEST(SortedTimerQueue, PopExpiredReturnsTimersInOrder) {
+  PopExpiredReturnsTimersInOrder<SortedTimerQueue<Timer, TestClock>>();
+}
+
+TEST(SortedTimerQueue, ReplaceKeepsExpiration) {
+  ReplaceKeepsExpiration<SortedTimerQueue<Timer, TestClock>>();
+}
+
+TEST(TimerWheel, InsertReportsNewEarliest) {
+  InsertReportsNewEarliest<TimerWheel<Timer, TestClock>>();
+}
+
+TEST(TimerWheel, PopExpiredReturnsTimersInOrder) {
+  PopExpiredReturnsTimersInOrder<TimerWheel<Timer, TestClock>>();
+}
+
+TEST(TimerWheel, ReplaceKeepsExpiration) {
+  ReplaceKeepsExpiration<TimerWheel<Timer, TestClock>>();
+}
+
+TEST(TimerWheel, HandlesNegativeTimes) {
+  TimerWheel<Timer, TestClock> wheel;
+  std::array<Timer, 2> timers;
+  timers[0].set_expiration(10);
+  timers[1].set_expiration(-10);
+  wheel.Insert(timers[0], At(-100));
+  wheel.Insert(timers[1], At(-100));
+
+  EXPECT_EQ(wheel.NextExpiration(), At(-10));
+  EXPECT_EQ(wheel.PopExpired(At(0)), &timers[1]);
+  EXPECT_EQ(wheel.PopExpired(At(0)), nullptr);
+  EXPECT_EQ(wheel.PopExpired(At(10)), &timers[0]);
+}
+
+TEST(TimerWheel, MatchesSortedTimerQueue) {
+  constexpr size_t kTimers = 512;
+  std::array<Timer, kTimers> wheel_timers;
+  std::array<Timer, kTimers> sorted_timers;
+  TimerWheel<Timer, TestClock> wheel;
+  SortedTimerQueue<Timer, TestClock> sorted;
+  uint32_t random = 1;
+  int64_t now = 0;
+
+  for (int round = 0; round < 8; ++round) {
+    for (size_t i = 0; i < kTimers; ++i) {
+      if (wheel_timers[i].queued()) {
+        continue;
+      }
+      // Mix near and far expirations so that timers start at every level.
+      const int64_t delay = 1 + (Next(random) >> (Next(random) % 24));
+      wheel_timers[i].set_expiration(now + delay);
+      sorted_timers[i].set_expiration(now + delay);
+      EXPECT_EQ(wheel.Insert(wheel_timers[i], At(now)),
+                sorted.Insert(sorted_timers[i], At(now)));
+    }
+    for (size_t i = 0; i < kTimers / 8; ++i) {
+      const size_t index = Next(random) % kTimers;
+      if (wheel_timers[index].queued()) {
+        wheel.Remove(wheel_timers[index]);
+        sorted.Remove(sorted_timers[index]);
+      }
+    }
+    EXPECT_EQ(wheel.NextExpiration(), sorted.NextExpiration());
+
+    now += Next(random) % (1 << 16);
+    while (Timer* timer = sorted.PopExpired(At(now))) {
+      Timer* wheel_timer = wheel.PopExpired(At(now));
+      ASSERT_NE(wheel_timer, nullptr);
+      EXPECT_EQ(wheel_timer->expiration(), timer->expiration());
+    }
+    EXPECT_EQ(wheel.PopExpired(At(now)), nullptr);
+    ASSERT_EQ(wheel.empty(), sorted.empty());
+    if (!sorted.empty()) {
+      EXPECT_EQ(wheel.NextExpiration(), sorted.NextExpiration());
+    }
+  }
+
+  const auto kEnd = At(std::numeric_limits<int64_t>::max());
+  while (sorted.PopExpired(kEnd) != nullptr) {
+  }
+  while (wheel.PopExpired(kEnd) != nullptr) {
+  }
+}
+
+}  // namespace
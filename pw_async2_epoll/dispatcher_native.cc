@@ -19,7 +19,6 @@
 #include <unistd.h>
 
 #include <cstring>
-#include <mutex>
 
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
@@ -62,7 +61,7 @@ Status NativeDispatcher::NativeInit() {
 
 Poll<> NativeDispatcher::DoRunUntilStalled(Dispatcher& dispatcher, Task* task) {
   {
-    std::lock_guard lock(impl::dispatcher_lock());
+    impl::DispatcherLockGuard lock(dispatcher_lock());
     PW_CHECK(task == nullptr || HasPostedTask(*task),
              "Attempted to run a dispatcher until a task was stalled, "
              "but that task has not been `Post`ed to that `Dispatcher`.");
@@ -80,7 +79,7 @@ Poll<> NativeDispatcher::DoRunUntilStalled(Dispatcher& dispatcher, Task* task) {
 
 void NativeDispatcher::DoRunToCompletion(Dispatcher& dispatcher, Task* task) {
   {
-    std::lock_guard lock(impl::dispatcher_lock());
+    impl::DispatcherLockGuard lock(dispatcher_lock());
     PW_CHECK(task == nullptr || HasPostedTask(*task),
              "Attempted to run a dispatcher until a task was complete, "
              "but that task has not been `Post`ed to that `Dispatcher`.");
@@ -20,6 +20,11 @@
 
 namespace pw::async2::backend {
 
+// GCC doesn't realize the nonvirtual destructor is protected and that the
+// class is final.
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wnon-virtual-dtor");
+
 class NativeDispatcher final : public NativeDispatcherBase {
  public:
   NativeDispatcher() { PW_ASSERT_OK(NativeInit()); }
@@ -67,4 +72,6 @@ class NativeDispatcher final : public NativeDispatcherBase {
   std::unordered_map<int, ReadWriteWaker> wakers_;
 };
 
+PW_MODIFY_DIAGNOSTICS_POP();
+
 }  // namespace pw::async2::backend
@@ -0,0 +1,349 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/dispatcher_native.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::async2::backend {
+
+thread_local NativeDispatcher::Worker* NativeDispatcher::current_worker_ =
+    nullptr;
+
+NativeDispatcher::NativeDispatcher() {
+  NativeSetWorkerCount(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+NativeDispatcher::~NativeDispatcher() { StopWorkerThreads(); }
+
+void NativeDispatcher::NativeSetWorkerCount(size_t count) {
+  PW_CHECK_UINT_GT(count, 0, "A dispatcher needs at least one worker");
+  StopWorkerThreads();
+  workers_.clear();
+  for (size_t i = 0; i < count; ++i) {
+    workers_.push_back(std::make_unique<Worker>(*this, i));
+  }
+}
+
+void NativeDispatcher::StartWorkerThreads() {
+  if (threads_started_) {
+    return;
+  }
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& worker = *workers_[i];
+    worker.thread = std::thread([this, &worker] { ParkWorker(worker); });
+  }
+  threads_started_ = true;
+}
+
+void NativeDispatcher::StopWorkerThreads() {
+  if (!threads_started_) {
+    return;
+  }
+  shutting_down_ = true;
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    workers_[i]->start.release();
+    workers_[i]->thread.join();
+  }
+  shutting_down_ = false;
+  threads_started_ = false;
+}
+
+void NativeDispatcher::ParkWorker(Worker& worker) {
+  while (true) {
+    worker.start.acquire();
+    if (shutting_down_) {
+      return;
+    }
+    RunWorker(worker);
+    worker.finished.release();
+  }
+}
+
+Poll<> NativeDispatcher::DoRunUntilStalled(Dispatcher& dispatcher, Task* task) {
+  {
+    impl::DispatcherLockGuard lock(dispatcher_lock());
+    PW_CHECK(task == nullptr || HasPostedTask(*task),
+             "Attempted to run a dispatcher until a task was stalled, "
+             "but that task has not been `Post`ed to that `Dispatcher`.");
+  }
+  Worker& worker = *workers_[0];
+  Worker* const previous_worker = std::exchange(current_worker_, &worker);
+
+  Poll<> result = Pending();
+  while (true) {
+    // The other workers are parked, so only this worker's queue and the
+    // injection queue can hold tasks.
+    ClaimQueuedTask(worker);
+    Task* next;
+    {
+      impl::DispatcherLockGuard lock(dispatcher_lock());
+      next = StartNextTaskLocked(worker);
+      if (next == nullptr) {
+        if (!HasSleepingTasksLocked()) {
+          result = Ready();
+        }
+        break;
+      }
+    }
+    if (RunTask(dispatcher, *next, task).completed_main_task()) {
+      result = Ready();
+      break;
+    }
+  }
+
+  impl::DispatcherLockGuard lock(dispatcher_lock());
+  ReturnQueuedTasksLocked();
+  current_worker_ = previous_worker;
+  return result;
+}
+
+void NativeDispatcher::DoRunToCompletion(Dispatcher& dispatcher, Task* task) {
+  {
+    impl::DispatcherLockGuard lock(dispatcher_lock());
+    PW_CHECK(task == nullptr || HasPostedTask(*task),
+             "Attempted to run a dispatcher until a task was complete, "
+             "but that task has not been `Post`ed to that `Dispatcher`.");
+    stopped_ = false;
+  }
+  dispatcher_ = &dispatcher;
+  main_task_ = task;
+
+  StartWorkerThreads();
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    workers_[i]->start.release();
+  }
+  RunWorker(*workers_[0]);
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    workers_[i]->finished.acquire();
+  }
+
+  dispatcher_ = nullptr;
+  main_task_ = nullptr;
+
+  impl::DispatcherLockGuard lock(dispatcher_lock());
+  ReturnQueuedTasksLocked();
+}
+
+void NativeDispatcher::RunWorker(Worker& worker) {
+  Worker* const previous_worker = std::exchange(current_worker_, &worker);
+  bool steal = false;
+  while (true) {
+    if (steal) {
+      StealTask(worker);
+    } else {
+      ClaimQueuedTask(worker);
+    }
+
+    Task* task;
+    {
+      impl::DispatcherLockGuard lock(dispatcher_lock());
+      if (worker.idle) {
+        // Woken by `DoWake` rather than `WakeIdleWorkerLocked`.
+        worker.idle = false;
+        idle_workers_ -= 1;
+      }
+      if (stopped_) {
+        break;
+      }
+      task = StartNextTaskLocked(worker);
+      if (task != nullptr) {
+        running_tasks_ += 1;
+        steal = false;
+      } else if (queued_tasks_ > 0) {
+        // Other workers have queued tasks, or have claimed tasks that they
+        // are about to start. Try to steal some before going idle.
+        steal = true;
+        continue;
+      } else if (running_tasks_ == 0 && !HasSleepingTasksLocked()) {
+        // Every task has completed or been deregistered.
+        StopRunLocked();
+        break;
+      } else {
+        if (running_tasks_ == 0) {
+          // Only deregistering the remaining sleeping tasks can end the run,
+          // so ask for a `DoWake` call when that happens.
+          static_cast<void>(AttemptRequestWakeLocked(/*allow_empty=*/true));
+        }
+        worker.idle = true;
+        idle_workers_ += 1;
+        steal = false;
+      }
+    }
+
+    if (task == nullptr) {
+      worker.wake.acquire();
+      continue;
+    }
+
+    const bool completed_main_task =
+        RunTask(*dispatcher_, *task, main_task_).completed_main_task();
+
+    impl::DispatcherLockGuard lock(dispatcher_lock());
+    running_tasks_ -= 1;
+    if (completed_main_task) {
+      StopRunLocked();
+    }
+  }
+  current_worker_ = previous_worker;
+}
+
+void NativeDispatcher::ClaimQueuedTask(Worker& worker) {
+  std::lock_guard lock(worker.lock);
+  if (worker.claimed == nullptr) {
+    worker.claimed = worker.queue.pop_front();
+  }
+}
+
+void NativeDispatcher::StealTask(Worker& thief) {
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& victim = *workers_[(thief.index + i) % workers_.size()];
+    Worker& first = victim.index < thief.index ? victim : thief;
+    Worker& second = victim.index < thief.index ? thief : victim;
+    std::lock_guard first_lock(first.lock);
+    std::lock_guard second_lock(second.lock);
+    if (thief.claimed != nullptr) {
+      return;
+    }
+    if (victim.queue.empty()) {
+      continue;
+    }
+    // Take the older half of the queue, rounding up, and claim the oldest
+    // task.
+    thief.claimed = victim.queue.pop_front();
+    for (size_t count = victim.queue.size() / 2; count > 0; --count) {
+      thief.queue.push_back(*victim.queue.pop_front());
+    }
+    return;
+  }
+  // Any tasks left are claimed by workers that are about to start them.
+  std::this_thread::yield();
+}
+
+Task* NativeDispatcher::StartNextTaskLocked(Worker& worker) {
+  Task* task;
+  {
+    std::lock_guard lock(worker.lock);
+    task = std::exchange(worker.claimed, nullptr);
+  }
+  if (task != nullptr) {
+    queued_tasks_ -= 1;
+  } else {
+    task = PopWokenTaskLocked();
+    if (task == nullptr) {
+      return nullptr;
+    }
+  }
+  StartRunningTaskLocked(*task);
+  return task;
+}
+
+void NativeDispatcher::DoEnqueueWokenTask(Task& task) {
+  Worker* worker = current_worker_;
+  if (worker != nullptr && &worker->dispatcher == this) {
+    std::lock_guard lock(worker->lock);
+    worker->queue.push_back(task);
+    queued_tasks_ += 1;
+  } else {
+    NativeDispatcherBase::DoEnqueueWokenTask(task);
+  }
+  WakeIdleWorkerLocked();
+}
+
+void NativeDispatcher::DoRemoveWokenTask(Task& task) {
+  // Workers move queued tasks without the dispatcher lock, so lock every
+  // worker's queue to find the task.
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->lock.lock();
+  }
+  bool found = false;
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    if (worker->queue.contains(task)) {
+      worker->queue.remove(task);
+      found = true;
+    } else if (worker->claimed == &task) {
+      worker->claimed = nullptr;
+      found = true;
+    }
+  }
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->lock.unlock();
+  }
+
+  if (found) {
+    queued_tasks_ -= 1;
+  } else {
+    NativeDispatcherBase::DoRemoveWokenTask(task);
+  }
+}
+
+void NativeDispatcher::DoWaitForRunningTask() {
+  // Workers poll tasks without the task execution lock, so let the worker
+  // polling the task finish rather than retrying immediately.
+  std::this_thread::yield();
+}
+
+void NativeDispatcher::WakeIdleWorkerLocked() {
+  if (idle_workers_ == 0) {
+    return;
+  }
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    if (worker->idle) {
+      worker->idle = false;
+      idle_workers_ -= 1;
+      worker->wake.release();
+      return;
+    }
+  }
+}
+
+void NativeDispatcher::StopRunLocked() {
+  stopped_ = true;
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    if (worker->idle) {
+      worker->idle = false;
+      idle_workers_ -= 1;
+      worker->wake.release();
+    }
+  }
+}
+
+void NativeDispatcher::ReturnQueuedTasksLocked() {
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    std::lock_guard lock(worker->lock);
+    if (Task* task = std::exchange(worker->claimed, nullptr)) {
+      NativeDispatcherBase::DoEnqueueWokenTask(*task);
+      queued_tasks_ -= 1;
+    }
+    while (Task* task = worker->queue.pop_front()) {
+      NativeDispatcherBase::DoEnqueueWokenTask(*task);
+      queued_tasks_ -= 1;
+    }
+  }
+}
+
+void NativeDispatcher::DoWake() {
+  // This may be called without the lock held, so wake every worker rather
+  // than checking which are idle. Workers that were not idle check for work
+  // once more before going idle.
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->wake.release();
+  }
+}
+
+}  // namespace pw::async2::backend
@@ -0,0 +1,84 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how the work-stealing dispatcher scales with its worker count.
+// `pw_async2:dispatcher_perf_test` compares it against other backends.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::async2 {
+namespace {
+
+constexpr size_t kTasks = 64;
+constexpr int kPollsPerTask = 16;
+
+// Spins for `work_per_poll` iterations each time it is polled and re-enqueues
+// itself until it has been polled `kPollsPerTask` times.
+class ComputeTask : public Task {
+ public:
+  void Reset(size_t work_per_poll) {
+    polls_left_ = kPollsPerTask;
+    work_per_poll_ = work_per_poll;
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    for (size_t i = 0; i < work_per_poll_; ++i) {
+      value_ = value_ * 1664525u + 1013904223u;
+    }
+    if (--polls_left_ == 0) {
+      return Ready();
+    }
+    cx.ReEnqueue();
+    return Pending();
+  }
+
+  int polls_left_ = 0;
+  size_t work_per_poll_ = 0;
+  volatile uint32_t value_ = 1;
+};
+
+void ComputeBound(perf_test::State& state,
+                  size_t workers,
+                  size_t work_per_poll) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(workers);
+  std::array<ComputeTask, kTasks> tasks;
+
+  while (state.KeepRunning()) {
+    for (ComputeTask& task : tasks) {
+      task.Reset(work_per_poll);
+      dispatcher.Post(task);
+    }
+    dispatcher.RunToCompletion();
+  }
+}
+
+PW_PERF_TEST(ComputeBoundLight1Worker, ComputeBound, 1, 100);
+PW_PERF_TEST(ComputeBoundLight2Workers, ComputeBound, 2, 100);
+PW_PERF_TEST(ComputeBoundLight4Workers, ComputeBound, 4, 100);
+PW_PERF_TEST(ComputeBoundLight8Workers, ComputeBound, 8, 100);
+
+PW_PERF_TEST(ComputeBoundHeavy1Worker, ComputeBound, 1, 10000);
+PW_PERF_TEST(ComputeBoundHeavy2Workers, ComputeBound, 2, 10000);
+PW_PERF_TEST(ComputeBoundHeavy4Workers, ComputeBound, 4, 10000);
+PW_PERF_TEST(ComputeBoundHeavy8Workers, ComputeBound, 8, 10000);
+
+}  // namespace
+}  // namespace pw::async2
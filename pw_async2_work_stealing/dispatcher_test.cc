@@ -0,0 +1,324 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/dispatcher.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+#include "pw_span/span.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::async2 {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr size_t kWorkers = 4;
+
+// Spins until `count` reaches `target`, which only happens if tasks are polled
+// on several workers at once. Gives up after a few seconds so that a broken
+// dispatcher fails the test rather than hanging it.
+bool WaitForCount(std::atomic<size_t>& count, size_t target) {
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (count.load() < target) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Completes once `target` tasks sharing `running` are being polled at once.
+class RendezvousTask : public Task {
+ public:
+  RendezvousTask(std::atomic<size_t>& running, size_t target)
+      : running_(running), target_(target) {}
+
+  bool met() const { return met_; }
+
+ private:
+  Poll<> DoPend(Context&) override {
+    running_ += 1;
+    met_ = WaitForCount(running_, target_);
+    return Ready();
+  }
+
+  std::atomic<size_t>& running_;
+  const size_t target_;
+  bool met_ = false;
+};
+
+TEST(WorkStealingDispatcher, RunToCompletion_PollsTasksOnEveryWorker) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  std::atomic<size_t> running = 0;
+  std::array<RendezvousTask, kWorkers> tasks{
+      RendezvousTask(running, kWorkers),
+      RendezvousTask(running, kWorkers),
+      RendezvousTask(running, kWorkers),
+      RendezvousTask(running, kWorkers),
+  };
+  for (RendezvousTask& task : tasks) {
+    dispatcher.Post(task);
+  }
+
+  dispatcher.RunToCompletion();
+
+  for (RendezvousTask& task : tasks) {
+    EXPECT_TRUE(task.met());
+    EXPECT_FALSE(task.IsRegistered());
+  }
+  EXPECT_EQ(dispatcher.tasks_completed(), kWorkers);
+}
+
+// Posts its children from inside `Pend`, which queues them on the worker
+// polling this task. Other workers can only run them by stealing.
+class ParentTask : public Task {
+ public:
+  explicit ParentTask(span<RendezvousTask> children) : children_(children) {}
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    for (RendezvousTask& child : children_) {
+      cx.dispatcher().Post(child);
+    }
+    return Ready();
+  }
+
+  span<RendezvousTask> children_;
+};
+
+TEST(WorkStealingDispatcher, RunToCompletion_StealsFromOtherWorkers) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(2);
+
+  std::atomic<size_t> running = 0;
+  std::array<RendezvousTask, 2> children{
+      RendezvousTask(running, 2),
+      RendezvousTask(running, 2),
+  };
+  ParentTask parent(children);
+  dispatcher.Post(parent);
+
+  dispatcher.RunToCompletion();
+
+  EXPECT_TRUE(children[0].met());
+  EXPECT_TRUE(children[1].met());
+  EXPECT_EQ(dispatcher.tasks_completed(), 3u);
+}
+
+// Stores its waker for other threads and checks that it is never polled by two
+// workers at once.
+class WokenTask : public Task {
+ public:
+  explicit WokenTask(int polls_to_complete)
+      : polls_to_complete_(polls_to_complete) {}
+
+  // Wakers are thread-safe, so this may race with `DoPend` storing a new one.
+  void Wake() { std::move(waker_).Wake(); }
+
+  int polls() const { return polls_; }
+  bool polled_concurrently() const { return polled_concurrently_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    if (in_pend_.exchange(true)) {
+      polled_concurrently_ = true;
+    }
+    polls_ += 1;
+    PW_ASYNC_STORE_WAKER(cx, waker_, "WokenTask is waiting for Wake()");
+    // Give a racing poll on another worker time to start.
+    this_thread::sleep_for(10us);
+    in_pend_ = false;
+    return polls_ >= polls_to_complete_ ? Ready() : Pending();
+  }
+
+  const int polls_to_complete_;
+  std::atomic<bool> in_pend_ = false;
+  std::atomic<bool> polled_concurrently_ = false;
+  std::atomic<int> polls_ = 0;
+  Waker waker_;
+};
+
+TEST(WorkStealingDispatcher, RunToCompletion_NeverPollsATaskConcurrently) {
+  constexpr int kPolls = 200;
+
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  WokenTask task(kPolls);
+  dispatcher.Post(task);
+
+  std::array<Thread, 2> wakers;
+  for (Thread& waker : wakers) {
+    waker = Thread(thread::stl::Options(), [&task] {
+      while (task.IsRegistered()) {
+        task.Wake();
+      }
+    });
+  }
+
+  dispatcher.RunToCompletion(task);
+  for (Thread& waker : wakers) {
+    waker.join();
+  }
+
+  EXPECT_EQ(task.polls(), kPolls);
+  EXPECT_FALSE(task.polled_concurrently());
+}
+
+TEST(WorkStealingDispatcher, RunToCompletion_SleepsUntilWoken) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  WokenTask task(2);
+  dispatcher.Post(task);
+
+  Thread work_thread(thread::stl::Options(), [&task] {
+    this_thread::sleep_for(50ms);
+    task.Wake();
+  });
+
+  dispatcher.RunToCompletion();
+  work_thread.join();
+
+  EXPECT_EQ(task.polls(), 2);
+  EXPECT_FALSE(task.IsRegistered());
+}
+
+TEST(WorkStealingDispatcher, RunToCompletion_EndsWhenLastTaskIsDeregistered) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  WokenTask task(2);
+  dispatcher.Post(task);
+
+  Thread work_thread(thread::stl::Options(), [&task] {
+    this_thread::sleep_for(50ms);
+    task.Deregister();
+  });
+
+  dispatcher.RunToCompletion();
+  work_thread.join();
+
+  EXPECT_EQ(task.polls(), 1);
+  EXPECT_FALSE(task.IsRegistered());
+}
+
+// Stays pending, and polls slowly enough for another thread to deregister it
+// while it is being polled.
+class SlowTask : public Task {
+ public:
+  // Deregisters the task once its first poll has started.
+  void DeregisterWhilePolled() {
+    while (!started_) {
+    }
+    Deregister();
+    in_pend_after_deregister_ = in_pend_.load();
+  }
+
+  bool in_pend_after_deregister() const { return in_pend_after_deregister_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    in_pend_ = true;
+    started_ = true;
+    PW_ASYNC_STORE_WAKER(cx, waker_, "SlowTask is never woken");
+    this_thread::sleep_for(20ms);
+    in_pend_ = false;
+    return Pending();
+  }
+
+  std::atomic<bool> started_ = false;
+  std::atomic<bool> in_pend_ = false;
+  bool in_pend_after_deregister_ = true;
+  Waker waker_;
+};
+
+TEST(WorkStealingDispatcher, Deregister_WaitsForTaskBeingPolled) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  SlowTask task;
+  dispatcher.Post(task);
+
+  Thread work_thread(thread::stl::Options(),
+                     [&task] { task.DeregisterWhilePolled(); });
+
+  dispatcher.RunToCompletion();
+  work_thread.join();
+
+  EXPECT_FALSE(task.in_pend_after_deregister());
+  EXPECT_FALSE(task.IsRegistered());
+}
+
+TEST(WorkStealingDispatcher, Deregister_RemovesTaskFromWorkerQueue) {
+  Dispatcher dispatcher;
+
+  std::atomic<size_t> running = 0;
+  std::array<RendezvousTask, 1> children{RendezvousTask(running, 1)};
+  ParentTask parent(children);
+  dispatcher.Post(parent);
+
+  // The child is left in the calling thread's worker queue.
+  EXPECT_TRUE(dispatcher.RunUntilStalled(parent).IsReady());
+  children[0].Deregister();
+  EXPECT_FALSE(children[0].IsRegistered());
+
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  EXPECT_FALSE(children[0].met());
+  EXPECT_EQ(running.load(), 0u);
+}
+
+TEST(WorkStealingDispatcher, RunUntilStalled_KeepsTasksQueuedAfterMainTask) {
+  Dispatcher dispatcher;
+
+  std::atomic<size_t> running = 0;
+  std::array<RendezvousTask, 1> children{RendezvousTask(running, 1)};
+  ParentTask parent(children);
+  dispatcher.Post(parent);
+
+  // The child is queued on the calling thread's worker when the parent
+  // completes, and must still be registered afterwards.
+  EXPECT_TRUE(dispatcher.RunUntilStalled(parent).IsReady());
+  EXPECT_TRUE(children[0].IsRegistered());
+
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  EXPECT_FALSE(children[0].IsRegistered());
+  EXPECT_TRUE(children[0].met());
+}
+
+TEST(WorkStealingDispatcher, RunToCompletion_CanBeCalledRepeatedly) {
+  Dispatcher dispatcher;
+  dispatcher.native().NativeSetWorkerCount(kWorkers);
+
+  for (int i = 0; i < 10; ++i) {
+    std::atomic<size_t> running = 0;
+    RendezvousTask task(running, 1);
+    dispatcher.Post(task);
+    dispatcher.RunToCompletion();
+    EXPECT_TRUE(task.met());
+  }
+  EXPECT_EQ(dispatcher.tasks_completed(), 10u);
+}
+
+}  // namespace
+}  // namespace pw::async2
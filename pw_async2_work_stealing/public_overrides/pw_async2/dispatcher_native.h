@@ -0,0 +1,169 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pw_async2/dispatcher_base.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+
+namespace pw::async2::backend {
+
+// GCC doesn't realize the nonvirtual destructor is protected and that the
+// class is final.
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wnon-virtual-dtor");
+
+// A ``Dispatcher`` backend that runs tasks on a pool of worker threads.
+//
+// Each worker has its own run queue. A task woken on a worker thread, e.g. by
+// another task, is queued on that worker. Tasks posted or woken from any other
+// thread go to a shared injection queue. A worker with an empty queue takes a
+// task from the injection queue, or else steals half of another worker's
+// queue.
+//
+// ``RunToCompletion`` runs tasks on every worker: the calling thread is one
+// worker and the others are threads that the dispatcher starts on first use
+// and parks between calls. ``RunUntilStalled`` runs tasks on the calling
+// thread only.
+//
+// Each worker's queue has its own lock, so workers take tasks from their own
+// queues and steal from each other without the dispatcher lock. It is only
+// taken to start running a task, and to queue or remove a woken task.
+//
+// A task is never polled by two workers at once, but different tasks may be
+// polled at the same time, so state shared between tasks must be synchronized.
+class NativeDispatcher final : public NativeDispatcherBase {
+ public:
+  // Uses one worker per hardware thread.
+  NativeDispatcher();
+
+  ~NativeDispatcher();
+
+  // Sets how many workers ``RunToCompletion`` uses, including the calling
+  // thread. Must not be called while the dispatcher is running.
+  void NativeSetWorkerCount(size_t count);
+
+  size_t NativeWorkerCount() const { return workers_.size(); }
+
+ private:
+  friend class ::pw::async2::Dispatcher;
+
+  struct Worker {
+    Worker(NativeDispatcher& owner, size_t worker_index)
+        : dispatcher(owner), index(worker_index) {}
+
+    NativeDispatcher& dispatcher;
+    const size_t index;
+
+    // Guards ``queue`` and ``claimed``. When this is held with the dispatcher
+    // lock, the dispatcher lock is taken first. When several workers' locks
+    // are held, they are taken in index order.
+    sync::Mutex lock;
+
+    TaskQueue queue PW_GUARDED_BY(lock);
+
+    // A task taken from a queue that this worker is about to start. It is
+    // still woken, and counted in ``queued_tasks_``, until then.
+    Task* claimed PW_GUARDED_BY(lock) = nullptr;
+
+    bool idle PW_GUARDED_BY(impl::dispatcher_lock()) = false;
+
+    // Released to wake the worker while it is idle.
+    sync::ThreadNotification wake;
+
+    // Used to start and join runs on parked worker threads. Worker 0 runs on
+    // the thread that called ``RunToCompletion`` and does not use these.
+    sync::ThreadNotification start;
+    sync::ThreadNotification finished;
+    std::thread thread;
+  };
+
+  void DoWake() final;
+  void DoEnqueueWokenTask(Task& task) final
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+  // Locks every worker's queue, which the analysis cannot follow.
+  void DoRemoveWokenTask(Task& task) final
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock())
+          PW_NO_LOCK_SAFETY_ANALYSIS;
+  void DoWaitForRunningTask() final
+      PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
+  Poll<> DoRunUntilStalled(Dispatcher&, Task* task);
+  void DoRunToCompletion(Dispatcher&, Task* task);
+
+  // Runs tasks on ``worker`` until the run is stopped.
+  void RunWorker(Worker& worker) PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
+
+  // Parks a worker thread between runs.
+  void ParkWorker(Worker& worker);
+
+  void StartWorkerThreads();
+  void StopWorkerThreads();
+
+  // Claims the first task in ``worker``'s queue, if any.
+  void ClaimQueuedTask(Worker& worker)
+      PW_LOCKS_EXCLUDED(impl::dispatcher_lock());
+
+  // Moves half of another worker's queue to ``thief`` and claims a task from
+  // it, if any worker has queued tasks. The two workers' locks are taken in
+  // index order, which the analysis cannot follow.
+  void StealTask(Worker& thief) PW_LOCKS_EXCLUDED(impl::dispatcher_lock())
+      PW_NO_LOCK_SAFETY_ANALYSIS;
+
+  // Starts the task ``worker`` claimed or, if it has none, a task from the
+  // injection queue. Returns ``nullptr`` if there is neither.
+  Task* StartNextTaskLocked(Worker& worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  void WakeIdleWorkerLocked()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  // Ends the current run and wakes every worker so that it can return.
+  void StopRunLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  // Moves tasks left in worker queues, or claimed by workers, at the end of a
+  // run to the injection queue, where ``NativeDispatcherBase`` can find them.
+  void ReturnQueuedTasksLocked()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(impl::dispatcher_lock());
+
+  // The worker that the current thread is running, if any.
+  static thread_local Worker* current_worker_;
+
+  // Only modified while the dispatcher is not running.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  bool threads_started_ = false;
+  bool shutting_down_ = false;
+
+  // Set for the duration of a ``RunToCompletion`` call.
+  Dispatcher* dispatcher_ = nullptr;
+  Task* main_task_ = nullptr;
+
+  size_t running_tasks_ PW_GUARDED_BY(impl::dispatcher_lock()) = 0;
+
+  // Woken tasks in worker queues or claimed by workers. Workers move these
+  // tasks without the dispatcher lock, so this is how a worker that holds it
+  // knows whether any are left.
+  size_t queued_tasks_ PW_GUARDED_BY(impl::dispatcher_lock()) = 0;
+  size_t idle_workers_ PW_GUARDED_BY(impl::dispatcher_lock()) = 0;
+  bool stopped_ PW_GUARDED_BY(impl::dispatcher_lock()) = false;
+};
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+}  // namespace pw::async2::backend
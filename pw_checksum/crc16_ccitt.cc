@@ -14,6 +14,17 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PW_CHECKSUM_CRC16_CCITT_X86_CLMUL 1
+#else
+#define PW_CHECKSUM_CRC16_CCITT_X86_CLMUL 0
+#endif
+
 namespace pw::checksum {
 namespace {
 
@@ -52,11 +63,151 @@ constexpr uint16_t kCrc16CcittTable[256]{
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
 };
 
+// Generates slicing tables from kCrc16CcittTable, as crc32.cc does for CRC32.
+template <size_t kSlices>
+constexpr std::array<std::array<uint16_t, 256>, kSlices>
+GenerateCrc16CcittSlicingTables() {
+  std::array<std::array<uint16_t, 256>, kSlices> tables{};
+  for (size_t i = 0; i < 256; ++i) {
+    tables[0][i] = kCrc16CcittTable[i];
+  }
+  for (size_t k = 1; k < kSlices; ++k) {
+    for (size_t i = 0; i < 256; ++i) {
+      uint16_t prev = tables[k - 1][i];
+      tables[k][i] = kCrc16CcittTable[prev >> 8u] ^
+                     static_cast<uint16_t>(prev << 8u);
+    }
+  }
+  return tables;
+}
+
+// This CRC is not reflected, so the CRC is combined with the first two bytes
+// of each block.
+template <size_t kSlices>
+uint16_t Crc16CcittSliceBy(const uint8_t* data,
+                           size_t size_bytes,
+                           uint16_t value) {
+  static_assert(kSlices >= sizeof(uint16_t));
+  static constexpr std::array<std::array<uint16_t, 256>, kSlices> kTables =
+      GenerateCrc16CcittSlicingTables<kSlices>();
+
+  for (; size_bytes >= kSlices; size_bytes -= kSlices, data += kSlices) {
+    uint16_t next = kTables[kSlices - 1][data[0] ^ (value >> 8u)] ^
+                    kTables[kSlices - 2][data[1] ^ (value & 0xffu)];
+    for (size_t i = 2; i < kSlices; ++i) {
+      next ^= kTables[kSlices - 1 - i][data[i]];
+    }
+    value = next;
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    value = kTables[0][((value >> 8u) ^ data[i]) & 0xffu] ^
+            static_cast<uint16_t>(value << 8u);
+  }
+  return value;
+}
+
+#if PW_CHECKSUM_CRC16_CCITT_X86_CLMUL
+
+constexpr size_t kClmulMinSize = 64;
+
+// Returns x^n mod P(x), where P(x) is the CRC-16-CCITT polynomial including
+// its x^16 term.
+constexpr uint64_t PowerOfXMod(size_t n) {
+  constexpr uint32_t kPolynomial = 0x11021;
+  uint32_t value = 1;
+  for (size_t i = 0; i < n; ++i) {
+    value <<= 1;
+    if ((value & 0x10000u) != 0) {
+      value ^= kPolynomial;
+    }
+  }
+  return value;
+}
+
+#define PW_CHECKSUM_CRC16_CCITT_CLMUL_TARGET \
+  __attribute__((target("pclmul,ssse3")))
+
+// Loads 16 bytes so that the first byte occupies the most significant bits,
+// matching the bit order of this CRC.
+PW_CHECKSUM_CRC16_CCITT_CLMUL_TARGET inline __m128i LoadReversed(
+    const uint8_t* data) {
+  const __m128i kReverse =
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  return _mm_shuffle_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), kReverse);
+}
+
+// The result is only congruent to the exact product modulo the polynomial,
+// which is all that the CRC depends on.
+PW_CHECKSUM_CRC16_CCITT_CLMUL_TARGET inline __m128i Fold(__m128i x,
+                                                         __m128i k,
+                                                         __m128i next) {
+  __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+  __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// Folds as Crc32Clmul() in crc32.cc does, but without bit reflection.
+// `size_bytes` must be a multiple of 16 and at least `kClmulMinSize`. The final
+// 128 bits are reduced with the lookup table rather than Barrett reduction.
+PW_CHECKSUM_CRC16_CCITT_CLMUL_TARGET uint16_t
+Crc16CcittClmul(const uint8_t* data, size_t size_bytes, uint16_t value) {
+  const __m128i k512 = _mm_set_epi64x(static_cast<int64_t>(PowerOfXMod(576)),
+                                      static_cast<int64_t>(PowerOfXMod(512)));
+  const __m128i k128 = _mm_set_epi64x(static_cast<int64_t>(PowerOfXMod(192)),
+                                      static_cast<int64_t>(PowerOfXMod(128)));
+
+  // The initial value is added to the first 16 bits of the message.
+  __m128i x1 = _mm_xor_si128(
+      LoadReversed(data),
+      _mm_set_epi64x(static_cast<int64_t>(uint64_t{value} << 48), 0));
+  __m128i x2 = LoadReversed(data + 16);
+  __m128i x3 = LoadReversed(data + 32);
+  __m128i x4 = LoadReversed(data + 48);
+  data += 64;
+  size_bytes -= 64;
+
+  while (size_bytes >= 64) {
+    x1 = Fold(x1, k512, LoadReversed(data));
+    x2 = Fold(x2, k512, LoadReversed(data + 16));
+    x3 = Fold(x3, k512, LoadReversed(data + 32));
+    x4 = Fold(x4, k512, LoadReversed(data + 48));
+    data += 64;
+    size_bytes -= 64;
+  }
+
+  x1 = Fold(x1, k128, x2);
+  x1 = Fold(x1, k128, x3);
+  x1 = Fold(x1, k128, x4);
+  while (size_bytes >= 16) {
+    x1 = Fold(x1, k128, LoadReversed(data));
+    data += 16;
+    size_bytes -= 16;
+  }
+
+  // The remainder of the folded value is the CRC, with an initial value of
+  // zero, of its bytes in the original order.
+  alignas(16) uint8_t folded[16];
+  const __m128i kReverse =
+      _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  _mm_store_si128(reinterpret_cast<__m128i*>(folded),
+                  _mm_shuffle_epi8(x1, kReverse));
+  return Crc16CcittSliceBy<8>(folded, sizeof(folded), 0);
+}
+
+bool HasClmul() {
+  static const bool kHasClmul =
+      __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+  return kHasClmul;
+}
+
+#endif  // PW_CHECKSUM_CRC16_CCITT_X86_CLMUL
+
 }  // namespace
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittEightBit(
+    const void* data, size_t size_bytes, uint16_t value) {
   const uint8_t* const array = static_cast<const uint8_t*>(data);
 
   for (size_t i = 0; i < size_bytes; ++i) {
@@ -67,4 +218,44 @@ extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
   return value;
 }
 
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSliceBy4(
+    const void* data, size_t size_bytes, uint16_t value) {
+  return Crc16CcittSliceBy<4>(
+      static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSliceBy8(
+    const void* data, size_t size_bytes, uint16_t value) {
+  return Crc16CcittSliceBy<8>(
+      static_cast<const uint8_t*>(data), size_bytes, value);
+}
+
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittHardware(
+    const void* data, size_t size_bytes, uint16_t value) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+#if PW_CHECKSUM_CRC16_CCITT_X86_CLMUL
+  if (size_bytes >= kClmulMinSize && HasClmul()) {
+    size_t folded = size_bytes & ~size_t{15};
+    value = Crc16CcittClmul(array, folded, value);
+    array += folded;
+    size_bytes -= folded;
+  }
+#endif  // PW_CHECKSUM_CRC16_CCITT_X86_CLMUL
+  return Crc16CcittSliceBy<8>(array, size_bytes, value);
+}
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+#if PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_8BITS
+  return _pw_checksum_InternalCrc16CcittEightBit(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_SLICE_BY_4
+  return _pw_checksum_InternalCrc16CcittSliceBy4(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_SLICE_BY_8
+  return _pw_checksum_InternalCrc16CcittSliceBy8(data, size_bytes, value);
+#elif PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL == PW_CHECKSUM_CRC16_CCITT_HARDWARE
+  return _pw_checksum_InternalCrc16CcittHardware(data, size_bytes, value);
+#endif
+}
+
 }  // namespace pw::checksum
@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <string_view>
 
 #include "pw_bytes/array.h"
@@ -33,5 +34,51 @@ PW_PERF_TEST_SIMPLE(CcittCalculationString,
                     Crc16Ccitt::Calculate,
                     as_bytes(span(kString)));
 
+// The following tests compare the implementations at several buffer sizes.
+// The throughput of each is the buffer size divided by the mean duration that
+// is reported; for example, 4096 bytes in 2000 ns is 2048 MB/s. The contents
+// of the buffers do not affect the timing.
+std::array<std::byte, 64> k64B{};
+std::array<std::byte, 1024> k1KiB{};
+std::array<std::byte, 16384> k16KiB{};
+
+template <typename CrcVariant>
+void CcittVariantTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    CrcVariant::Calculate(data);
+  }
+}
+
+PW_PERF_TEST(CcittEightBit64BTest, CcittVariantTest<Crc16CcittEightBit>, k64B);
+PW_PERF_TEST(CcittSliceBy464BTest, CcittVariantTest<Crc16CcittSliceBy4>, k64B);
+PW_PERF_TEST(CcittSliceBy864BTest, CcittVariantTest<Crc16CcittSliceBy8>, k64B);
+PW_PERF_TEST(CcittHardware64BTest, CcittVariantTest<Crc16CcittHardware>, k64B);
+
+PW_PERF_TEST(CcittEightBit1KiBTest,
+             CcittVariantTest<Crc16CcittEightBit>,
+             k1KiB);
+PW_PERF_TEST(CcittSliceBy41KiBTest,
+             CcittVariantTest<Crc16CcittSliceBy4>,
+             k1KiB);
+PW_PERF_TEST(CcittSliceBy81KiBTest,
+             CcittVariantTest<Crc16CcittSliceBy8>,
+             k1KiB);
+PW_PERF_TEST(CcittHardware1KiBTest,
+             CcittVariantTest<Crc16CcittHardware>,
+             k1KiB);
+
+PW_PERF_TEST(CcittEightBit16KiBTest,
+             CcittVariantTest<Crc16CcittEightBit>,
+             k16KiB);
+PW_PERF_TEST(CcittSliceBy416KiBTest,
+             CcittVariantTest<Crc16CcittSliceBy4>,
+             k16KiB);
+PW_PERF_TEST(CcittSliceBy816KiBTest,
+             CcittVariantTest<Crc16CcittSliceBy8>,
+             k16KiB);
+PW_PERF_TEST(CcittHardware16KiBTest,
+             CcittVariantTest<Crc16CcittHardware>,
+             k16KiB);
+
 }  // namespace
 }  // namespace pw::checksum
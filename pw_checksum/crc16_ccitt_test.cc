@@ -14,8 +14,11 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+#include <cstddef>
 #include <string_view>
 
+#include "pw_checksum_private/test_helpers.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::checksum {
@@ -67,6 +70,81 @@ TEST(Crc16Class, String) {
   EXPECT_EQ(crc16.value(), kStringCrc);
 }
 
+template <typename CrcVariant>
+void TestVariant() {
+  EXPECT_EQ(CrcVariant::Calculate(span<std::byte>()),
+            CrcVariant::kInitialValue);
+  EXPECT_EQ(CrcVariant::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(CrcVariant::Calculate(as_bytes(span(kString))), kStringCrc);
+
+  CrcVariant crc16;
+  for (size_t i = 0; i < sizeof(kBytes); i++) {
+    crc16.Update(std::byte{kBytes[i]});
+  }
+  EXPECT_EQ(crc16.value(), kBufferCrc);
+}
+
+TEST(Crc16Variants, KnownValues) {
+  TestVariant<Crc16CcittEightBit>();
+  TestVariant<Crc16CcittSliceBy4>();
+  TestVariant<Crc16CcittSliceBy8>();
+  TestVariant<Crc16CcittHardware>();
+}
+
+// Exercises the multi-byte paths of the faster implementations, including
+// unaligned starts and lengths that leave a partial block.
+template <typename CrcVariant>
+void TestLargeBuffer() {
+  constexpr size_t kOffsets[] = {0, 1, 3, 7};
+  constexpr size_t kLengths[] = {0, 15, 16, 63, 64, 65, 127, 1000, 1024};
+  test::ExpectMatchesReference<CrcVariant, Crc16CcittEightBit>(
+      test::RandomBuffer(), kOffsets, kLengths);
+}
+
+TEST(Crc16Variants, LargeBuffer) {
+  TestLargeBuffer<Crc16Ccitt>();
+  TestLargeBuffer<Crc16CcittSliceBy4>();
+  TestLargeBuffer<Crc16CcittSliceBy8>();
+  TestLargeBuffer<Crc16CcittHardware>();
+}
+
+// Crc16CcittHardware folds buffers of at least 64 bytes in 16-byte blocks and
+// finishes the tail with slicing-by-8. Checks every length from below that
+// threshold to past two extra folded blocks, so each tail length follows zero,
+// one, and two extra blocks, from every 16-byte alignment.
+template <typename CrcVariant>
+void TestFoldingThreshold() {
+  std::array<size_t, 16> offsets;
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    offsets[i] = i;
+  }
+  std::array<size_t, 64> lengths;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    lengths[i] = 48 + i;
+  }
+  test::ExpectMatchesReference<CrcVariant, Crc16CcittEightBit>(
+      test::RandomBuffer(), offsets, lengths);
+}
+
+TEST(Crc16Variants, FoldingThreshold) {
+  TestFoldingThreshold<Crc16CcittSliceBy4>();
+  TestFoldingThreshold<Crc16CcittSliceBy8>();
+  TestFoldingThreshold<Crc16CcittHardware>();
+}
+
+// Unlike CRC32, CRC-16-CCITT is often calculated with an initial value of 0
+// (e.g. XMODEM), which the folding path adds to the first block.
+TEST(Crc16Variants, ZeroInitialValue) {
+  const test::RandomBuffer buffer;
+  for (size_t length : {size_t{0}, size_t{9}, size_t{64}, size_t{200}}) {
+    const span<const std::byte> data = buffer.bytes().first(length);
+    const uint16_t expected = Crc16CcittEightBit::Calculate(data, 0);
+    EXPECT_EQ(Crc16CcittSliceBy4::Calculate(data, 0), expected);
+    EXPECT_EQ(Crc16CcittSliceBy8::Calculate(data, 0), expected);
+    EXPECT_EQ(Crc16CcittHardware::Calculate(data, 0), expected);
+  }
+}
+
 extern "C" uint16_t CallChecksumCrc16Ccitt(const void* data, size_t size_bytes);
 
 TEST(Crc16FromC, Buffer) {
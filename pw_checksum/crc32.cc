@@ -15,6 +15,22 @@
 #include "pw_checksum/crc32.h"
 
 #include <array>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define PW_CHECKSUM_CRC32_ARM_CRC 1
+#else
+#define PW_CHECKSUM_CRC32_ARM_CRC 0
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PW_CHECKSUM_CRC32_X86_CLMUL 1
+#else
+#define PW_CHECKSUM_CRC32_X86_CLMUL 0
+#endif
 
 namespace pw::checksum {
 namespace {
@@ -53,6 +69,145 @@ constexpr std::array<uint32_t, (1 << kBits)> GenerateCrc32Table() {
 // https://en.wikipedia.org/wiki/Cyclic_redundancy_check#Polynomial_representations_of_cyclic_redundancy_checks
 constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
 
+// Generates the lookup tables for a slicing-by-kSlices CRC32 implementation.
+// Table 0 is the usual 8-bit table. Table k holds the CRC of each byte value
+// followed by k zero bytes, which lets kSlices bytes be processed with
+// independent lookups.
+//
+// See "A Systematic Approach to Building High Performance, Software-based,
+// CRC Generators" by Kounavis and Berry.
+template <std::size_t kSlices, uint32_t kPolynomial>
+constexpr std::array<std::array<uint32_t, 256>, kSlices>
+GenerateCrc32SlicingTables() {
+  std::array<std::array<uint32_t, 256>, kSlices> tables{};
+  tables[0] = GenerateCrc32Table<8, kPolynomial>();
+  for (std::size_t k = 1; k < kSlices; ++k) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      uint32_t prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+// Processes kSlices bytes per iteration using kSlices table lookups. Bytes are
+// read individually, so the result does not depend on the host's endianness or
+// the alignment of the data.
+template <std::size_t kSlices>
+uint32_t Crc32SliceBy(const uint8_t* data, size_t size_bytes, uint32_t state) {
+  static_assert(kSlices >= sizeof(uint32_t));
+  static constexpr std::array<std::array<uint32_t, 256>, kSlices> kTables =
+      GenerateCrc32SlicingTables<kSlices, kCrc32Polynomial>();
+
+  for (; size_bytes >= kSlices; size_bytes -= kSlices, data += kSlices) {
+    uint32_t next = 0;
+    for (std::size_t i = 0; i < kSlices; ++i) {
+      uint32_t byte = data[i];
+      if (i < sizeof(uint32_t)) {
+        byte ^= (state >> (8 * i)) & 0xFFu;
+      }
+      next ^= kTables[kSlices - 1 - i][byte];
+    }
+    state = next;
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = kTables[0][(state ^ data[i]) & 0xFFu] ^ (state >> 8);
+  }
+  return state;
+}
+
+#if PW_CHECKSUM_CRC32_X86_CLMUL
+
+// Buffers shorter than this are not worth folding.
+constexpr size_t kClmulMinSize = 64;
+
+// Calculates the CRC32 of a buffer using carry-less multiplication, as
+// described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction" by Gopal et al. `size_bytes` must be a multiple of 16 and at
+// least `kClmulMinSize`.
+//
+// The constants are the bit-reflected fold constants and Barrett reduction
+// parameters for the CRC32 polynomial given at the end of that paper.
+#define PW_CHECKSUM_CRC32_CLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+
+PW_CHECKSUM_CRC32_CLMUL_TARGET inline __m128i Load(const uint8_t* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Multiplies each half of x by the matching half of k, moving it 128 or more
+// bits forward, then adds the next block of data.
+PW_CHECKSUM_CRC32_CLMUL_TARGET inline __m128i Fold(__m128i x,
+                                                   __m128i k,
+                                                   __m128i next) {
+  __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+  __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+PW_CHECKSUM_CRC32_CLMUL_TARGET uint32_t Crc32Clmul(
+    const uint8_t* data, size_t size_bytes, uint32_t state) {
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  // Fold four 128-bit lanes in parallel over each 64 byte block.
+  __m128i x1 = _mm_xor_si128(Load(data),
+                             _mm_cvtsi32_si128(static_cast<int>(state)));
+  __m128i x2 = Load(data + 16);
+  __m128i x3 = Load(data + 32);
+  __m128i x4 = Load(data + 48);
+  data += 64;
+  size_bytes -= 64;
+
+  while (size_bytes >= 64) {
+    x1 = Fold(x1, k1k2, Load(data));
+    x2 = Fold(x2, k1k2, Load(data + 16));
+    x3 = Fold(x3, k1k2, Load(data + 32));
+    x4 = Fold(x4, k1k2, Load(data + 48));
+    data += 64;
+    size_bytes -= 64;
+  }
+
+  // Fold the lanes into a single 128-bit value, then fold any remaining
+  // 16 byte blocks into it.
+  x1 = Fold(x1, k3k4, x2);
+  x1 = Fold(x1, k3k4, x3);
+  x1 = Fold(x1, k3k4, x4);
+  while (size_bytes >= 16) {
+    x1 = Fold(x1, k3k4, Load(data));
+    data += 16;
+    size_bytes -= 16;
+  }
+
+  // Fold 128 bits to 64 bits.
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask32);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduce to 32 bits.
+  x2 = _mm_and_si128(x1, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, mask32);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+bool HasClmul() {
+  static const bool kHasClmul =
+      __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+  return kHasClmul;
+}
+
+#endif  // PW_CHECKSUM_CRC32_X86_CLMUL
+
 }  // namespace
 
 extern "C" uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
@@ -97,4 +252,46 @@ extern "C" uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
   return state;
 }
 
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy8(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  return Crc32SliceBy<8>(static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy16(const void* data,
+                                                        size_t size_bytes,
+                                                        uint32_t state) {
+  return Crc32SliceBy<16>(
+      static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+#if PW_CHECKSUM_CRC32_ARM_CRC
+  for (; size_bytes >= sizeof(uint64_t); size_bytes -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data_bytes, sizeof(word));
+    state = __crc32d(state, word);
+    data_bytes += sizeof(uint64_t);
+  }
+  for (; size_bytes != 0; --size_bytes) {
+    state = __crc32b(state, *data_bytes++);
+  }
+  return state;
+#else
+#if PW_CHECKSUM_CRC32_X86_CLMUL
+  if (size_bytes >= kClmulMinSize && HasClmul()) {
+    size_t folded = size_bytes & ~size_t{15};
+    state = Crc32Clmul(data_bytes, folded, state);
+    data_bytes += folded;
+    size_bytes -= folded;
+  }
+#endif  // PW_CHECKSUM_CRC32_X86_CLMUL
+  return Crc32SliceBy<8>(data_bytes, size_bytes, state);
+#endif  // PW_CHECKSUM_CRC32_ARM_CRC
+}
+
 }  // namespace pw::checksum
@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <cstdint>
 #include <string_view>
 
@@ -28,6 +29,11 @@ constexpr std::string_view kString =
     "people very angry and been widely regarded as a bad move.";
 constexpr auto kBytes = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9>();
 
+// Large buffers show the throughput of the implementations that process more
+// than one byte per iteration. The contents do not affect the timing.
+std::array<std::byte, 4096> k4KiB{};
+std::array<std::byte, 65536> k64KiB{};
+
 void Crc32OneBitTest(perf_test::State& state, span<const std::byte> data) {
   while (state.KeepRunning()) {
     Crc32OneBit::Calculate(data);
@@ -46,6 +52,24 @@ void Crc32EightBitTest(perf_test::State& state, span<const std::byte> data) {
   }
 }
 
+void Crc32SliceBy8Test(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32SliceBy8::Calculate(data);
+  }
+}
+
+void Crc32SliceBy16Test(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32SliceBy16::Calculate(data);
+  }
+}
+
+void Crc32HardwareTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32Hardware::Calculate(data);
+  }
+}
+
 PW_PERF_TEST(CrcOneBitStringTest, Crc32OneBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcFourBitStringTest, Crc32FourBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcEightBitStringTest, Crc32EightBitTest, as_bytes(span(kString)));
@@ -54,5 +78,25 @@ PW_PERF_TEST(CrcOneBitBytesTest, Crc32OneBitTest, kBytes);
 PW_PERF_TEST(CrcFourBitBytesTest, Crc32FourBitTest, kBytes);
 PW_PERF_TEST(CrcEightBitBytesTest, Crc32EightBitTest, kBytes);
 
+PW_PERF_TEST(CrcSliceBy8StringTest,
+             Crc32SliceBy8Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcSliceBy16StringTest,
+             Crc32SliceBy16Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcHardwareStringTest,
+             Crc32HardwareTest,
+             as_bytes(span(kString)));
+
+PW_PERF_TEST(CrcEightBit4KiBTest, Crc32EightBitTest, k4KiB);
+PW_PERF_TEST(CrcSliceBy84KiBTest, Crc32SliceBy8Test, k4KiB);
+PW_PERF_TEST(CrcSliceBy164KiBTest, Crc32SliceBy16Test, k4KiB);
+PW_PERF_TEST(CrcHardware4KiBTest, Crc32HardwareTest, k4KiB);
+
+PW_PERF_TEST(CrcEightBit64KiBTest, Crc32EightBitTest, k64KiB);
+PW_PERF_TEST(CrcSliceBy864KiBTest, Crc32SliceBy8Test, k64KiB);
+PW_PERF_TEST(CrcSliceBy1664KiBTest, Crc32SliceBy16Test, k64KiB);
+PW_PERF_TEST(CrcHardware64KiBTest, Crc32HardwareTest, k64KiB);
+
 }  // namespace
 }  // namespace pw::checksum
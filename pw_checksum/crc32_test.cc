@@ -13,10 +13,12 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <array>
 #include <string_view>
 
 #include "pw_bytes/array.h"
 #include "pw_checksum/crc32.h"
+#include "pw_checksum_private/test_helpers.h"
 #include "pw_span/span.h"
 #include "pw_unit_test/framework.h"
 
@@ -46,6 +48,12 @@ TEST(Crc32, Empty) {
   EXPECT_EQ(Crc32FourBit::Calculate(span<std::byte>()),
             PW_CHECKSUM_EMPTY_CRC32);
   EXPECT_EQ(Crc32OneBit::Calculate(span<std::byte>()), PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32Hardware::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
 }
 
 TEST(Crc32, Buffer) {
@@ -53,6 +61,9 @@ TEST(Crc32, Buffer) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kBytes))), kBufferCrc);
 }
 
 TEST(Crc32, String) {
@@ -60,6 +71,9 @@ TEST(Crc32, String) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kString))), kStringCrc);
 }
 
 template <typename CrcVariant>
@@ -76,6 +90,9 @@ TEST(Crc32Class, ByteByByte) {
   TestByByte<Crc32EightBit>();
   TestByByte<Crc32FourBit>();
   TestByByte<Crc32OneBit>();
+  TestByByte<Crc32SliceBy8>();
+  TestByByte<Crc32SliceBy16>();
+  TestByByte<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -90,6 +107,9 @@ TEST(Crc32Class, Buffer) {
   TestBuffer<Crc32EightBit>();
   TestBuffer<Crc32FourBit>();
   TestBuffer<Crc32OneBit>();
+  TestBuffer<Crc32SliceBy8>();
+  TestBuffer<Crc32SliceBy16>();
+  TestBuffer<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -105,6 +125,9 @@ TEST(Crc32Class, BufferAppend) {
   TestBufferAppend<Crc32EightBit>();
   TestBufferAppend<Crc32FourBit>();
   TestBufferAppend<Crc32OneBit>();
+  TestBufferAppend<Crc32SliceBy8>();
+  TestBufferAppend<Crc32SliceBy16>();
+  TestBufferAppend<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -119,6 +142,28 @@ TEST(Crc32Class, String) {
   TestString<Crc32EightBit>();
   TestString<Crc32FourBit>();
   TestString<Crc32OneBit>();
+  TestString<Crc32SliceBy8>();
+  TestString<Crc32SliceBy16>();
+  TestString<Crc32Hardware>();
+}
+
+// Exercises the multi-byte paths of the faster implementations, including
+// unaligned starts and lengths that leave a partial block.
+template <typename CrcVariant>
+void TestLargeBuffer() {
+  constexpr size_t kOffsets[] = {0, 1, 3, 7};
+  constexpr size_t kLengths[] = {0, 15, 16, 63, 64, 65, 127, 1000, 1024};
+  test::ExpectMatchesReference<CrcVariant, Crc32EightBit>(
+      test::RandomBuffer(), kOffsets, kLengths);
+}
+
+TEST(Crc32Class, LargeBuffer) {
+  TestLargeBuffer<Crc32>();
+  TestLargeBuffer<Crc32FourBit>();
+  TestLargeBuffer<Crc32OneBit>();
+  TestLargeBuffer<Crc32SliceBy8>();
+  TestLargeBuffer<Crc32SliceBy16>();
+  TestLargeBuffer<Crc32Hardware>();
 }
 
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
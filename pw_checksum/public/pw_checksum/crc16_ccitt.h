@@ -23,6 +23,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "pw_checksum/internal/config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -32,6 +34,21 @@ uint16_t pw_checksum_Crc16Ccitt(const void* data,
                                 size_t size_bytes,
                                 uint16_t initial_value);
 
+// Internal implementation functions for CRC-16-CCITT. Do not call them
+// directly.
+uint16_t _pw_checksum_InternalCrc16CcittEightBit(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+uint16_t _pw_checksum_InternalCrc16CcittSliceBy4(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+uint16_t _pw_checksum_InternalCrc16CcittSliceBy8(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+uint16_t _pw_checksum_InternalCrc16CcittHardware(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t value);
+
 #ifdef __cplusplus
 }  // extern "C"
 
@@ -41,7 +58,8 @@ uint16_t pw_checksum_Crc16Ccitt(const void* data,
 namespace pw::checksum {
 
 // Calculates the CRC-16-CCITT for all data passed to Update.
-class Crc16Ccitt {
+template <uint16_t (*kChecksumFunction)(const void*, size_t, uint16_t)>
+class Crc16CcittImpl {
  public:
   static constexpr uint16_t kInitialValue = 0xFFFF;
 
@@ -50,8 +68,7 @@ class Crc16Ccitt {
   // Crc16Ccitt class or pass the previous value as the initial_value argument.
   static uint16_t Calculate(span<const std::byte> data,
                             uint16_t initial_value = kInitialValue) {
-    return pw_checksum_Crc16Ccitt(
-        data.data(), data.size_bytes(), initial_value);
+    return kChecksumFunction(data.data(), data.size_bytes(), initial_value);
   }
 
   static uint16_t Calculate(std::byte data,
@@ -59,7 +76,7 @@ class Crc16Ccitt {
     return Calculate(ConstByteSpan(&data, 1), initial_value);
   }
 
-  constexpr Crc16Ccitt() : value_(kInitialValue) {}
+  constexpr Crc16CcittImpl() : value_(kInitialValue) {}
 
   void Update(span<const std::byte> data) { value_ = Calculate(data, value_); }
 
@@ -75,6 +92,17 @@ class Crc16Ccitt {
   uint16_t value_;
 };
 
+// Uses the implementation selected by PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL.
+using Crc16Ccitt = Crc16CcittImpl<pw_checksum_Crc16Ccitt>;
+using Crc16CcittEightBit =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittEightBit>;
+using Crc16CcittSliceBy4 =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittSliceBy4>;
+using Crc16CcittSliceBy8 =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittSliceBy8>;
+using Crc16CcittHardware =
+    Crc16CcittImpl<_pw_checksum_InternalCrc16CcittHardware>;
+
 }  // namespace pw::checksum
 
 #endif  // __cplusplus
@@ -17,13 +17,43 @@
 #define PW_CHECKSUM_CRC32_8BITS 8
 #define PW_CHECKSUM_CRC32_4BITS 4
 #define PW_CHECKSUM_CRC32_1BITS 1
+#define PW_CHECKSUM_CRC32_SLICE_BY_8 64
+#define PW_CHECKSUM_CRC32_SLICE_BY_16 128
+
+// Uses the CPU's CRC instructions when they are available at compile time
+// (ARMv8 CRC32) or at run time (x86 PCLMULQDQ), and slicing-by-8 otherwise.
+#define PW_CHECKSUM_CRC32_HARDWARE -1
 
 #ifndef PW_CHECKSUM_CRC32_DEFAULT_IMPL
 #define PW_CHECKSUM_CRC32_DEFAULT_IMPL PW_CHECKSUM_CRC32_8BITS
 #endif  // PW_CHECKSUM_CRC32_DEFAULT_IMPL
 
+#define PW_CHECKSUM_CRC16_CCITT_8BITS 8
+#define PW_CHECKSUM_CRC16_CCITT_SLICE_BY_4 32
+#define PW_CHECKSUM_CRC16_CCITT_SLICE_BY_8 64
+
+// Folds large buffers using x86 carry-less multiplication when PCLMULQDQ is
+// available at run time, and uses slicing-by-8 otherwise.
+#define PW_CHECKSUM_CRC16_CCITT_HARDWARE -1
+
+#ifndef PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL
+#define PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL PW_CHECKSUM_CRC16_CCITT_8BITS
+#endif  // PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL
+
 #ifdef __cplusplus
 static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS ||
-              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS);
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_8 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICE_BY_16 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE);
+static_assert(PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_8BITS ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_SLICE_BY_4 ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_SLICE_BY_8 ||
+              PW_CHECKSUM_CRC16_CCITT_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC16_CCITT_HARDWARE);
 #endif  // __cplusplus
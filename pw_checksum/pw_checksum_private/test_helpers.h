@@ -0,0 +1,66 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_random/xor_shift.h"
+#include "pw_span/span.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::checksum::test {
+
+// Pseudorandom bytes for comparing CRC implementations with each other.
+class RandomBuffer {
+ public:
+  static constexpr size_t kSize = 1040;
+
+  RandomBuffer() {
+    random::XorShiftStarRng64 rng(0x12345678u);
+    rng.Get(bytes_);
+  }
+
+  span<const std::byte> bytes() const { return bytes_; }
+
+ private:
+  std::array<std::byte, kSize> bytes_;
+};
+
+// Expects CrcVariant to match Reference, typically the byte-at-a-time
+// implementation, for every span of `buffer` that starts at one of `offsets`
+// and has one of `lengths`. Also checks that a CRC calculated in two parts
+// matches.
+template <typename CrcVariant, typename Reference>
+void ExpectMatchesReference(const RandomBuffer& buffer,
+                            span<const size_t> offsets,
+                            span<const size_t> lengths) {
+  for (size_t offset : offsets) {
+    for (size_t length : lengths) {
+      ASSERT_LE(offset + length, RandomBuffer::kSize);
+      const span<const std::byte> data =
+          buffer.bytes().subspan(offset, length);
+      EXPECT_EQ(CrcVariant::Calculate(data), Reference::Calculate(data))
+          << "offset " << offset << ", length " << length;
+    }
+  }
+
+  CrcVariant crc;
+  crc.Update(buffer.bytes().first(100));
+  crc.Update(buffer.bytes().subspan(100));
+  EXPECT_EQ(crc.value(), Reference::Calculate(buffer.bytes()));
+}
+
+}  // namespace pw::checksum::test
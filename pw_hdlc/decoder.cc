@@ -14,6 +14,16 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h>
+#define PW_HDLC_DECODER_SSE2 1
+#else
+#define PW_HDLC_DECODER_SSE2 0
+#endif
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -23,6 +33,56 @@
 using std::byte;
 
 namespace pw::hdlc {
+namespace {
+
+// Returns the index of the first flag or escape byte in `data`, or its size if
+// it contains neither.
+size_t FindControlByte(ConstByteSpan data) {
+  size_t i = 0;
+
+#if PW_HDLC_DECODER_SSE2
+  const __m128i flag_bytes = _mm_set1_epi8(static_cast<char>(kFlag));
+  const __m128i escape_bytes = _mm_set1_epi8(static_cast<char>(kEscape));
+  for (; i + sizeof(__m128i) <= data.size(); i += sizeof(__m128i)) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i]));
+    const int matches =
+        _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, flag_bytes),
+                                       _mm_cmpeq_epi8(block, escape_bytes)));
+    if (matches != 0) {
+      return i + static_cast<size_t>(
+                     __builtin_ctz(static_cast<unsigned>(matches)));
+    }
+  }
+#endif  // PW_HDLC_DECODER_SSE2
+
+  // Check a word at a time for a byte that is zero after XOR-ing with a flag
+  // or escape. This may report a false match after a true one, so the byte
+  // loop below finds the exact position.
+  constexpr uint64_t kLowBits = 0x0101010101010101u;
+  constexpr uint64_t kHighBits = 0x8080808080808080u;
+  constexpr uint64_t kFlags = kLowBits * static_cast<uint8_t>(kFlag);
+  constexpr uint64_t kEscapes = kLowBits * static_cast<uint8_t>(kEscape);
+  for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, &data[i], sizeof(word));
+    const uint64_t flags = word ^ kFlags;
+    const uint64_t escapes = word ^ kEscapes;
+    if ((((flags - kLowBits) & ~flags) | ((escapes - kLowBits) & ~escapes)) &
+        kHighBits) {
+      break;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (data[i] == kFlag || data[i] == kEscape) {
+      return i;
+    }
+  }
+  return data.size();
+}
+
+}  // namespace
 
 Result<Frame> Frame::Parse(ConstByteSpan frame) {
   uint64_t address;
@@ -118,6 +178,42 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+size_t Decoder::AppendUnescaped(ConstByteSpan data) {
+  const size_t run = FindControlByte(data);
+
+  // Short runs do not fully replace the ring buffer's contents.
+  if (run < last_read_bytes_.size()) {
+    for (size_t i = 0; i < run; ++i) {
+      AppendByte(data[i]);
+    }
+    return run;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    const size_t to_copy = std::min(run, max_size() - current_frame_size_);
+    std::memcpy(&buffer_[current_frame_size_], data.data(), to_copy);
+  }
+
+  // Every byte in the ring buffer is ejected by the run. Add them to the
+  // running checksum, oldest first, followed by all of the run except the
+  // bytes that replace them.
+  const size_t held = std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - held) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < held; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+  fcs_.Update(data.first(run - last_read_bytes_.size()));
+
+  const ConstByteSpan last = data.first(run).last(last_read_bytes_.size());
+  std::copy(last.begin(), last.end(), last_read_bytes_.begin());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += run;
+  return run;
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
@@ -0,0 +1,80 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr size_t kMaxPayloadSize = 1024;
+
+// Holds a stream of identical encoded frames. About 1 in 128 payload bytes
+// needs to be escaped, which is typical of arbitrary binary data.
+class EncodedFrames {
+ public:
+  EncodedFrames(size_t payload_size, size_t num_frames) {
+    std::array<std::byte, kMaxPayloadSize> payload;
+    for (size_t i = 0; i < payload.size(); ++i) {
+      payload[i] = static_cast<std::byte>(i * 13 + 1);
+    }
+    for (size_t i = 0; i < num_frames; ++i) {
+      WriteUIFrame(1, span(payload).first(payload_size), writer_)
+          .IgnoreError();
+    }
+  }
+
+  ConstByteSpan data() const { return writer_.WrittenData(); }
+
+ private:
+  stream::MemoryWriterBuffer<16 * 1024> writer_;
+};
+
+void DecodeByteByByte(perf_test::State& state, size_t payload_size) {
+  EncodedFrames frames(payload_size, 16 * kMaxPayloadSize / payload_size / 2);
+  DecoderBuffer<kMaxPayloadSize + 16> decoder;
+  while (state.KeepRunning()) {
+    for (std::byte b : frames.data()) {
+      decoder.Process(b).IgnoreError();
+    }
+  }
+}
+
+void DecodeSpan(perf_test::State& state, size_t payload_size) {
+  EncodedFrames frames(payload_size, 16 * kMaxPayloadSize / payload_size / 2);
+  DecoderBuffer<kMaxPayloadSize + 16> decoder;
+  while (state.KeepRunning()) {
+    decoder.Process(frames.data(), [](const Result<Frame>&) {});
+  }
+}
+
+PW_PERF_TEST(DecodeByteByByte16BFrames, DecodeByteByByte, 16);
+PW_PERF_TEST(DecodeSpan16BFrames, DecodeSpan, 16);
+
+PW_PERF_TEST(DecodeByteByByte256BFrames, DecodeByteByByte, 256);
+PW_PERF_TEST(DecodeSpan256BFrames, DecodeSpan, 256);
+
+PW_PERF_TEST(DecodeByteByByte1KiBFrames, DecodeByteByByte, 1024);
+PW_PERF_TEST(DecodeSpan1KiBFrames, DecodeSpan, 1024);
+
+}  // namespace
+}  // namespace pw::hdlc
@@ -18,8 +18,11 @@
 #include <cstddef>
 
 #include "pw_bytes/array.h"
+#include "pw_checksum/crc32.h"
 #include "pw_fuzzer/fuzztest.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::hdlc {
@@ -154,6 +157,149 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+TEST(Decoder, ProcessSpan_TooLargeForBuffer_StaysWithinBufferBoundaries) {
+  std::array<byte, 16> buffer = bytes::Initialized<16>('?');
+
+  Decoder decoder(span(buffer.data(), 8));
+  Status status = Status::Unknown();
+  decoder.Process(
+      bytes::String("~12345678901234567890\xf2\x19\x63\x90~"),
+      [&status](const Result<Frame>& result) { status = result.status(); });
+
+  for (size_t i = 8; i < buffer.size(); ++i) {
+    ASSERT_EQ(byte{'?'}, buffer[i]);
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+}
+
+// Records the results reported by a decoder, so that the results of decoding
+// the same data in different ways can be compared.
+class DecodeLog {
+ public:
+  void Add(const Result<Frame>& result) {
+    ASSERT_LT(size_, entries_.size());
+    Entry& entry = entries_[size_++];
+    entry.status = result.status();
+    if (result.ok()) {
+      entry.address = result->address();
+      entry.data_size = result->data().size();
+      entry.data_crc = checksum::Crc32::Calculate(result->data());
+    }
+  }
+
+  bool operator==(const DecodeLog& other) const {
+    if (size_ != other.size_) {
+      return false;
+    }
+    for (size_t i = 0; i < size_; ++i) {
+      const Entry& lhs = entries_[i];
+      const Entry& rhs = other.entries_[i];
+      if (lhs.status != rhs.status || lhs.address != rhs.address ||
+          lhs.data_size != rhs.data_size || lhs.data_crc != rhs.data_crc) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t size() const { return size_; }
+
+  Status status(size_t i) const { return entries_[i].status; }
+
+ private:
+  struct Entry {
+    Status status;
+    uint64_t address = 0;
+    size_t data_size = 0;
+    uint32_t data_crc = 0;
+  };
+
+  std::array<Entry, 1024> entries_;
+  size_t size_ = 0;
+};
+
+DecodeLog DecodeByteByByte(Decoder& decoder, ConstByteSpan data) {
+  DecodeLog log;
+  for (byte b : data) {
+    auto result = decoder.Process(b);
+    if (result.status() != Status::Unavailable()) {
+      log.Add(result);
+    }
+  }
+  return log;
+}
+
+DecodeLog DecodeInChunks(Decoder& decoder,
+                         ConstByteSpan data,
+                         size_t chunk_size) {
+  DecodeLog log;
+  while (!data.empty()) {
+    ConstByteSpan chunk = data.first(std::min(chunk_size, data.size()));
+    decoder.Process(chunk, [&log](const Result<Frame>& result) {
+      log.Add(result);
+    });
+    data = data.subspan(chunk.size());
+  }
+  return log;
+}
+
+TEST(Decoder, ProcessSpan_MatchesProcessByte) {
+  // Payloads with long unescaped runs, escaped bytes at various positions, and
+  // a frame that is too large for the decoder's buffer.
+  std::array<byte, 300> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = static_cast<byte>(i * 37 + 11);
+  }
+  payload[3] = kFlag;
+  payload[40] = kEscape;
+  payload[41] = kEscape;
+  payload[200] = kFlag;
+
+  stream::MemoryWriterBuffer<2048> writer;
+  ASSERT_EQ(OkStatus(), WriteUIFrame(123, span(payload).first(5), writer));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(7, span(payload).first(64), writer));
+  ASSERT_EQ(OkStatus(), writer.Write(bytes::String("garbage")));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, payload, writer));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(9, span(payload).subspan(100), writer));
+  ASSERT_EQ(OkStatus(), writer.Write(bytes::String("~~\x7d\x7d~")));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(2, span(payload).first(17), writer));
+
+  // Append a copy of the last frame with a corrupted FCS.
+  ASSERT_EQ(OkStatus(), WriteUIFrame(2, span(payload).first(17), writer));
+  std::array<byte, 2048> buffer;
+  std::copy(writer.begin(), writer.end(), buffer.begin());
+  buffer[writer.bytes_written() - 2] ^= byte{0x01};
+  ConstByteSpan data = span(buffer).first(writer.bytes_written());
+
+  DecoderBuffer<256> expected_decoder;
+  const DecodeLog expected = DecodeByteByByte(expected_decoder, data);
+  ASSERT_EQ(expected.size(), 8u);
+  EXPECT_EQ(expected.status(0), OkStatus());
+  EXPECT_EQ(expected.status(1), OkStatus());
+  EXPECT_EQ(expected.status(2), Status::DataLoss());
+  EXPECT_EQ(expected.status(3), Status::ResourceExhausted());
+  EXPECT_EQ(expected.status(4), OkStatus());
+  EXPECT_EQ(expected.status(5), Status::DataLoss());
+  EXPECT_EQ(expected.status(6), OkStatus());
+  EXPECT_EQ(expected.status(7), Status::DataLoss());
+
+  for (size_t chunk_size : {1u, 2u, 3u, 5u, 16u, 17u, 100u, 2048u}) {
+    DecoderBuffer<256> decoder;
+    EXPECT_TRUE(DecodeInChunks(decoder, data, chunk_size) == expected);
+  }
+}
+
+void ProcessSpanMatchesProcessByte(ConstByteSpan data) {
+  DecoderBuffer<64> expected_decoder;
+  DecoderBuffer<64> decoder;
+  EXPECT_TRUE(DecodeInChunks(decoder, data, 13) ==
+              DecodeByteByByte(expected_decoder, data));
+}
+
+FUZZ_TEST(Decoder, ProcessSpanMatchesProcessByte)
+    .WithDomains(VectorOf<1024>(
+        ElementOf<byte>({kFlag, kEscape, byte{0x5E}, byte{0x01}, byte{0xA5}})));
+
 void ProcessNeverCrashes(ConstByteSpan data) {
   DecoderBuffer<1024> decoder;
   for (byte b : data) {
@@ -112,10 +112,21 @@ class Decoder {
 
   /// @brief Processes a span of data and calls the provided callback with each
   /// frame or error.
+  ///
+  /// This produces the same results as calling `Process(std::byte)` for each
+  /// byte, but within a frame, runs of bytes that are neither flags nor
+  /// escapes are copied and added to the frame check sequence in bulk.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      if (state_ == State::kFrame) {
+        data = data.subspan(AppendUnescaped(data));
+        if (data.empty()) {
+          break;
+        }
+      }
+      auto result = Process(data.front());
+      data = data.subspan(1);
       if (result.status() != Status::Unavailable()) {
         callback(std::forward<Args>(args)..., result);
       }
@@ -147,6 +158,10 @@ class Decoder {
 
   void AppendByte(std::byte new_byte);
 
+  // Appends the bytes from the start of `data` up to the first flag or escape
+  // byte to the current frame. Returns the number of bytes appended.
+  size_t AppendUnescaped(ConstByteSpan data);
+
   Status CheckFrame() const;
 
   bool VerifyFrameCheckSequence() const;
@@ -69,53 +69,52 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      std::string_view read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = std::string_view(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  const int i = FindIndex(hash);
+  if (i == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  bool key_found = false;
+  std::string_view read_key;
+
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = std::string_view(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
@@ -123,6 +122,7 @@ EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
   // TODO(hepler): DCHECK(!full());
   Address* first_address = ResetAddresses(descriptors_.size(), address);
   descriptors_.push_back(descriptor);
+  IndexInsert(descriptors_.size() - 1);
   return EntryMetadata(descriptors_.back(), span(first_address, 1));
 }
 
@@ -138,7 +138,13 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   // deleted descriptor's space and then pops the last entry.
   Address* addresses_at_end = first_address(descriptors_.size() - 1);
 
+  IndexErase(index_to_remove);
+
   if (index_to_remove < descriptors_.size() - 1) {
+    if (indexed()) {
+      index_[IndexSlotOf(descriptors_.size() - 1)] =
+          static_cast<IndexSlot>(index_to_remove);
+    }
     Address* addresses_to_remove = first_address(index_to_remove);
     for (unsigned int i = 0; i < redundancy_; i++) {
       addresses_to_remove[i] = addresses_at_end[i];
@@ -152,10 +158,8 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   return {this, descriptors_.data() + index_to_remove};
 }
 
-// TODO(hepler): This method is the trigger of the O(valid_entries *
-// all_entries) time complexity for reading. At some cost to memory, this could
-// be optimized by using a hash table instead of scanning, but in practice this
-// should be fine for a small number of keys
+// Without a hash index, this method is the trigger of the O(valid_entries *
+// all_entries) time complexity for reading, since each lookup is a scan.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -220,6 +224,19 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
+  if (indexed()) {
+    // The index is never full, so probing always reaches an empty slot.
+    for (size_t slot = IndexHome(key_hash);; slot = NextIndexSlot(slot)) {
+      const IndexSlot descriptor_index = index_[slot];
+      if (descriptor_index == kEmptyIndexSlot) {
+        return -1;
+      }
+      if (descriptors_[descriptor_index].key_hash == key_hash) {
+        return descriptor_index;
+      }
+    }
+  }
+
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     if (descriptors_[i].key_hash == key_hash) {
       return i;
@@ -228,6 +245,47 @@ int EntryCache::FindIndex(uint32_t key_hash) const {
   return -1;
 }
 
+size_t EntryCache::IndexSlotOf(size_t descriptor_index) const {
+  size_t slot = IndexHome(descriptors_[descriptor_index].key_hash);
+  while (index_[slot] != descriptor_index) {
+    PW_DCHECK_UINT_NE(index_[slot], kEmptyIndexSlot);
+    slot = NextIndexSlot(slot);
+  }
+  return slot;
+}
+
+void EntryCache::IndexInsert(size_t descriptor_index) const {
+  if (!indexed()) {
+    return;
+  }
+  size_t slot = IndexHome(descriptors_[descriptor_index].key_hash);
+  while (index_[slot] != kEmptyIndexSlot) {
+    slot = NextIndexSlot(slot);
+  }
+  index_[slot] = static_cast<IndexSlot>(descriptor_index);
+}
+
+void EntryCache::IndexErase(size_t descriptor_index) const {
+  if (!indexed()) {
+    return;
+  }
+  size_t hole = IndexSlotOf(descriptor_index);
+
+  // Move later entries in the probe sequence back into the hole if their home
+  // slot is not between the hole and their current slot (cyclically).
+  for (size_t slot = NextIndexSlot(hole); index_[slot] != kEmptyIndexSlot;
+       slot = NextIndexSlot(slot)) {
+    const size_t home = IndexHome(descriptors_[index_[slot]].key_hash);
+    const size_t distance_to_home = (slot - home) & (index_.size() - 1);
+    const size_t distance_to_hole = (slot - hole) & (index_.size() - 1);
+    if (distance_to_home >= distance_to_hole) {
+      index_[hole] = index_[slot];
+      hole = slot;
+    }
+  }
+  index_[hole] = kEmptyIndexSlot;
+}
+
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
                                   Address address) const {
   Address* const existing = first_address(descriptor_index);
@@ -0,0 +1,102 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_containers/vector.h"
+#include "pw_kvs/internal/entry_cache.h"
+#include "pw_kvs/internal/hash.h"
+#include "pw_kvs/internal/key_descriptor.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::kvs::internal {
+namespace {
+
+// Returns the hash of the key "key_<number>".
+uint32_t KeyHash(uint32_t number) {
+  std::array<char, 16> key = {'k', 'e', 'y', '_'};
+  size_t length = 4;
+  do {
+    key[length++] = static_cast<char>('0' + number % 10);
+    number /= 10;
+  } while (number != 0);
+  return Hash(std::string_view(key.data(), length));
+}
+
+// An EntryCache filled with kMaxEntries entries.
+template <size_t kMaxEntries>
+class FullEntryCache {
+ public:
+  explicit FullEntryCache(bool indexed)
+      : entries_(descriptors_,
+                 addresses_,
+                 1,
+                 indexed ? span(index_) : span<EntryCache::IndexSlot>()) {
+    entries_.Reset();
+    for (uint32_t i = 0; i < kMaxEntries; ++i) {
+      hashes_[i] = KeyHash(i);
+      entries_.AddNew({hashes_[i], 0, EntryState::kValid}, i);
+    }
+  }
+
+  EntryCache& entries() { return entries_; }
+
+  uint32_t hash(size_t i) const { return hashes_[i]; }
+
+ private:
+  std::array<uint32_t, kMaxEntries> hashes_;
+  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EntryCache::AddressList<kMaxEntries, 1> addresses_;
+  EntryCache::Index<kMaxEntries> index_;
+  EntryCache entries_;
+};
+
+// Looks up and updates every entry in the cache, as is done for each entry
+// read from flash when a KeyValueStore is initialized.
+template <size_t kMaxEntries>
+void UpdateAllEntries(perf_test::State& state, bool indexed) {
+  static FullEntryCache<kMaxEntries> scanned_cache(false);
+  static FullEntryCache<kMaxEntries> indexed_cache(true);
+  FullEntryCache<kMaxEntries>& cache = indexed ? indexed_cache : scanned_cache;
+
+  uint32_t transaction_id = 0;
+  while (state.KeepRunning()) {
+    transaction_id += 1;
+    for (uint32_t i = 0; i < kMaxEntries; ++i) {
+      cache.entries()
+          .AddNewOrUpdateExisting(
+              {cache.hash(i), transaction_id, EntryState::kValid}, i, 1)
+          .IgnoreError();
+    }
+  }
+}
+
+PW_PERF_TEST(UpdateAll16EntriesScan, UpdateAllEntries<16>, false);
+PW_PERF_TEST(UpdateAll16EntriesIndexed, UpdateAllEntries<16>, true);
+
+PW_PERF_TEST(UpdateAll64EntriesScan, UpdateAllEntries<64>, false);
+PW_PERF_TEST(UpdateAll64EntriesIndexed, UpdateAllEntries<64>, true);
+
+PW_PERF_TEST(UpdateAll256EntriesScan, UpdateAllEntries<256>, false);
+PW_PERF_TEST(UpdateAll256EntriesIndexed, UpdateAllEntries<256>, true);
+
+PW_PERF_TEST(UpdateAll1024EntriesScan, UpdateAllEntries<1024>, false);
+PW_PERF_TEST(UpdateAll1024EntriesIndexed, UpdateAllEntries<1024>, true);
+
+}  // namespace
+}  // namespace pw::kvs::internal
@@ -31,10 +31,14 @@ class EmptyEntryCache : public ::testing::Test {
   static constexpr size_t kMaxEntries = 32;
   static constexpr size_t kRedundancy = 3;
 
-  EmptyEntryCache() : entries_(descriptors_, addresses_, kRedundancy) {}
+  EmptyEntryCache()
+      : entries_(descriptors_, addresses_, kRedundancy, index_) {
+    entries_.Reset();
+  }
 
   Vector<KeyDescriptor, kMaxEntries> descriptors_;
   EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::Index<kMaxEntries> index_;
 
   EntryCache entries_;
 };
@@ -194,6 +198,90 @@ TEST_F(EmptyEntryCache, Iterator_Const_CanBeAssignedFromMutable) {
   EXPECT_EQ(99u, it->first_address());
 }
 
+TEST(EntryCacheIndex, IndexSlotsFor) {
+  static_assert(EntryCache::IndexSlotsFor(1) == 2);
+  static_assert(EntryCache::IndexSlotsFor(32) == 64);
+  static_assert(EntryCache::IndexSlotsFor(42) == 64);
+  static_assert(EntryCache::IndexSlotsFor(43) == 128);
+  static_assert(EntryCache::IndexSlotsFor(0xFFFF) == 0);
+  static_assert(EntryCache::Index<0xFFFF>().empty());
+}
+
+// Adds entries whose hashes all map to the same few index slots, removes some
+// of them, and checks that the rest can still be found.
+void CheckIndexConsistentAfterRemoval(EntryCache& entries, size_t max_entries) {
+  // Every hash is a multiple of 64 below 2^16, so all entries share a home
+  // slot in an index of up to 64 slots, giving long probe sequences.
+  auto hash_for = [](uint32_t i) { return i * 64; };
+
+  for (uint32_t i = 0; i < max_entries; ++i) {
+    entries.AddNew({hash_for(i), 1, EntryState::kValid}, i);
+  }
+
+  // Remove every third entry, which moves other descriptors in the list.
+  for (auto it = entries.begin(); it != entries.end();) {
+    if ((it->hash() / 64) % 3 == 0) {
+      it = entries.RemoveEntry(it);
+    } else {
+      ++it;
+    }
+  }
+  const size_t remaining = entries.total_entries();
+  ASSERT_EQ(max_entries - (max_entries + 2) / 3, remaining);
+
+  // Entries that remain are updated in place, rather than added again.
+  for (uint32_t i = 0; i < max_entries; ++i) {
+    if (i % 3 != 0) {
+      ASSERT_EQ(OkStatus(),
+                entries.AddNewOrUpdateExisting(
+                    {hash_for(i), 2, EntryState::kValid}, 1000 + i, 1));
+    }
+  }
+  EXPECT_EQ(remaining, entries.total_entries());
+  for (const EntryMetadata& entry : entries) {
+    EXPECT_EQ(2u, entry.transaction_id());
+    EXPECT_EQ(1000u + entry.hash() / 64, entry.first_address());
+  }
+
+  // Removed entries are not found, so they are added again.
+  for (uint32_t i = 0; i < max_entries; i += 3) {
+    ASSERT_EQ(OkStatus(),
+              entries.AddNewOrUpdateExisting(
+                  {hash_for(i), 3, EntryState::kValid}, 2000 + i, 1));
+  }
+  EXPECT_EQ(max_entries, entries.total_entries());
+  EXPECT_TRUE(entries.full());
+}
+
+TEST_F(EmptyEntryCache, RemoveEntry_IndexStaysConsistent) {
+  ASSERT_TRUE(entries_.indexed());
+  CheckIndexConsistentAfterRemoval(entries_, kMaxEntries);
+}
+
+TEST_F(EmptyEntryCache, Reset_ClearsIndex) {
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    entries_.AddNew({i, 1, EntryState::kValid}, i);
+  }
+  entries_.Reset();
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(
+        OkStatus(),
+        entries_.AddNewOrUpdateExisting({i, 1, EntryState::kValid}, i, 1));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+}
+
+TEST(UnindexedEntryCache, RemoveEntry_FindsRemainingEntries) {
+  constexpr size_t kMaxEntries = 16;
+  Vector<KeyDescriptor, kMaxEntries> descriptors;
+  EntryCache::AddressList<kMaxEntries, 1> addresses;
+  EntryCache entries(descriptors, addresses, 1);
+
+  ASSERT_FALSE(entries.indexed());
+  CheckIndexConsistentAfterRemoval(entries, kMaxEntries);
+}
+
 constexpr size_t kSectorSize = 64;
 constexpr uint32_t kMagic = 0xa14ae726;
 // For KVS entry magic value always use a random 32 bit integer rather than a
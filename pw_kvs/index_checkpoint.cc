@@ -0,0 +1,358 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "KVS"
+#define PW_LOG_LEVEL PW_KVS_LOG_LEVEL
+
+#include "pw_kvs/internal/index_checkpoint.h"
+
+#include "pw_bytes/alignment.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
+#include "pw_kvs_private/config.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs::internal {
+namespace {
+
+using std::byte;
+using Address = FlashPartition::Address;
+
+// For magic values always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr uint32_t kCheckpointMagic = 0x5be3c0d6;
+constexpr uint32_t kInvalidatedMagic = 0x91a7e24c;
+
+constexpr Address kNoAddress = Address(-1);
+
+constexpr size_t kWriteBufferSize = kMaxFlashAlignment;
+
+struct CheckpointHeader {
+  uint32_t magic;
+  uint32_t checksum;  // CRC32 of the contents, then the rest of the header.
+  uint32_t transaction_id;
+  uint32_t entry_count;
+  uint32_t sector_size_bytes;
+  uint16_t sector_count;
+  uint16_t redundancy;
+};
+
+static_assert(sizeof(CheckpointHeader) == 24);
+
+// Precedes the addresses of each entry in the entry table.
+struct CheckpointEntry {
+  uint32_t key_hash;
+  uint32_t transaction_id;
+  uint32_t state;
+};
+
+// The checksum covers the contents, followed by the header fields after it.
+uint32_t Checksum(uint32_t contents_checksum, const CheckpointHeader& header) {
+  const span<const byte> fields = as_bytes(span(&header, 1))
+                                      .subspan(offsetof(CheckpointHeader,
+                                                        transaction_id));
+  return pw_checksum_Crc32Append(
+      fields.data(), fields.size(), contents_checksum);
+}
+
+size_t ContentsSize(size_t sector_count,
+                    size_t entry_count,
+                    size_t redundancy) {
+  return sector_count * sizeof(uint32_t) +
+         entry_count *
+             (sizeof(CheckpointEntry) + redundancy * sizeof(Address));
+}
+
+// Writes values to flash through an AlignedWriter and checksums them.
+class ContentsWriter {
+ public:
+  ContentsWriter(FlashPartition& partition, Address address)
+      : output_(partition, address),
+        writer_(partition.alignment_bytes(), output_) {}
+
+  template <typename T>
+  Status Write(const T& value) {
+    const span<const byte> bytes = as_bytes(span(&value, 1));
+    crc_.Update(bytes);
+    return writer_.Write(bytes).status();
+  }
+
+  Status Flush() { return writer_.Flush().status(); }
+
+  uint32_t checksum() const { return crc_.value(); }
+
+ private:
+  FlashPartition::Output output_;
+  AlignedWriterBuffer<kWriteBufferSize> writer_;
+  checksum::Crc32 crc_;
+};
+
+// Reads values from flash and checksums them.
+class ContentsReader {
+ public:
+  ContentsReader(FlashPartition& partition, Address address)
+      : partition_(partition), address_(address) {}
+
+  template <typename T>
+  Status Read(T& value) {
+    const span<byte> bytes = as_writable_bytes(span(&value, 1));
+    PW_TRY(partition_.Read(address_, bytes));
+    address_ += bytes.size();
+    crc_.Update(bytes);
+    return OkStatus();
+  }
+
+  uint32_t checksum() const { return crc_.value(); }
+
+ private:
+  FlashPartition& partition_;
+  Address address_;
+  checksum::Crc32 crc_;
+};
+
+}  // namespace
+
+size_t IndexCheckpoint::HeaderSize() const {
+  return AlignUp(sizeof(CheckpointHeader), partition_->alignment_bytes());
+}
+
+size_t IndexCheckpoint::MarkerSize() const {
+  return AlignUp(sizeof(kInvalidatedMagic), partition_->alignment_bytes());
+}
+
+Status IndexCheckpoint::Write(const FlashPartition& kvs_partition,
+                              const Sectors& sectors,
+                              const EntryCache& entry_cache,
+                              uint32_t transaction_id) {
+  if (!enabled() || partition_->alignment_bytes() > kWriteBufferSize) {
+    return Status::FailedPrecondition();
+  }
+  if (valid_ && transaction_id == transaction_id_ &&
+      entry_cache.total_entries() == entry_count_) {
+    return OkStatus();
+  }
+
+  const size_t sector_size_bytes = kvs_partition.sector_size_bytes();
+  const size_t contents_address = HeaderSize() + MarkerSize();
+  const size_t total_size =
+      contents_address +
+      AlignUp(ContentsSize(sectors.size(),
+                           entry_cache.total_entries(),
+                           entry_cache.redundancy()),
+              partition_->alignment_bytes());
+  if (total_size > partition_->size_bytes()) {
+    PW_LOG_WARN("Index checkpoint needs %u B, but its partition has only %u B",
+                unsigned(total_size),
+                unsigned(partition_->size_bytes()));
+    return Status::ResourceExhausted();
+  }
+
+  for (const SectorDescriptor& sector : sectors) {
+    if (sector.corrupt()) {
+      return Status::FailedPrecondition();
+    }
+  }
+
+  valid_ = false;
+  PW_TRY(partition_->Erase(
+      0, AlignUp(total_size, partition_->sector_size_bytes()) /
+             partition_->sector_size_bytes()));
+
+  ContentsWriter writer(*partition_, contents_address);
+  for (const SectorDescriptor& sector : sectors) {
+    const uint32_t written_bytes =
+        static_cast<uint32_t>(sector_size_bytes - sector.writable_bytes());
+    PW_TRY(writer.Write(written_bytes));
+  }
+
+  for (const EntryMetadata& metadata : entry_cache) {
+    PW_TRY(writer.Write(CheckpointEntry{
+        .key_hash = metadata.hash(),
+        .transaction_id = metadata.transaction_id(),
+        .state = static_cast<uint32_t>(metadata.state()),
+    }));
+    for (size_t i = 0; i < entry_cache.redundancy(); ++i) {
+      PW_TRY(writer.Write(i < metadata.addresses().size()
+                              ? metadata.addresses()[i]
+                              : kNoAddress));
+    }
+  }
+  PW_TRY(writer.Flush());
+
+  CheckpointHeader header{
+      .magic = kCheckpointMagic,
+      .checksum = 0,
+      .transaction_id = transaction_id,
+      .entry_count = static_cast<uint32_t>(entry_cache.total_entries()),
+      .sector_size_bytes = static_cast<uint32_t>(sector_size_bytes),
+      .sector_count = static_cast<uint16_t>(sectors.size()),
+      .redundancy = static_cast<uint16_t>(entry_cache.redundancy()),
+  };
+  header.checksum = Checksum(writer.checksum(), header);
+
+  // Write the header last so that an interrupted checkpoint is never loaded.
+  FlashPartition::Output output(*partition_, 0);
+  PW_TRY(AlignedWrite<kWriteBufferSize>(output,
+                                        partition_->alignment_bytes(),
+                                        {as_bytes(span(&header, 1))})
+             .status());
+
+  valid_ = true;
+  stale_ = false;
+  transaction_id_ = transaction_id;
+  entry_count_ = entry_cache.total_entries();
+  PW_LOG_INFO("Wrote index checkpoint with %u entries",
+              unsigned(entry_count_));
+  return OkStatus();
+}
+
+Status IndexCheckpoint::Load(const FlashPartition& kvs_partition,
+                             Sectors& sectors,
+                             EntryCache& entry_cache) {
+  valid_ = false;
+  if (!enabled()) {
+    return Status::NotFound();
+  }
+  if (stale_) {
+    PW_LOG_DEBUG("Index checkpoint could not be invalidated; not loading it");
+    return Status::NotFound();
+  }
+
+  const Status status = DoLoad(kvs_partition, sectors, entry_cache);
+  if (!status.ok() && !status.IsNotFound()) {
+    // The checkpoint could not be loaded, but a later Load() might succeed
+    // after sectors are erased, when it is out of date. Invalidate it now,
+    // since Invalidate() does nothing until a checkpoint is loaded or written.
+    if (!WriteInvalidationMarker().ok()) {
+      stale_ = true;
+    }
+  }
+  return status;
+}
+
+Status IndexCheckpoint::DoLoad(const FlashPartition& kvs_partition,
+                               Sectors& sectors,
+                               EntryCache& entry_cache) {
+  CheckpointHeader header;
+  PW_TRY(partition_->Read(0, as_writable_bytes(span(&header, 1))));
+  if (header.magic != kCheckpointMagic) {
+    return Status::NotFound();
+  }
+
+  uint32_t marker;
+  PW_TRY(partition_->Read(HeaderSize(), as_writable_bytes(span(&marker, 1))));
+  if (!partition_->AppearsErased(as_bytes(span(&marker, 1)))) {
+    PW_LOG_DEBUG("Index checkpoint was invalidated");
+    return Status::NotFound();
+  }
+
+  const size_t sector_size_bytes = kvs_partition.sector_size_bytes();
+  if (header.sector_size_bytes != sector_size_bytes ||
+      header.sector_count != sectors.size() ||
+      header.redundancy != entry_cache.redundancy() ||
+      header.entry_count > entry_cache.max_entries() ||
+      HeaderSize() + MarkerSize() +
+              ContentsSize(header.sector_count,
+                           header.entry_count,
+                           header.redundancy) >
+          partition_->size_bytes()) {
+    PW_LOG_WARN("Index checkpoint does not match the KVS configuration");
+    return Status::DataLoss();
+  }
+
+  ContentsReader reader(*partition_, HeaderSize() + MarkerSize());
+  for (SectorDescriptor& sector : sectors) {
+    uint32_t written_bytes;
+    PW_TRY(reader.Read(written_bytes));
+    if (written_bytes > sector_size_bytes) {
+      return Status::DataLoss();
+    }
+    sector.set_writable_bytes(
+        static_cast<uint16_t>(sector_size_bytes - written_bytes));
+  }
+
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    CheckpointEntry entry;
+    PW_TRY(reader.Read(entry));
+    if (entry.state > static_cast<uint32_t>(EntryState::kDeleted)) {
+      return Status::DataLoss();
+    }
+
+    EntryMetadata metadata;
+    for (size_t copy = 0; copy < header.redundancy; ++copy) {
+      Address address;
+      PW_TRY(reader.Read(address));
+      if (address == kNoAddress) {
+        if (copy == 0) {
+          return Status::DataLoss();
+        }
+        continue;
+      }
+      if (address >= kvs_partition.size_bytes()) {
+        return Status::DataLoss();
+      }
+      if (copy == 0) {
+        metadata = entry_cache.AddNew(
+            {.key_hash = entry.key_hash,
+             .transaction_id = entry.transaction_id,
+             .state = static_cast<EntryState>(entry.state)},
+            address);
+      } else {
+        metadata.AddNewAddress(address);
+      }
+    }
+  }
+
+  if (Checksum(reader.checksum(), header) != header.checksum) {
+    PW_LOG_WARN("Index checkpoint is corrupt");
+    return Status::DataLoss();
+  }
+
+  valid_ = true;
+  transaction_id_ = header.transaction_id;
+  entry_count_ = header.entry_count;
+  PW_LOG_INFO("Loaded index checkpoint with %u entries",
+              unsigned(entry_count_));
+  return OkStatus();
+}
+
+Status IndexCheckpoint::Invalidate() {
+  if (!valid_) {
+    return OkStatus();
+  }
+  valid_ = false;
+  const Status status = WriteInvalidationMarker();
+  if (!status.ok()) {
+    stale_ = true;
+  }
+  return status;
+}
+
+Status IndexCheckpoint::WriteInvalidationMarker() {
+  FlashPartition::Output output(*partition_, HeaderSize());
+  const Status status =
+      AlignedWrite<kWriteBufferSize>(output,
+                                     partition_->alignment_bytes(),
+                                     {as_bytes(span(&kInvalidatedMagic, 1))})
+          .status();
+  if (status.ok()) {
+    return OkStatus();
+  }
+
+  PW_LOG_WARN("Failed to invalidate index checkpoint; erasing it");
+  return partition_->Erase(0, 1);
+}
+
+}  // namespace pw::kvs::internal
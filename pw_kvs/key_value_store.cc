@@ -45,15 +45,17 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
                              Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             Address* addresses,
+                             span<internal::EntryCache::IndexSlot> key_index)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      entry_cache_(key_descriptor_list, addresses, redundancy, key_index),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
+      incremental_gc_sector_(nullptr),
       last_transaction_id_(0) {}
 
 Status KeyValueStore::Init() {
@@ -144,11 +146,41 @@ Status KeyValueStore::Init() {
 }
 
 Status KeyValueStore::InitializeMetadata() {
+  incremental_gc_sector_ = nullptr;
+
+  if (index_checkpoint_.enabled()) {
+    Status status = ReadMetadata(/*use_index_checkpoint=*/true);
+    if (!status.IsAborted()) {
+      return status;
+    }
+
+    PW_LOG_WARN("Index checkpoint does not match flash; reading all entries");
+    index_checkpoint_.Invalidate().IgnoreError();
+    error_detected_ = false;
+  }
+  return ReadMetadata(/*use_index_checkpoint=*/false);
+}
+
+// Returns ABORTED if the index checkpoint was loaded, but an entry it refers to
+// does not match what is in flash.
+Status KeyValueStore::ReadMetadata(bool use_index_checkpoint) {
   const size_t sector_size_bytes = partition_.sector_size_bytes();
 
   sectors_.Reset();
   entry_cache_.Reset();
 
+  // If there is a checkpoint, the sectors' writable bytes and the entry cache
+  // are loaded from it. Only entries written after it need to be read.
+  bool from_checkpoint = false;
+  if (use_index_checkpoint) {
+    from_checkpoint =
+        index_checkpoint_.Load(partition_, sectors_, entry_cache_).ok();
+    if (!from_checkpoint) {
+      sectors_.Reset();
+      entry_cache_.Reset();
+    }
+  }
+
   PW_LOG_DEBUG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
 
@@ -158,7 +190,7 @@ Status KeyValueStore::InitializeMetadata() {
   size_t entry_copies_missing = 0;
 
   for (SectorDescriptor& sector : sectors_) {
-    Address entry_address = sector_address;
+    Address entry_address = sectors_.NextWritableAddress(sector);
 
     size_t sector_corrupt_bytes = 0;
 
@@ -254,6 +286,12 @@ Status KeyValueStore::InitializeMetadata() {
 
       SectorDescriptor& sector = sectors_.FromAddress(address);
 
+      if (from_checkpoint &&
+          (!read_result.ok() ||
+           entry.transaction_id() != metadata.transaction_id())) {
+        return Status::Aborted();
+      }
+
       if (read_result.ok()) {
         sector.AddValidBytes(entry.size());
         index++;
@@ -1012,6 +1050,17 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
   }
 #endif  // PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE
 
+  // Step 5: Checkpoint the index, so that the next Init can skip reading the
+  // entries that are in flash now.
+  if (overall_status.ok() && !error_detected_ && index_checkpoint_.enabled()) {
+    Status checkpoint_status = index_checkpoint_.Write(
+        partition_, sectors_, entry_cache_, last_transaction_id_);
+    if (!checkpoint_status.ok()) {
+      PW_LOG_WARN("Failed to write index checkpoint: %s",
+                  checkpoint_status.str());
+    }
+  }
+
   if (overall_status.ok()) {
     PW_LOG_INFO("Full maintenance complete");
   } else {
@@ -1033,6 +1082,89 @@ Status KeyValueStore::PartialMaintenance() {
   return GarbageCollect(span<const Address>());
 }
 
+Status KeyValueStore::IncrementalMaintenance(size_t max_entries_to_relocate) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return Status::FailedPrecondition();
+  }
+
+  // A step that may not relocate anything could only make progress by
+  // collecting the whole sector at once, which is not a bounded step.
+  if (max_entries_to_relocate == 0) {
+    return Status::InvalidArgument();
+  }
+
+  CheckForErrors();
+  // Do automatic repair, if KVS options allow for it.
+  if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
+    PW_TRY(Repair());
+  }
+
+  // The sector may have been collected, or erased and written to again, by
+  // other operations since the last step.
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  if (incremental_gc_sector_ == nullptr ||
+      incremental_gc_sector_->RecoverableBytes(sector_size_bytes) == 0) {
+    incremental_gc_sector_ = FindSectorForIncrementalGarbageCollection();
+    if (incremental_gc_sector_ == nullptr) {
+      return Status::NotFound();
+    }
+  }
+  SectorDescriptor& sector = *incremental_gc_sector_;
+
+  // Step 1: Relocate up to max_entries_to_relocate entries out of the sector.
+  if (sector.valid_bytes() != 0) {
+    size_t entries_relocated = 0;
+    for (EntryMetadata& metadata : entry_cache_) {
+      if (entries_relocated >= max_entries_to_relocate) {
+        break;
+      }
+      for (Address address : metadata.addresses()) {
+        if (sectors_.AddressInSector(sector, address)) {
+          PW_TRY(RelocateKeyAddressesInSector(sector, metadata, {}));
+          entries_relocated += 1;
+          break;
+        }
+      }
+    }
+    PW_LOG_DEBUG("Incremental GC relocated %u entries from sector %u",
+                 unsigned(entries_relocated),
+                 sectors_.Index(sector));
+
+    // Don't erase in the same step, to bound the work done by each step.
+    if (entries_relocated != 0) {
+      return OkStatus();
+    }
+  }
+
+  // Step 2: Erase the sector, now that it has no valid entries.
+  incremental_gc_sector_ = nullptr;
+  return GarbageCollectSector(sector, {});
+}
+
+KeyValueStore::SectorDescriptor*
+KeyValueStore::FindSectorForIncrementalGarbageCollection() const {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  size_t empty_sectors = 0;
+  for (const SectorDescriptor& sector : sectors_) {
+    if (sector.Empty(sector_size_bytes)) {
+      empty_sectors += 1;
+    }
+  }
+
+  // A write of an entry and its redundant copies needs up to redundancy()
+  // empty sectors, in addition to the one that is always kept free. Collect
+  // sectors with valid entries before the empty sectors run out, so that the
+  // write does not have to.
+  const bool low_on_space = empty_sectors < redundancy() + 2;
+
+  SectorDescriptor* sector = sectors_.FindSectorToGarbageCollect({});
+  if (sector == nullptr || sector->RecoverableBytes(sector_size_bytes) == 0 ||
+      (sector->valid_bytes() != 0 && !low_on_space)) {
+    return nullptr;
+  }
+  return sector;
+}
+
 Status KeyValueStore::GarbageCollect(span<const Address> reserved_addresses) {
   PW_LOG_DEBUG("Garbage Collect a single sector");
   for ([[maybe_unused]] Address address : reserved_addresses) {
@@ -1091,6 +1223,12 @@ Status KeyValueStore::GarbageCollectSector(
 
   // Step 2: Reinitialize the sector
   if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
+    // The index checkpoint describes the sector's current contents, so it is
+    // out of date once the sector is erased. If it cannot be invalidated, it
+    // is skipped by the next Init, so garbage collection can still continue.
+    if (Status status = index_checkpoint_.Invalidate(); !status.ok()) {
+      PW_LOG_WARN("Failed to invalidate index checkpoint: %s", status.str());
+    }
     sector_to_gc.mark_corrupt();
     internal_stats_.sector_erase_count++;
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
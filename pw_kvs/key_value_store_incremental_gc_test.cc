@@ -0,0 +1,273 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Always use stats, these tests depend on it.
+#define PW_KVS_RECORD_PARTITION_STATS 1
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/flash_partition_with_stats.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_log/log.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kSectors = 8;
+constexpr size_t kSectorSize = 512;
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kKeys = 12;
+constexpr size_t kPuts = 400;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x2d6e8f41, .checksum = nullptr};
+
+// Also counts the bytes written, so that the flash work done by each operation
+// can be measured.
+class CountingPartition : public FlashPartitionWithStatsBuffer<kSectors> {
+ public:
+  explicit CountingPartition(FlashMemory* flash)
+      : FlashPartitionWithStatsBuffer<kSectors>(flash) {}
+
+  using FlashPartition::Write;
+
+  StatusWithSize Write(Address address, span<const byte> data) override {
+    bytes_written_ += data.size();
+    return FlashPartitionWithStatsBuffer<kSectors>::Write(address, data);
+  }
+
+  size_t bytes_written() const { return bytes_written_; }
+
+ private:
+  size_t bytes_written_ = 0;
+};
+
+// Flash work done by a single operation.
+struct FlashWork {
+  size_t bytes_written;
+  size_t erases;
+};
+
+class IncrementalGcTest : public ::testing::Test {
+ protected:
+  IncrementalGcTest()
+      : flash_(internal::Entry::kMinAlignmentBytes),
+        partition_(&flash_),
+        kvs_(&partition_, kFormat) {}
+
+  void SetUp() override {
+    partition_.ResetCounters();
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  // Measures the flash work done by an operation.
+  template <typename Function>
+  FlashWork Measure(Function&& function) {
+    const size_t bytes_written = partition_.bytes_written();
+    const size_t erases = partition_.total_erase_count();
+    function();
+    return {partition_.bytes_written() - bytes_written,
+            partition_.total_erase_count() - erases};
+  }
+
+  // Repeatedly updates kKeys keys, running steps_per_put incremental GC steps
+  // after each Put. Records the flash work done by each Put.
+  //
+  // Three of every four Puts update the first key, and the rest cycle through
+  // the others. This leaves valid entries in sectors that are mostly stale, so
+  // collecting them requires relocating entries.
+  void SustainedWrites(size_t steps_per_put) {
+    for (size_t i = 0; i < kPuts; ++i) {
+      const size_t key = (i % 4 != 0) ? 0 : 1 + (i / 4) % (kKeys - 1);
+      value_[0] = static_cast<byte>(i);
+      last_values_[key] = value_[0];
+      put_work_[i] = Measure(
+          [&] { EXPECT_EQ(OkStatus(), kvs_.Put(kKeyNames[key], value_)); });
+      for (size_t step = 0; step < steps_per_put; ++step) {
+        const Status status = kvs_.IncrementalMaintenance();
+        EXPECT_TRUE(status.ok() || status.IsNotFound());
+      }
+    }
+  }
+
+  // Returns the work done by the Put at the given percentile.
+  FlashWork PutPercentile(size_t percentile) const {
+    std::array<size_t, kPuts> bytes;
+    std::array<size_t, kPuts> erases;
+    for (size_t i = 0; i < kPuts; ++i) {
+      bytes[i] = put_work_[i].bytes_written;
+      erases[i] = put_work_[i].erases;
+    }
+    std::sort(bytes.begin(), bytes.end());
+    std::sort(erases.begin(), erases.end());
+    const size_t index = std::min(kPuts - 1, kPuts * percentile / 100);
+    return {bytes[index], erases[index]};
+  }
+
+  void LogPutWork(const char* label) const {
+    const FlashWork p50 = PutPercentile(50);
+    const FlashWork p99 = PutPercentile(99);
+    const FlashWork max = PutPercentile(100);
+    PW_LOG_INFO("%s: Put bytes written p50 %u, p99 %u, max %u; erases max %u",
+                label,
+                unsigned(p50.bytes_written),
+                unsigned(p99.bytes_written),
+                unsigned(max.bytes_written),
+                unsigned(max.erases));
+  }
+
+  static constexpr std::array<const char*, kKeys> kKeyNames = {
+      "key_0",
+      "key_1",
+      "key_2",
+      "key_3",
+      "key_4",
+      "key_5",
+      "key_6",
+      "key_7",
+      "key_8",
+      "key_9",
+      "key_10",
+      "key_11",
+  };
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectors> flash_;
+  CountingPartition partition_;
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs_;
+
+  std::array<byte, 64> value_ = {};
+  std::array<FlashWork, kPuts> put_work_ = {};
+  std::array<byte, kKeys> last_values_ = {};
+};
+
+TEST_F(IncrementalGcTest, NotInitialized) {
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(&partition_, kFormat);
+  EXPECT_EQ(Status::FailedPrecondition(), kvs.IncrementalMaintenance());
+}
+
+TEST_F(IncrementalGcTest, NothingToCollect) {
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(kKeyNames[0], value_));
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance());
+}
+
+TEST_F(IncrementalGcTest, ZeroEntriesToRelocateIsInvalid) {
+  // Fill the KVS so that sectors with valid entries need to be collected.
+  SustainedWrites(0);
+
+  const FlashWork work = Measure([&] {
+    EXPECT_EQ(Status::InvalidArgument(), kvs_.IncrementalMaintenance(0));
+  });
+  EXPECT_EQ(0u, work.bytes_written);
+  EXPECT_EQ(0u, work.erases);
+}
+
+TEST_F(IncrementalGcTest, ValidEntriesNotMovedWhileSectorsAreEmpty) {
+  // Leave one stale entry next to valid entries in the first sector.
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(kKeyNames[i], value_));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Put(kKeyNames[0], value_));
+
+  const FlashWork work = Measure(
+      [&] { EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance()); });
+  EXPECT_EQ(0u, work.bytes_written);
+  EXPECT_EQ(0u, work.erases);
+}
+
+TEST_F(IncrementalGcTest, EachStepDoesBoundedWork) {
+  for (size_t max_entries : {size_t(1), size_t(3)}) {
+    // Fill the KVS so that sectors with valid entries need to be collected.
+    SustainedWrites(0);
+    const size_t entry_size = PutPercentile(50).bytes_written;
+
+    size_t steps = 0;
+    Status status;
+    do {
+      const FlashWork work =
+          Measure([&] { status = kvs_.IncrementalMaintenance(max_entries); });
+      ASSERT_TRUE(status.ok() || status.IsNotFound());
+      // A step either relocates up to max_entries entries or erases a sector.
+      if (work.erases != 0) {
+        EXPECT_EQ(1u, work.erases);
+        EXPECT_EQ(0u, work.bytes_written);
+      } else {
+        EXPECT_LE(work.bytes_written, max_entries * entry_size);
+      }
+      steps += 1;
+    } while (status.ok() && steps < kSectors * kMaxEntries);
+    EXPECT_EQ(Status::NotFound(), status);
+    EXPECT_GT(steps, 1u);
+  }
+
+  for (const char* key : kKeyNames) {
+    EXPECT_EQ(OkStatus(), kvs_.Get(key, value_).status());
+  }
+}
+
+TEST_F(IncrementalGcTest, SustainedWrites_WithoutIncrementalGc) {
+  SustainedWrites(0);
+  LogPutWork("Without incremental GC");
+
+  // Some Puts had to garbage collect a sector themselves.
+  EXPECT_GE(PutPercentile(100).erases, 1u);
+  EXPECT_GT(PutPercentile(100).bytes_written, PutPercentile(50).bytes_written);
+}
+
+TEST_F(IncrementalGcTest, SustainedWrites_WithIncrementalGc) {
+  SustainedWrites(2);
+  LogPutWork("With incremental GC");
+
+  // Every Put found space without garbage collecting, so it only wrote its own
+  // entry.
+  EXPECT_EQ(0u, PutPercentile(100).erases);
+  EXPECT_EQ(PutPercentile(50).bytes_written, PutPercentile(100).bytes_written);
+
+  for (size_t key = 0; key < kKeys; ++key) {
+    std::array<byte, 64> value;
+    ASSERT_EQ(OkStatus(), kvs_.Get(kKeyNames[key], value).status());
+    EXPECT_EQ(last_values_[key], value[0]);
+  }
+}
+
+TEST_F(IncrementalGcTest, Init_ResetsSectorBeingCollected) {
+  SustainedWrites(0);
+
+  // Start collecting a sector, then reinitialize partway through.
+  ASSERT_EQ(OkStatus(), kvs_.IncrementalMaintenance());
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+
+  Status status;
+  for (size_t steps = 0; steps < kSectors * kMaxEntries; ++steps) {
+    status = kvs_.IncrementalMaintenance();
+    if (!status.ok()) {
+      break;
+    }
+  }
+  EXPECT_EQ(Status::NotFound(), status);
+  EXPECT_EQ(kKeys, kvs_.size());
+}
+
+}  // namespace
+}  // namespace pw::kvs
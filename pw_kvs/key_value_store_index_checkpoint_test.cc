@@ -0,0 +1,308 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kSectorSize = 512;
+constexpr size_t kSectorCount = 16;
+
+// Counts the bytes read from the partition, to show how much of it Init reads.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  explicit ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  using FlashPartition::Read;
+
+  StatusWithSize Read(Address address, span<byte> output) override {
+    bytes_read_ += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read() const { return bytes_read_; }
+  void ResetBytesRead() { bytes_read_ = 0; }
+
+ private:
+  size_t bytes_read_ = 0;
+};
+
+// Fails every write and erase while broken, as a failing flash part would.
+class BreakablePartition : public FlashPartition {
+ public:
+  explicit BreakablePartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  using FlashPartition::Write;
+
+  Status Erase(Address address, size_t num_sectors) override {
+    if (broken_) {
+      return Status::DataLoss();
+    }
+    return FlashPartition::Erase(address, num_sectors);
+  }
+
+  StatusWithSize Write(Address address, span<const byte> data) override {
+    if (broken_) {
+      return StatusWithSize::DataLoss();
+    }
+    return FlashPartition::Write(address, data);
+  }
+
+  void set_broken(bool broken) { broken_ = broken; }
+
+ private:
+  bool broken_ = false;
+};
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x3f8a21d7, .checksum = &checksum};
+
+class IndexCheckpointTest : public ::testing::Test {
+ protected:
+  IndexCheckpointTest()
+      : flash_(16),
+        partition_(&flash_),
+        checkpoint_flash_(16),
+        checkpoint_partition_(&checkpoint_flash_),
+        kvs_(&partition_, kFormat),
+        unindexed_kvs_(&partition_, kFormat) {
+    kvs_.EnableIndexCheckpoint(checkpoint_partition_);
+  }
+
+  void SetUp() override { ASSERT_EQ(OkStatus(), kvs_.Init()); }
+
+  // Writes each key several times, so that flash holds stale entries.
+  void PutKeys(uint32_t value_offset, size_t count = 10) {
+    for (int update = 0; update < 3; ++update) {
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[i], uint32_t(i + value_offset)));
+      }
+    }
+  }
+
+  void ExpectKeys(KeyValueStore& kvs, uint32_t value_offset, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      uint32_t value = 0;
+      EXPECT_EQ(OkStatus(), kvs.Get(kKeys[i], &value));
+      EXPECT_EQ(i + value_offset, value);
+    }
+  }
+
+  // Returns the number of bytes read from the KVS partition by Init.
+  size_t InitAndCountBytesRead(KeyValueStore& kvs) {
+    partition_.ResetBytesRead();
+    EXPECT_EQ(OkStatus(), kvs.Init());
+    return partition_.bytes_read();
+  }
+
+  static constexpr std::array<const char*, 12> kKeys = {
+      "alpha",
+      "bravo",
+      "charlie",
+      "delta",
+      "echo",
+      "foxtrot",
+      "golf",
+      "hotel",
+      "india",
+      "juliett",
+      "kilo",
+      "lima",
+  };
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  ReadCountingPartition partition_;
+
+  FakeFlashMemoryBuffer<kSectorSize, 4> checkpoint_flash_;
+  BreakablePartition checkpoint_partition_;
+
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs_;
+
+  // Reads the same partition without using the checkpoint.
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> unindexed_kvs_;
+};
+
+TEST_F(IndexCheckpointTest, Init_WithoutCheckpoint_ReadsAllEntries) {
+  PutKeys(100);
+
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 100, 10);
+}
+
+TEST_F(IndexCheckpointTest, Init_LoadsCheckpointFromMaintenance) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_LT(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 100, 10);
+}
+
+TEST_F(IndexCheckpointTest, Init_ReadsEntriesWrittenAfterCheckpoint) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  const uint32_t transaction_count = kvs_.transaction_count();
+
+  // Update some keys, add new ones, and delete one.
+  PutKeys(200, 5);
+  ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[10], uint32_t(210)));
+  ASSERT_EQ(OkStatus(), kvs_.Put(kKeys[11], uint32_t(211)));
+  ASSERT_EQ(OkStatus(), kvs_.Delete(kKeys[9]));
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_GT(kvs_.transaction_count(), transaction_count);
+  EXPECT_EQ(11u, kvs_.size());
+  ExpectKeys(kvs_, 200, 5);
+  for (size_t i = 5; i < 9; ++i) {
+    uint32_t value = 0;
+    EXPECT_EQ(OkStatus(), kvs_.Get(kKeys[i], &value));
+    EXPECT_EQ(i + 100, value);
+  }
+  uint32_t value = 0;
+  EXPECT_EQ(Status::NotFound(), kvs_.Get(kKeys[9], &value));
+  EXPECT_EQ(OkStatus(), kvs_.Get(kKeys[10], &value));
+  EXPECT_EQ(210u, value);
+  EXPECT_EQ(OkStatus(), kvs_.Get(kKeys[11], &value));
+  EXPECT_EQ(211u, value);
+
+  // The new entries are reflected in the next checkpoint.
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(11u, kvs_.size());
+  ExpectKeys(kvs_, 200, 5);
+}
+
+TEST_F(IndexCheckpointTest, GarbageCollect_InvalidatesCheckpoint) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Make a sector eligible for garbage collection, then collect it.
+  PutKeys(200);
+  ASSERT_EQ(OkStatus(), kvs_.PartialMaintenance());
+
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 200, 10);
+}
+
+TEST_F(IndexCheckpointTest, GarbageCollect_IgnoresInvalidationFailure) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Garbage collection erases the sector even though the checkpoint cannot be
+  // invalidated.
+  checkpoint_partition_.set_broken(true);
+  PutKeys(200);
+  EXPECT_EQ(OkStatus(), kvs_.PartialMaintenance());
+  checkpoint_partition_.set_broken(false);
+
+  // The out-of-date checkpoint is still in flash, but is not loaded.
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 200, 10);
+
+  // A new checkpoint is loaded as usual.
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  EXPECT_LT(InitAndCountBytesRead(kvs_), bytes_read);
+  ExpectKeys(kvs_, 200, 10);
+}
+
+TEST_F(IndexCheckpointTest, Init_FallsBackToFullScanIfFlashDoesNotMatch) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Replace the contents of the KVS without updating the checkpoint.
+  ASSERT_EQ(OkStatus(), partition_.Erase(0, partition_.sector_count()));
+  ASSERT_EQ(OkStatus(), unindexed_kvs_.Init());
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(OkStatus(), unindexed_kvs_.Put(kKeys[i], uint32_t(i + 300)));
+  }
+
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_EQ(3u, kvs_.size());
+  ExpectKeys(kvs_, 300, 3);
+
+  // The mismatched checkpoint is invalidated, so it is not loaded again.
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+}
+
+TEST_F(IndexCheckpointTest, Init_IgnoresCorruptCheckpoint) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Flip a bit in the entry table.
+  checkpoint_flash_.buffer()[160] ^= byte{0x10};
+
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 100, 10);
+}
+
+TEST_F(IndexCheckpointTest, Init_InvalidatesCheckpointThatFailsToLoad) {
+  PutKeys(100);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Corrupt the checkpoint only while Init reads it, as a read error would.
+  checkpoint_flash_.buffer()[160] ^= byte{0x10};
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  checkpoint_flash_.buffer()[160] ^= byte{0x10};
+
+  // The checkpoint is never loaded again, since sectors may since have been
+  // erased.
+  const size_t bytes_read = InitAndCountBytesRead(kvs_);
+  EXPECT_EQ(bytes_read, InitAndCountBytesRead(unindexed_kvs_));
+  EXPECT_EQ(10u, kvs_.size());
+  ExpectKeys(kvs_, 100, 10);
+}
+
+TEST_F(IndexCheckpointTest, FullMaintenance_CheckpointPartitionTooSmall) {
+  FakeFlashMemoryBuffer<64, 1> small_flash(16);
+  FlashPartition small_partition(&small_flash);
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition_, kFormat);
+  kvs.EnableIndexCheckpoint(small_partition);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put(kKeys[0], uint32_t(1)));
+
+  // Maintenance succeeds even though no checkpoint could be written.
+  EXPECT_EQ(OkStatus(), kvs.FullMaintenance());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  uint32_t value = 0;
+  EXPECT_EQ(OkStatus(), kvs.Get(kKeys[0], &value));
+  EXPECT_EQ(1u, value);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,108 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 4 * 1024;
+constexpr size_t kAlignment = 16;
+constexpr size_t kValueSize = 128;
+constexpr size_t kEntriesPerSector = 4;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x7c4e19b2, .checksum = &checksum};
+
+// A large partition filled with kMaxEntries keys, with an index checkpoint,
+// and KeyValueStores that mount it with and without the checkpoint.
+template <size_t kSectorCount, size_t kMaxEntries>
+class FilledKeyValueStore {
+ public:
+  FilledKeyValueStore()
+      : flash_(kAlignment),
+        partition_(&flash_),
+        checkpoint_flash_(kAlignment),
+        checkpoint_partition_(&checkpoint_flash_),
+        kvs_(&partition_, kFormat),
+        scanned_kvs_(&partition_, kFormat),
+        checkpoint_kvs_(&partition_, kFormat) {
+    kvs_.EnableIndexCheckpoint(checkpoint_partition_);
+    checkpoint_kvs_.EnableIndexCheckpoint(checkpoint_partition_);
+    kvs_.Init().IgnoreError();
+
+    std::array<std::byte, kValueSize> value{};
+    for (uint32_t i = 0; i < kMaxEntries; ++i) {
+      std::array<char, 16> key = {'k', 'e', 'y', '_'};
+      size_t length = 4;
+      uint32_t number = i;
+      do {
+        key[length++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+      } while (number != 0);
+      value[0] = static_cast<std::byte>(i);
+      kvs_.Put(std::string_view(key.data(), length), value).IgnoreError();
+    }
+    kvs_.FullMaintenance().IgnoreError();
+  }
+
+  KeyValueStore& kvs(bool use_checkpoint) {
+    return use_checkpoint ? checkpoint_kvs_ : scanned_kvs_;
+  }
+
+ private:
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  FlashPartition partition_;
+
+  FakeFlashMemoryBuffer<kSectorSize, 4> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs_;
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> scanned_kvs_;
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> checkpoint_kvs_;
+};
+
+// Initializes a KeyValueStore on a filled partition, with or without loading
+// the index checkpoint.
+template <size_t kSectorCount>
+void Mount(perf_test::State& state, bool use_checkpoint) {
+  static FilledKeyValueStore<kSectorCount, kSectorCount * kEntriesPerSector>
+      filled;
+  KeyValueStore& kvs = filled.kvs(use_checkpoint);
+
+  while (state.KeepRunning()) {
+    kvs.Init().IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Mount32SectorsScan, Mount<32>, false);
+PW_PERF_TEST(Mount32SectorsCheckpoint, Mount<32>, true);
+
+PW_PERF_TEST(Mount128SectorsScan, Mount<128>, false);
+PW_PERF_TEST(Mount128SectorsCheckpoint, Mount<128>, true);
+
+}  // namespace
+}  // namespace pw::kvs
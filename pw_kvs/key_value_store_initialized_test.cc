@@ -465,4 +465,26 @@ TEST_F(EmptyInitializedKvs, Basic) {
   EXPECT_EQ(kvs_.size(), 0u);
 }
 
+TEST(KeyIndex, CanBeLeftOut) {
+  using IndexedKvs = KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors>;
+  using UnindexedKvs =
+      KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 1, 1, false>;
+  static_assert(sizeof(UnindexedKvs) < sizeof(IndexedKvs));
+
+  UnindexedKvs kvs(&test_partition, default_format);
+  ASSERT_EQ(OkStatus(), test_partition.Erase());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(keys[i], uint32_t(i)));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint32_t value = 0;
+    EXPECT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(OkStatus(), kvs.Delete(keys[0]));
+  uint32_t value = 0;
+  EXPECT_EQ(Status::NotFound(), kvs.Get(keys[0], &value));
+}
+
 }  // namespace pw::kvs
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string_view>
@@ -152,15 +153,50 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
+  // A slot in the optional hash index. Each slot holds the position of a
+  // KeyDescriptor in the descriptor list, or kEmptyIndexSlot.
+  using IndexSlot = uint16_t;
+  static constexpr IndexSlot kEmptyIndexSlot = 0xFFFF;
+
+  // The number of hash index slots to use for the specified number of entries.
+  // This is the smallest power of two that keeps the index at most two-thirds
+  // full, or 0 if there are too many entries to index.
+  static constexpr size_t IndexSlotsFor(size_t max_entries) {
+    if (max_entries >= kEmptyIndexSlot) {
+      return 0;
+    }
+    size_t slots = 1;
+    while (slots < max_entries + max_entries / 2 + 1) {
+      slots *= 2;
+    }
+    return slots;
+  }
+
+  // The type to use for a hash index for the specified number of entries.
+  template <size_t kMaxEntries>
+  using Index = std::array<IndexSlot, IndexSlotsFor(kMaxEntries)>;
+
+  // If an index is provided, keys are found by probing an open-addressed hash
+  // table instead of scanning every descriptor. The index must have
+  // IndexSlotsFor(descriptors.max_size()) slots. Without one, lookups fall
+  // back to a linear scan.
+  //
+  // The index may belong to an object that is not yet constructed, so it is
+  // not accessed here. Call Reset() to clear the index before using the cache.
   constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       span<IndexSlot> index = {})
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        index_(index) {}
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const {
+    descriptors_.clear();
+    ClearIndex();
+  }
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -181,7 +217,8 @@ class EntryCache {
                       EntryMetadata* metadata) const;
 
   // Adds a new descriptor to the descriptor list. The entry MUST be unique and
-  // the EntryCache must NOT be full!
+  // the EntryCache must NOT be full! The key hash of the returned metadata
+  // must not be changed, since the hash index refers to it.
   EntryMetadata AddNew(const KeyDescriptor& descriptor, Address address) const;
 
   // Adds a new descriptor, overwrites an existing one, or adds an additional
@@ -217,6 +254,9 @@ class EntryCache {
   // The maximum number of entries supported by this EntryCache.
   size_t max_entries() const { return descriptors_.max_size(); }
 
+  // True if lookups use the hash index rather than a linear scan.
+  bool indexed() const { return !index_.empty(); }
+
   iterator begin() const { return {this, descriptors_.begin()}; }
   const_iterator cbegin() const { return {this, descriptors_.begin()}; }
 
@@ -226,6 +266,31 @@ class EntryCache {
  private:
   int FindIndex(uint32_t key_hash) const;
 
+  constexpr void ClearIndex() const {
+    for (IndexSlot& slot : index_) {
+      slot = kEmptyIndexSlot;
+    }
+  }
+
+  // The slot at which probing for a key hash starts.
+  size_t IndexHome(uint32_t key_hash) const {
+    return (key_hash ^ (key_hash >> 16)) & (index_.size() - 1);
+  }
+
+  size_t NextIndexSlot(size_t slot) const {
+    return (slot + 1) & (index_.size() - 1);
+  }
+
+  // Returns the index slot that refers to the descriptor at this position.
+  size_t IndexSlotOf(size_t descriptor_index) const;
+
+  // Adds the descriptor at this position to the index.
+  void IndexInsert(size_t descriptor_index) const;
+
+  // Removes the descriptor at this position from the index. Slots after it in
+  // its probe sequence are shifted back, so no tombstones are needed.
+  void IndexErase(size_t descriptor_index) const;
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -242,6 +307,7 @@ class EntryCache {
   Vector<KeyDescriptor>& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const span<IndexSlot> index_;
 };
 
 }  // namespace internal
@@ -0,0 +1,130 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/internal/entry_cache.h"
+#include "pw_kvs/internal/sectors.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// Stores a snapshot of a KeyValueStore's in-memory state in a separate flash
+// partition. The snapshot holds how many bytes were written to each sector and
+// the KeyDescriptors and addresses of all entries. It lets the KVS skip reading
+// the entries that were in flash when the checkpoint was written.
+//
+// Since sectors are only appended to between erases, a checkpoint stays
+// accurate, apart from entries appended after it, until a sector is erased.
+// Invalidate() must be called before erasing a sector.
+//
+// The checkpoint partition is laid out as follows. Each part starts on an
+// alignment boundary:
+//
+//   1. Header, with a checksum covering the rest of the header and parts 3-4.
+//   2. Invalidation marker. Erased while the checkpoint is valid.
+//   3. Sector table: the number of bytes written to each sector.
+//   4. Entry table: each KeyDescriptor followed by redundancy addresses.
+//
+// The header is written last, so a checkpoint that was interrupted while being
+// written is not loaded.
+class IndexCheckpoint {
+ public:
+  using Address = FlashPartition::Address;
+
+  constexpr IndexCheckpoint()
+      : partition_(nullptr),
+        valid_(false),
+        stale_(false),
+        transaction_id_(0),
+        entry_count_(0) {}
+
+  // Sets the partition to store checkpoints in. The partition must not be used
+  // for anything else.
+  void set_partition(FlashPartition* partition) {
+    partition_ = partition;
+    valid_ = false;
+  }
+
+  bool enabled() const { return partition_ != nullptr; }
+
+  // True if the checkpoint in flash is known to match the KVS, apart from
+  // entries written since the checkpoint.
+  bool valid() const { return valid_; }
+
+  // Writes a checkpoint of the sectors and entries. Does nothing if a valid
+  // checkpoint with the same transaction ID and entry count was already
+  // written.
+  //
+  //                   OK: the checkpoint was written
+  //  FAILED_PRECONDITION: checkpoints are not enabled, or a sector is corrupt
+  //   RESOURCE_EXHAUSTED: the checkpoint partition is too small
+  //
+  // Other errors are from erasing or writing the checkpoint partition.
+  Status Write(const FlashPartition& kvs_partition,
+               const Sectors& sectors,
+               const EntryCache& entry_cache,
+               uint32_t transaction_id);
+
+  // Loads the checkpoint. Sets the writable bytes of each sector and adds each
+  // entry to the EntryCache, which must be empty. If loading fails, the
+  // sectors and EntryCache may be partially updated and must be reset. A
+  // checkpoint that exists but cannot be loaded is invalidated.
+  //
+  //          OK: the checkpoint was loaded
+  //   NOT_FOUND: checkpoints are not enabled, there is no valid checkpoint, or
+  //              the checkpoint could not be invalidated since it was written
+  //   DATA_LOSS: the checkpoint is corrupt or does not match the KVS
+  //
+  Status Load(const FlashPartition& kvs_partition,
+              Sectors& sectors,
+              EntryCache& entry_cache);
+
+  // Marks the checkpoint in flash as out of date, if it is not already. If
+  // the marker cannot be written, the checkpoint partition is erased instead.
+  // If that fails too, the checkpoint is not loaded again until a new one is
+  // written. This is only tracked in RAM, so it does not survive a reboot.
+  Status Invalidate();
+
+ private:
+  size_t HeaderSize() const;
+  size_t MarkerSize() const;
+
+  Status DoLoad(const FlashPartition& kvs_partition,
+                Sectors& sectors,
+                EntryCache& entry_cache);
+
+  // Writes the invalidation marker, or erases the checkpoint if that fails.
+  Status WriteInvalidationMarker();
+
+  FlashPartition* partition_;
+  bool valid_;
+
+  // True if the checkpoint in flash may be out of date, but could not be
+  // marked as such.
+  bool stale_;
+
+  // The transaction ID and number of entries in the valid checkpoint.
+  uint32_t transaction_id_;
+  size_t entry_count_;
+};
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
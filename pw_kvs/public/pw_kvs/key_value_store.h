@@ -25,6 +25,7 @@
 #include "pw_kvs/format.h"
 #include "pw_kvs/internal/entry.h"
 #include "pw_kvs/internal/entry_cache.h"
+#include "pw_kvs/internal/index_checkpoint.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
@@ -32,6 +33,18 @@
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 
+/// @def PW_KVS_KEY_INDEX
+///
+/// Whether `KeyValueStoreBuffer` allocates a hash index over its keys by
+/// default. The index makes finding a key take about the same time regardless
+/// of how many keys are stored, but costs two bytes of RAM per slot, with at
+/// least 1.5 slots per key. Without it, keys are found by scanning every key
+/// descriptor. Each `KeyValueStoreBuffer` can override this with its
+/// `kKeyIndex` template parameter.
+#ifndef PW_KVS_KEY_INDEX
+#define PW_KVS_KEY_INDEX 1
+#endif  // PW_KVS_KEY_INDEX
+
 namespace pw {
 namespace kvs {
 
@@ -122,6 +135,28 @@ class KeyValueStore {
   /// @endrst
   Status Init();
 
+  /// Stores checkpoints of the KVS's in-memory index in a separate flash
+  /// partition, to make `Init()` faster.
+  ///
+  /// Without a checkpoint, `Init()` reads and verifies every entry in every
+  /// sector, so it takes longer as the partition grows. With a checkpoint,
+  /// `Init()` loads the location of each key directly, and only reads entries
+  /// written since the checkpoint. If the checkpoint does not match what is in
+  /// flash, `Init()` falls back to reading every entry.
+  ///
+  /// Checkpoints are written by `FullMaintenance()` and `HeavyMaintenance()`.
+  /// Garbage collecting a sector makes the checkpoint out of date until the
+  /// next one is written. If the checkpoint partition cannot be written to
+  /// mark it as out of date, garbage collection continues and `Init()` skips
+  /// the checkpoint until the next one is written.
+  ///
+  /// Must be called before `Init()`. The partition must not be used for
+  /// anything else, and must be large enough to hold a table of sectors and
+  /// entries. See the module docs for details.
+  void EnableIndexCheckpoint(FlashPartition& checkpoint_partition) {
+    index_checkpoint_.set_partition(&checkpoint_partition);
+  }
+
   bool initialized() const {
     return initialized_ == InitializationState::kReady;
   }
@@ -295,6 +330,38 @@ class KeyValueStore {
   /// that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  /// Performs one bounded step of garbage collection. Calling this regularly,
+  /// such as from a `pw_async2` task or a `pw_work_queue` work item, reclaims
+  /// space before `Put()` runs out of it, so that `Put()` does not have to
+  /// garbage collect a whole sector at once.
+  ///
+  /// Each step either relocates up to `max_entries_to_relocate` valid entries
+  /// out of the sector being collected, or erases that sector once it holds no
+  /// valid entries. Sectors without valid entries are collected whenever they
+  /// have reclaimable space. To limit flash wear, sectors with valid entries
+  /// are only collected once few empty sectors remain.
+  ///
+  /// The KVS is not thread safe, so steps must not run concurrently with other
+  /// KVS operations.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: A step of garbage collection was done. Call again to continue.
+  ///
+  ///    NOT_FOUND: No garbage collection is needed.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized. Call ``Init()``
+  ///    before calling this method.
+  ///
+  ///    INVALID_ARGUMENT: ``max_entries_to_relocate`` is 0.
+  ///
+  /// Other errors are from repairing, relocating entries, or erasing.
+  ///
+  /// @endrst
+  Status IncrementalMaintenance(size_t max_entries_to_relocate = 1);
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
@@ -475,7 +542,8 @@ class KeyValueStore {
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
                 Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Address* addresses,
+                span<internal::EntryCache::IndexSlot> key_index = {});
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -492,6 +560,7 @@ class KeyValueStore {
   }
 
   Status InitializeMetadata();
+  Status ReadMetadata(bool use_index_checkpoint);
   Status LoadEntry(Address entry_address, Address* next_entry_address);
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
@@ -619,6 +688,10 @@ class KeyValueStore {
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               span<const Address> reserved_addresses);
 
+  // Selects the next sector for IncrementalMaintenance() to collect, or
+  // returns nullptr if none needs to be collected yet.
+  SectorDescriptor* FindSectorForIncrementalGarbageCollection() const;
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -651,10 +724,14 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors, with an optional hash index. Finding a
+  // key requires looking up its hash and verifying a match by reading the
+  // actual entry.
   internal::EntryCache entry_cache_;
 
+  // Optional snapshot of the sectors and entry cache in another partition.
+  internal::IndexCheckpoint index_checkpoint_;
+
   Options options_;
 
   // Threshold value for when to garbage collect all stale data. Above the
@@ -688,13 +765,17 @@ class KeyValueStore {
   };
   InternalStats internal_stats_;
 
+  // The sector IncrementalMaintenance() is relocating entries out of, if any.
+  SectorDescriptor* incremental_gc_sector_;
+
   uint32_t last_transaction_id_;
 };
 
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          bool kKeyIndex = PW_KVS_KEY_INDEX>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -723,7 +804,8 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       sectors_,
                       temp_sectors_to_skip_,
                       key_descriptors_,
-                      addresses_),
+                      addresses_,
+                      key_index_),
         sectors_(),
         key_descriptors_(),
         formats_() {
@@ -755,6 +837,12 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Hash index over the KeyDescriptors, so that finding a key does not require
+  // scanning every descriptor. Empty if kKeyIndex is false.
+  std::array<internal::EntryCache::IndexSlot,
+             kKeyIndex ? internal::EntryCache::IndexSlotsFor(kMaxEntries) : 0>
+      key_index_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
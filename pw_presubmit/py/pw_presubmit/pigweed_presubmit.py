@@ -215,6 +215,7 @@ def _gn_platform_build_check_targets() -> Sequence[str]:
     # TODO: b/269354373 - clang is not supported on windows yet
     if sys.platform != 'win32':
         build_targets.append('host_clang_debug_dynamic_allocation')
+        build_targets.append('host_clang_debug_rpc_scaling')
 
     return build_targets
 
@@ -827,6 +828,14 @@ def bazel_test(ctx: PresubmitContext) -> None:
         '--',
         '//pw_rpc/...',
     )
+    build_bazel(
+        ctx,
+        'test',
+        '--//pw_rpc:config_override=//pw_rpc:scaling_test_config',
+        '--',
+        '//pw_rpc/...',
+        '//pw_rpc_transport/...',
+    )
 
     # pw_grpc
     build_bazel(
@@ -15,6 +15,7 @@
 #include "pw_rpc/benchmark.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "pw_rpc/internal/config.h"
 
@@ -26,6 +27,38 @@ void BenchmarkService::UnaryEcho(ConstByteSpan request,
       .IgnoreError();
 }
 
+void BenchmarkService::ServerStreamEcho(ConstByteSpan request,
+                                        RawServerWriter& writer) {
+  writer.Write(request).IgnoreError();
+  writer.Finish().IgnoreError();
+}
+
+void BenchmarkService::ClientStreamEcho(RawServerReader& new_reader) {
+  // Readers are finished from their own callbacks, so they are removed here.
+  for (auto reader = readers_.begin(); reader != readers_.end();) {
+    reader = reader->second.active() ? std::next(reader)
+                                     : readers_.erase(reader);
+  }
+
+  auto id = AllocateReaderWriterId();
+
+  struct Captures {
+    BenchmarkService* self;
+    ReaderWriterId id;
+  };
+
+  auto captures = std::make_unique<Captures>(Captures{.self = this, .id = id});
+  new_reader.set_on_next(
+      [context = std::move(captures)](ConstByteSpan request) {
+        auto& readers = context->self->readers_;
+        auto reader = readers.find(context->id);
+        if (reader != readers.end()) {
+          reader->second.Finish(request).IgnoreError();
+        }
+      });
+  readers_.insert({id, std::move(new_reader)});
+}
+
 BenchmarkService::ReaderWriterId BenchmarkService::AllocateReaderWriterId() {
   return next_reader_writer_id_++;
 }
@@ -46,5 +46,29 @@ TEST(BenchmarkService, Benchmark_EmptyRequest) {
   ASSERT_TRUE(DataEqual(context.response(), msg));
 }
 
+TEST(BenchmarkService, ServerStreamEcho_WritesRequestAndCompletes) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ServerStreamEcho) context;
+  auto msg = pw::bytes::Array<0x12, 0x34, 0x56, 0x78>();
+
+  context.call(msg);
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_EQ(1u, context.responses().size());
+  ASSERT_TRUE(DataEqual(context.responses()[0], msg));
+}
+
+TEST(BenchmarkService, ClientStreamEcho_CompletesWithFirstRequest) {
+  PW_RAW_TEST_METHOD_CONTEXT(BenchmarkService, ClientStreamEcho) context;
+  auto msg = pw::bytes::Array<0x12, 0x34, 0x56, 0x78>();
+
+  context.call();
+  EXPECT_FALSE(context.done());
+
+  context.SendClientStream(msg);
+  ASSERT_TRUE(context.done());
+  EXPECT_EQ(OkStatus(), context.status());
+  ASSERT_TRUE(DataEqual(context.response(), msg));
+}
+
 }  // namespace
 }  // namespace pw::rpc
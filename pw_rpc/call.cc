@@ -153,7 +153,9 @@ void Call::MoveFrom(Call& other) {
   service_id_ = other.service_id_;
   method_id_ = other.method_id_;
 
-  state_ = other.state_;
+  // If the other call is finishing, the thread sending its final packet sees
+  // that it was closed by the move, so this call is not finishing.
+  state_ = static_cast<uint8_t>(other.state_ & ~kFinishing);
 
   // No need to move awaiting_cleanup_, since it is 0 in both calls here.
 
@@ -167,8 +169,8 @@ void Call::MoveFrom(Call& other) {
 
   if (other.active_locked()) {
     // Mark the other call inactive, unregister it, and register this one.
-    other.MarkClosed();
     endpoint().UnregisterCall(other);
+    other.MarkClosed();
     endpoint().RegisterUniqueCall(*this);
   }
 }
@@ -213,7 +215,7 @@ bool Call::CleanUpIfRequired() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
 }
 
 Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
-  if (!active_locked()) {
+  if (!active_locked() || finishing()) {
     encoding_buffer.ReleaseIfAllocated();
     return Status::FailedPrecondition();
   }
@@ -223,7 +225,15 @@ Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
     encoding_buffer.ReleaseIfAllocated();
     return Status::Unavailable();
   }
-  return channel->Send(MakePacket(type, payload, status));
+  return SendOnChannel(*channel, MakePacket(type, payload, status));
+}
+
+Status Call::SendOnChannel(ChannelBase& channel, const Packet& packet) {
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  return channel.SendOutsideRpcLock(packet);
+#else
+  return channel.Send(packet);
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
 }
 
 Status Call::CloseAndSendResponseCallbackLocked(
@@ -243,20 +253,71 @@ Status Call::TryCloseAndSendResponseCallbackLocked(
 Status Call::CloseAndSendFinalPacketLocked(PacketType type,
                                            ConstByteSpan response,
                                            Status status) {
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  if (!active_locked() || finishing()) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::FailedPrecondition();
+  }
+
+  ChannelBase* channel = endpoint_->GetInternalChannel(channel_id_);
+  const Packet packet = MakePacket(type, response, status);
+
+  // Sending releases the RPC lock, so close the call first. Other threads
+  // then see that the call is closed and do not send another final packet.
+  UnregisterAndMarkClosed();
+
+  if (channel == nullptr) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::Unavailable();
+  }
+  return SendOnChannel(*channel, packet);
+#else
   const Status send_status = SendPacket(type, response, status);
   UnregisterAndMarkClosed();
   return send_status;
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
 }
 
 Status Call::TryCloseAndSendFinalPacketLocked(PacketType type,
                                               ConstByteSpan response,
                                               Status status) {
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  if (!active_locked() || finishing()) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::FailedPrecondition();
+  }
+
+  ChannelBase* channel = endpoint_->GetInternalChannel(channel_id_);
+  if (channel == nullptr) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::Unavailable();
+  }
+
+  // The call is only closed if the final packet is sent, but the RPC lock is
+  // released while it is sent. Mark the call as finishing until then, so that
+  // other threads neither send packets for it nor handle packets received for
+  // it.
+  state_ |= kFinishing;
+  const Status send_status =
+      channel->SendOutsideRpcLock(MakePacket(type, response, status));
+
+  // If the call is no longer finishing, another thread closed it while the
+  // lock was released.
+  if (finishing()) {
+    state_ &= static_cast<uint8_t>(~kFinishing);
+    if (send_status.ok()) {
+      UnregisterAndMarkClosed();
+    }
+  }
+  return send_status;
+#else
   const Status send_status = SendPacket(type, response, status);
   // Only close the call if the final packet gets sent out successfully.
   if (send_status.ok()) {
     UnregisterAndMarkClosed();
   }
   return send_status;
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
 }
 
 Status Call::WriteLocked(ConstByteSpan payload) {
@@ -275,6 +336,26 @@ Status Call::WriteCallbackLocked(
                     payload);
 }
 
+Status Call::WriteWithHeaderLocked(
+    size_t payload_size,
+    const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send) {
+  if (!active_locked() || finishing()) {
+    return Status::FailedPrecondition();
+  }
+
+  ChannelBase* channel = endpoint_->GetInternalChannel(channel_id_);
+  if (channel == nullptr) {
+    return Status::Unavailable();
+  }
+  return channel->SendWithHeader(
+      MakePacket(properties_.call_type() == kServerCall
+                     ? PacketType::SERVER_STREAM
+                     : PacketType::CLIENT_STREAM,
+                 {}),
+      payload_size,
+      send);
+}
+
 // This definition is in the .cc file because the Endpoint class is not defined
 // in the Call header, due to circular dependencies between the two.
 void Call::CloseAndMarkForCleanup(Status error) {
@@ -282,6 +363,23 @@ void Call::CloseAndMarkForCleanup(Status error) {
 }
 
 void Call::HandlePayload(ConstByteSpan payload) {
+  if (!InvokeOnNext(payload)) {
+    rpc_lock().unlock();
+    return;
+  }
+
+  // The call could have been reinitialized and cleaned up already by another
+  // thread that acquired the rpc_lock() while on_next_local was executing
+  // without lock held.
+  if (endpoint_ != nullptr) {
+    // Clean up calls in case decoding failed.
+    endpoint_->CleanUpCalls();
+  } else {
+    rpc_lock().unlock();
+  }
+}
+
+bool Call::InvokeOnNext(ConstByteSpan payload) {
   // pw_rpc only supports handling packets for a particular RPC one at a time.
   // Check if any callbacks are running and drop the packet if they are.
   //
@@ -296,13 +394,11 @@ void Call::HandlePayload(ConstByteSpan payload) {
         static_cast<unsigned>(channel_id_),
         static_cast<unsigned>(service_id_),
         static_cast<unsigned>(method_id_));
-    rpc_lock().unlock();
-    return;
+    return false;
   }
 
   if (on_next_ == nullptr) {
-    rpc_lock().unlock();
-    return;
+    return false;
   }
 
   const uint32_t original_id = id();
@@ -325,16 +421,7 @@ void Call::HandlePayload(ConstByteSpan payload) {
   if (active_locked() && id() == original_id && on_next_ == nullptr) {
     on_next_ = std::move(on_next_local);
   }
-
-  // The call could have been reinitialized and cleaned up already by another
-  // thread that acquired the rpc_lock() while on_next_local was executing
-  // without lock held.
-  if (endpoint_ != nullptr) {
-    // Clean up calls in case decoding failed.
-    endpoint_->CleanUpCalls();
-  } else {
-    rpc_lock().unlock();
-  }
+  return true;
 }
 
 void Call::CloseClientCall() {
@@ -345,7 +432,11 @@ void Call::CloseClientCall() {
   // RPCs, since the client is not sending messages, server does not need to be
   // notified.
   if (has_client_stream() && !client_requested_completion()) {
-    RequestCompletionLocked().IgnoreError();
+    // Closes the call before sending, since sending may release the RPC lock.
+    CloseAndSendFinalPacketLocked(
+        pwpb::PacketType::CLIENT_REQUEST_COMPLETION, {}, OkStatus())
+        .IgnoreError();
+    return;
   }
   UnregisterAndMarkClosed();
 }
@@ -0,0 +1,85 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/internal/test_utils.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+#include "pw_rpc_private/test_method.h"
+
+namespace pw::rpc {
+
+class LookupTestService : public Service {
+ public:
+  constexpr LookupTestService(uint32_t id) : Service(id, method) {}
+
+  static constexpr internal::TestMethodUnion method = internal::TestMethod(8);
+};
+
+namespace internal {
+namespace {
+
+using ::pw::rpc::internal::test::FakeServerWriter;
+
+constexpr uint32_t kChannelId = 99;
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 8;
+
+// Opens `call_count` concurrent server streaming calls on a single RPC and
+// measures how long it takes to resolve an incoming packet to its call.
+//
+// Build with PW_RPC_CALL_INDEX_BUCKETS set to compare the hash index against
+// the default search of the calls list.
+void FindCallWithOpenCalls(perf_test::State& state, size_t call_count) {
+  ServerContextForTest<LookupTestService, kChannelId, kServiceId> context(
+      LookupTestService::method.method());
+
+  std::vector<FakeServerWriter> writers;
+  writers.reserve(call_count);
+  for (size_t i = 0; i < call_count; ++i) {
+    rpc_lock().lock();
+    writers.emplace_back(
+        context.get(static_cast<uint32_t>(i + 1)).ClaimLocked());
+    rpc_lock().unlock();
+  }
+
+  uint32_t call_id = 1;
+  while (state.KeepRunning()) {
+    const Packet packet(pwpb::PacketType::CLIENT_STREAM,
+                        kChannelId,
+                        kServiceId,
+                        kMethodId,
+                        call_id);
+    {
+      RpcLockGuard lock;
+      context.server().FindCall(packet);
+    }
+    call_id = call_id == call_count ? 1 : call_id + 1;
+  }
+
+  // Cancel the calls so that they do not send responses when destroyed.
+  context.server().CloseChannel(kChannelId).IgnoreError();
+}
+
+PW_PERF_TEST(FindCall_1OpenCall, FindCallWithOpenCalls, 1);
+PW_PERF_TEST(FindCall_100OpenCalls, FindCallWithOpenCalls, 100);
+PW_PERF_TEST(FindCall_1000OpenCalls, FindCallWithOpenCalls, 1000);
+PW_PERF_TEST(FindCall_10000OpenCalls, FindCallWithOpenCalls, 10000);
+
+}  // namespace
+}  // namespace internal
+}  // namespace pw::rpc
@@ -59,6 +59,8 @@ static_assert(sizeof(Call) ==
                       sizeof(Endpoint*) +
                       // call_id, channel_id, service_id, method_id
                       4 * sizeof(uint32_t) +
+                      // CallIndex chain pointer, if enabled
+                      (PW_RPC_CALL_INDEX_BUCKETS > 0 ? sizeof(Call*) : 0) +
                       // Packed state and properties
                       sizeof(void*) +
                       // on_error and on_next callbacks
@@ -120,9 +122,9 @@ TEST_F(ServerWriterTest, DefaultConstruct_Closed) {
 
 TEST_F(ServerWriterTest, Construct_RegistersWithServer) {
   RpcLockGuard lock;
-  IntrusiveList<Call>::iterator call = context_.server().FindCall(kPacket);
-  ASSERT_NE(call, context_.server().calls_end());
-  EXPECT_EQ(static_cast<void*>(&*call), static_cast<void*>(&writer_));
+  Call* call = context_.server().FindCall(kPacket);
+  ASSERT_NE(call, nullptr);
+  EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writer_));
 }
 
 TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
@@ -136,13 +138,13 @@ TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
   }
 
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_RemovesFromServer) {
   EXPECT_EQ(OkStatus(), writer_.Finish());
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_SendsResponse) {
@@ -230,6 +232,93 @@ TEST_F(ServerWriterTest, Open_NoClientStream) {
   EXPECT_FALSE(writer_.as_server_call().client_requested_completion());
 }
 
+class ServerCallLookupTest : public Test {
+ public:
+  ServerCallLookupTest() : context_(TestService::method.method()) {}
+
+  // Cancel the calls so that they do not send responses when destroyed.
+  ~ServerCallLookupTest() override {
+    EXPECT_EQ(OkStatus(), context_.server().CloseChannel(kChannelId));
+  }
+
+ protected:
+  static constexpr uint32_t CallId(size_t index) {
+    return static_cast<uint32_t>(1000 + index);
+  }
+
+  static constexpr Packet PacketFor(uint32_t call_id) {
+    return Packet(pwpb::PacketType::CLIENT_STREAM,
+                  kChannelId,
+                  kServiceId,
+                  kMethodId,
+                  call_id);
+  }
+
+  void OpenWriters() {
+    for (size_t i = 0; i < writers_.size(); ++i) {
+      rpc_lock().lock();
+      FakeServerWriter writer(context_.get(CallId(i)).ClaimLocked());
+      rpc_lock().unlock();
+      writers_[i] = std::move(writer);
+    }
+  }
+
+  Call* Find(uint32_t call_id) {
+    RpcLockGuard lock;
+    return context_.server().FindCall(PacketFor(call_id));
+  }
+
+  ServerContextForTest<TestService, kChannelId, kServiceId, kCallId> context_;
+  std::array<FakeServerWriter, 24> writers_;
+};
+
+TEST_F(ServerCallLookupTest, ManyCalls_FindsEachCall) {
+  OpenWriters();
+
+  for (size_t i = 0; i < writers_.size(); ++i) {
+    EXPECT_EQ(static_cast<void*>(Find(CallId(i))),
+              static_cast<void*>(&writers_[i]));
+  }
+  EXPECT_EQ(Find(CallId(writers_.size())), nullptr);
+}
+
+TEST_F(ServerCallLookupTest, FinishedCalls_NotFound) {
+  OpenWriters();
+
+  // The channel output stores up to 5 packets, so finish every sixth call.
+  for (size_t i = 0; i < writers_.size(); i += 6) {
+    EXPECT_EQ(OkStatus(), writers_[i].Finish());
+  }
+
+  for (size_t i = 0; i < writers_.size(); ++i) {
+    if (i % 6 == 0) {
+      EXPECT_EQ(Find(CallId(i)), nullptr);
+    } else {
+      EXPECT_EQ(static_cast<void*>(Find(CallId(i))),
+                static_cast<void*>(&writers_[i]));
+    }
+  }
+}
+
+TEST_F(ServerCallLookupTest, DuplicateCallId_CancelsOriginalCall) {
+  OpenWriters();
+
+  rpc_lock().lock();
+  FakeServerWriter duplicate(context_.get(CallId(3)).ClaimLocked());
+  rpc_lock().unlock();
+
+  EXPECT_FALSE(writers_[3].active());
+  EXPECT_EQ(static_cast<void*>(Find(CallId(3))),
+            static_cast<void*>(&duplicate));
+}
+
+TEST_F(ServerCallLookupTest, MovedCall_FoundAtNewLocation) {
+  OpenWriters();
+
+  FakeServerWriter moved(std::move(writers_[5]));
+  EXPECT_EQ(static_cast<void*>(Find(CallId(5))), static_cast<void*>(&moved));
+}
+
 class ServerReaderTest : public Test {
  public:
   ServerReaderTest() : context_(TestService::method.method()) {
@@ -18,6 +18,9 @@
 #include "pw_rpc/channel.h"
 // clang-format on
 
+#include <array>
+#include <mutex>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/span.h"
 #include "pw_log/log.h"
@@ -56,6 +59,12 @@ Status ChannelBase::Send(const Packet& packet) {
                 static_cast<unsigned>(packet.method_id()));
   }
 
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  // Other packets may be in flight on this channel outside the RPC lock. Hold
+  // the channel's send lock so this packet is sent in order after them.
+  std::lock_guard channel_lock(ChannelEncodingBufferFor(id()).send_lock());
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
   ByteSpan buffer = encoding_buffer.GetPacketBuffer(packet.payload().size());
   Result encoded = packet.Encode(buffer);
 
@@ -72,10 +81,128 @@ Status ChannelBase::Send(const Packet& packet) {
   PW_CHECK_NOTNULL(output_);
   Status sent = output_->Send(encoded.value());
   encoding_buffer.Release();
+  return HandleSendStatus(id(), sent);
+}
+
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
+namespace {
+
+// Locks and returns a free encoding buffer, starting with the one that the
+// channel's ID maps to. If every buffer is in use, waits for that one.
+ChannelEncodingBuffer& LockFreeEncodingBuffer(uint32_t channel_id)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  span<ChannelEncodingBuffer> buffers = ChannelEncodingBuffers();
+  const size_t first = channel_id % buffers.size();
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ChannelEncodingBuffer& buffer = buffers[(first + i) % buffers.size()];
+    if (buffer.lock().try_lock()) {
+      return buffer;
+    }
+  }
+  buffers[first].lock().lock();
+  return buffers[first];
+}
+
+// Releases the RPC lock and acquires the channel's send lock. If another
+// packet is being sent on the channel, this waits for it without holding the
+// RPC lock, so that other channels are not held up.
+void ReleaseRpcLockForSend(uint32_t channel_id) PW_NO_LOCK_SAFETY_ANALYSIS {
+  RpcLock& send_lock = ChannelEncodingBufferFor(channel_id).send_lock();
+  const bool locked = send_lock.try_lock();
+  rpc_lock().unlock();
+  if (!locked) {
+    send_lock.lock();
+  }
+}
+
+// Releases the channel's send lock and the encoding buffer, and reacquires the
+// RPC lock.
+void ReacquireRpcLockAfterSend(uint32_t channel_id,
+                               ChannelEncodingBuffer& buffer)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  ChannelEncodingBufferFor(channel_id).send_lock().unlock();
+  buffer.lock().unlock();
+  rpc_lock().lock();
+}
+
+}  // namespace
+
+Status ChannelBase::SendOutsideRpcLock(const Packet& packet)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  const uint32_t channel_id = id();
+  ChannelEncodingBuffer& buffer = LockFreeEncodingBuffer(channel_id);
+
+  // The payload may be in the global encoding buffer, so encode the packet
+  // before releasing it.
+  Result encoded = packet.Encode(buffer.buffer());
+  encoding_buffer.ReleaseIfAllocated();
+
+  if (!encoded.ok()) {
+    buffer.lock().unlock();
+    PW_LOG_ERROR(
+        "Failed to encode RPC packet type %u to channel %u buffer, status %u",
+        static_cast<unsigned>(packet.type()),
+        static_cast<unsigned>(channel_id),
+        encoded.status().code());
+    return Status::Internal();
+  }
+
+  PW_CHECK_NOTNULL(output_);
+  ChannelOutput& output = *output_;
+
+  // This channel object must not be accessed without the RPC lock. Holding the
+  // buffer's lock keeps Endpoint::CloseChannel() from returning while the
+  // output is in use.
+  ReleaseRpcLockForSend(channel_id);
+  const Status sent = output.Send(encoded.value());
+  ReacquireRpcLockAfterSend(channel_id, buffer);
+
+  return HandleSendStatus(channel_id, sent);
+}
+
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
+Status ChannelBase::SendWithHeader(
+    const Packet& packet,
+    size_t payload_size,
+    const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send)
+    PW_NO_LOCK_SAFETY_ANALYSIS {
+  std::array<std::byte, Packet::kMinEncodedSizeWithoutPayload> header_buffer;
+  Result<ConstByteSpan> header =
+      packet.EncodeHeader(header_buffer, payload_size);
+
+  if (!header.ok()) {
+    PW_LOG_ERROR(
+        "Failed to encode RPC packet type %u header for channel %u, status %u",
+        static_cast<unsigned>(packet.type()),
+        static_cast<unsigned>(id()),
+        header.status().code());
+    return Status::Internal();
+  }
+
+  PW_CHECK_NOTNULL(output_);
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  // As in SendOutsideRpcLock(), the buffer's lock keeps the output valid while
+  // the RPC lock is released. `send` may copy the packet into the buffer.
+  const uint32_t channel_id = id();
+  ChannelOutput& output = *output_;
+  ChannelEncodingBuffer& buffer = LockFreeEncodingBuffer(channel_id);
+
+  ReleaseRpcLockForSend(channel_id);
+  const Status sent = send(*header, buffer.buffer(), output);
+  ReacquireRpcLockAfterSend(channel_id, buffer);
+
+  return HandleSendStatus(channel_id, sent);
+#else
+  return HandleSendStatus(id(), send(*header, {}, *output_));
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+}
 
+Status ChannelBase::HandleSendStatus(uint32_t channel_id, Status sent) {
   if (!sent.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
-                 static_cast<unsigned>(id()),
+                 static_cast<unsigned>(channel_id),
                  sent.code());
 
     return Status::Unknown();
@@ -34,9 +34,37 @@ using internal::pwpb::PacketType;
 Status Client::ProcessPacket(ConstByteSpan data) {
   PW_TRY_ASSIGN(Packet packet, Endpoint::ProcessPacket(data, Packet::kClient));
 
-  // Find an existing call for this RPC, if any.
   internal::rpc_lock().lock();
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  return ProcessPacketLocked(packet);
+}
+
+StatusWithSize Client::ProcessPackets(span<const ConstByteSpan> packets) {
+  size_t processed = 0;
+  Status status;
+
+  internal::rpc_lock().lock();
+  for (ConstByteSpan packet_data : packets) {
+    Result<Packet> packet =
+        Endpoint::ProcessPacket(packet_data, Packet::kClient);
+    Status packet_status = packet.status();
+    if (packet.ok()) {
+      packet_status = ProcessBatchedPacket(*packet);
+    }
+
+    if (packet_status.ok()) {
+      processed += 1;
+    } else {
+      status.Update(packet_status);
+    }
+  }
+  CleanUpCalls();
+
+  return StatusWithSize(status, processed);
+}
+
+Status Client::ProcessPacketLocked(const internal::Packet& packet) {
+  // Find an existing call for this RPC, if any.
+  internal::Call* call = FindCall(packet);
 
   internal::ChannelBase* channel = GetInternalChannel(packet.channel_id());
 
@@ -47,7 +75,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::Unavailable();
   }
 
-  if (call == calls_end()) {
+  if (call == nullptr) {
     // The call for the packet does not exist. If the packet is a server stream
     // message, notify the server so that it can kill the stream. Otherwise,
     // silently drop the packet (as it would terminate the RPC anyway).
@@ -111,4 +139,29 @@ Status Client::ProcessPacket(ConstByteSpan data) {
   return OkStatus();  // OK since the packet was handled
 }
 
+Status Client::ProcessBatchedPacket(const internal::Packet& packet) {
+  // Server stream packets make up most large batches. They are handled here
+  // without releasing the lock, except to invoke the call's on_next callback.
+  // Other packets are processed as by ProcessPacket(), and the lock is
+  // reacquired afterwards.
+  internal::Call* call =
+      packet.type() == PacketType::SERVER_STREAM ? FindCall(packet) : nullptr;
+  if (call == nullptr || !call->has_server_stream()) {
+    const Status status = ProcessPacketLocked(packet);
+    internal::rpc_lock().lock();
+    return status;
+  }
+
+  if (GetInternalChannel(packet.channel_id()) == nullptr) {
+    PW_LOG_WARN("RPC client received a packet for an unregistered channel: %lu",
+                static_cast<unsigned long>(packet.channel_id()));
+    return Status::Unavailable();
+  }
+
+  if (call->InvokeOnNext(packet.payload())) {
+    CleanUpCallsAndRelock();  // Decoding the payload could have failed.
+  }
+  return OkStatus();
+}
+
 }  // namespace pw::rpc
@@ -18,8 +18,10 @@ namespace pw::rpc::internal {
 
 void ClientCall::MoveClientCallFrom(ClientCall& other)
     PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-  WaitUntilReadyForMove(*this, other);
+  // Closing this call may send a packet, which can release the RPC lock, so do
+  // it before waiting for the other call's callbacks.
   CloseClientCall();
+  WaitUntilReadyForMove(*this, other);
   MoveFrom(other);
 }
 
@@ -19,6 +19,7 @@
 // clang-format on
 
 #include "pw_log/log.h"
+#include "pw_rpc/internal/encoding_buffer.h"
 #include "pw_rpc/internal/lock.h"
 
 #if PW_RPC_YIELD_MODE == PW_RPC_YIELD_MODE_BUSY_LOOP
@@ -111,13 +112,42 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
 
 void Endpoint::RegisterCall(Call& new_call) {
   // Mark any exisitng duplicate calls as cancelled.
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  if (call_index_.CanFind(new_call.id())) {
+    Call* call = call_index_.Find(new_call.channel_id_locked(),
+                                  new_call.service_id(),
+                                  new_call.method_id(),
+                                  new_call.id());
+    if (call != nullptr) {
+      CloseCallAndMarkForCleanup(*call, Status::Cancelled());
+    }
+    RegisterUniqueCall(new_call);
+    return;
+  }
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+
   auto [before_call, call] = FindIteratorsForCall(new_call);
   if (call != calls_.end()) {
     CloseCallAndMarkForCleanup(before_call, call, Status::Cancelled());
   }
 
   // Register the new call.
-  calls_.push_front(new_call);
+  RegisterUniqueCall(new_call);
+}
+
+Call* Endpoint::FindCall(uint32_t channel_id,
+                         uint32_t service_id,
+                         uint32_t method_id,
+                         uint32_t call_id) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  if (call_index_.CanFind(call_id)) {
+    return call_index_.Find(channel_id, service_id, method_id, call_id);
+  }
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+
+  auto call = std::get<1>(
+      FindIteratorsForCall(channel_id, service_id, method_id, call_id));
+  return call == calls_.end() ? nullptr : &(*call);
 }
 
 std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
@@ -142,7 +172,9 @@ Endpoint::FindIteratorsForCall(uint32_t channel_id,
         // kLegacyOpenCallId is used for compatibility with old servers
         // which do not specify a Call ID but expect to be able to send
         // unrequested responses.
+        RemoveFromCallIndex(*call);
         call->set_id(call_id);
+        AddToCallIndex(*call);
         break;
       }
     }
@@ -163,6 +195,16 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
   }
   static_cast<internal::ChannelBase*>(channel)->Close();
 
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  // Wait for any packet that is being sent on this channel without the RPC
+  // lock, so the channel's output is no longer in use when this returns. The
+  // packet may be in any of the buffers.
+  for (ChannelEncodingBuffer& buffer : ChannelEncodingBuffers()) {
+    buffer.lock().lock();
+    buffer.lock().unlock();
+  }
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
   // Close pending calls on the channel that's going away.
   AbortCalls(AbortIdType::kChannel, channel_id);
 
@@ -216,6 +258,9 @@ void Endpoint::RemoveAllCalls() {
 
   // Close all calls without invoking on_error callbacks, since the calls should
   // have been closed before the Endpoint was deleted.
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  call_index_.Clear();
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
   while (!calls_.empty()) {
     calls_.front().CloseFromDeletedEndpoint();
     calls_.pop_front();
@@ -0,0 +1,120 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/internal/method_index.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/test_method.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+class TestService : public Service {
+ public:
+  TestService(uint32_t service_id)
+      : Service(service_id, methods_),
+        methods_{
+            TestMethod(100),
+            TestMethod(200),
+            TestMethod(300),
+        } {}
+
+  const Method& method(size_t index) const {
+    return methods_[index].method();
+  }
+
+ private:
+  std::array<TestMethodUnion, 3> methods_;
+};
+
+class MethodIndexTest : public ::testing::Test {
+ protected:
+  MethodIndexTest() : service_1_(1), service_2_(2) {
+    services_.push_front(service_1_);
+    services_.push_front(service_2_);
+  }
+
+  ~MethodIndexTest() override { services_.clear(); }
+
+  TestService service_1_;
+  TestService service_2_;
+  IntrusiveList<Service> services_;
+};
+
+TEST_F(MethodIndexTest, EmptyIndex_FindsNothing) {
+  MethodIndex<8> index;
+  EXPECT_EQ(index.size(), 0u);
+  EXPECT_EQ(index.Find(1, 100), (std::tuple<Service*, const Method*>{}));
+}
+
+TEST_F(MethodIndexTest, Rebuild_FindsAllMethods) {
+  MethodIndex<16> index;
+  index.Rebuild(services_);
+  ASSERT_EQ(index.size(), 6u);
+
+  EXPECT_EQ(index.Find(1, 100),
+            std::make_tuple(static_cast<Service*>(&service_1_),
+                            &service_1_.method(0)));
+  EXPECT_EQ(index.Find(1, 300),
+            std::make_tuple(static_cast<Service*>(&service_1_),
+                            &service_1_.method(2)));
+  EXPECT_EQ(index.Find(2, 200),
+            std::make_tuple(static_cast<Service*>(&service_2_),
+                            &service_2_.method(1)));
+}
+
+TEST_F(MethodIndexTest, UnknownIds_NotFound) {
+  MethodIndex<16> index;
+  index.Rebuild(services_);
+
+  EXPECT_EQ(index.Find(3, 100), (std::tuple<Service*, const Method*>{}));
+  EXPECT_EQ(index.Find(1, 400), (std::tuple<Service*, const Method*>{}));
+}
+
+TEST_F(MethodIndexTest, Rebuild_AfterServiceRemoved_DropsItsMethods) {
+  MethodIndex<16> index;
+  index.Rebuild(services_);
+
+  services_.remove(service_1_);
+  index.Rebuild(services_);
+
+  EXPECT_EQ(index.size(), 3u);
+  EXPECT_EQ(index.Find(1, 100), (std::tuple<Service*, const Method*>{}));
+  EXPECT_EQ(std::get<Service*>(index.Find(2, 100)), &service_2_);
+}
+
+TEST_F(MethodIndexTest, Overflow_IndexesUpToMaxSize) {
+  MethodIndex<4> index;
+  static_assert(MethodIndex<4>::max_size() == 3u);
+  index.Rebuild(services_);
+  EXPECT_EQ(index.size(), 3u);
+
+  size_t found = 0;
+  for (uint32_t service_id : {1u, 2u}) {
+    for (uint32_t method_id : {100u, 200u, 300u}) {
+      if (std::get<const Method*>(index.Find(service_id, method_id)) !=
+          nullptr) {
+        found += 1;
+      }
+    }
+  }
+  EXPECT_EQ(found, 3u);
+}
+
+}  // namespace
+}  // namespace pw::rpc::internal
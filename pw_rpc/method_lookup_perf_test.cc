@@ -0,0 +1,116 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/test_method.h"
+
+namespace pw::rpc {
+
+class ServerTestHelper {
+ public:
+  // Looks up a method the way the server does when it processes a packet.
+  static std::tuple<Service*, const internal::Method*> FindMethod(
+      Server& server, uint32_t service_id, uint32_t method_id) {
+    internal::RpcLockGuard lock;
+    return server.FindMethodLocked(service_id, method_id);
+  }
+};
+
+namespace {
+
+using internal::TestMethod;
+using internal::TestMethodUnion;
+
+// Roughly the shape of a large gateway: many services, each with several
+// methods.
+constexpr size_t kServiceCount = 40;
+constexpr size_t kMethodsPerService = 8;
+
+constexpr uint32_t MethodId(size_t index) {
+  return static_cast<uint32_t>(0x1000 + index * 0x101);
+}
+
+class LookupTestService : public Service {
+ public:
+  LookupTestService(uint32_t service_id)
+      : Service(service_id, methods_),
+        methods_{
+            TestMethod(MethodId(0)),
+            TestMethod(MethodId(1)),
+            TestMethod(MethodId(2)),
+            TestMethod(MethodId(3)),
+            TestMethod(MethodId(4)),
+            TestMethod(MethodId(5)),
+            TestMethod(MethodId(6)),
+            TestMethod(MethodId(7)),
+        } {}
+
+ private:
+  std::array<TestMethodUnion, kMethodsPerService> methods_;
+};
+
+constexpr uint32_t ServiceId(size_t index) {
+  return static_cast<uint32_t>(0xc0de0000 + index * 0x35);
+}
+
+template <size_t... kIndices>
+std::array<LookupTestService, sizeof...(kIndices)> MakeServices(
+    std::index_sequence<kIndices...>) {
+  return {LookupTestService(ServiceId(kIndices))...};
+}
+
+// Each iteration looks up every registered method, so that both early and late
+// entries in the services list are measured.
+void ServerFindMethodLocked(perf_test::State& state) {
+  static auto services =
+      MakeServices(std::make_index_sequence<kServiceCount>());
+  static Server server{span<Channel>()};
+  if (!server.IsServiceRegistered(services.front())) {
+    for (LookupTestService& service : services) {
+      server.RegisterService(service);
+    }
+  }
+
+  while (state.KeepRunning()) {
+    for (size_t service = 0; service < kServiceCount; ++service) {
+      for (size_t method = 0; method < kMethodsPerService; ++method) {
+        ServerTestHelper::FindMethod(
+            server, ServiceId(service), MethodId(method));
+      }
+    }
+  }
+}
+
+// The method index is part of the server, so it is enabled or disabled for the
+// whole build with PW_RPC_METHOD_INDEX_SIZE. Run this test in a build with the
+// index and one without to compare them. Methods that do not fit in the index
+// are found by searching the services list, so the index must have at least
+// 512 entries for every method to be indexed.
+#if PW_RPC_METHOD_INDEX_SIZE > 0
+PW_PERF_TEST(ServerFindMethodLockedWithIndex, ServerFindMethodLocked);
+#else
+PW_PERF_TEST(ServerFindMethodLockedWithoutIndex, ServerFindMethodLocked);
+#endif  // PW_RPC_METHOD_INDEX_SIZE > 0
+
+}  // namespace
+}  // namespace pw::rpc
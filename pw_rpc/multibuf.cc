@@ -0,0 +1,88 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/multibuf.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/encoding_buffer.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::encoding_buffer;
+
+// Copies the header and payload into the buffer and sends them as a contiguous
+// packet.
+Status CopyAndSend(ChannelOutput& output,
+                   ConstByteSpan header,
+                   const multibuf::MultiBuf& payload,
+                   ByteSpan buffer) {
+  const size_t packet_size = header.size() + payload.size();
+  if (packet_size > buffer.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  std::copy(header.begin(), header.end(), buffer.begin());
+  payload.CopyTo(buffer.subspan(header.size())).IgnoreError();  // Size checked
+
+  return output.Send(buffer.first(packet_size));
+}
+
+// Copies the packet into the channel encoding buffer that SendWithHeader
+// provided or, if there is none, into the global encoding buffer, which the
+// RPC lock then guards.
+Status SendCopy(ChannelOutput& output,
+                ConstByteSpan header,
+                const multibuf::MultiBuf& payload,
+                ByteSpan channel_buffer) PW_NO_LOCK_SAFETY_ANALYSIS {
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  return CopyAndSend(output, header, payload, channel_buffer);
+#else
+  static_cast<void>(channel_buffer);
+  const Status status = CopyAndSend(
+      output, header, payload, encoding_buffer.GetPacketBuffer(payload.size()));
+  encoding_buffer.Release();
+  return status;
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+}
+
+}  // namespace
+
+Status WriteMultiBuf(Writer& writer, multibuf::MultiBuf&& payload) {
+  // With channel encoding buffers, the callback runs without the RPC lock.
+  // Otherwise, the lock is held while it runs.
+  return writer.WriteWithHeader(
+      payload.size(),
+      [&payload](ConstByteSpan header, ByteSpan buffer, ChannelOutput& output) {
+        if (!payload.ClaimPrefix(header.size())) {
+          return SendCopy(output, header, payload, buffer);
+        }
+
+        payload.CopyFrom(header).IgnoreError();  // The prefix was claimed.
+
+        Status status = output.SendMultiBuf(std::move(payload));
+        if (status.IsUnimplemented()) {
+          // The output left the packet untouched, as SendMultiBuf requires. It
+          // already has its header.
+          return SendCopy(output, {}, payload, buffer);
+        }
+        return status;
+      });
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,117 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "pw_multibuf/single_chunk_region_tracker.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/multibuf.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint32_t kChannelId = 1;
+
+// The largest payload that the copying path can send.
+constexpr size_t kPayloadSize = MaxSafePayloadSize();
+
+// Counts sent bytes. MultiBuf packets are kept so that the benchmark can reuse
+// their chunks for the next payload.
+class SinkOutput : public ChannelOutput {
+ public:
+  SinkOutput() : ChannelOutput("SinkOutput") {}
+
+  Status Send(span<const std::byte> buffer) override {
+    bytes_sent_ += buffer.size();
+    return OkStatus();
+  }
+
+  Status SendMultiBuf(multibuf::MultiBuf&& packet) override {
+    bytes_sent_ += packet.size();
+    packet_ = std::move(packet);
+    return OkStatus();
+  }
+
+  multibuf::MultiBuf TakePacket() { return std::move(packet_); }
+
+ private:
+  size_t bytes_sent_ = 0;
+  multibuf::MultiBuf packet_;
+};
+
+// A server with a BenchmarkService and an open BidirectionalEcho call, which
+// is the stream that the echo RPC writes its responses to.
+class EchoServer {
+ public:
+  EchoServer()
+      : channels_{Channel::Create<kChannelId>(&output_)}, server_(channels_) {
+    server_.RegisterService(service_);
+    call_ = RawServerReaderWriter::Open<
+        pw_rpc::raw::Benchmark::BidirectionalEcho>(
+        server_, kChannelId, service_);
+  }
+
+  SinkOutput& output() { return output_; }
+  RawServerReaderWriter& call() { return call_; }
+
+ private:
+  SinkOutput output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  BenchmarkService service_;
+  RawServerReaderWriter call_;
+};
+
+// Baseline: the payload is copied into the encoding buffer with its header.
+void WriteCopiedPayload(perf_test::State& state) {
+  EchoServer echo;
+  std::array<std::byte, kPayloadSize> payload{};
+
+  while (state.KeepRunning()) {
+    echo.call().Write(payload).IgnoreError();
+  }
+}
+
+// The header is written in front of the payload, which is handed to the output
+// without copying.
+void WriteMultiBufPayload(perf_test::State& state) {
+  std::array<std::byte, kMultiBufPacketHeaderReserve + kPayloadSize> region{};
+  multibuf::SingleChunkRegionTracker tracker(region);
+  EchoServer echo;
+
+  std::optional<multibuf::OwnedChunk> chunk = tracker.GetChunk(region.size());
+  (*chunk)->DiscardPrefix(kMultiBufPacketHeaderReserve);
+  multibuf::MultiBuf payload = multibuf::MultiBuf::FromChunk(std::move(*chunk));
+
+  while (state.KeepRunning()) {
+    WriteMultiBuf(echo.call().as_writer(), std::move(payload)).IgnoreError();
+
+    // Strip the header from the sent packet to reuse it as the next payload.
+    payload = echo.output().TakePacket();
+    payload.DiscardPrefix(payload.size() - kPayloadSize);
+  }
+}
+
+PW_PERF_TEST(BidirectionalEchoWrite, WriteCopiedPayload);
+PW_PERF_TEST(BidirectionalEchoWriteMultiBuf, WriteMultiBufPayload);
+
+}  // namespace
+}  // namespace pw::rpc
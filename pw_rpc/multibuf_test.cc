@@ -0,0 +1,248 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/multibuf.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/array.h"
+#include "pw_multibuf/single_chunk_region_tracker.h"
+#include "pw_rpc/internal/call_context.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+#include "pw_rpc_private/test_method.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::CallContext;
+using internal::Packet;
+using internal::rpc_lock;
+using internal::pwpb::PacketType;
+using internal::test::FakeServerReaderWriter;
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 8;
+constexpr uint32_t kCallId = 327;
+
+constexpr auto kPayload = bytes::Array<0x01, 0x23, 0x45, 0x67, 0x89>();
+
+class TestService : public Service {
+ public:
+  constexpr TestService(uint32_t id) : Service(id, method) {}
+
+  static constexpr internal::TestMethodUnion method =
+      internal::TestMethod(kMethodId);
+};
+
+// Records packets sent as MultiBufs or as contiguous buffers.
+class TestOutput : public ChannelOutput {
+ public:
+  TestOutput(bool supports_multibuf)
+      : ChannelOutput("TestOutput"), supports_multibuf_(supports_multibuf) {}
+
+  Status Send(span<const std::byte> buffer) override {
+    CheckRpcLock();
+    std::copy(buffer.begin(), buffer.end(), packet_buffer_.begin());
+    packet_size_ = buffer.size();
+    copied_packets_ += 1;
+    return OkStatus();
+  }
+
+  Status SendMultiBuf(multibuf::MultiBuf&& packet) override {
+    if (!supports_multibuf_) {
+      return Status::Unimplemented();
+    }
+    CheckRpcLock();
+    packet_size_ =
+        packet.CopyTo(span(packet_buffer_).first(packet.size())).size();
+    multibuf_packet_ = std::move(packet);
+    multibuf_packets_ += 1;
+    return OkStatus();
+  }
+
+  Packet last_packet() const {
+    return Packet::FromBuffer(span(packet_buffer_).first(packet_size_))
+        .value();
+  }
+
+  const multibuf::MultiBuf& multibuf_packet() const { return multibuf_packet_; }
+  size_t copied_packets() const { return copied_packets_; }
+  size_t multibuf_packets() const { return multibuf_packets_; }
+  bool rpc_lock_was_free() const { return rpc_lock_was_free_; }
+
+ private:
+  // Records whether the RPC lock was free during the send. This is only
+  // checked if packets are sent without the RPC lock, since this thread holds
+  // it otherwise.
+  void CheckRpcLock() PW_NO_LOCK_SAFETY_ANALYSIS {
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+    rpc_lock_was_free_ = rpc_lock().try_lock();
+    if (rpc_lock_was_free_) {
+      rpc_lock().unlock();
+    }
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  }
+
+  const bool supports_multibuf_;
+  std::array<std::byte, 128> packet_buffer_{};
+  size_t packet_size_ = 0;
+  multibuf::MultiBuf multibuf_packet_;
+  size_t copied_packets_ = 0;
+  size_t multibuf_packets_ = 0;
+  bool rpc_lock_was_free_ = false;
+};
+
+class WriteMultiBufTest : public ::testing::Test {
+ protected:
+  WriteMultiBufTest(bool supports_multibuf = true)
+      : tracker_(region_),
+        output_(supports_multibuf),
+        channels_{Channel::Create<kChannelId>(&output_)},
+        server_(channels_),
+        service_(kServiceId) {
+    server_.RegisterService(service_);
+
+    rpc_lock().lock();
+    FakeServerReaderWriter call(
+        CallContext(server_,
+                    kChannelId,
+                    service_,
+                    TestService::method.method(),
+                    kCallId)
+            .ClaimLocked());
+    rpc_lock().unlock();
+    call_ = std::move(call);
+  }
+
+  // Returns a MultiBuf containing kPayload, optionally with space in front of
+  // it for the packet header.
+  multibuf::MultiBuf MakePayload(size_t headroom) {
+    std::optional<multibuf::OwnedChunk> chunk =
+        tracker_.GetChunk(headroom + kPayload.size());
+    PW_ASSERT(chunk.has_value());
+    (*chunk)->DiscardPrefix(headroom);
+    std::copy(kPayload.begin(), kPayload.end(), (*chunk)->begin());
+    return multibuf::MultiBuf::FromChunk(std::move(*chunk));
+  }
+
+  void ExpectStreamPacket(const Packet& packet) {
+    EXPECT_EQ(packet.type(), PacketType::SERVER_STREAM);
+    EXPECT_EQ(packet.channel_id(), kChannelId);
+    EXPECT_EQ(packet.service_id(), kServiceId);
+    EXPECT_EQ(packet.method_id(), kMethodId);
+    EXPECT_EQ(packet.call_id(), kCallId);
+    ASSERT_EQ(packet.payload().size(), kPayload.size());
+    EXPECT_TRUE(std::equal(
+        kPayload.begin(), kPayload.end(), packet.payload().begin()));
+  }
+
+  // Declared first so that the output releases its chunk before the tracker is
+  // destroyed.
+  std::array<std::byte, 64> region_{};
+  multibuf::SingleChunkRegionTracker tracker_;
+
+  TestOutput output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  TestService service_;
+  FakeServerReaderWriter call_;
+};
+
+TEST_F(WriteMultiBufTest, WithHeadroom_SendsPayloadInPlace) {
+  ASSERT_EQ(OkStatus(),
+            WriteMultiBuf(call_.as_writer(),
+                          MakePayload(kMultiBufPacketHeaderReserve)));
+
+  EXPECT_EQ(output_.multibuf_packets(), 1u);
+  EXPECT_EQ(output_.copied_packets(), 0u);
+  ExpectStreamPacket(output_.last_packet());
+
+  // The packet is the original chunk, with the header written in front of the
+  // payload.
+  const multibuf::MultiBuf& packet = output_.multibuf_packet();
+  ASSERT_EQ(packet.Chunks().size(), 1u);
+  const multibuf::Chunk& chunk = *packet.ConstChunks().begin();
+  EXPECT_EQ(chunk.data() + chunk.size(),
+            region_.data() + kMultiBufPacketHeaderReserve + kPayload.size());
+}
+
+TEST_F(WriteMultiBufTest, WithoutHeadroom_CopiesPacket) {
+  ASSERT_EQ(OkStatus(), WriteMultiBuf(call_.as_writer(), MakePayload(0)));
+
+  EXPECT_EQ(output_.multibuf_packets(), 0u);
+  EXPECT_EQ(output_.copied_packets(), 1u);
+  ExpectStreamPacket(output_.last_packet());
+}
+
+TEST_F(WriteMultiBufTest, WithEncodingBuffers_SendsWithoutRpcLock) {
+  if constexpr (PW_RPC_CHANNEL_ENCODING_BUFFERS == 0) {
+    GTEST_SKIP();
+  }
+
+  ASSERT_EQ(OkStatus(),
+            WriteMultiBuf(call_.as_writer(),
+                          MakePayload(kMultiBufPacketHeaderReserve)));
+  EXPECT_EQ(output_.multibuf_packets(), 1u);
+  EXPECT_TRUE(output_.rpc_lock_was_free());
+}
+
+TEST_F(WriteMultiBufTest, InactiveCall_FailedPrecondition) {
+  ASSERT_EQ(OkStatus(), call_.Finish());
+
+  EXPECT_EQ(Status::FailedPrecondition(),
+            WriteMultiBuf(call_.as_writer(),
+                          MakePayload(kMultiBufPacketHeaderReserve)));
+  EXPECT_EQ(output_.multibuf_packets(), 0u);
+}
+
+class WriteMultiBufUnsupportedOutputTest : public WriteMultiBufTest {
+ protected:
+  WriteMultiBufUnsupportedOutputTest() : WriteMultiBufTest(false) {}
+};
+
+TEST_F(WriteMultiBufUnsupportedOutputTest, CopiesPacket) {
+  ASSERT_EQ(OkStatus(),
+            WriteMultiBuf(call_.as_writer(),
+                          MakePayload(kMultiBufPacketHeaderReserve)));
+
+  EXPECT_EQ(output_.multibuf_packets(), 0u);
+  EXPECT_EQ(output_.copied_packets(), 1u);
+  ExpectStreamPacket(output_.last_packet());
+}
+
+TEST_F(WriteMultiBufUnsupportedOutputTest,
+       WithEncodingBuffers_CopiesWithoutRpcLock) {
+  if constexpr (PW_RPC_CHANNEL_ENCODING_BUFFERS == 0) {
+    GTEST_SKIP();
+  }
+
+  ASSERT_EQ(OkStatus(),
+            WriteMultiBuf(call_.as_writer(),
+                          MakePayload(kMultiBufPacketHeaderReserve)));
+  EXPECT_EQ(output_.copied_packets(), 1u);
+  EXPECT_TRUE(output_.rpc_lock_was_free());
+  ExpectStreamPacket(output_.last_packet());
+}
+
+}  // namespace
+}  // namespace pw::rpc
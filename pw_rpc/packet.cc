@@ -16,6 +16,9 @@
 
 #include "pw_log/log.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::rpc::internal {
 
@@ -91,6 +94,37 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
     rpc_packet.WritePayload(payload_).IgnoreError();
   }
 
+  EncodeFieldsExceptPayload(rpc_packet);
+
+  if (rpc_packet.status().ok()) {
+    return ConstByteSpan(rpc_packet);
+  }
+  return rpc_packet.status();
+}
+
+Result<ConstByteSpan> Packet::EncodeHeader(ByteSpan buffer,
+                                           size_t payload_size) const {
+  RpcPacket::MemoryEncoder rpc_packet(buffer);
+  EncodeFieldsExceptPayload(rpc_packet);
+  PW_TRY(rpc_packet.status());
+
+  const size_t fields_size = rpc_packet.size();
+  if (payload_size == 0u) {
+    return ConstByteSpan(buffer.first(fields_size));
+  }
+
+  // Protobuf fields may appear in any order, so the payload field is written
+  // last so that its contents can directly follow the header.
+  stream::MemoryWriter writer(buffer.subspan(fields_size));
+  PW_TRY(protobuf::WriteLengthDelimitedKeyAndLengthPrefix(
+      static_cast<uint32_t>(RpcPacket::Fields::kPayload),
+      payload_size,
+      writer));
+  return ConstByteSpan(buffer.first(fields_size + writer.bytes_written()));
+}
+
+void Packet::EncodeFieldsExceptPayload(
+    pwpb::RpcPacket::MemoryEncoder& rpc_packet) const {
   rpc_packet.WriteType(type_).IgnoreError();
   rpc_packet.WriteChannelId(channel_id_).IgnoreError();
   rpc_packet.WriteServiceId(service_id_).IgnoreError();
@@ -105,11 +139,6 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
   if (call_id_ != 0) {
     rpc_packet.WriteCallId(call_id_).IgnoreError();
   }
-
-  if (rpc_packet.status().ok()) {
-    return ConstByteSpan(rpc_packet);
-  }
-  return rpc_packet.status();
 }
 
 size_t Packet::MinEncodedSizeBytes() const {
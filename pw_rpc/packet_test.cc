@@ -97,6 +97,40 @@ TEST(Packet, Encode_BufferTooSmall) {
   EXPECT_EQ(Status::ResourceExhausted(), result.status());
 }
 
+TEST(Packet, EncodeHeader_FollowedByPayload_DecodesToPacket) {
+  byte buffer[64];
+
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7);
+
+  auto header = packet.EncodeHeader(buffer, kPayload.size());
+  ASSERT_EQ(OkStatus(), header.status());
+  ASSERT_LE(header->size(), Packet::kMinEncodedSizeWithoutPayload);
+
+  std::memcpy(buffer + header->size(), kPayload.data(), kPayload.size());
+  auto result = Packet::FromBuffer(
+      span(buffer).first(header->size() + kPayload.size()));
+  ASSERT_EQ(OkStatus(), result.status());
+
+  EXPECT_EQ(PacketType::RESPONSE, result->type());
+  EXPECT_EQ(1u, result->channel_id());
+  EXPECT_EQ(42u, result->service_id());
+  EXPECT_EQ(100u, result->method_id());
+  EXPECT_EQ(7u, result->call_id());
+  ASSERT_EQ(kPayload.size(), result->payload().size());
+  EXPECT_EQ(
+      0,
+      std::memcmp(result->payload().data(), kPayload.data(), kPayload.size()));
+}
+
+TEST(Packet, EncodeHeader_BufferTooSmall) {
+  byte buffer[2];
+
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 12);
+
+  EXPECT_EQ(Status::ResourceExhausted(),
+            packet.EncodeHeader(buffer, kPayload.size()).status());
+}
+
 TEST(Packet, Decode_ValidPacket) {
   auto result = Packet::FromBuffer(kEncoded);
   ASSERT_TRUE(result.ok());
@@ -0,0 +1,364 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/method_info.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc {
+namespace {
+
+using namespace std::chrono_literals;
+
+using chrono::SystemClock;
+using internal::Packet;
+using internal::pwpb::PacketType;
+
+constexpr size_t kChannels = 4;
+constexpr uint32_t kPacketsPerChannel = 25;
+
+// Number of channels that have their own encoding buffer. Channel IDs that
+// differ by less than PW_RPC_CHANNEL_ENCODING_BUFFERS map to different
+// buffers.
+constexpr size_t kParallelChannels = std::max<size_t>(
+    1, std::min<size_t>(PW_RPC_CHANNEL_ENCODING_BUFFERS, kChannels));
+
+// Time that the simulated transport takes to send each packet.
+constexpr auto kSendTime = 1ms;
+
+// Tracks how many outputs are sending packets at the same time.
+struct SendStats {
+  std::atomic<int> sending = 0;
+  std::atomic<int> max_sending = 0;
+};
+
+// Simulates a slow transport. Checks that each channel's stream packets are
+// sent in order. While held, Send() waits until the output is released.
+class SlowOutput : public ChannelOutput {
+ public:
+  SlowOutput(SendStats& stats) : ChannelOutput("SlowOutput"), stats_(stats) {}
+
+  Status Send(span<const std::byte> buffer) override {
+    const int sending = stats_.sending.fetch_add(1) + 1;
+    int max_sending = stats_.max_sending.load();
+    while (sending > max_sending &&
+           !stats_.max_sending.compare_exchange_weak(max_sending, sending)) {
+    }
+
+    Result<Packet> packet = Packet::FromBuffer(buffer);
+    if (packet.ok() && packet->type() == PacketType::SERVER_STREAM &&
+        packet->payload().size() == sizeof(uint32_t)) {
+      uint32_t sequence = 0;
+      std::memcpy(&sequence, packet->payload().data(), sizeof(sequence));
+      if (sequence != stream_packets_) {
+        out_of_order_ = true;
+      }
+      stream_packets_ += 1;
+    } else if (packet.ok() && packet->type() == PacketType::RESPONSE) {
+      response_packets_ += 1;
+    }
+
+    if (held_.load()) {
+      waiting_ = true;
+      while (held_.load()) {
+        this_thread::sleep_for(kSendTime);
+      }
+    }
+    this_thread::sleep_for(kSendTime);
+
+    stats_.sending.fetch_sub(1);
+    return send_status_;
+  }
+
+  void Hold() { held_ = true; }
+
+  // Releases the output. Held sends return send_status.
+  void Release(Status send_status = OkStatus()) {
+    send_status_ = send_status;
+    held_ = false;
+  }
+
+  // Waits until a send is held. Returns false if none is within a second.
+  bool WaitUntilSendIsHeld() const {
+    const SystemClock::time_point deadline = SystemClock::now() + 1s;
+    while (!waiting_.load()) {
+      if (SystemClock::now() > deadline) {
+        return false;
+      }
+      this_thread::sleep_for(kSendTime);
+    }
+    return true;
+  }
+
+  uint32_t stream_packets() const { return stream_packets_; }
+  uint32_t response_packets() const { return response_packets_; }
+  bool out_of_order() const { return out_of_order_; }
+
+ private:
+  SendStats& stats_;
+  uint32_t stream_packets_ = 0;
+  uint32_t response_packets_ = 0;
+  bool out_of_order_ = false;
+  std::atomic<bool> held_ = false;
+  std::atomic<bool> waiting_ = false;
+  Status send_status_;
+};
+
+class ParallelSendTest : public ::testing::Test {
+ protected:
+  ParallelSendTest()
+      : outputs_{SlowOutput(stats_),
+                 SlowOutput(stats_),
+                 SlowOutput(stats_),
+                 SlowOutput(stats_)},
+        channels_{Channel::Create<1>(&outputs_[0]),
+                  Channel::Create<2>(&outputs_[1]),
+                  Channel::Create<3>(&outputs_[2]),
+                  Channel::Create<4>(&outputs_[3])},
+        server_(channels_) {
+    server_.RegisterService(service_);
+  }
+
+  // Writes kPacketsPerChannel stream packets on each of the first
+  // channel_count channels, each from its own thread. Returns the elapsed
+  // time.
+  SystemClock::duration WriteFromThreads(size_t channel_count) {
+    std::array<Thread, kChannels> threads;
+
+    next_channel_ = 0;
+
+    const SystemClock::time_point start = SystemClock::now();
+    for (size_t i = 0; i < channel_count; ++i) {
+      threads[i] = Thread(thread::stl::Options(), [this] { WriteOnChannel(); });
+    }
+    for (size_t i = 0; i < channel_count; ++i) {
+      threads[i].join();
+    }
+    return SystemClock::now() - start;
+  }
+
+  // Opens a call on the next unused channel and writes to it.
+  void WriteOnChannel() {
+    RawServerReaderWriter call =
+        OpenCall(channels_[next_channel_.fetch_add(1)]);
+
+    for (uint32_t sequence = 0; sequence < kPacketsPerChannel; ++sequence) {
+      EXPECT_EQ(OkStatus(), call.Write(as_bytes(span(&sequence, 1))));
+    }
+  }
+
+  RawServerReaderWriter OpenCall(const Channel& channel) {
+    return RawServerReaderWriter::Open<
+        pw_rpc::raw::Benchmark::BidirectionalEcho>(
+        server_, channel.id(), service_);
+  }
+
+  std::atomic<size_t> next_channel_ = 0;
+  SendStats stats_;
+  std::array<SlowOutput, kChannels> outputs_;
+  std::array<Channel, kChannels> channels_;
+  Server server_;
+  BenchmarkService service_;
+};
+
+TEST_F(ParallelSendTest, AllPacketsAreSentInOrder) {
+  WriteFromThreads(kChannels);
+
+  for (const SlowOutput& output : outputs_) {
+    EXPECT_EQ(output.stream_packets(), kPacketsPerChannel);
+    EXPECT_FALSE(output.out_of_order());
+  }
+}
+
+TEST_F(ParallelSendTest, ConcurrentFinishSendsOneResponse) {
+  struct {
+    RawServerReaderWriter call;
+    std::atomic<int> finished = 0;
+  } state;
+  state.call =
+      RawServerReaderWriter::Open<pw_rpc::raw::Benchmark::BidirectionalEcho>(
+          server_, channels_[0].id(), service_);
+
+  std::array<Thread, kChannels> threads;
+  for (Thread& thread : threads) {
+    thread = Thread(thread::stl::Options(), [&state] {
+      if (state.call.Finish().ok()) {
+        state.finished.fetch_add(1);
+      }
+    });
+  }
+  for (Thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(state.finished.load(), 1);
+  EXPECT_EQ(outputs_[0].response_packets(), 1u);
+  EXPECT_FALSE(state.call.active());
+}
+
+TEST_F(ParallelSendTest, WaitingOnChannelDoesNotHoldUpOtherChannels) {
+  // Two writes wait on the first channel while the second channel is written
+  // to. Each of them needs its own buffer.
+  if constexpr (PW_RPC_CHANNEL_ENCODING_BUFFERS < 3) {
+    GTEST_SKIP();
+  }
+
+  struct {
+    RawServerReaderWriter held_call;
+    RawServerReaderWriter other_call;
+    std::atomic<bool> other_call_done = false;
+  } state;
+  state.held_call = OpenCall(channels_[0]);
+  state.other_call = OpenCall(channels_[1]);
+
+  // Empty packets are not checked for order.
+  outputs_[0].Hold();
+  std::array<Thread, 2> held_threads;
+  for (Thread& thread : held_threads) {
+    thread = Thread(thread::stl::Options(), [&state] {
+      EXPECT_EQ(OkStatus(), state.held_call.Write(ConstByteSpan()));
+    });
+  }
+  ASSERT_TRUE(outputs_[0].WaitUntilSendIsHeld());
+  this_thread::sleep_for(10ms);  // Let the other write start waiting.
+
+  Thread other_thread(thread::stl::Options(), [&state] {
+    for (uint32_t sequence = 0; sequence < kPacketsPerChannel; ++sequence) {
+      EXPECT_EQ(OkStatus(),
+                state.other_call.Write(as_bytes(span(&sequence, 1))));
+    }
+    state.other_call_done = true;
+  });
+
+  const SystemClock::time_point deadline = SystemClock::now() + 1s;
+  while (!state.other_call_done.load() && SystemClock::now() < deadline) {
+    this_thread::sleep_for(kSendTime);
+  }
+  const bool other_call_done = state.other_call_done.load();
+
+  outputs_[0].Release();
+  for (Thread& thread : held_threads) {
+    thread.join();
+  }
+  other_thread.join();
+
+  EXPECT_TRUE(other_call_done);
+  EXPECT_EQ(outputs_[1].stream_packets(), kPacketsPerChannel);
+  EXPECT_FALSE(outputs_[1].out_of_order());
+}
+
+TEST_F(ParallelSendTest, TryFinishRejectsPacketsUntilSent) {
+  // With the global encoding buffer, the RPC lock is held during the send.
+  if constexpr (PW_RPC_CHANNEL_ENCODING_BUFFERS == 0) {
+    GTEST_SKIP();
+  }
+
+  struct {
+    RawServerReaderWriter call;
+    std::atomic<int> received = 0;
+    Status try_finish_status;
+  } state;
+  state.call = OpenCall(channels_[0]);
+  state.call.set_on_next([&state](ConstByteSpan) { state.received += 1; });
+
+  outputs_[0].Hold();
+  Thread thread(thread::stl::Options(), [&state] {
+    state.try_finish_status = state.call.TryFinish();
+  });
+  ASSERT_TRUE(outputs_[0].WaitUntilSendIsHeld());
+
+  // The call is still open, but does not send or receive packets.
+  EXPECT_TRUE(state.call.active());
+  EXPECT_EQ(Status::FailedPrecondition(), state.call.Write(ConstByteSpan()));
+  EXPECT_EQ(Status::FailedPrecondition(), state.call.Finish());
+
+  using BidirectionalEcho =
+      internal::MethodInfo<pw_rpc::raw::Benchmark::BidirectionalEcho>;
+  std::array<std::byte, 32> buffer;
+  const Result<ConstByteSpan> packet =
+      Packet(PacketType::CLIENT_STREAM,
+             channels_[0].id(),
+             BidirectionalEcho::kServiceId,
+             BidirectionalEcho::kMethodId,
+             internal::kOpenCallId,
+             {})
+          .Encode(buffer);
+  ASSERT_EQ(OkStatus(), packet.status());
+  EXPECT_EQ(OkStatus(), server_.ProcessPacket(*packet));
+  EXPECT_EQ(state.received.load(), 0);
+
+  // The final packet could not be sent, so the call is still open.
+  outputs_[0].Release(Status::Unavailable());
+  thread.join();
+  EXPECT_EQ(Status::Unknown(), state.try_finish_status);
+  EXPECT_TRUE(state.call.active());
+
+  EXPECT_EQ(OkStatus(), server_.ProcessPacket(*packet));
+  EXPECT_EQ(state.received.load(), 1);
+
+  outputs_[0].Release();
+  EXPECT_EQ(OkStatus(), state.call.TryFinish());
+  EXPECT_FALSE(state.call.active());
+  EXPECT_EQ(outputs_[0].response_packets(), 2u);
+}
+
+TEST_F(ParallelSendTest, ThroughputScalesWithChannels) {
+  const SystemClock::duration one_channel = WriteFromThreads(1);
+  const SystemClock::duration parallel = WriteFromThreads(kParallelChannels);
+
+  const auto packets_per_second = [](size_t channels,
+                                     SystemClock::duration elapsed) {
+    return static_cast<unsigned>(
+        channels * kPacketsPerChannel * 1000 /
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+  };
+  PW_LOG_INFO("1 channel: %u packets/s, %u channels: %u packets/s",
+              packets_per_second(1, one_channel),
+              static_cast<unsigned>(kParallelChannels),
+              packets_per_second(kParallelChannels, parallel));
+
+  if constexpr (kParallelChannels == 1) {
+    // Every packet is encoded in the same buffer, so packets are sent one at a
+    // time.
+    EXPECT_EQ(stats_.max_sending.load(), 1);
+  } else {
+    EXPECT_GT(stats_.max_sending.load(), 1);
+    EXPECT_LE(stats_.max_sending.load(),
+              static_cast<int>(kParallelChannels));
+
+    // Writing on channels with separate buffers should take well under
+    // kParallelChannels times as long as writing on one channel.
+    EXPECT_LT(parallel, one_channel * (kParallelChannels + 1) / 2);
+  }
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -26,6 +26,10 @@ class BenchmarkService
  public:
   static void UnaryEcho(ConstByteSpan request, RawUnaryResponder& responder);
 
+  static void ServerStreamEcho(ConstByteSpan request, RawServerWriter& writer);
+
+  void ClientStreamEcho(RawServerReader& reader);
+
   void BidirectionalEcho(RawServerReaderWriter& reader_writer);
 
  private:
@@ -33,6 +37,7 @@ class BenchmarkService
   ReaderWriterId AllocateReaderWriterId();
 
   ReaderWriterId next_reader_writer_id_ = 0;
+  std::unordered_map<ReaderWriterId, RawServerReader> readers_;
   std::unordered_map<ReaderWriterId, RawServerReaderWriter> reader_writers_;
 };
 
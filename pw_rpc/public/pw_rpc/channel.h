@@ -19,12 +19,19 @@
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
+#include "pw_function/function.h"
 #include "pw_result/result.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 
+namespace pw::multibuf {
+
+class MultiBuf;  // Forward declaration for ChannelOutput::SendMultiBuf
+
+}  // namespace pw::multibuf
+
 namespace pw::rpc {
 namespace internal {
 namespace test {
@@ -126,7 +133,9 @@ class ChannelOutput {
   //
   // The RPC system’s internal lock is held while this function is called. Avoid
   // long-running operations, since these will delay any other users of the RPC
-  // system.
+  // system. If PW_RPC_CHANNEL_ENCODING_BUFFERS is enabled, packets sent by
+  // calls are sent without the RPC lock, so outputs that are shared by
+  // multiple channels must be thread safe.
   //
   // !!! DANGER !!!
   //
@@ -142,6 +151,25 @@ class ChannelOutput {
   virtual Status Send(span<const std::byte> buffer)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
 
+  // Sends an encoded RPC packet that is stored in a MultiBuf. This is used by
+  // pw::rpc::WriteMultiBuf (pw_rpc/multibuf.h), which prepends the packet
+  // header to the payload's chunks instead of copying the payload into
+  // pw_rpc's encoding buffer. The same restrictions apply as for Send().
+  //
+  // Outputs that support MultiBufs should take ownership of the packet and
+  // return the same status as Send() would. The default implementation returns
+  // UNIMPLEMENTED, in which case pw_rpc copies the packet into an encoding
+  // buffer and calls Send() instead.
+  //
+  // Although the packet is passed as an rvalue reference, pw_rpc still uses it
+  // after an UNIMPLEMENTED return. Overrides that return UNIMPLEMENTED MUST NOT
+  // move from or modify the packet. Any other status means that the output
+  // took the packet, even if it failed to send it.
+  virtual Status SendMultiBuf([[maybe_unused]] multibuf::MultiBuf&& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    return Status::Unimplemented();
+  }
+
  private:
   const char* name_;
 };
@@ -213,6 +241,31 @@ class ChannelBase {
   // indicates that the Channel is permanently closed.
   Status Send(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+  // Like Send(), but encodes the packet into a free channel encoding buffer
+  // and releases the RPC lock while the ChannelOutput sends it. If another
+  // packet is being sent on the channel, this waits for it without the RPC
+  // lock. The RPC lock is held again when this returns, but the channel may
+  // have been closed.
+  Status SendOutsideRpcLock(const Packet& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
+  // Encodes the packet's header for a payload of payload_size bytes, which is
+  // stored elsewhere, and passes the header and the ChannelOutput to `send`.
+  // `send` must transmit the header immediately followed by the payload. Its
+  // status is handled the same as the ChannelOutput's status in Send().
+  //
+  // If PW_RPC_CHANNEL_ENCODING_BUFFERS is enabled, `send` runs without the RPC
+  // lock, as in SendOutsideRpcLock(), and is passed a free channel encoding
+  // buffer that it may copy the packet into. Otherwise, the RPC lock is held,
+  // the buffer is empty, and `send` may use the global encoding buffer.
+  Status SendWithHeader(
+      const Packet& packet,
+      size_t payload_size,
+      const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   constexpr void Close() {
     PW_ASSERT(id_ != kUnassignedChannelId);
     id_ = kUnassignedChannelId;
@@ -224,6 +277,8 @@ class ChannelBase {
       : id_(id), output_(output) {}
 
  private:
+  static Status HandleSendStatus(uint32_t channel_id, Status sent);
+
   uint32_t id_;
   ChannelOutput* output_;
 };
@@ -272,6 +327,7 @@ class Channel : public internal::ChannelBase {
   // Hide internal-only methods defined in the internal::ChannelBase.
   using internal::ChannelBase::Close;
   using internal::ChannelBase::Send;
+  using internal::ChannelBase::SendWithHeader;
 };
 
 }  // namespace pw::rpc
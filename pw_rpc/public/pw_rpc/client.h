@@ -20,6 +20,7 @@
 #include "pw_rpc/internal/endpoint.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::rpc {
 
@@ -47,7 +48,24 @@ class Client : public internal::Endpoint {
   Status ProcessPacket(ConstByteSpan data)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Processes a batch of RPC packets, such as every packet decoded from one
+  // read from a transport. The RPC lock is acquired once for the batch. It is
+  // only released while callbacks run. Packets are processed in order; a
+  // packet that cannot be processed does not stop the rest of the batch.
+  //
+  // Returns the number of packets that were processed. The status is OK if
+  // every packet was processed, or the error for the first packet that was not.
+  StatusWithSize ProcessPackets(span<const ConstByteSpan> packets)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
  private:
+  Status ProcessPacketLocked(const internal::Packet& packet)
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
+
+  // Processes one packet from a batch. Returns with rpc_lock() held.
+  Status ProcessBatchedPacket(const internal::Packet& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   // Remove these internal::Endpoint functions from the public interface.
   using Endpoint::active_call_count;
   using Endpoint::ClaimLocked;
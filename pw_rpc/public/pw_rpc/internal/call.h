@@ -88,6 +88,9 @@ class CallProperties {
   uint8_t bits_;
 };
 
+template <size_t>
+class CallIndex;
+
 // Unrequested RPCs always use this call ID. When a subsequent request
 // or response is sent with a matching channel + service + method,
 // it will match a calls with this ID if one exists.
@@ -296,12 +299,30 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
   Status WriteCallbackLocked(const Function<StatusWithSize(ByteSpan)>& callback)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Sends a stream packet with a payload of payload_size bytes that is stored
+  // outside of the encoding buffer. `send` is invoked with the encoded packet
+  // header and the channel's output, and must send the header immediately
+  // followed by the payload. See ChannelBase::SendWithHeader.
+  Status WriteWithHeader(
+      size_t payload_size,
+      const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send)
+      PW_LOCKS_EXCLUDED(rpc_lock()) {
+    RpcLockGuard lock;
+    return WriteWithHeaderLocked(payload_size, send);
+  }
+
+  Status WriteWithHeaderLocked(
+      size_t payload_size,
+      const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Sends the initial request for a client call. If the request fails, the call
   // is closed.
   void SendInitialClientRequest(ConstByteSpan payload)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    // Sending may release the RPC lock, during which the call may be closed.
     if (const Status status = SendPacket(pwpb::PacketType::REQUEST, payload);
-        !status.ok()) {
+        !status.ok() && active_locked()) {
       CloseAndMarkForCleanup(status);
     }
   }
@@ -314,6 +335,13 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
   // Precondition: rpc_lock() must be held.
   void HandlePayload(ConstByteSpan payload) PW_UNLOCK_FUNCTION(rpc_lock());
 
+  // Like HandlePayload, but returns with rpc_lock() held. The lock is only
+  // released while the on_next_ callback runs. Calls that the callback closes
+  // are left for the endpoint to clean up. Returns false if the payload was
+  // dropped without invoking a callback.
+  bool InvokeOnNext(ConstByteSpan payload)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Handles an error condition for the call. This closes the call and calls the
   // on_error callback, if set.
   void HandleError(Status status) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -352,6 +380,14 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
     return (state_ & kClientRequestedCompletion) != 0;
   }
 
+  // Returns true while the call's final packet is being sent by
+  // TryCloseAndSendFinalPacketLocked() without the RPC lock. The call stays
+  // registered, but no other packets are sent or handled for it until the
+  // result is known.
+  bool finishing() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return (state_ & kFinishing) != 0;
+  }
+
   // Closes a call without doing anything else. Called from the Endpoint
   // destructor.
   void CloseFromDeletedEndpoint() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
@@ -545,10 +581,14 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
  private:
   friend class rpc::Writer;
 
+  template <size_t>
+  friend class CallIndex;
+
   enum State : uint8_t {
     kActive = 0b001,
     kClientRequestedCompletion = 0b010,
     kHasBeenDestroyed = 0b100,
+    kFinishing = 0b1000,
   };
 
   // Common constructor for server & client calls.
@@ -598,6 +638,13 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
                     Status status = OkStatus())
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Sends a packet on the channel. If PW_RPC_CHANNEL_ENCODING_BUFFERS is
+  // enabled, the RPC lock is released while the packet is sent, so the call
+  // may be closed or changed by other threads before this returns.
+  Status SendOnChannel(ChannelBase& channel, const Packet& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Closes the call, then sends its final packet.
   Status CloseAndSendFinalPacketLocked(pwpb::PacketType type,
                                        ConstByteSpan response,
                                        Status status)
@@ -621,6 +668,11 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
   uint32_t service_id_ PW_GUARDED_BY(rpc_lock());
   uint32_t method_id_ PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  // Next call in the same bucket of the endpoint's CallIndex.
+  Call* next_indexed_ PW_GUARDED_BY(rpc_lock()) = nullptr;
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+
   // State of call and client stream.
   //
   //   bit 0: call is active
@@ -665,4 +717,11 @@ inline Status Writer::Write(
   return static_cast<internal::Call*>(this)->Write(callback);
 }
 
+inline Status Writer::WriteWithHeader(
+    size_t payload_size,
+    const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send) {
+  return static_cast<internal::Call*>(this)->WriteWithHeader(payload_size,
+                                                             send);
+}
+
 }  // namespace pw::rpc
@@ -0,0 +1,149 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_preprocessor/compiler.h"
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/lock.h"
+
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+
+namespace pw::rpc::internal {
+
+// Intrusive hash table of the active calls in an Endpoint, keyed on channel,
+// service, method, and call ID. Calls are chained through their
+// Call::next_indexed_ pointers, so the index needs no storage beyond its
+// buckets.
+//
+// The Endpoint keeps the index in sync with its calls list. A call's key must
+// not change while it is in the index, so calls are removed before they are
+// closed or their IDs are updated.
+//
+// Calls that were opened without a request (kOpenCallId) match packets with
+// any call ID, and packets with an open call ID match any call ID. These
+// lookups cannot be answered with a hash, so open calls are counted but not
+// indexed, and the Endpoint falls back to searching its calls list whenever
+// CanFind() returns false.
+template <size_t kBuckets>
+class CallIndex {
+ public:
+  static_assert(kBuckets > 0u && (kBuckets & (kBuckets - 1)) == 0u,
+                "The call index bucket count must be a power of two");
+
+  constexpr CallIndex() = default;
+
+  CallIndex(const CallIndex&) = delete;
+  CallIndex& operator=(const CallIndex&) = delete;
+
+  // Returns whether Find() gives a definitive answer for this call ID.
+  bool CanFind(uint32_t call_id) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return open_calls_ == 0u && !IsOpenCallId(call_id);
+  }
+
+  // Adds an active call to the index.
+  void Add(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (IsOpenCallId(call.id())) {
+      open_calls_ += 1;
+      return;
+    }
+    Call*& head = Bucket(call.channel_id_locked(),
+                         call.service_id(),
+                         call.method_id(),
+                         call.id());
+    call.next_indexed_ = head;
+    head = &call;
+  }
+
+  // Removes a call from the index. The call's key must be the same as when it
+  // was added.
+  void Remove(const Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (IsOpenCallId(call.id())) {
+      open_calls_ -= 1;
+      return;
+    }
+    Call** link = &Bucket(call.channel_id_locked(),
+                          call.service_id(),
+                          call.method_id(),
+                          call.id());
+    while (*link != nullptr) {
+      if (*link == &call) {
+        *link = call.next_indexed_;
+        return;
+      }
+      link = &(*link)->next_indexed_;
+    }
+  }
+
+  // Finds the call with exactly these IDs. Returns nullptr if there is none.
+  // Only valid if CanFind(call_id) is true.
+  Call* Find(uint32_t channel_id,
+             uint32_t service_id,
+             uint32_t method_id,
+             uint32_t call_id) const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    Call* call = buckets_[Slot(channel_id, service_id, method_id, call_id)];
+    while (call != nullptr) {
+      if (call->id() == call_id && call->method_id() == method_id &&
+          call->service_id() == service_id &&
+          call->channel_id_locked() == channel_id) {
+        return call;
+      }
+      call = call->next_indexed_;
+    }
+    return nullptr;
+  }
+
+  // Empties the index without updating the calls.
+  void Clear() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    buckets_.fill(nullptr);
+    open_calls_ = 0;
+  }
+
+ private:
+  static constexpr bool IsOpenCallId(uint32_t call_id) {
+    return call_id == kOpenCallId || call_id == kLegacyOpenCallId;
+  }
+
+  // Service and method IDs are hashes; call IDs are sequential, so they
+  // vary the low bits for calls to the same RPC.
+  static constexpr size_t Slot(uint32_t channel_id,
+                               uint32_t service_id,
+                               uint32_t method_id,
+                               uint32_t call_id)
+      PW_NO_SANITIZE("unsigned-integer-overflow") {
+    constexpr uint32_t kMultiplier = 65599;
+    const uint32_t hash =
+        (service_id ^ method_id ^ channel_id) * kMultiplier + call_id;
+    return static_cast<size_t>(hash) & (kBuckets - 1);
+  }
+
+  Call*& Bucket(uint32_t channel_id,
+                uint32_t service_id,
+                uint32_t method_id,
+                uint32_t call_id) {
+    return buckets_[Slot(channel_id, service_id, method_id, call_id)];
+  }
+
+  std::array<Call*, kBuckets> buckets_{};
+  size_t open_calls_ = 0;
+};
+
+}  // namespace pw::rpc::internal
+
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
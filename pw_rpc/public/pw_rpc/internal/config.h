@@ -240,6 +240,58 @@ static_assert(
 #define PW_RPC_ENCODING_BUFFER_SIZE_BYTES 512
 #endif  // PW_RPC_ENCODING_BUFFER_SIZE_BYTES
 
+/// Number of packet encoding buffers shared by channels. If nonzero, packets
+/// sent by RPC calls are encoded into a free buffer instead of the global
+/// encoding buffer, and the global RPC lock is released while the
+/// `ChannelOutput` sends the packet. Channels whose IDs differ modulo
+/// `PW_RPC_CHANNEL_ENCODING_BUFFERS` send in parallel. Packets on channels
+/// with the same ID modulo `PW_RPC_CHANNEL_ENCODING_BUFFERS` are still sent
+/// one at a time, in order, but a thread waiting to send one does not hold the
+/// RPC lock, so it does not hold up other channels. Up to
+/// `PW_RPC_CHANNEL_ENCODING_BUFFERS` packets can be sent or waiting to be
+/// sent at once; more wait for a buffer while holding the RPC lock.
+///
+/// Each buffer is @c_macro{PW_RPC_ENCODING_BUFFER_SIZE_BYTES} bytes. Since
+/// `ChannelOutput::Send` may run concurrently for different channels, an
+/// output that is shared by multiple channels must be thread safe.
+///
+/// This is disabled (0) by default.
+#ifndef PW_RPC_CHANNEL_ENCODING_BUFFERS
+#define PW_RPC_CHANNEL_ENCODING_BUFFERS 0
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS
+
+/// Number of slots in the method dispatch index kept by each
+/// @cpp_class{pw::rpc::Server}. If nonzero, the server maintains an
+/// open-addressed hash table of its registered services' methods, which is
+/// rebuilt when services are registered or unregistered. Incoming packets are
+/// then dispatched with a hash lookup rather than a linear search of every
+/// service and method.
+///
+/// The index holds up to 3/4 of this many methods; methods that do not fit are
+/// found by searching the services list, as when the index is disabled. Each
+/// slot stores two pointers. Must be 0 or a power of two.
+///
+/// This is disabled (0) by default.
+#ifndef PW_RPC_METHOD_INDEX_SIZE
+#define PW_RPC_METHOD_INDEX_SIZE 0
+#endif  // PW_RPC_METHOD_INDEX_SIZE
+
+/// Number of buckets in the hash index of active calls kept by each pw_rpc
+/// endpoint (server or client). If nonzero, incoming packets are matched to
+/// their calls with a hash lookup on channel, service, method, and call ID
+/// instead of a search of every active call. This benefits endpoints with
+/// many concurrent streaming calls.
+///
+/// Each endpoint stores one pointer per bucket, and each call object grows by
+/// one pointer. Calls opened without a request (e.g. with
+/// `Server::OpenCall`) cannot be hashed; while any are active, lookups fall
+/// back to searching the calls list. Must be 0 or a power of two.
+///
+/// This is disabled (0) by default.
+#ifndef PW_RPC_CALL_INDEX_BUCKETS
+#define PW_RPC_CALL_INDEX_BUCKETS 0
+#endif  // PW_RPC_CALL_INDEX_BUCKETS
+
 /// The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_RPC_CONFIG_LOG_LEVEL
 #define PW_RPC_CONFIG_LOG_LEVEL PW_LOG_LEVEL_INFO
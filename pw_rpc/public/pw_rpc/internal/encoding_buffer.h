@@ -118,6 +118,46 @@ using EncodingBuffer = StaticEncodingBuffer;
 // allocation is enabled or not.
 inline EncodingBuffer encoding_buffer PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
+// An encoding buffer, and the lock that orders packets sent on the channels
+// whose IDs map to it. Packets sent outside the RPC lock may be encoded into
+// any free buffer. Both locks are acquired while the RPC lock is held, or
+// after releasing it, and are released before the RPC lock is reacquired.
+class ChannelEncodingBuffer {
+ public:
+  // Held while a packet is encoded into the buffer and sent from it.
+  RpcLock& lock() PW_LOCK_RETURNED(lock_) { return lock_; }
+
+  // Held while a packet is sent on a channel whose ID maps to this buffer, so
+  // that those packets are sent one at a time, in order.
+  RpcLock& send_lock() PW_LOCK_RETURNED(send_lock_) { return send_lock_; }
+
+  ByteSpan buffer() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_) { return buffer_; }
+
+ private:
+  RpcLock lock_;
+  RpcLock send_lock_;
+  std::array<std::byte, cfg::kEncodingBufferSizeBytes> buffer_
+      PW_GUARDED_BY(lock_) = {};
+};
+
+// Returns all of the channel encoding buffers.
+inline span<ChannelEncodingBuffer> ChannelEncodingBuffers() {
+  static NoDestructor<
+      std::array<ChannelEncodingBuffer, PW_RPC_CHANNEL_ENCODING_BUFFERS>>
+      buffers;
+  return *buffers;
+}
+
+// Returns the encoding buffer that the specified channel's ID maps to.
+inline ChannelEncodingBuffer& ChannelEncodingBufferFor(uint32_t channel_id) {
+  return ChannelEncodingBuffers()[channel_id %
+                                  PW_RPC_CHANNEL_ENCODING_BUFFERS];
+}
+
+#endif  // PW_RPC_CHANNEL_ENCODING_BUFFERS > 0
+
 // Successful calls to EncodeToPayloadBuffer MUST send the returned buffer,
 // without releasing the RPC lock.
 template <typename Proto, typename Encoder>
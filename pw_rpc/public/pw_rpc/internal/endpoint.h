@@ -20,6 +20,7 @@
 #include "pw_result/result.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/call_index.h"
 #include "pw_rpc/internal/channel_list.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
@@ -119,26 +120,34 @@ class Endpoint {
   _PW_RPC_CONSTEXPR Endpoint(span<Channel> channels) : channels_(channels) {}
 
   // Parses an RPC packet and sets ongoing_call to the matching call, if any.
-  // Returns the parsed packet or an error.
-  Result<Packet> ProcessPacket(span<const std::byte> data,
-                               Packet::Destination destination)
-      PW_LOCKS_EXCLUDED(rpc_lock());
+  // Returns the parsed packet or an error. Does not access the endpoint, so
+  // it may be called with or without rpc_lock() held.
+  static Result<Packet> ProcessPacket(span<const std::byte> data,
+                                      Packet::Destination destination);
+
+  // Cleans up any calls that are awaiting cleanup, then reacquires rpc_lock().
+  // Used when processing a batch of packets under one lock acquisition.
+  void CleanUpCallsAndRelock() PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if (!to_cleanup_.empty()) {
+      CleanUpCalls();
+      rpc_lock().lock();
+    }
+  }
 
   // Finds a call object for an ongoing call associated with this packet, if
-  // any. The iterator will be calls_end() if no match was found.
-  IntrusiveList<Call>::iterator FindCall(const Packet& packet)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return std::get<1>(FindIteratorsForCall(packet.channel_id(),
-                                            packet.service_id(),
-                                            packet.method_id(),
-                                            packet.call_id()));
+  // any. Returns nullptr if no match was found.
+  Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return FindCall(packet.channel_id(),
+                    packet.service_id(),
+                    packet.method_id(),
+                    packet.call_id());
   }
 
-  // Used to check if a call iterator is valid or not.
-  IntrusiveList<Call>::const_iterator calls_end() const
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return calls_.end();
-  }
+  // Finds the call that matches these IDs, using the call index if enabled.
+  Call* FindCall(uint32_t channel_id,
+                 uint32_t service_id,
+                 uint32_t method_id,
+                 uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   // Aborts calls associated with a particular service. Calls to
   // AbortCallsForService() must be followed by a call to CleanUpCalls().
@@ -153,8 +162,9 @@ class Endpoint {
   // This method is protected so it can be exposed in tests.
   void CloseCallAndMarkForCleanup(Call& call, Status error)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    call.CloseAndMarkForCleanupFromEndpoint(error);
+    RemoveFromCallIndex(call);
     calls_.remove(call);
+    call.CloseAndMarkForCleanupFromEndpoint(error);
     to_cleanup_.push_front(call);
   }
 
@@ -165,8 +175,9 @@ class Endpoint {
       IntrusiveList<Call>::iterator call_iterator,
       Status error) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     Call& call = *call_iterator;
-    call.CloseAndMarkForCleanupFromEndpoint(error);
+    RemoveFromCallIndex(call);
     auto next = calls_.erase_after(before_call);
+    call.CloseAndMarkForCleanupFromEndpoint(error);
     to_cleanup_.push_front(call);
     return next;
   }
@@ -207,6 +218,7 @@ class Endpoint {
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     calls_.push_front(call);
+    AddToCallIndex(call);
   }
 
   void CleanUpCall(Call& call) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -218,10 +230,27 @@ class Endpoint {
   // Removes the provided call from the call registry.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    RemoveFromCallIndex(call);
     bool closed_call_was_in_list = calls_.remove(call);
     PW_DASSERT(closed_call_was_in_list);
   }
 
+  // Keep the call index, if enabled, in sync with calls_. Calls must be removed
+  // from the index before their IDs or channel change.
+  void AddToCallIndex([[maybe_unused]] Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+    call_index_.Add(call);
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+  }
+
+  void RemoveFromCallIndex([[maybe_unused]] const Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+    call_index_.Remove(call);
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+  }
+
   std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
   FindIteratorsForCall(uint32_t channel_id,
                        uint32_t service_id,
@@ -255,6 +284,11 @@ class Endpoint {
   // this list when they start and removed from it when they finish.
   IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
 
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  // Hash index over calls_ for resolving incoming packets to calls.
+  CallIndex<PW_RPC_CALL_INDEX_BUCKETS> call_index_ PW_GUARDED_BY(rpc_lock());
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+
   // List of all inactive calls that need to have their on_error callbacks
   // called. Calling on_error requires releasing the RPC lock, so calls are
   // added to this list in situations where releasing the mutex could be
@@ -34,6 +34,9 @@ using RpcLock = sync::Mutex;
 class PW_LOCKABLE("pw::rpc::internal::RpcLock") RpcLock {
  public:
   constexpr void lock() PW_EXCLUSIVE_LOCK_FUNCTION() {}
+  [[nodiscard]] constexpr bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    return true;
+  }
   constexpr void unlock() PW_UNLOCK_FUNCTION() {}
 };
 
@@ -0,0 +1,127 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include "pw_containers/intrusive_list.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_rpc/internal/method.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc/service_id.h"
+
+namespace pw::rpc::internal {
+
+// Open-addressed hash table that maps (service ID, method ID) pairs to the
+// registered Service and Method objects. The server rebuilds the index whenever
+// its set of registered services changes, so lookups in the packet path cost a
+// hash and a short probe instead of a walk over every service and method.
+//
+// The index is a cache: if it has no entry for a service and method, the caller
+// must fall back to searching the services list. This keeps unknown-RPC and
+// overflow behavior identical to the unindexed lookup. The index only fills up
+// to 3/4 of its capacity so that probe sequences stay short; methods beyond
+// that are found with the fallback search.
+template <size_t kCapacity>
+class MethodIndex {
+ public:
+  static_assert(kCapacity > 0u && (kCapacity & (kCapacity - 1)) == 0u,
+                "The method index capacity must be a power of two");
+
+  constexpr MethodIndex() = default;
+
+  MethodIndex(const MethodIndex&) = delete;
+  MethodIndex& operator=(const MethodIndex&) = delete;
+
+  // Repopulates the index from the provided services.
+  void Rebuild(IntrusiveList<Service>& services) {
+    entries_.fill(Entry{});
+    size_ = 0;
+
+    for (Service& service : services) {
+      for (size_t i = 0; i < service.method_count_; ++i) {
+        if (size_ >= kMaxEntries) {
+          return;  // Remaining methods are found with the fallback search.
+        }
+        Insert(service, service.MethodAt(i));
+      }
+    }
+  }
+
+  // Finds the service and method for the provided IDs. Returns {} if the
+  // method is not in the index.
+  std::tuple<Service*, const Method*> Find(uint32_t service_id,
+                                           uint32_t method_id) const {
+    for (size_t i = Slot(service_id, method_id);; i = (i + 1) & kMask) {
+      const Entry& entry = entries_[i];
+      if (entry.method == nullptr) {
+        return {};
+      }
+      if (entry.method->id() == method_id &&
+          UnwrapServiceId(entry.service->service_id()) == service_id) {
+        return {entry.service, entry.method};
+      }
+    }
+  }
+
+  // Returns the number of methods in the index.
+  constexpr size_t size() const { return size_; }
+
+  static constexpr size_t max_size() { return kMaxEntries; }
+
+ private:
+  struct Entry {
+    Service* service = nullptr;
+    const Method* method = nullptr;
+  };
+
+  static constexpr size_t kMask = kCapacity - 1;
+
+  // Always leave at least one empty slot so that probing terminates.
+  static constexpr size_t kMaxEntries =
+      kCapacity * 3 / 4 == 0 ? kCapacity - 1 : kCapacity * 3 / 4;
+
+  // Method and service IDs are already hashes, so they only need to be mixed.
+  static constexpr size_t Slot(uint32_t service_id, uint32_t method_id)
+      PW_NO_SANITIZE("unsigned-integer-overflow") {
+    constexpr uint32_t kMultiplier = 65599;
+    return static_cast<size_t>(service_id ^ (method_id * kMultiplier)) & kMask;
+  }
+
+  void Insert(Service& service, const Method& method) {
+    const uint32_t service_id = UnwrapServiceId(service.service_id());
+    size_t i = Slot(service_id, method.id());
+
+    while (entries_[i].method != nullptr) {
+      // Keep the first registration of a duplicated service, which matches
+      // the order that the services list is searched.
+      if (entries_[i].method->id() == method.id() &&
+          UnwrapServiceId(entries_[i].service->service_id()) == service_id) {
+        return;
+      }
+      i = (i + 1) & kMask;
+    }
+
+    entries_[i] = Entry{&service, &method};
+    size_ += 1;
+  }
+
+  std::array<Entry, kCapacity> entries_{};
+  size_t size_ = 0;
+};
+
+}  // namespace pw::rpc::internal
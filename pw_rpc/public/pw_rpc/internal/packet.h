@@ -110,6 +110,16 @@ class Packet {
   // Encodes the packet into its wire format. Returns the encoded size.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
 
+  // Encodes every field of the packet except the payload, followed by the key
+  // and length prefix of a payload of payload_size bytes. Appending the payload
+  // to the returned header produces a complete packet, so the payload can be
+  // sent from separate storage without copying it. The packet's own payload()
+  // is ignored.
+  //
+  // The header is at most kMinEncodedSizeWithoutPayload bytes.
+  Result<ConstByteSpan> EncodeHeader(ByteSpan buffer,
+                                     size_t payload_size) const;
+
   // Determines the space required to encode the packet proto fields for a
   // response, excluding the payload. This may be used to split the buffer into
   // reserved space and available space for the payload.
@@ -148,6 +158,9 @@ class Packet {
   void DebugLog() const;
 
  private:
+  void EncodeFieldsExceptPayload(
+      pwpb::RpcPacket::MemoryEncoder& rpc_packet) const;
+
   pwpb::PacketType type_;
   uint32_t channel_id_;
   uint32_t service_id_;
@@ -0,0 +1,63 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_multibuf/multibuf.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/writer.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+/// Number of bytes to reserve in front of a MultiBuf payload so that
+/// `WriteMultiBuf` can write the RPC packet header in place. Reserve the space
+/// by allocating a larger chunk and calling `DiscardPrefix` on it.
+inline constexpr size_t kMultiBufPacketHeaderReserve =
+    internal::Packet::kMinEncodedSizeWithoutPayload;
+
+/// Sends a server or client stream packet with a payload that is stored in a
+/// `MultiBuf`, without copying the payload into pw_rpc's encoding buffer.
+///
+/// The packet header is written into the space in front of the payload's
+/// first chunk, which is then claimed with `ClaimPrefix`. The resulting packet
+/// is passed to the channel's `ChannelOutput::SendMultiBuf`.
+///
+/// The payload is copied into the encoding buffer as a fallback if the first
+/// chunk does not have `kMultiBufPacketHeaderReserve` bytes of headroom or if
+/// the `ChannelOutput` does not support `MultiBuf` packets. In that case, the
+/// packet must fit in the encoding buffer.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The packet was sent.
+///
+///    FAILED_PRECONDITION: The call is not active.
+///
+///    UNAVAILABLE: The call's channel is closed.
+///
+///    INTERNAL: The packet header could not be encoded.
+///
+///    UNKNOWN: The channel output failed to send the packet, or the packet
+///    was copied and did not fit in the encoding buffer.
+///
+/// @endrst
+Status WriteMultiBuf(Writer& writer, multibuf::MultiBuf&& payload)
+    PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+}  // namespace pw::rpc
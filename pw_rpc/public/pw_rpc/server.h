@@ -23,11 +23,13 @@
 #include "pw_rpc/internal/grpc.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/method.h"
+#include "pw_rpc/internal/method_index.h"
 #include "pw_rpc/internal/method_info.h"
 #include "pw_rpc/internal/server_call.h"
 #include "pw_rpc/service.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::rpc {
 
@@ -59,6 +61,8 @@ class Server : public internal::Endpoint {
     // Register any additional services by expanding the parameter pack. This
     // is a fold expression of the comma operator.
     (services_.push_front(services), ...);
+
+    RebuildMethodIndexLocked();
   }
 
   // Returns whether a service is registered.
@@ -83,6 +87,7 @@ class Server : public internal::Endpoint {
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::rpc_lock().lock();
     UnregisterServiceLocked(service, static_cast<Service&>(services)...);
+    RebuildMethodIndexLocked();
     CleanUpCalls();
   }
 
@@ -97,6 +102,17 @@ class Server : public internal::Endpoint {
   Status ProcessPacket(ConstByteSpan packet_data)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Processes a batch of RPC packets, such as every packet decoded from one
+  // read from a transport. The RPC lock is acquired once for the batch. It is
+  // only released while user code, such as a method handler or an on_next
+  // callback, runs. Packets are processed in order; a packet that cannot be
+  // processed does not stop the rest of the batch.
+  //
+  // Returns the number of packets that were processed. The status is OK if
+  // every packet was processed, or the error for the first packet that was not.
+  StatusWithSize ProcessPackets(span<const ConstByteSpan> packets)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
  private:
   friend class internal::Call;
   friend class ServerTestHelper;
@@ -189,13 +205,20 @@ class Server : public internal::Endpoint {
 
   void HandleCompletionRequest(const internal::Packet& packet,
                                internal::ChannelBase& channel,
-                               IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                               internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   void HandleClientStreamPacket(const internal::Packet& packet,
                                 internal::ChannelBase& channel,
-                                IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                                internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
+
+  // Returns whether a client stream packet can be passed to its call. If not,
+  // sends an error to the client.
+  bool ClientStreamPacketIsValid(const internal::Packet& packet,
+                                 internal::ChannelBase& channel,
+                                 internal::Call* call) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
 
   template <typename... OtherServices>
   void UnregisterServiceLocked(Service& service, OtherServices&... services)
@@ -207,9 +230,25 @@ class Server : public internal::Endpoint {
 
   void UnregisterServiceLocked() {}  // Base case; nothing left to do.
 
+  // Updates the method dispatch index after services_ changes. No-op if
+  // PW_RPC_METHOD_INDEX_SIZE is 0.
+  void RebuildMethodIndexLocked()
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+#if PW_RPC_METHOD_INDEX_SIZE > 0
+    method_index_.Rebuild(services_);
+#endif  // PW_RPC_METHOD_INDEX_SIZE > 0
+  }
+
   Status ProcessPacket(internal::Packet packet)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  Status ProcessPacketLocked(const internal::Packet& packet)
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
+
+  // Processes one packet from a batch. Returns with rpc_lock() held.
+  Status ProcessBatchedPacket(const internal::Packet& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   // Remove these internal::Endpoint functions from the public interface.
   using Endpoint::active_call_count;
   using Endpoint::ClaimLocked;
@@ -217,6 +256,11 @@ class Server : public internal::Endpoint {
   using Endpoint::GetInternalChannel;
 
   IntrusiveList<Service> services_ PW_GUARDED_BY(internal::rpc_lock());
+
+#if PW_RPC_METHOD_INDEX_SIZE > 0
+  internal::MethodIndex<PW_RPC_METHOD_INDEX_SIZE> method_index_
+      PW_GUARDED_BY(internal::rpc_lock());
+#endif  // PW_RPC_METHOD_INDEX_SIZE > 0
 };
 
 }  // namespace pw::rpc
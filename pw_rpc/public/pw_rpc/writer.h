@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "pw_bytes/span.h"
@@ -21,11 +22,17 @@
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 
+namespace pw::multibuf {
+class MultiBuf;
+}  // namespace pw::multibuf
+
 namespace pw::rpc {
 namespace internal {
 class Call;
 }
 
+class ChannelOutput;
+
 // The Writer class allows writing requests or responses to a streaming RPC.
 // ClientWriter, ClientReaderWriter, ServerWriter, and ServerReaderWriter
 // classes can be used as a generic Writer.
@@ -49,6 +56,14 @@ class Writer {
   // always safely downcast to Call.
   friend class internal::Call;
 
+  // Sends payloads that are not stored in a contiguous buffer.
+  friend Status WriteMultiBuf(Writer& writer, multibuf::MultiBuf&& payload);
+
+  Status WriteWithHeader(
+      size_t payload_size,
+      const Function<Status(ConstByteSpan, ByteSpan, ChannelOutput&)>& send)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
   // Writers cannot be created directly. They may only be used as a reference to
   // an existing call object.
   constexpr Writer() = default;
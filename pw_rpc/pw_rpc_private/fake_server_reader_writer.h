@@ -70,6 +70,7 @@ class FakeServerReaderWriter : private ServerCall {
 
   // Expose a few additional methods for test use.
   ServerCall& as_server_call() { return *this; }
+  using Call::as_writer;
   using Call::channel_id_locked;
   using Call::DebugLog;
   using Call::id;
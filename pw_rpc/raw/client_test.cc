@@ -181,6 +181,81 @@ TEST(Client, ProcessPacket_InvokesErrorCallback) {
   EXPECT_EQ(call.error, Status::Aborted());
 }
 
+TEST(Client, ProcessPackets_ProcessesEachPacket) {
+  RawClientTestContext context;
+  auto call = StartStreamCall<BidirectionalStreamMethod>(context);
+
+  std::byte stream[64];
+  std::byte response[64];
+  const ConstByteSpan packets[] = {
+      internal::Packet(
+          internal::pwpb::PacketType::SERVER_STREAM,
+          context.channel().id(),
+          internal::MethodInfo<BidirectionalStreamMethod>::kServiceId,
+          internal::MethodInfo<BidirectionalStreamMethod>::kMethodId,
+          call.call.id(),
+          as_bytes(span("<=>")))
+          .Encode(stream)
+          .value(),
+      ConstByteSpan(),  // Cannot be decoded.
+      internal::Packet(
+          internal::pwpb::PacketType::RESPONSE,
+          context.channel().id(),
+          internal::MethodInfo<BidirectionalStreamMethod>::kServiceId,
+          internal::MethodInfo<BidirectionalStreamMethod>::kMethodId,
+          call.call.id(),
+          {},
+          Status::NotFound())
+          .Encode(response)
+          .value(),
+  };
+
+  const StatusWithSize result = context.client().ProcessPackets(packets);
+  EXPECT_EQ(result.status(), Status::DataLoss());
+  EXPECT_EQ(result.size(), 2u);
+
+  ASSERT_NE(call.payload, nullptr);
+  EXPECT_STREQ(call.payload, "<=>");
+  EXPECT_EQ(call.completed, Status::NotFound());
+}
+
+TEST(Client, ProcessPackets_ReleasesLockForCallbacks) {
+  RawClientTestContext context;
+
+  struct {
+    CallContext<RawClientReaderWriter> call;
+    int calls = 0;
+  } state;
+  state.call = StartStreamCall<BidirectionalStreamMethod>(context);
+
+  // Writing from on_next requires the RPC lock, so this would deadlock if the
+  // lock were held across the callback.
+  state.call.call.set_on_next([&state](ConstByteSpan payload) {
+    state.calls += 1;
+    EXPECT_EQ(OkStatus(), state.call.call.Write(payload));
+  });
+
+  std::byte stream[64];
+  const ConstByteSpan packet =
+      internal::Packet(
+          internal::pwpb::PacketType::SERVER_STREAM,
+          context.channel().id(),
+          internal::MethodInfo<BidirectionalStreamMethod>::kServiceId,
+          internal::MethodInfo<BidirectionalStreamMethod>::kMethodId,
+          state.call.call.id(),
+          as_bytes(span("><")))
+          .Encode(stream)
+          .value();
+  const ConstByteSpan packets[] = {packet, packet, packet};
+
+  const size_t sent_before = context.output().total_packets();
+  const StatusWithSize result = context.client().ProcessPackets(packets);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_EQ(state.calls, 3);
+  EXPECT_EQ(context.output().total_packets(), sent_before + 3);
+}
+
 TEST(Client, ProcessPacket_SendsClientErrorOnUnregisteredServerStream) {
   RawClientTestContext context;
   context.server().SendServerStream<BidirectionalStreamMethod>({});
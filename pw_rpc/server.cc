@@ -39,9 +39,36 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
   return ProcessPacket(packet);
 }
 
+StatusWithSize Server::ProcessPackets(span<const ConstByteSpan> packets) {
+  size_t processed = 0;
+  Status status;
+
+  internal::rpc_lock().lock();
+  for (ConstByteSpan packet_data : packets) {
+    Result<Packet> packet =
+        Endpoint::ProcessPacket(packet_data, Packet::kServer);
+    Status packet_status = packet.status();
+    if (packet.ok()) {
+      packet_status = ProcessBatchedPacket(*packet);
+    }
+
+    if (packet_status.ok()) {
+      processed += 1;
+    } else {
+      status.Update(packet_status);
+    }
+  }
+  CleanUpCalls();
+
+  return StatusWithSize(status, processed);
+}
+
 Status Server::ProcessPacket(internal::Packet packet) {
   internal::rpc_lock().lock();
+  return ProcessPacketLocked(packet);
+}
 
+Status Server::ProcessPacketLocked(const internal::Packet& packet) {
   static constexpr bool kLogAllIncomingPackets = false;
   if constexpr (kLogAllIncomingPackets) {
     PW_LOG_INFO("RPC server received packet type %u for %u:%08x/%08x",
@@ -84,14 +111,14 @@ Status Server::ProcessPacket(internal::Packet packet) {
     return OkStatus();
   }
 
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   switch (packet.type()) {
     case PacketType::CLIENT_STREAM:
       HandleClientStreamPacket(packet, *channel, call);
       break;
     case PacketType::CLIENT_ERROR:
-      if (call != calls_end()) {
+      if (call != nullptr) {
         PW_LOG_DEBUG("Server call %u for %u:%08x/%08x terminated with error %s",
                      static_cast<unsigned>(packet.call_id()),
                      static_cast<unsigned>(packet.channel_id()),
@@ -119,6 +146,42 @@ Status Server::ProcessPacket(internal::Packet packet) {
   return OkStatus();  // OK since the packet was handled
 }
 
+Status Server::ProcessBatchedPacket(const internal::Packet& packet) {
+  // Client stream packets make up most large batches. They are handled here
+  // without releasing the lock, except to invoke the call's on_next callback.
+  // Other packets are processed as by ProcessPacket(), and the lock is
+  // reacquired afterwards.
+  if (packet.type() != PacketType::CLIENT_STREAM) {
+    const Status status = ProcessPacketLocked(packet);
+    internal::rpc_lock().lock();
+    return status;
+  }
+
+  internal::ChannelBase* channel = GetInternalChannel(packet.channel_id());
+  if (channel == nullptr) {
+    PW_LOG_WARN("RPC server received packet for unknown channel %u",
+                static_cast<unsigned>(packet.channel_id()));
+    return Status::Unavailable();
+  }
+
+  if (std::get<const internal::Method*>(FindMethodLocked(packet)) == nullptr) {
+    channel->Send(Packet::ServerError(packet, Status::NotFound()))
+        .IgnoreError();
+    PW_LOG_DEBUG("Received packet on channel %u for unknown RPC %08x/%08x",
+                 static_cast<unsigned>(packet.channel_id()),
+                 static_cast<unsigned>(packet.service_id()),
+                 static_cast<unsigned>(packet.method_id()));
+    return OkStatus();  // OK since the packet was handled.
+  }
+
+  internal::Call* call = FindCall(packet);
+  if (ClientStreamPacketIsValid(packet, *channel, call) &&
+      call->InvokeOnNext(packet.payload())) {
+    CleanUpCallsAndRelock();  // Decoding the payload could have failed.
+  }
+  return OkStatus();
+}
+
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     uint32_t service_id, uint32_t method_id) {
   internal::RpcLockGuard lock;
@@ -127,6 +190,13 @@ std::tuple<Service*, const internal::Method*> Server::FindMethod(
 
 std::tuple<Service*, const internal::Method*> Server::FindMethodLocked(
     uint32_t service_id, uint32_t method_id) {
+#if PW_RPC_METHOD_INDEX_SIZE > 0
+  if (auto found = method_index_.Find(service_id, method_id);
+      std::get<const internal::Method*>(found) != nullptr) {
+    return found;
+  }
+#endif  // PW_RPC_METHOD_INDEX_SIZE > 0
+
   auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
     return internal::UnwrapServiceId(s.service_id()) == service_id;
   });
@@ -141,8 +211,8 @@ std::tuple<Service*, const internal::Method*> Server::FindMethodLocked(
 void Server::HandleCompletionRequest(
     const internal::Packet& packet,
     internal::ChannelBase& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -155,6 +225,16 @@ void Server::HandleCompletionRequest(
     return;
   }
 
+  if (call->finishing()) {
+    internal::rpc_lock().unlock();
+    PW_LOG_DEBUG("Received a completion request for %u:%08x/%08x, which is "
+                 "sending its final packet",
+                 static_cast<unsigned>(packet.channel_id()),
+                 static_cast<unsigned>(packet.service_id()),
+                 static_cast<unsigned>(packet.method_id()));
+    return;
+  }
+
   if (call->client_requested_completion()) {
     internal::rpc_lock().unlock();
     PW_LOG_DEBUG("Received multiple completion requests for %u:%08x/%08x",
@@ -170,46 +250,65 @@ void Server::HandleCompletionRequest(
 void Server::HandleClientStreamPacket(
     const internal::Packet& packet,
     internal::ChannelBase& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (ClientStreamPacketIsValid(packet, channel, call)) {
+    call->HandlePayload(packet.payload());
+  } else {
+    internal::rpc_lock().unlock();
+  }
+}
+
+bool Server::ClientStreamPacketIsValid(const internal::Packet& packet,
+                                       internal::ChannelBase& channel,
+                                       internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
-    internal::rpc_lock().unlock();
     PW_LOG_DEBUG(
         "Received client stream packet for %u:%08x/%08x, which is not pending",
         static_cast<unsigned>(packet.channel_id()),
         static_cast<unsigned>(packet.service_id()),
         static_cast<unsigned>(packet.method_id()));
-    return;
+    return false;
+  }
+
+  // The call's final packet is being sent. Drop the packet without replying,
+  // since the call stays open if the final packet cannot be sent.
+  if (call->finishing()) {
+    PW_LOG_DEBUG(
+        "Received client stream packet for %u:%08x/%08x, which is sending its "
+        "final packet",
+        static_cast<unsigned>(packet.channel_id()),
+        static_cast<unsigned>(packet.service_id()),
+        static_cast<unsigned>(packet.method_id()));
+    return false;
   }
 
   if (!call->has_client_stream()) {
     channel.Send(Packet::ServerError(packet, Status::InvalidArgument()))
         .IgnoreError();  // Errors are logged in Channel::Send.
-    internal::rpc_lock().unlock();
     PW_LOG_DEBUG(
         "Received client stream packet for %u:%08x/%08x, which doesn't have a "
         "client stream",
         static_cast<unsigned>(packet.channel_id()),
         static_cast<unsigned>(packet.service_id()),
         static_cast<unsigned>(packet.method_id()));
-    return;
+    return false;
   }
 
   if (call->client_requested_completion()) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
-    internal::rpc_lock().unlock();
     PW_LOG_DEBUG(
         "Received client stream packet for %u:%08x/%08x, but its client stream "
         "is closed",
         static_cast<unsigned>(packet.channel_id()),
         static_cast<unsigned>(packet.service_id()),
         static_cast<unsigned>(packet.method_id()));
-    return;
+    return false;
   }
 
-  call->HandlePayload(packet.payload());
+  return true;
 }
 
 }  // namespace pw::rpc
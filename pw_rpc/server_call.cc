@@ -49,13 +49,13 @@ void ServerCall::HandleClientRequestedCompletion()
 }
 
 void ServerCall::MoveServerCallFrom(ServerCall& other) {
-  WaitUntilReadyForMove(*this, other);
-
-  // If this call is active, finish it first.
+  // If this call is active, finish it first. Sending the response may release
+  // the RPC lock, so do this before waiting for the other call's callbacks.
   if (active_locked()) {
     CloseAndSendResponseLocked(OkStatus()).IgnoreError();
   }
 
+  WaitUntilReadyForMove(*this, other);
   MoveFrom(other);
 
 #if PW_RPC_COMPLETION_REQUEST_CALLBACK
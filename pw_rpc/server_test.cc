@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_rpc/internal/call.h"
@@ -625,6 +626,118 @@ TEST_F(BidiMethod, ClientStream_CallsCallback) {
   EXPECT_STREQ(span_as_cstr(data), "hello");
 }
 
+TEST_F(BidiMethod, ProcessPackets_ProcessesEachPacket) {
+  int calls = 0;
+  responder_.set_on_next([&calls](ConstByteSpan) { calls += 1; });
+
+  byte buffer[64];
+  const ConstByteSpan packet = PacketForRpc(PacketType::CLIENT_STREAM);
+  std::memcpy(buffer, packet.data(), packet.size());
+  const ConstByteSpan packets[] = {span(buffer, packet.size()),
+                                   span(buffer, packet.size()),
+                                   span(buffer, packet.size())};
+
+  const StatusWithSize result = server_.ProcessPackets(packets);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(3, calls);
+  EXPECT_EQ(output_.total_packets(), 0u);
+}
+
+TEST_F(BidiMethod, ProcessPackets_ContinuesAfterFailedPackets) {
+  int calls = 0;
+  responder_.set_on_next([&calls](ConstByteSpan) { calls += 1; });
+
+  byte unknown_channel[64];
+  const ConstByteSpan unknown_channel_packet =
+      EncodePacket(PacketType::CLIENT_STREAM, 99, 42, 100);
+  std::memcpy(unknown_channel,
+              unknown_channel_packet.data(),
+              unknown_channel_packet.size());
+
+  const ConstByteSpan packets[] = {
+      span(unknown_channel, unknown_channel_packet.size()),
+      ConstByteSpan(),  // Cannot be decoded.
+      PacketForRpc(PacketType::CLIENT_STREAM),
+  };
+
+  const StatusWithSize result = server_.ProcessPackets(packets);
+  EXPECT_EQ(Status::Unavailable(), result.status());
+  EXPECT_EQ(1u, result.size());
+  EXPECT_EQ(1, calls);
+}
+
+TEST_F(BidiMethod, ProcessPackets_ReleasesLockForCallbacks) {
+  struct {
+    internal::test::FakeServerReaderWriter& responder;
+    int calls;
+  } state{responder_, 0};
+
+  // Checking whether the call is active requires the RPC lock, so this would
+  // deadlock if the lock were held across the callback.
+  responder_.set_on_next([&state](ConstByteSpan) {
+    state.calls += 1;
+    EXPECT_TRUE(state.responder.active());
+  });
+
+  byte buffer[64];
+  const ConstByteSpan packet = PacketForRpc(PacketType::CLIENT_STREAM);
+  std::memcpy(buffer, packet.data(), packet.size());
+  const ConstByteSpan packets[] = {span(buffer, packet.size()),
+                                   span(buffer, packet.size())};
+
+  const StatusWithSize result = server_.ProcessPackets(packets);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ(2, state.calls);
+}
+
+TEST_F(BidiMethod, ProcessPackets_LaterPacketsSeeCallbackChanges) {
+  struct {
+    internal::test::FakeServerReaderWriter& responder;
+    int calls;
+  } state{responder_, 0};
+  responder_.set_on_next([&state](ConstByteSpan) {
+    state.calls += 1;
+    EXPECT_EQ(OkStatus(), state.responder.Finish());
+  });
+
+  byte buffer[64];
+  const ConstByteSpan packet = PacketForRpc(PacketType::CLIENT_STREAM);
+  std::memcpy(buffer, packet.data(), packet.size());
+  const ConstByteSpan packets[] = {span(buffer, packet.size()),
+                                   span(buffer, packet.size())};
+
+  const StatusWithSize result = server_.ProcessPackets(packets);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ(1, state.calls);
+  EXPECT_FALSE(responder_.active());
+
+  // The second packet arrived after the call finished.
+  const Packet& sent =
+      static_cast<internal::test::FakeChannelOutput&>(output_).last_packet();
+  EXPECT_EQ(sent.type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(sent.status(), Status::FailedPrecondition());
+}
+
+TEST_F(BidiMethod, ProcessPackets_ProcessesRequests) {
+  const TestMethod& method = service_42_.method(100);
+
+  byte request[64];
+  const ConstByteSpan request_packet = PacketForRpc(PacketType::REQUEST);
+  std::memcpy(request, request_packet.data(), request_packet.size());
+  const ConstByteSpan packets[] = {
+      span(request, request_packet.size()),
+      span(request, request_packet.size()),
+  };
+
+  const StatusWithSize result = server_.ProcessPackets(packets);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ(method.invocations(), 2u);
+}
+
 TEST_F(BidiMethod, ClientStream_CallsCallbackOnCallWithOpenId) {
   ConstByteSpan data = as_bytes(span("?"));
   responder_.set_on_next([&data](ConstByteSpan payload) { data = payload; });
@@ -0,0 +1,369 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/load_generator.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pw_json/builder.h"
+#include "pw_random/xor_shift.h"
+#include "pw_rpc/benchmark.raw_rpc.pb.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/timed_thread_notification.h"
+
+namespace pw::rpc {
+namespace {
+
+using Clock = chrono::SystemClock;
+
+uint64_t Microseconds(Clock::duration duration) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+uint64_t PerSecond(size_t count, Clock::duration elapsed) {
+  const uint64_t elapsed_us = Microseconds(elapsed);
+  return elapsed_us == 0 ? 0 : count * uint64_t{1'000'000} / elapsed_us;
+}
+
+// Makes one call at a time and records the latency of each. Responses are
+// handled by callbacks on the transport's thread, which wake the worker.
+//
+// Each RPC that the worker opens has a sequence number. Callbacks for an RPC
+// that the worker has moved on from, such as a late response to a call that
+// timed out, are ignored, so they can't complete the next call.
+class Worker {
+ public:
+  Worker(Client& client,
+         uint32_t channel_id,
+         const LoadOptions& options,
+         uint64_t seed)
+      : client_(client, channel_id),
+        options_(options),
+        rng_(seed),
+        payload_(std::max(options.max_payload_size,
+                          options.large_payloads_per_mille != 0
+                              ? options.large_payload_size
+                              : 0)) {
+    rng_.Get(payload_);
+  }
+
+  void Run() {
+    latencies_.reserve(options_.calls_per_worker);
+    rpcs_.reserve(options_.calls_per_worker);
+
+    for (size_t i = 0; i < options_.calls_per_worker; ++i) {
+      const ConstByteSpan payload = NextPayload();
+
+      const Clock::time_point start = Clock::now();
+      if (StartCall(payload).ok() &&
+          response_ready_.try_acquire_for(options_.timeout) && status_.ok() &&
+          response_matches_) {
+        latencies_.push_back(
+            static_cast<uint32_t>(Microseconds(response_time_ - start)));
+        payload_bytes_ += payload.size();
+      } else {
+        failures_ += 1;
+        CancelCalls();
+      }
+    }
+
+    CancelCalls();
+  }
+
+  const std::vector<uint32_t>& latencies() const { return latencies_; }
+  size_t failures() const { return failures_; }
+  size_t payload_bytes() const { return payload_bytes_; }
+
+ private:
+  // An RPC opened by the worker. Its callbacks capture a pointer to this,
+  // since a pw::Function only has room for one pointer.
+  struct Rpc {
+    void OnResponse(ConstByteSpan response) const {
+      worker->OnResponse(sequence, response);
+    }
+    void OnCompleted(Status status) const {
+      worker->OnCompleted(sequence, status);
+    }
+
+    Worker* worker;
+    uint32_t sequence;
+  };
+
+  ConstByteSpan NextPayload() {
+    if (options_.large_payloads_per_mille != 0) {
+      uint32_t per_mille;
+      rng_.GetInt(per_mille, 1000u);
+      if (per_mille < options_.large_payloads_per_mille) {
+        return span(payload_).first(options_.large_payload_size);
+      }
+    }
+
+    size_t size = options_.min_payload_size;
+    if (options_.max_payload_size > options_.min_payload_size) {
+      size_t offset;
+      rng_.GetInt(offset,
+                  options_.max_payload_size - options_.min_payload_size + 1);
+      size += offset;
+    }
+    return span(payload_).first(size);
+  }
+
+  Status StartCall(ConstByteSpan payload) {
+    // An open bidirectional stream has no outstanding responses, since a
+    // call that fails or times out cancels it, so its RPC is reused.
+    const bool new_rpc = options_.call_type !=
+                             LoadCallType::kBidirectionalStream ||
+                         !bidirectional_stream_.active();
+    const Rpc* rpc = PrepareCall(payload, new_rpc);
+
+    switch (options_.call_type) {
+      case LoadCallType::kUnary:
+        unary_ = client_.UnaryEcho(
+            payload,
+            [rpc](ConstByteSpan response, Status status) {
+              rpc->OnResponse(response);
+              rpc->OnCompleted(status);
+            },
+            [rpc](Status error) { rpc->OnCompleted(error); });
+        return OkStatus();
+      case LoadCallType::kServerStream:
+        server_stream_ = client_.ServerStreamEcho(
+            payload,
+            [rpc](ConstByteSpan response) { rpc->OnResponse(response); },
+            [rpc](Status status) { rpc->OnCompleted(status); },
+            [rpc](Status error) { rpc->OnCompleted(error); });
+        return OkStatus();
+      case LoadCallType::kClientStream:
+        client_stream_ = client_.ClientStreamEcho(
+            [rpc](ConstByteSpan response, Status status) {
+              rpc->OnResponse(response);
+              rpc->OnCompleted(status);
+            },
+            [rpc](Status error) { rpc->OnCompleted(error); });
+        return client_stream_.Write(payload);
+      case LoadCallType::kBidirectionalStream:
+        if (new_rpc) {
+          bidirectional_stream_ = client_.BidirectionalEcho(
+              [rpc](ConstByteSpan response) {
+                rpc->OnResponse(response);
+                rpc->OnCompleted(OkStatus());
+              },
+              // The server never ends the stream, so treat that as an error.
+              [rpc](Status) { rpc->OnCompleted(Status::Aborted()); },
+              [rpc](Status error) { rpc->OnCompleted(error); });
+        }
+        return bidirectional_stream_.Write(payload);
+    }
+    return Status::InvalidArgument();
+  }
+
+  // Resets the call state before a call starts. Returns the RPC to use for the
+  // call, which is a new one if `new_rpc` is set.
+  const Rpc* PrepareCall(ConstByteSpan payload, bool new_rpc) {
+    std::lock_guard lock(mutex_);
+    if (new_rpc) {
+      sequence_ += 1;
+      rpcs_.push_back({this, sequence_});
+    }
+    expected_ = payload;
+    response_matches_ = false;
+    status_ = Status::Unknown();
+
+    // Discard a notification from a callback for an earlier RPC that ran
+    // after its call timed out.
+    static_cast<void>(response_ready_.try_acquire());
+    return &rpcs_.back();
+  }
+
+  void OnResponse(uint32_t sequence, ConstByteSpan response) {
+    std::lock_guard lock(mutex_);
+    if (sequence == sequence_) {
+      response_matches_ = std::equal(
+          response.begin(), response.end(), expected_.begin(), expected_.end());
+    }
+  }
+
+  void OnCompleted(uint32_t sequence, Status status) {
+    std::lock_guard lock(mutex_);
+    if (sequence == sequence_) {
+      response_time_ = Clock::now();
+      status_ = status;
+      response_ready_.release();
+    }
+  }
+
+  // Cancels calls that failed or timed out, and the bidirectional stream once
+  // the worker is done.
+  void CancelCalls() {
+    unary_.Cancel().IgnoreError();
+    server_stream_.Cancel().IgnoreError();
+    client_stream_.Cancel().IgnoreError();
+    bidirectional_stream_.Cancel().IgnoreError();
+  }
+
+  pw_rpc::raw::Benchmark::Client client_;
+  const LoadOptions& options_;
+  random::XorShiftStarRng64 rng_;
+  std::vector<std::byte> payload_;
+
+  // Every RPC opened by the worker, at most one per call. Reserved up front so
+  // that the pointers held by callbacks stay valid.
+  std::vector<Rpc> rpcs_;
+
+  // Set before each call is started and read by the callbacks.
+  sync::Mutex mutex_;
+  uint32_t sequence_ = 0;
+  ConstByteSpan expected_;
+
+  // Set by the callbacks of the current RPC before response_ready_ is
+  // released.
+  sync::TimedThreadNotification response_ready_;
+  bool response_matches_ = false;
+  Status status_;
+  Clock::time_point response_time_;
+
+  std::vector<uint32_t> latencies_;
+  size_t failures_ = 0;
+  size_t payload_bytes_ = 0;
+
+  // Destroying a call waits for its callbacks to finish, so the calls are
+  // declared last to be destroyed before the state that the callbacks use.
+  RawUnaryReceiver unary_;
+  RawClientReader server_stream_;
+  RawClientWriter client_stream_;
+  RawClientReaderWriter bidirectional_stream_;
+};
+
+}  // namespace
+
+std::string_view LoadCallTypeName(LoadCallType call_type) {
+  switch (call_type) {
+    case LoadCallType::kUnary:
+      return "unary";
+    case LoadCallType::kServerStream:
+      return "server_stream";
+    case LoadCallType::kClientStream:
+      return "client_stream";
+    case LoadCallType::kBidirectionalStream:
+      return "bidirectional_stream";
+  }
+  return "unknown";
+}
+
+Result<LoadCallType> LoadCallTypeFromName(std::string_view name) {
+  for (LoadCallType call_type : {LoadCallType::kUnary,
+                                 LoadCallType::kServerStream,
+                                 LoadCallType::kClientStream,
+                                 LoadCallType::kBidirectionalStream}) {
+    if (name == LoadCallTypeName(call_type)) {
+      return call_type;
+    }
+  }
+  return Status::InvalidArgument();
+}
+
+uint64_t LoadResults::calls_per_second() const {
+  return PerSecond(calls, elapsed);
+}
+
+uint64_t LoadResults::payload_bytes_per_second() const {
+  return PerSecond(payload_bytes, elapsed);
+}
+
+StatusWithSize LoadResults::WriteJson(span<char> buffer) const {
+  JsonBuilder json(buffer);
+  JsonObject& object =
+      json.StartObject()
+          .Add("call_type", LoadCallTypeName(options.call_type))
+          .Add("concurrency", options.concurrency)
+          .Add("min_payload_size", options.min_payload_size)
+          .Add("max_payload_size", options.max_payload_size);
+  if (options.large_payloads_per_mille != 0) {
+    object.Add("large_payloads_per_mille", options.large_payloads_per_mille)
+        .Add("large_payload_size", options.large_payload_size);
+  }
+  object.Add("calls", calls)
+      .Add("failures", failures)
+      .Add("payload_bytes", payload_bytes)
+      .Add("elapsed_us", Microseconds(elapsed))
+      .Add("calls_per_second", calls_per_second())
+      .Add("payload_bytes_per_second", payload_bytes_per_second());
+  object.AddNestedObject("latency_us")
+      .Add("p50", p50_us)
+      .Add("p99", p99_us)
+      .Add("p999", p999_us)
+      .Add("max", max_us);
+  return StatusWithSize(json.status(), json.size());
+}
+
+uint32_t LatencyPercentile(span<const uint32_t> sorted_samples,
+                           uint32_t per_mille) {
+  if (sorted_samples.empty()) {
+    return 0;
+  }
+  const size_t rank = (per_mille * sorted_samples.size() + 999) / 1000;
+  return sorted_samples[std::clamp<size_t>(rank, 1, sorted_samples.size()) - 1];
+}
+
+Result<LoadResults> LoadGenerator::Run(const LoadOptions& options) {
+  if (options.concurrency == 0 ||
+      options.min_payload_size > options.max_payload_size ||
+      options.max_payload_size > MaxSafePayloadSize() ||
+      options.large_payloads_per_mille > 1000 ||
+      options.large_payload_size > MaxSafePayloadSize()) {
+    return Status::InvalidArgument();
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (size_t i = 0; i < options.concurrency; ++i) {
+    workers.push_back(std::make_unique<Worker>(
+        client_, channel_id_, options, options.seed + i));
+  }
+
+  std::vector<std::thread> threads;
+  const Clock::time_point start = Clock::now();
+  for (std::unique_ptr<Worker>& worker : workers) {
+    threads.emplace_back([&worker] { worker->Run(); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  LoadResults results{.options = options};
+  results.elapsed = Clock::now() - start;
+
+  std::vector<uint32_t> latencies;
+  for (const std::unique_ptr<Worker>& worker : workers) {
+    latencies.insert(latencies.end(),
+                     worker->latencies().begin(),
+                     worker->latencies().end());
+    results.failures += worker->failures();
+    results.payload_bytes += worker->payload_bytes();
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  results.calls = latencies.size();
+  results.p50_us = LatencyPercentile(latencies, 500);
+  results.p99_us = LatencyPercentile(latencies, 990);
+  results.p999_us = LatencyPercentile(latencies, 999);
+  results.max_us = latencies.empty() ? 0 : latencies.back();
+  return results;
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,238 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/load_generator.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc_transport/local_rpc_egress.h"
+#include "pw_rpc_transport/service_registry.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr uint32_t kChannelId = 1;
+constexpr size_t kMaxPacketSize = 256;
+constexpr size_t kPacketQueueSize = 16;
+
+// Loops packets from the client back to the server and vice versa. Packets are
+// processed on the egress thread.
+class LoopbackBenchmark {
+ public:
+  LoopbackBenchmark() {
+    egress_.set_packet_processor(registry_);
+    registry_.RegisterService(service_);
+    egress_thread_ = Thread(thread_context_.options(), egress_);
+  }
+
+  ~LoopbackBenchmark() {
+    egress_.Stop();
+    egress_thread_.join();
+  }
+
+  Client& client() { return registry_.client_server().client(); }
+
+ private:
+  LocalRpcEgress<kPacketQueueSize, kMaxPacketSize> egress_;
+  std::array<Channel, 1> channels_{Channel::Create<kChannelId>(&egress_)};
+  ServiceRegistry registry_{channels_};
+  BenchmarkService service_;
+  thread::test::TestThreadContext thread_context_;
+  Thread egress_thread_;
+};
+
+TEST(LoadGenerator, LatencyPercentile_NearestRank) {
+  std::array<uint32_t, 1000> samples;
+  for (uint32_t i = 0; i < samples.size(); ++i) {
+    samples[i] = i + 1;
+  }
+
+  EXPECT_EQ(LatencyPercentile(samples, 500), 500u);
+  EXPECT_EQ(LatencyPercentile(samples, 990), 990u);
+  EXPECT_EQ(LatencyPercentile(samples, 999), 999u);
+  EXPECT_EQ(LatencyPercentile(samples, 1000), 1000u);
+  EXPECT_EQ(LatencyPercentile(samples, 0), 1u);
+}
+
+TEST(LoadGenerator, LatencyPercentile_FewSamples) {
+  constexpr uint32_t kOne[] = {7};
+  EXPECT_EQ(LatencyPercentile(kOne, 500), 7u);
+  EXPECT_EQ(LatencyPercentile(kOne, 999), 7u);
+
+  constexpr uint32_t kTen[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ(LatencyPercentile(kTen, 500), 5u);
+  EXPECT_EQ(LatencyPercentile(kTen, 990), 10u);
+
+  EXPECT_EQ(LatencyPercentile({}, 500), 0u);
+}
+
+TEST(LoadGenerator, CallTypeNames_RoundTrip) {
+  for (LoadCallType call_type : {LoadCallType::kUnary,
+                                 LoadCallType::kServerStream,
+                                 LoadCallType::kClientStream,
+                                 LoadCallType::kBidirectionalStream}) {
+    const Result<LoadCallType> parsed =
+        LoadCallTypeFromName(LoadCallTypeName(call_type));
+    ASSERT_EQ(parsed.status(), OkStatus());
+    EXPECT_EQ(*parsed, call_type);
+  }
+  EXPECT_EQ(LoadCallTypeFromName("bidi").status(), Status::InvalidArgument());
+}
+
+TEST(LoadGenerator, WriteJson) {
+  LoadResults results{
+      .options = {.call_type = LoadCallType::kServerStream,
+                  .concurrency = 2,
+                  .min_payload_size = 8,
+                  .max_payload_size = 16},
+      .calls = 10,
+      .failures = 1,
+      .payload_bytes = 120,
+      .elapsed = std::chrono::duration_cast<chrono::SystemClock::duration>(2s),
+      .p50_us = 10,
+      .p99_us = 20,
+      .p999_us = 30,
+      .max_us = 40,
+  };
+
+  std::array<char, 512> buffer;
+  const StatusWithSize written = results.WriteJson(buffer);
+  ASSERT_EQ(written.status(), OkStatus());
+  EXPECT_EQ(
+      std::string_view(buffer.data(), written.size()),
+      R"({"call_type": "server_stream", "concurrency": 2, )"
+      R"("min_payload_size": 8, "max_payload_size": 16, "calls": 10, )"
+      R"("failures": 1, "payload_bytes": 120, "elapsed_us": 2000000, )"
+      R"("calls_per_second": 5, "payload_bytes_per_second": 60, )"
+      R"("latency_us": {"p50": 10, "p99": 20, "p999": 30, "max": 40}})");
+}
+
+TEST(LoadGenerator, WriteJson_LargePayloads) {
+  LoadResults results{
+      .options = {.min_payload_size = 8,
+                  .max_payload_size = 8,
+                  .large_payloads_per_mille = 10,
+                  .large_payload_size = 512},
+  };
+
+  std::array<char, 512> buffer;
+  const StatusWithSize written = results.WriteJson(buffer);
+  ASSERT_EQ(written.status(), OkStatus());
+  EXPECT_NE(std::string_view(buffer.data(), written.size())
+                .find(R"("max_payload_size": 8, )"
+                      R"("large_payloads_per_mille": 10, )"
+                      R"("large_payload_size": 512, "calls": 0, )"),
+            std::string_view::npos);
+}
+
+TEST(LoadGenerator, Run_InvalidOptions) {
+  LoopbackBenchmark loopback;
+  LoadGenerator generator(loopback.client(), kChannelId);
+
+  EXPECT_EQ(generator.Run({.concurrency = 0}).status(),
+            Status::InvalidArgument());
+  EXPECT_EQ(
+      generator.Run({.min_payload_size = 10, .max_payload_size = 9}).status(),
+      Status::InvalidArgument());
+  EXPECT_EQ(generator.Run({.max_payload_size = MaxSafePayloadSize() + 1})
+                .status(),
+            Status::InvalidArgument());
+  EXPECT_EQ(generator.Run({.large_payloads_per_mille = 1001}).status(),
+            Status::InvalidArgument());
+  EXPECT_EQ(generator
+                .Run({.large_payloads_per_mille = 1,
+                      .large_payload_size = MaxSafePayloadSize() + 1})
+                .status(),
+            Status::InvalidArgument());
+}
+
+TEST(LoadGenerator, Run_LargePayloads) {
+  LoopbackBenchmark loopback;
+  LoadGenerator generator(loopback.client(), kChannelId);
+
+  // Every payload is large.
+  Result<LoadResults> results =
+      generator.Run({.calls_per_worker = 20,
+                     .min_payload_size = 4,
+                     .max_payload_size = 4,
+                     .large_payloads_per_mille = 1000,
+                     .large_payload_size = 100,
+                     .timeout = 5s});
+  ASSERT_EQ(results.status(), OkStatus());
+  EXPECT_EQ(results->calls, 20u);
+  EXPECT_EQ(results->payload_bytes, 2000u);
+
+  // Payloads are either small or large.
+  results = generator.Run({.calls_per_worker = 200,
+                           .min_payload_size = 4,
+                           .max_payload_size = 4,
+                           .large_payloads_per_mille = 500,
+                           .large_payload_size = 100,
+                           .timeout = 5s});
+  ASSERT_EQ(results.status(), OkStatus());
+  ASSERT_EQ(results->calls, 200u);
+  const size_t large_calls = (results->payload_bytes - 4 * 200) / 96;
+  EXPECT_EQ(results->payload_bytes, 4 * 200 + 96 * large_calls);
+  EXPECT_GT(large_calls, 50u);
+  EXPECT_LT(large_calls, 150u);
+}
+
+void ExpectEveryCallSucceeds(LoadCallType call_type) {
+  LoopbackBenchmark loopback;
+  LoadGenerator generator(loopback.client(), kChannelId);
+
+  const Result<LoadResults> results =
+      generator.Run({.call_type = call_type,
+                     .concurrency = 4,
+                     .calls_per_worker = 25,
+                     .min_payload_size = 1,
+                     .max_payload_size = 64,
+                     .timeout = 5s});
+  ASSERT_EQ(results.status(), OkStatus());
+
+  EXPECT_EQ(results->calls, 100u);
+  EXPECT_EQ(results->failures, 0u);
+  EXPECT_GE(results->payload_bytes, 100u);
+  EXPECT_LE(results->payload_bytes, 6400u);
+  EXPECT_LE(results->p50_us, results->p99_us);
+  EXPECT_LE(results->p99_us, results->p999_us);
+  EXPECT_LE(results->p999_us, results->max_us);
+}
+
+TEST(LoadGenerator, Run_Unary) {
+  ExpectEveryCallSucceeds(LoadCallType::kUnary);
+}
+
+TEST(LoadGenerator, Run_ServerStream) {
+  ExpectEveryCallSucceeds(LoadCallType::kServerStream);
+}
+
+TEST(LoadGenerator, Run_ClientStream) {
+  ExpectEveryCallSucceeds(LoadCallType::kClientStream);
+}
+
+TEST(LoadGenerator, Run_BidirectionalStream) {
+  ExpectEveryCallSucceeds(LoadCallType::kBidirectionalStream);
+}
+
+}  // namespace
+}  // namespace pw::rpc
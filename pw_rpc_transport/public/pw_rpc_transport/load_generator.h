@@ -0,0 +1,137 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
+#include "pw_rpc/client.h"
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::rpc {
+
+// The kind of pw.rpc.Benchmark RPC that a LoadGenerator makes.
+enum class LoadCallType {
+  // Each call is a UnaryEcho RPC.
+  kUnary,
+  // Each call is a ServerStreamEcho RPC.
+  kServerStream,
+  // Each call is a ClientStreamEcho RPC.
+  kClientStream,
+  // Each worker opens one BidirectionalEcho RPC. Each call is one write to it.
+  kBidirectionalStream,
+};
+
+// Returns the name of a LoadCallType, as used in LoadResults::WriteJson().
+std::string_view LoadCallTypeName(LoadCallType call_type);
+
+// Parses a name returned by LoadCallTypeName().
+Result<LoadCallType> LoadCallTypeFromName(std::string_view name);
+
+struct LoadOptions {
+  LoadCallType call_type = LoadCallType::kUnary;
+
+  // Number of workers. Each worker has at most one call outstanding.
+  size_t concurrency = 1;
+
+  // Number of calls that each worker makes.
+  size_t calls_per_worker = 100;
+
+  // Payload sizes are uniformly distributed over [min, max] bytes. Setting
+  // both to the same value sends fixed-size payloads.
+  size_t min_payload_size = 0;
+  size_t max_payload_size = 64;
+
+  // For a bimodal mix of payload sizes, such as small commands among
+  // occasional bulk transfers, this many calls out of every 1000 send
+  // large_payload_size bytes instead of a size from [min, max].
+  uint32_t large_payloads_per_mille = 0;
+  size_t large_payload_size = 0;
+
+  // How long to wait for the response to each call before counting it as
+  // failed. A call that times out is cancelled, and a late response to it is
+  // ignored.
+  chrono::SystemClock::duration timeout = std::chrono::seconds(1);
+
+  // Seeds the payload size and content generator of each worker.
+  uint64_t seed = 1;
+};
+
+struct LoadResults {
+  LoadOptions options;
+
+  // Number of calls that completed with the payload that was sent.
+  size_t calls = 0;
+
+  // Number of calls that failed, timed out, or returned the wrong payload.
+  size_t failures = 0;
+
+  // Total size of the payloads sent by successful calls.
+  size_t payload_bytes = 0;
+
+  // Wall-clock time for the whole run.
+  chrono::SystemClock::duration elapsed{};
+
+  // Latencies of successful calls, from starting the call to receiving its
+  // response, in microseconds.
+  uint32_t p50_us = 0;
+  uint32_t p99_us = 0;
+  uint32_t p999_us = 0;
+  uint32_t max_us = 0;
+
+  uint64_t calls_per_second() const;
+  uint64_t payload_bytes_per_second() const;
+
+  // Writes the results as a single-line JSON object.
+  StatusWithSize WriteJson(span<char> buffer) const;
+};
+
+// Returns the nearest-rank percentile of latency samples sorted in ascending
+// order, with the percentile given in tenths of a percent (e.g. 999 for
+// p99.9). Returns 0 if there are no samples.
+uint32_t LatencyPercentile(span<const uint32_t> sorted_samples,
+                           uint32_t per_mille);
+
+// Generates load on a pw.rpc.Benchmark service and measures the latency and
+// throughput of its RPCs. Uses std::thread, so it is for host builds only.
+//
+// The generator only needs an RPC client. It works over any transport that
+// dispatches responses to the client on another thread, such as
+// SocketRpcTransport or a LocalRpcEgress loopback.
+class LoadGenerator {
+ public:
+  LoadGenerator(Client& client, uint32_t channel_id)
+      : client_(client), channel_id_(channel_id) {}
+
+  // Runs the load described by `options` and blocks until every worker is
+  // done.
+  //
+  // Returns:
+  //   OK - The load ran. Individual calls may still have failed.
+  //   INVALID_ARGUMENT - The options are not valid, e.g. no workers,
+  //     payloads that don't fit in an RPC packet, or more than 1000 large
+  //     payloads per mille.
+  Result<LoadResults> Run(const LoadOptions& options);
+
+ private:
+  Client& client_;
+  const uint32_t channel_id_;
+};
+
+}  // namespace pw::rpc
@@ -0,0 +1,234 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Generates load on a pw.rpc.Benchmark service and prints the results as a JSON
+// object on stdout.
+//
+//   rpc_load_generator --serve PORT
+//     Serves a BenchmarkService over a SocketRpcTransport until killed.
+//
+//   rpc_load_generator [--connect HOST PORT] [OPTIONS]
+//     Generates load on the server at HOST:PORT, or on an in-process loopback
+//     server if --connect is not given.
+//
+// OPTIONS:
+//   --call-type unary|server_stream|client_stream|bidirectional_stream
+//   --concurrency N    Number of workers, each with one outstanding call.
+//   --calls N          Number of calls each worker makes.
+//   --min-payload N    Smallest payload size, in bytes.
+//   --max-payload N    Largest payload size, in bytes.
+//   --large-payload N  Size of occasional large payloads, in bytes.
+//   --large-per-mille N
+//                      Number of calls out of 1000 with a large payload.
+//   --timeout-ms N     How long to wait for each response.
+//   --seed N           Seed for payload sizes and contents.
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include "pw_log/log.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc_transport/egress_ingress.h"
+#include "pw_rpc_transport/load_generator.h"
+#include "pw_rpc_transport/local_rpc_egress.h"
+#include "pw_rpc_transport/service_registry.h"
+#include "pw_rpc_transport/socket_rpc_transport.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint32_t kChannelId = 1;
+constexpr size_t kMaxPacketSize = 1024;
+constexpr size_t kPacketQueueSize = 64;
+
+using Transport = SocketRpcTransport<kMaxPacketSize>;
+using LocalEgress = LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>;
+
+// RPC client and server that send packets over a socket. Received packets are
+// processed on the local egress thread.
+class SocketEndpoint {
+ public:
+  explicit SocketEndpoint(Transport& transport)
+      : transport_(transport), rpc_egress_("tx", transport_) {
+    local_egress_.set_packet_processor(registry_);
+    transport_.set_ingress(rpc_ingress_);
+    registry_.RegisterService(service_);
+    local_egress_thread_ = Thread(thread::stl::Options(), local_egress_);
+    transport_thread_ = Thread(thread::stl::Options(), transport_);
+  }
+
+  ~SocketEndpoint() {
+    local_egress_.Stop();
+    transport_.Stop();
+    local_egress_thread_.join();
+    transport_thread_.join();
+  }
+
+  Client& client() { return registry_.client_server().client(); }
+
+ private:
+  Transport& transport_;
+  SimpleRpcEgress<kMaxPacketSize> rpc_egress_;
+  LocalEgress local_egress_;
+  std::array<Channel, 1> tx_channels_{
+      Channel::Create<kChannelId>(&rpc_egress_)};
+  std::array<ChannelEgress, 1> rx_channels_{
+      ChannelEgress(kChannelId, local_egress_)};
+  SimpleRpcIngress<kMaxPacketSize> rpc_ingress_{rx_channels_};
+  ServiceRegistry registry_{tx_channels_};
+  BenchmarkService service_;
+  Thread local_egress_thread_;
+  Thread transport_thread_;
+};
+
+// RPC client and server that send packets to each other through a local
+// egress.
+class LoopbackEndpoint {
+ public:
+  LoopbackEndpoint() {
+    egress_.set_packet_processor(registry_);
+    registry_.RegisterService(service_);
+    egress_thread_ = Thread(thread::stl::Options(), egress_);
+  }
+
+  ~LoopbackEndpoint() {
+    egress_.Stop();
+    egress_thread_.join();
+  }
+
+  Client& client() { return registry_.client_server().client(); }
+
+ private:
+  LocalEgress egress_;
+  std::array<Channel, 1> channels_{Channel::Create<kChannelId>(&egress_)};
+  ServiceRegistry registry_{channels_};
+  BenchmarkService service_;
+  Thread egress_thread_;
+};
+
+bool ParseNumber(const char* arg, uint64_t& value) {
+  char* end;
+  value = std::strtoull(arg, &end, 10);
+  return *arg != '\0' && *end == '\0';
+}
+
+int Serve(uint16_t port) {
+  Transport transport(Transport::kAsServer, port);
+  SocketEndpoint endpoint(transport);
+  transport.WaitUntilReady();
+  PW_LOG_INFO("Serving pw.rpc.Benchmark on port %u", port);
+  while (true) {
+    this_thread::sleep_for(std::chrono::seconds(1));
+  }
+}
+
+int Generate(Client& client, const LoadOptions& options) {
+  const Result<LoadResults> results =
+      LoadGenerator(client, kChannelId).Run(options);
+  if (!results.ok()) {
+    PW_LOG_ERROR("Invalid load options: %s", results.status().str());
+    return 1;
+  }
+
+  std::array<char, 512> json;
+  const StatusWithSize written = results->WriteJson(json);
+  if (!written.ok()) {
+    return 1;
+  }
+  std::printf("%s\n", json.data());
+  return results->failures == 0 ? 0 : 2;
+}
+
+int Main(int argc, char** argv) {
+  LoadOptions options;
+  const char* host = nullptr;
+  uint64_t port = 0;
+  bool serve = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    uint64_t value = 0;
+
+    if (arg == "--serve" && has_value && ParseNumber(argv[++i], port)) {
+      serve = true;
+    } else if (arg == "--connect" && i + 2 < argc &&
+               ParseNumber(argv[i + 2], port)) {
+      host = argv[i + 1];
+      i += 2;
+    } else if (arg == "--call-type" && has_value) {
+      const Result<LoadCallType> call_type = LoadCallTypeFromName(argv[++i]);
+      if (!call_type.ok()) {
+        PW_LOG_ERROR("Unknown call type %s", argv[i]);
+        return 1;
+      }
+      options.call_type = *call_type;
+    } else if (has_value && ParseNumber(argv[i + 1], value)) {
+      i += 1;
+      if (arg == "--concurrency") {
+        options.concurrency = value;
+      } else if (arg == "--calls") {
+        options.calls_per_worker = value;
+      } else if (arg == "--min-payload") {
+        options.min_payload_size = value;
+      } else if (arg == "--max-payload") {
+        options.max_payload_size = value;
+      } else if (arg == "--large-payload") {
+        options.large_payload_size = value;
+      } else if (arg == "--large-per-mille") {
+        options.large_payloads_per_mille = static_cast<uint32_t>(value);
+      } else if (arg == "--timeout-ms") {
+        options.timeout = std::chrono::milliseconds(value);
+      } else if (arg == "--seed") {
+        options.seed = value;
+      } else {
+        PW_LOG_ERROR("Unknown option %s", argv[i - 1]);
+        return 1;
+      }
+    } else {
+      PW_LOG_ERROR("Invalid argument %s; see rpc_load_generator.cc for usage",
+                   argv[i]);
+      return 1;
+    }
+  }
+
+  if (port > UINT16_MAX) {
+    PW_LOG_ERROR("Invalid port %u", static_cast<unsigned>(port));
+    return 1;
+  }
+
+  if (serve) {
+    return Serve(static_cast<uint16_t>(port));
+  }
+
+  if (host == nullptr) {
+    LoopbackEndpoint endpoint;
+    return Generate(endpoint.client(), options);
+  }
+
+  Transport transport(Transport::kAsClient, host, static_cast<uint16_t>(port));
+  SocketEndpoint endpoint(transport);
+  transport.WaitUntilConnected();
+  return Generate(endpoint.client(), options);
+}
+
+}  // namespace
+}  // namespace pw::rpc
+
+int main(int argc, char** argv) { return pw::rpc::Main(argc, argv); }
@@ -0,0 +1,308 @@
+// Copyright 2025 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/internal/method_info.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc_transport/egress_ingress.h"
+#include "pw_rpc_transport/simple_framing.h"
+#include "pw_rpc_transport/stream_rpc_dispatcher.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::pwpb::PacketType;
+
+using UnaryEcho = internal::MethodInfo<pw_rpc::raw::Benchmark::UnaryEcho>;
+using BidirectionalEcho =
+    internal::MethodInfo<pw_rpc::raw::Benchmark::BidirectionalEcho>;
+
+constexpr uint32_t kChannelId = 1;
+constexpr size_t kMaxPacketSize = 128;
+constexpr size_t kPacketsPerRead = 8;
+constexpr size_t kReads = 4;
+constexpr size_t kPayloadSize = 32;
+constexpr uint32_t kStreamCallId = 1;
+
+constexpr size_t kFrameSize =
+    SimpleRpcPacketEncoder<kMaxPacketSize>::kHeaderSize +
+    internal::Packet::kMinEncodedSizeWithoutPayload + kPayloadSize;
+constexpr size_t kReadSize = kPacketsPerRead * kFrameSize;
+
+// kFrameSize is an upper bound, so a read may contain a few extra packets.
+constexpr size_t kMaxBatchSize = 2 * kPacketsPerRead;
+
+// Discards the server's responses.
+class SinkOutput : public ChannelOutput {
+ public:
+  SinkOutput() : ChannelOutput("SinkOutput") {}
+
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+// Encodes an RPC packet for one of the BenchmarkService's echo methods.
+template <typename Method>
+ConstByteSpan EncodePacket(PacketType type,
+                           uint32_t call_id,
+                           ByteSpan buffer,
+                           ConstByteSpan payload = {}) {
+  return internal::Packet(type,
+                          kChannelId,
+                          Method::kServiceId,
+                          Method::kMethodId,
+                          call_id,
+                          payload)
+      .Encode(buffer)
+      .value();
+}
+
+// A server with a BenchmarkService, which echoes unary requests and each
+// message on a bidirectional stream. A BidirectionalEcho call is opened so
+// client stream packets can be sent to it.
+class EchoServer {
+ public:
+  EchoServer()
+      : channels_{Channel::Create<kChannelId>(&output_)}, server_(channels_) {
+    server_.RegisterService(service_);
+
+    std::array<std::byte, kMaxPacketSize> buffer;
+    server_
+        .ProcessPacket(EncodePacket<BidirectionalEcho>(
+            PacketType::REQUEST, kStreamCallId, buffer))
+        .IgnoreError();
+  }
+
+  Server& server() { return server_; }
+
+ private:
+  SinkOutput output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  BenchmarkService service_;
+};
+
+// Encodes kPacketsPerRead packets of the given type.
+class EncodedPackets {
+ public:
+  explicit EncodedPackets(PacketType type) {
+    const std::array<std::byte, kPayloadSize> payload{};
+    for (uint32_t i = 0; i < kPacketsPerRead; ++i) {
+      packets_[i] =
+          type == PacketType::REQUEST
+              ? EncodePacket<UnaryEcho>(type, i + 1, buffers_[i], payload)
+              : EncodePacket<BidirectionalEcho>(
+                    type, kStreamCallId, buffers_[i], payload);
+    }
+  }
+
+  span<const ConstByteSpan> packets() const { return packets_; }
+
+ private:
+  std::array<std::array<std::byte, kMaxPacketSize>, kPacketsPerRead> buffers_;
+  std::array<ConstByteSpan, kPacketsPerRead> packets_;
+};
+
+// Reads simple-framed packets, kPacketsPerRead at a time. Stops the dispatcher
+// once every packet has been read.
+//
+// Packets are either UnaryEcho requests, each of which starts a call, or
+// messages on the open BidirectionalEcho call's client stream.
+class RequestReader : public stream::NonSeekableReader {
+ public:
+  explicit RequestReader(PacketType type) {
+    const std::array<std::byte, kPayloadSize> payload{};
+    SimpleRpcPacketEncoder<kMaxPacketSize> encoder;
+
+    for (uint32_t call_id = 1; call_id <= kPacketsPerRead * kReads; ++call_id) {
+      std::array<std::byte, kMaxPacketSize> packet_buffer;
+      const ConstByteSpan packet =
+          type == PacketType::REQUEST
+              ? EncodePacket<UnaryEcho>(type, call_id, packet_buffer, payload)
+              : EncodePacket<BidirectionalEcho>(
+                    type, kStreamCallId, packet_buffer, payload);
+      encoder
+          .Encode(packet,
+                  kMaxPacketSize,
+                  [this](RpcFrame& frame) {
+                    Append(frame.header);
+                    Append(frame.payload);
+                    return OkStatus();
+                  })
+          .IgnoreError();
+    }
+  }
+
+  void Rewind(StreamRpcDispatcher<kReadSize>& dispatcher) {
+    dispatcher_ = &dispatcher;
+    position_ = 0;
+  }
+
+ private:
+  void Append(ConstByteSpan data) {
+    std::copy(data.begin(), data.end(), data_.begin() + size_);
+    size_ += data.size();
+  }
+
+  StatusWithSize DoRead(ByteSpan destination) override {
+    if (position_ == size_) {
+      dispatcher_->Stop();
+      return StatusWithSize::OutOfRange();
+    }
+    const size_t size = std::min(destination.size(), size_ - position_);
+    std::copy_n(data_.begin() + position_, size, destination.begin());
+    position_ += size;
+    return StatusWithSize(size);
+  }
+
+  std::array<std::byte, kFrameSize * kPacketsPerRead * kReads> data_;
+  size_t size_ = 0;
+  size_t position_ = 0;
+  StreamRpcDispatcher<kReadSize>* dispatcher_ = nullptr;
+};
+
+// Passes each decoded packet to Server::ProcessPacket().
+class PacketEgress : public RpcEgressHandler {
+ public:
+  explicit PacketEgress(Server& server) : server_(server) {}
+
+  Status SendRpcPacket(ConstByteSpan rpc_packet) override {
+    return server_.ProcessPacket(rpc_packet);
+  }
+
+ private:
+  Server& server_;
+};
+
+// Collects the packets decoded from each read and passes them to
+// Server::ProcessPackets().
+class BatchingIngress : public RpcIngressHandler, public RpcEgressHandler {
+ public:
+  explicit BatchingIngress(Server& server)
+      : server_(server), egresses_{ChannelEgress(kChannelId, *this)} {}
+
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    const Status status = ingress_.ProcessIncomingData(buffer);
+    server_.ProcessPackets(span(packets_.data(), batch_size_)).IgnoreError();
+    batch_size_ = 0;
+    return status;
+  }
+
+  // The decoder reuses its buffer, so each packet is copied into the batch.
+  Status SendRpcPacket(ConstByteSpan rpc_packet) override {
+    if (batch_size_ == packets_.size()) {
+      return Status::ResourceExhausted();
+    }
+    std::byte* packet = buffers_[batch_size_].data();
+    std::copy(rpc_packet.begin(), rpc_packet.end(), packet);
+    packets_[batch_size_] = ConstByteSpan(packet, rpc_packet.size());
+    batch_size_ += 1;
+    return OkStatus();
+  }
+
+ private:
+  Server& server_;
+  std::array<ChannelEgress, 1> egresses_;
+  SimpleRpcIngress<kMaxPacketSize> ingress_{egresses_};
+  std::array<std::array<std::byte, kMaxPacketSize>, kMaxBatchSize> buffers_;
+  std::array<ConstByteSpan, kMaxBatchSize> packets_;
+  size_t batch_size_ = 0;
+};
+
+void Dispatch(RequestReader& reader, RpcIngressHandler& ingress) {
+  StreamRpcDispatcher<kReadSize> dispatcher(reader, ingress);
+  reader.Rewind(dispatcher);
+  dispatcher.Start();  // Runs until the reader stops the dispatcher.
+}
+
+// Baseline: each decoded packet is processed as soon as it is decoded.
+void DispatchEachPacket(perf_test::State& state, PacketType type) {
+  EchoServer echo;
+  RequestReader reader(type);
+  PacketEgress egress(echo.server());
+  std::array<ChannelEgress, 1> egresses{ChannelEgress(kChannelId, egress)};
+  SimpleRpcIngress<kMaxPacketSize> ingress(egresses);
+
+  while (state.KeepRunning()) {
+    Dispatch(reader, ingress);
+  }
+}
+
+// The packets decoded from each read are processed as a batch.
+void DispatchBatches(perf_test::State& state, PacketType type) {
+  EchoServer echo;
+  RequestReader reader(type);
+  BatchingIngress ingress(echo.server());
+
+  while (state.KeepRunning()) {
+    Dispatch(reader, ingress);
+  }
+}
+
+// The transport is left out, so these only measure packet processing.
+void ProcessEachPacket(perf_test::State& state, PacketType type) {
+  EchoServer echo;
+  EncodedPackets encoded(type);
+
+  while (state.KeepRunning()) {
+    for (ConstByteSpan packet : encoded.packets()) {
+      echo.server().ProcessPacket(packet).IgnoreError();
+    }
+  }
+}
+
+void ProcessBatch(perf_test::State& state, PacketType type) {
+  EchoServer echo;
+  EncodedPackets encoded(type);
+
+  while (state.KeepRunning()) {
+    echo.server().ProcessPackets(encoded.packets()).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(UnaryRequestsProcessPacket,
+             DispatchEachPacket,
+             PacketType::REQUEST);
+PW_PERF_TEST(UnaryRequestsProcessPackets,
+             DispatchBatches,
+             PacketType::REQUEST);
+PW_PERF_TEST(ClientStreamProcessPacket,
+             DispatchEachPacket,
+             PacketType::CLIENT_STREAM);
+PW_PERF_TEST(ClientStreamProcessPackets,
+             DispatchBatches,
+             PacketType::CLIENT_STREAM);
+
+PW_PERF_TEST(UnaryRequestsProcessEachPacket,
+             ProcessEachPacket,
+             PacketType::REQUEST);
+PW_PERF_TEST(UnaryRequestsProcessBatch, ProcessBatch, PacketType::REQUEST);
+PW_PERF_TEST(ClientStreamProcessEachPacket,
+             ProcessEachPacket,
+             PacketType::CLIENT_STREAM);
+PW_PERF_TEST(ClientStreamProcessBatch,
+             ProcessBatch,
+             PacketType::CLIENT_STREAM);
+
+}  // namespace
+}  // namespace pw::rpc
@@ -79,7 +79,7 @@ class Event {
         const char* group,
         uint32_t trace_id,
         const char* data_type,
-        const char* data,
+        const void* data,
         size_t size)
       : event_type_(event_type),
         flags_(flags),
@@ -88,7 +88,7 @@ class Event {
         trace_id_(trace_id),
         has_data_(true),
         data_format_string_(data_type),
-        data_(data),
+        data_(static_cast<const char*>(data)),
         data_size_(size) {}
   bool operator==(const Event& rhs) const {
     return event_type_ == rhs.event_type_ &&                      //
@@ -102,6 +102,12 @@ class Event {
             (std::memcmp(data_, rhs.data_, data_size_) == 0));
   }
 
+  pw_trace_EventType event_type() const { return event_type_; }
+  const char* label() const { return label_; }
+  const char* group() const { return group_; }
+  const void* data() const { return data_; }
+  size_t data_size() const { return data_size_; }
+
   bool IsEqualIgnoreLabel(const Event& rhs) const {
     return event_type_ == rhs.event_type_ &&                      //
            flags_ == rhs.flags_ &&                                //
@@ -138,11 +144,13 @@ class LastEvent {
 };
 
 #define PW_TRACE(event_type, flags, label, group, trace_id) \
-  LastEvent::Instance().Set(Event(event_type, flags, label, group, trace_id));
+  ::trace_fake_backend::LastEvent::Instance().Set(        \
+      ::trace_fake_backend::Event(event_type, flags, label, group, trace_id));
 
 #define PW_TRACE_DATA(                                           \
     event_type, flags, label, group, trace_id, type, data, size) \
-  LastEvent::Instance().Set(                                     \
-      Event(event_type, flags, label, group, trace_id, type, data, size));
+  ::trace_fake_backend::LastEvent::Instance().Set(               \
+      ::trace_fake_backend::Event(                               \
+          event_type, flags, label, group, trace_id, type, data, size));
 
 }  // namespace trace_fake_backend